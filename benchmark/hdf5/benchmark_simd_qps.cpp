@@ -40,7 +40,7 @@ class Benchmark_simd_qps : public Benchmark_knowhere, public ::testing::Test {
         for (auto simd_type : SIMD_TYPEs_) {
             std::string simd_str = knowhere::KnowhereConfig::SetSimdType(simd_type);
             CALC_TIME_SPAN(task<T>(base, query, worker_func, thread_num, dist));
-            printf("  func = %10s, simd_type = %7s, elapse = %6.3fs, VPS = %.3f\n", worker_name.c_str(),
+            printf("  func = %20s, simd_type = %7s, elapse = %6.3fs, VPS = %.3f\n", worker_name.c_str(),
                    simd_str.c_str(), TDIFF_, nq_ / TDIFF_);
             std::fflush(stdout);
         }
@@ -289,6 +289,135 @@ class Benchmark_simd_qps : public Benchmark_knowhere, public ::testing::Test {
         }
     }
 
+    // all the rows through the _ny kernels, in blocks of the size the typed brute force uses, to compare with the
+    // batch_4 workers above
+    template <typename T>
+    static void
+    ny_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num, float* dist,
+              bool is_ip) {
+        constexpr int64_t block_size = 256;
+        auto dim = base->GetDim();
+        auto nb = base->GetRows();
+        auto xb = (const T*)base->GetTensor();
+
+        auto nq = query->GetRows();
+        auto xq = (const T*)query->GetTensor();
+
+        std::vector<float> block_dist(block_size);
+        num = std::min<int32_t>(num, nq - start);
+        for (int32_t i = 0; i < num; i++) {
+            const T* x = xq + (start + i) * dim;
+            for (int64_t j = 0; j < nb; j += block_size) {
+                const T* y = xb + j * dim;
+                const int64_t ny = std::min(block_size, nb - j);
+                float* d = dist ? dist + (start + i) * nb + j : block_dist.data();
+                if constexpr (std::is_same_v<T, knowhere::fp32>) {
+                    is_ip ? faiss::fvec_inner_products_ny(d, x, y, dim, ny) : faiss::fvec_L2sqr_ny(d, x, y, dim, ny);
+                } else if constexpr (std::is_same_v<T, knowhere::fp16>) {
+                    is_ip ? faiss::fp16_vec_inner_products_ny(d, x, y, dim, ny)
+                          : faiss::fp16_vec_L2sqr_ny(d, x, y, dim, ny);
+                } else if constexpr (std::is_same_v<T, knowhere::bf16>) {
+                    is_ip ? faiss::bf16_vec_inner_products_ny(d, x, y, dim, ny)
+                          : faiss::bf16_vec_L2sqr_ny(d, x, y, dim, ny);
+                } else if constexpr (std::is_same_v<T, knowhere::int8>) {
+                    is_ip ? faiss::int8_vec_inner_products_ny(d, x, y, dim, ny)
+                          : faiss::int8_vec_L2sqr_ny(d, x, y, dim, ny);
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    static void
+    ip_ny_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num, float* dist) {
+        ny_worker<T>(base, query, start, num, dist, true);
+    }
+
+    template <typename T>
+    static void
+    l2_ny_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num, float* dist) {
+        ny_worker<T>(base, query, start, num, dist, false);
+    }
+
+    // fp32 kernels picked for the dimension with fvec_*_for_dim(), to compare with the workers above
+    static void
+    fixed_dim_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num, float* dist,
+                     bool is_ip) {
+        auto dim = base->GetDim();
+        auto nb = base->GetRows();
+        auto xb = (const float*)base->GetTensor();
+
+        auto nq = query->GetRows();
+        auto xq = (const float*)query->GetTensor();
+
+        auto dis_func = is_ip ? faiss::fvec_inner_product_for_dim(dim) : faiss::fvec_L2sqr_for_dim(dim);
+
+        num = std::min<int32_t>(num, nq - start);
+        for (int32_t i = 0; i < num; i++) {
+            const float* x = xq + (start + i) * dim;
+            for (int32_t j = 0; j < nb; j++) {
+                auto d = dis_func(x, xb + j * dim, dim);
+                if (dist) {
+                    dist[(start + i) * nb + j] = d;
+                }
+            }
+        }
+    }
+
+    static void
+    fixed_dim_batch_4_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num,
+                             float* dist, bool is_ip) {
+        auto dim = base->GetDim();
+        auto nb = base->GetRows();
+        auto xb = (const float*)base->GetTensor();
+
+        auto nq = query->GetRows();
+        auto xq = (const float*)query->GetTensor();
+
+        auto dis_func =
+            is_ip ? faiss::fvec_inner_product_batch_4_for_dim(dim) : faiss::fvec_L2sqr_batch_4_for_dim(dim);
+
+        num = std::min<int32_t>(num, nq - start);
+        for (int32_t i = 0; i < num; i++) {
+            const float* x = xq + (start + i) * dim;
+            for (int32_t j = 0; j < nb; j += 4) {
+                const float* y = xb + j * dim;
+                float d0, d1, d2, d3;
+                dis_func(x, y, y + dim, y + 2 * dim, y + 3 * dim, dim, d0, d1, d2, d3);
+                if (dist) {
+                    dist[(start + i) * nb + j] = d0;
+                    dist[(start + i) * nb + j + 1] = d1;
+                    dist[(start + i) * nb + j + 2] = d2;
+                    dist[(start + i) * nb + j + 3] = d3;
+                }
+            }
+        }
+    }
+
+    static void
+    ip_fixed_dim_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num,
+                        float* dist) {
+        fixed_dim_worker(base, query, start, num, dist, true);
+    }
+
+    static void
+    l2_fixed_dim_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num,
+                        float* dist) {
+        fixed_dim_worker(base, query, start, num, dist, false);
+    }
+
+    static void
+    ip_fixed_dim_batch_4_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num,
+                                float* dist) {
+        fixed_dim_batch_4_worker(base, query, start, num, dist, true);
+    }
+
+    static void
+    l2_fixed_dim_batch_4_worker(knowhere::DataSetPtr base, knowhere::DataSetPtr query, int32_t start, int32_t num,
+                                float* dist) {
+        fixed_dim_batch_4_worker(base, query, start, num, dist, false);
+    }
+
  private:
     template <typename T>
     void
@@ -346,6 +475,12 @@ TEST_F(Benchmark_simd_qps, TEST_SIMD) {
     test_simd<T1>("L2_NORM", l2_norm_worker<T1>);
     test_simd<T1>("IP_BATCH_4", ip_batch_4_worker<T1>);
     test_simd<T1>("L2_BATCH_4", l2_batch_4_worker<T1>);
+    test_simd<T1>("IP_NY", ip_ny_worker<T1>);
+    test_simd<T1>("L2_NY", l2_ny_worker<T1>);
+    test_simd<T1>("IP_FIXED_DIM", ip_fixed_dim_worker);
+    test_simd<T1>("L2_FIXED_DIM", l2_fixed_dim_worker);
+    test_simd<T1>("IP_BATCH_4_FIXED_DIM", ip_fixed_dim_batch_4_worker);
+    test_simd<T1>("L2_BATCH_4_FIXED_DIM", l2_fixed_dim_batch_4_worker);
 
     using T2 = knowhere::fp16;
     test_simd<T2>("IP", ip_worker<T2>);
@@ -353,6 +488,8 @@ TEST_F(Benchmark_simd_qps, TEST_SIMD) {
     test_simd<T2>("L2_NORM", l2_norm_worker<T2>);
     test_simd<T2>("IP_BATCH_4", ip_batch_4_worker<T2>);
     test_simd<T2>("L2_BATCH_4", l2_batch_4_worker<T2>);
+    test_simd<T2>("IP_NY", ip_ny_worker<T2>);
+    test_simd<T2>("L2_NY", l2_ny_worker<T2>);
 
     using T3 = knowhere::bf16;
     test_simd<T3>("IP", ip_worker<T3>);
@@ -360,6 +497,8 @@ TEST_F(Benchmark_simd_qps, TEST_SIMD) {
     test_simd<T3>("L2_NORM", l2_norm_worker<T3>);
     test_simd<T3>("IP_BATCH_4", ip_batch_4_worker<T3>);
     test_simd<T3>("L2_BATCH_4", l2_batch_4_worker<T3>);
+    test_simd<T3>("IP_NY", ip_ny_worker<T3>);
+    test_simd<T3>("L2_NY", l2_ny_worker<T3>);
 
     using T4 = knowhere::int8;
     test_simd<T4>("IP", ip_worker<T4>);
@@ -367,4 +506,6 @@ TEST_F(Benchmark_simd_qps, TEST_SIMD) {
     test_simd<T4>("L2_NORM", l2_norm_worker<T4>);
     test_simd<T4>("IP_BATCH_4", ip_batch_4_worker<T4>);
     test_simd<T4>("L2_BATCH_4", l2_batch_4_worker<T4>);
+    test_simd<T4>("IP_NY", ip_ny_worker<T4>);
+    test_simd<T4>("L2_NY", l2_ny_worker<T4>);
 }
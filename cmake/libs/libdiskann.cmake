@@ -12,15 +12,34 @@ set(DISKANN_SOURCES
     thirdparty/DiskANN/src/ann_exception.cpp
     thirdparty/DiskANN/src/aux_utils.cpp
     thirdparty/DiskANN/src/distance.cpp
+    thirdparty/DiskANN/src/inflight_read_table.cpp
     thirdparty/DiskANN/src/index.cpp
     thirdparty/DiskANN/src/linux_aligned_file_reader.cpp
     thirdparty/DiskANN/src/math_utils.cpp
     thirdparty/DiskANN/src/memory_mapper.cpp
     thirdparty/DiskANN/src/partition_and_pq.cpp
+    thirdparty/DiskANN/src/pq_fast_scan.cpp
     thirdparty/DiskANN/src/pq_flash_index.cpp
+    thirdparty/DiskANN/src/sector_cache.cpp
     thirdparty/DiskANN/src/logger.cpp
     thirdparty/DiskANN/src/utils.cpp)
 
+# io_uring is optional, DiskANN falls back to libaio when it is missing
+find_package(liburing QUIET)
+if(liburing_FOUND)
+  set(URING_FOUND TRUE)
+  set(URING_LIBRARIES liburing::liburing)
+else()
+  find_package(uring QUIET)
+endif()
+if(URING_FOUND)
+  message(STATUS "Build DiskANN with io_uring support")
+  add_definitions(-DKNOWHERE_WITH_LIBURING)
+  include_directories(${URING_INCLUDE_DIR})
+  list(APPEND DISKANN_SOURCES
+       thirdparty/DiskANN/src/uring_aligned_file_reader.cpp)
+endif()
+
 find_package(folly REQUIRED)
 
 add_library(diskann STATIC ${DISKANN_SOURCES})
@@ -39,4 +58,7 @@ if(__X86_64)
     diskann PRIVATE -fno-builtin-malloc -fno-builtin-calloc
                     -fno-builtin-realloc -fno-builtin-free)
 endif()
+if(URING_FOUND)
+  target_link_libraries(diskann PUBLIC ${URING_LIBRARIES})
+endif()
 list(APPEND KNOWHERE_LINKER_LIBS diskann)
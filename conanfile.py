@@ -112,6 +112,8 @@ class KnowhereConan(ConanFile):
             self.requires("opentelemetry-cpp/1.8.1.1@milvus/dev")
         if self.settings.os not in ["Macos", "Android"]:
             self.requires("libunwind/1.7.2")
+        if self.options.with_diskann and self.settings.os == "Linux":
+            self.requires("liburing/2.4")
         if self.options.with_ut:
             self.requires("catch2/3.3.1")
         if self.options.with_benchmark:
@@ -0,0 +1,112 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#include "knowhere/expected.h"
+
+namespace knowhere {
+
+// Cooperative cancellation of a search request. A token is cancelled explicitly with Cancel() or implicitly once its
+// deadline has passed. The token passed to Search/RangeSearch/AnnIterator is made current on the calling thread and
+// on the search pool threads working on the request: queued tasks of a cancelled request are dropped when they
+// start, and the inner loops of the indexes poll CurrentIsCancelled() to give up early. A request stopped this way
+// fails with Status::cancelled or Status::timeout, its partial results are discarded.
+class CancelToken {
+ public:
+    using Clock = std::chrono::steady_clock;
+
+    // a token without deadline, cancelled with Cancel() only
+    CancelToken();
+
+    explicit CancelToken(Clock::time_point deadline);
+
+    static std::shared_ptr<CancelToken>
+    WithDeadline(Clock::time_point deadline) {
+        return std::make_shared<CancelToken>(deadline);
+    }
+
+    static std::shared_ptr<CancelToken>
+    WithTimeout(std::chrono::milliseconds timeout) {
+        return std::make_shared<CancelToken>(Clock::now() + timeout);
+    }
+
+    void
+    Cancel() {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    bool
+    IsCancelled() const {
+        return GetStatus() != Status::success;
+    }
+
+    // Status::cancelled, Status::timeout once the deadline has passed, Status::success otherwise
+    Status
+    GetStatus() const {
+        if (cancelled_.load(std::memory_order_relaxed)) {
+            return Status::cancelled;
+        }
+        if (expired_.load(std::memory_order_relaxed)) {
+            return Status::timeout;
+        }
+        if (has_deadline_ && Clock::now() >= deadline_) {
+            expired_.store(true, std::memory_order_relaxed);
+            return Status::timeout;
+        }
+        return Status::success;
+    }
+
+    // the token of the request the calling thread works on, nullptr if none
+    static const CancelToken*
+    Current() {
+        return current_;
+    }
+
+    static bool
+    CurrentIsCancelled() {
+        return current_ != nullptr && current_->IsCancelled();
+    }
+
+    class ScopedSetter {
+     public:
+        explicit ScopedSetter(const CancelToken* token) : token_before_(current_) {
+            current_ = token;
+        }
+        ~ScopedSetter() {
+            current_ = token_before_;
+        }
+
+        ScopedSetter(const ScopedSetter&) = delete;
+        ScopedSetter&
+        operator=(const ScopedSetter&) = delete;
+
+     private:
+        const CancelToken* token_before_;
+    };
+
+ private:
+    std::atomic<bool> cancelled_ = false;
+    // caches a passed deadline, saves reading the clock
+    mutable std::atomic<bool> expired_ = false;
+    bool has_deadline_ = false;
+    Clock::time_point deadline_;
+
+    inline static thread_local const CancelToken* current_ = nullptr;
+};
+
+using CancelTokenPtr = std::shared_ptr<CancelToken>;
+
+}  // namespace knowhere
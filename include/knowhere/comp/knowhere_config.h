@@ -12,6 +12,7 @@
 #ifndef COMP_KNOWHERE_CONFIG_H
 #define COMP_KNOWHERE_CONFIG_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -40,6 +41,18 @@ class KnowhereConfig {
     static std::string
     SetSimdType(const SimdType simd_type);
 
+    /**
+     * Optional step after SetSimdType: micro-benchmark the SIMD implementations available on this host for every
+     * distance kernel and data type over short, medium and long vectors, and install the fastest one per kernel.
+     * Takes in the order of a hundred milliseconds, a later SetSimdType drops the result.
+     * Returns the chosen table, one line per kernel.
+     */
+    static std::vector<std::string>
+    CalibrateSimdKernels();
+
+    static std::vector<std::string>
+    GetSimdCalibrationTable();
+
     /**
      *The purpose of this interface is: part of the sealed indexes default to using bf16 as the base data to achieve
      *higher capacity; to ensure consistency in computation between growing and sealed, it is necessary to maintain the
@@ -95,6 +108,23 @@ class KnowhereConfig {
     static bool
     SetAioContextPool(size_t num_ctx);
 
+    /**
+     * set disk I/O engine used by DiskANN indexes loaded afterwards
+     */
+    enum DiskIOEngine {
+        LIBAIO = 0,  // linux native aio with a shared context pool (default)
+        IO_URING,    // io_uring with registered files, one ring per search thread shared by all indexes
+    };
+
+    /**
+     * IO_URING needs knowhere to be built with liburing and a kernel supporting io_uring. When `enable_sqpoll` is
+     * set, the rings share one kernel submission thread which sleeps after `sq_thread_idle_ms` of
+     * inactivity. This function returns false and keeps libaio if the requested engine is unavailable.
+     */
+    static bool
+    SetDiskIOEngine(const DiskIOEngine engine, const bool enable_sqpoll = false,
+                    const uint32_t sq_thread_idle_ms = 1000);
+
     static void
     SetBuildThreadPoolSize(size_t num_threads);
     static size_t
@@ -105,6 +135,36 @@ class KnowhereConfig {
     static size_t
     GetSearchThreadPoolSize();
 
+    /**
+     * create one search thread pool per NUMA node, with its threads pinned to the cpus of the node. Indexes loaded
+     * with `numa_node` set are allocated on that node and searched on its pool. Returns false on single node machines.
+     */
+    static bool
+    SetNumaAwareSearchThreadPool(bool enable);
+
+    /**
+     * search requests run in one of three priority lanes of the search thread pool, chosen with the `search_priority`
+     * search param: interactive (0), batch (1) or background (2, also used for index warmup). While the lanes compete,
+     * each gets a share of the threads proportional to its weight. Defaults to 8:2:1.
+     */
+    static void
+    SetSearchPriorityWeights(uint32_t interactive, uint32_t batch, uint32_t background);
+
+    /**
+     * reject the requests of a lane with Status::search_queue_full as long as the lane has this many tasks waiting.
+     * 0 (the default) rejects nothing, the submitters then block while the lane holds 16 tasks per search thread.
+     */
+    static void
+    SetSearchAdmissionLimits(size_t interactive, size_t batch, size_t background);
+
+    /**
+     * let searches with few queries split each query across the idle threads of the search thread pool (rows of
+     * FLAT and brute force, probed lists of IVF_FLAT, IVF_PQ and IVF_SQ), and merge the partial top-k. Only kicks in
+     * while nq is at most half the pool size and no task is waiting. Disabled by default.
+     */
+    static void
+    SetIntraQueryParallelism(bool enable);
+
     /**
      * init GPU Resource
      */
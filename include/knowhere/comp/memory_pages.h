@@ -0,0 +1,52 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "knowhere/expected.h"
+
+namespace knowhere {
+
+// A large memory region of a loaded index, such as the graph links or the codes of a faiss index.
+struct MemoryRegion {
+    const void* addr = nullptr;
+    size_t size = 0;
+    // mapped from the index file, anonymous memory owned by the index otherwise
+    bool mapped = false;
+    // read by most searches, unlike e.g. the refine data
+    bool hot = true;
+};
+
+// How much of the memory regions of an index is resident in RAM.
+struct MemoryResidency {
+    size_t mapped_bytes = 0;
+    size_t mapped_resident_bytes = 0;
+    size_t anonymous_bytes = 0;
+    size_t anonymous_resident_bytes = 0;
+};
+
+// Asks for transparent huge pages on the anonymous regions spanning at least one huge page. Where the kernel supports
+// MADV_COLLAPSE the regions are collapsed right away rather than by khugepaged later on. Returns the advised bytes.
+size_t
+AdviseHugePages(const std::vector<MemoryRegion>& regions);
+
+// Faults in the hot mapped regions in chunks spread over the search thread pool of the calling thread, at BACKGROUND
+// priority, so that the first searches after a load do not pay for the page faults.
+Status
+PrefaultMappedRegions(const std::vector<MemoryRegion>& regions);
+
+MemoryResidency
+GetMemoryResidency(const std::vector<MemoryRegion>& regions);
+
+}  // namespace knowhere
@@ -0,0 +1,67 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <vector>
+
+namespace knowhere {
+
+// NUMA topology of the machine, read from sysfs once. On non-linux platforms or machines without NUMA, all cpus
+// belong to node 0 and binding is a no-op. libnuma is not required.
+class NumaTopology {
+ public:
+    static int
+    NumNodes();
+
+    // cpus of `node`, empty if the node does not exist
+    static const std::vector<int>&
+    NodeCpus(int node);
+
+    static bool
+    IsValidNode(int node) {
+        return node >= 0 && node < NumNodes() && !NodeCpus(node).empty();
+    }
+
+    // pins the calling thread to `cpus`
+    static bool
+    SetCurrentThreadAffinity(const std::vector<int>& cpus);
+
+ private:
+    NumaTopology();
+
+    static const NumaTopology&
+    Instance();
+
+    std::vector<std::vector<int>> node_cpus_;
+};
+
+// Pins the calling thread to the cpus of a NUMA node and makes it allocate from that node for the scope, so that
+// the memory of an index loaded in the scope is local to the node. This includes the pages of mmapped files faulted
+// in the scope, pages faulted later by the pinned search threads of the node are local anyway. Does nothing if
+// `node` < 0 or invalid.
+class ScopedNumaBind {
+ public:
+    explicit ScopedNumaBind(int node);
+    ~ScopedNumaBind();
+
+    ScopedNumaBind(const ScopedNumaBind&) = delete;
+    ScopedNumaBind&
+    operator=(const ScopedNumaBind&) = delete;
+
+ private:
+    bool bound_ = false;
+    std::vector<int> cpus_before_;
+    int mode_before_ = 0;
+    std::vector<unsigned long> mask_before_;
+};
+
+}  // namespace knowhere
@@ -0,0 +1,155 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+
+#include "folly/Optional.h"
+#include "folly/executors/task_queue/BlockingQueue.h"
+
+namespace knowhere {
+
+enum class TaskPriority : int8_t {
+    // latency sensitive searches
+    INTERACTIVE = 0,
+    // bulk searches and iterator draining
+    BATCH = 1,
+    // index warmup and other maintenance work
+    BACKGROUND = 2,
+};
+
+constexpr size_t kNumTaskPriorities = 3;
+
+// Task queue of the search thread pools, with one FIFO lane per TaskPriority. The lanes are served by smooth weighted
+// round robin: when all of them have work, each lane gets a share of the dequeues proportional to its weight, a lane
+// without work leaves its share to the others. Unlike strict priorities, lower lanes are slowed down but never
+// starved. The priority of a task is the index of its lane, out of range priorities (e.g. the poison tasks folly uses
+// to stop threads) go to the INTERACTIVE lane. Each lane holds at most `lane_capacity` tasks, adding to a full lane
+// blocks until a task of the lane is taken.
+template <typename T>
+class PriorityTaskQueue : public folly::BlockingQueue<T> {
+ public:
+    explicit PriorityTaskQueue(size_t lane_capacity = std::numeric_limits<size_t>::max())
+        : lane_capacity_(std::max<size_t>(lane_capacity, 1)) {
+    }
+
+    folly::BlockingQueueAddResult
+    add(T item) override {
+        return addWithPriority(std::move(item), static_cast<int8_t>(TaskPriority::INTERACTIVE));
+    }
+
+    folly::BlockingQueueAddResult
+    addWithPriority(T item, int8_t priority) override {
+        const auto lane = std::clamp<int>(priority, 0, kNumTaskPriorities - 1);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_full_.wait(lock, [&] { return lanes_[lane].size() < lane_capacity_; });
+            lanes_[lane].push_back(std::move(item));
+            lane_sizes_[lane].fetch_add(1, std::memory_order_relaxed);
+            size_.fetch_add(1, std::memory_order_relaxed);
+        }
+        not_empty_.notify_one();
+        return folly::BlockingQueueAddResult();
+    }
+
+    uint8_t
+    getNumPriorities() override {
+        return kNumTaskPriorities;
+    }
+
+    T
+    take() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return size_.load(std::memory_order_relaxed) > 0; });
+        return Pop();
+    }
+
+    folly::Optional<T>
+    try_take_for(std::chrono::milliseconds time) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!not_empty_.wait_for(lock, time, [this] { return size_.load(std::memory_order_relaxed) > 0; })) {
+            return folly::none;
+        }
+        return Pop();
+    }
+
+    size_t
+    size() override {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    size_t
+    size(TaskPriority priority) const {
+        return lane_sizes_[static_cast<size_t>(priority)].load(std::memory_order_relaxed);
+    }
+
+    // shared by all the queues, a weight of 0 is taken as 1
+    static void
+    SetWeights(uint32_t interactive, uint32_t batch, uint32_t background) {
+        weights_[0].store(std::max<uint32_t>(interactive, 1), std::memory_order_relaxed);
+        weights_[1].store(std::max<uint32_t>(batch, 1), std::memory_order_relaxed);
+        weights_[2].store(std::max<uint32_t>(background, 1), std::memory_order_relaxed);
+    }
+
+ private:
+    // requires the lock and a non empty queue
+    T
+    Pop() {
+        size_t best = kNumTaskPriorities;
+        int64_t total = 0;
+        for (size_t lane = 0; lane < kNumTaskPriorities; ++lane) {
+            if (lanes_[lane].empty()) {
+                // an idle lane does not bank credits, nor carry a debt
+                credits_[lane] = 0;
+                continue;
+            }
+            const int64_t weight = weights_[lane].load(std::memory_order_relaxed);
+            credits_[lane] += weight;
+            total += weight;
+            if (best == kNumTaskPriorities || credits_[lane] > credits_[best]) {
+                best = lane;
+            }
+        }
+        credits_[best] -= total;
+        if (lanes_[best].size() == lane_capacity_) {
+            // the waiters may be adding to any lane
+            not_full_.notify_all();
+        }
+        T item = std::move(lanes_[best].front());
+        lanes_[best].pop_front();
+        lane_sizes_[best].fetch_sub(1, std::memory_order_relaxed);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return item;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    const size_t lane_capacity_;
+    std::array<std::deque<T>, kNumTaskPriorities> lanes_;
+    std::array<int64_t, kNumTaskPriorities> credits_{};
+    // readable without the lock, for GetPendingTaskCount() and admission checks
+    std::atomic<size_t> size_ = 0;
+    std::array<std::atomic<size_t>, kNumTaskPriorities> lane_sizes_{};
+
+    inline static std::array<std::atomic<uint32_t>, kNumTaskPriorities> weights_{8, 2, 1};
+};
+
+}  // namespace knowhere
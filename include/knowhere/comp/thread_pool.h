@@ -29,23 +29,36 @@
 #endif
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "folly/executors/CPUThreadPoolExecutor.h"
 #include "folly/executors/task_queue/UnboundedBlockingQueue.h"
 #include "folly/futures/Future.h"
+#include "knowhere/comp/cancel_token.h"
+#include "knowhere/comp/numa.h"
+#include "knowhere/comp/priority_task_queue.h"
 #include "knowhere/expected.h"
 #include "knowhere/log.h"
 
 namespace knowhere {
 
+template <typename T>
+inline Status
+WaitAllSuccess(std::vector<folly::Future<T>>& futures);
+
 class ThreadPool {
  public:
-    enum class QueueType { LIFO, FIFO };
+    // search pools use PRIORITY, see PriorityTaskQueue
+    enum class QueueType { LIFO, FIFO, PRIORITY };
 #ifdef __linux__
  private:
     class CustomPriorityThreadFactory : public folly::NamedThreadFactory {
@@ -67,50 +80,39 @@ class ThreadPool {
                 } else {
                     LOG_KNOWHERE_INFO_ << "Successfully set priority of knowhere thread.";
                 }
+                if (!cpus_.empty()) {
+                    NumaTopology::SetCurrentThreadAffinity(cpus_);
+                }
                 func();
             });
         }
 
-        explicit CustomPriorityThreadFactory(const std::string& thread_name_prefix, int thread_priority)
-            : folly::NamedThreadFactory(thread_name_prefix), thread_priority_(thread_priority) {
+        explicit CustomPriorityThreadFactory(const std::string& thread_name_prefix, int thread_priority,
+                                             std::vector<int> cpus = {})
+            : folly::NamedThreadFactory(thread_name_prefix), thread_priority_(thread_priority), cpus_(std::move(cpus)) {
             assert(thread_priority_ >= -20 && thread_priority_ < 20);
         }
 
      private:
         int thread_priority_;
+        // threads are pinned to these cpus if not empty
+        std::vector<int> cpus_;
     };
 
  public:
     explicit ThreadPool(uint32_t num_threads, const std::string& thread_name_prefix, QueueType queueT = QueueType::LIFO,
-                        int thread_priority = 10)
-        : pool_(queueT == QueueType::LIFO
-                    ? folly::CPUThreadPoolExecutor(
-                          num_threads,
-                          std::make_unique<folly::LifoSemMPMCQueue<folly::CPUThreadPoolExecutor::CPUTask,
-                                                                   folly::QueueBehaviorIfFull::BLOCK>>(
-                              num_threads * kTaskQueueFactor),
-                          std::make_shared<CustomPriorityThreadFactory>(thread_name_prefix, thread_priority))
-                    : folly::CPUThreadPoolExecutor(
-                          num_threads,
-                          std::make_unique<folly::UnboundedBlockingQueue<folly::CPUThreadPoolExecutor::CPUTask>>(),
-                          std::make_shared<CustomPriorityThreadFactory>(thread_name_prefix, thread_priority))) {
+                        int thread_priority = 10, const std::vector<int>& cpus = {})
+        : pool_(num_threads, MakeTaskQueue(num_threads, queueT),
+                std::make_shared<CustomPriorityThreadFactory>(thread_name_prefix, thread_priority, cpus)) {
     }
 #else
  public:
-    // `thread_priority` is linux only, the param is kept here to make signature same between linux & mac one
+    // `thread_priority` and `cpus` are linux only, the params are kept here to make signature same between linux & mac
+    // one
     explicit ThreadPool(uint32_t num_threads, const std::string& thread_name_prefix, QueueType queueT = QueueType::LIFO,
-                        int thread_priority = 10)
-        : pool_(queueT == QueueType::LIFO
-                    ? folly::CPUThreadPoolExecutor(
-                          num_threads,
-                          std::make_unique<folly::LifoSemMPMCQueue<folly::CPUThreadPoolExecutor::CPUTask,
-                                                                   folly::QueueBehaviorIfFull::BLOCK>>(
-                              num_threads * kTaskQueueFactor),
-                          std::make_shared<folly::NamedThreadFactory>(thread_name_prefix))
-                    : folly::CPUThreadPoolExecutor(
-                          num_threads,
-                          std::make_unique<folly::UnboundedBlockingQueue<folly::CPUThreadPoolExecutor::CPUTask>>(),
-                          std::make_shared<folly::NamedThreadFactory>(thread_name_prefix))) {
+                        int thread_priority = 10, const std::vector<int>& cpus = {})
+        : pool_(num_threads, MakeTaskQueue(num_threads, queueT),
+                std::make_shared<folly::NamedThreadFactory>(thread_name_prefix)) {
     }
 #endif
 
@@ -124,11 +126,80 @@ class ThreadPool {
     ThreadPool&
     operator=(ThreadPool&&) noexcept = delete;
 
+    // on a PRIORITY pool, the task goes to the lane of the priority set with ScopedTaskPrioritySetter
     template <typename Func, typename... Args>
     auto
     push(Func&& func, Args&&... args) {
-        return folly::makeSemiFuture().via(&pool_).then(
-            [func = std::forward<Func>(func), &args...](auto&&) mutable { return func(std::forward<Args>(args)...); });
+        auto task = [func = std::forward<Func>(func), &args...](auto&&) mutable {
+            return func(std::forward<Args>(args)...);
+        };
+        if (priority_queue_ != nullptr) {
+            return folly::makeSemiFuture()
+                .via(folly::getKeepAliveToken(pool_), static_cast<int8_t>(current_priority_))
+                .then(std::move(task));
+        }
+        return folly::makeSemiFuture().via(&pool_).then(std::move(task));
+    }
+
+    // Runs `func(i)` for every i in [begin, end) on the pool. Rather than one task per index, at most size() tasks
+    // are pushed and each of them claims chunks of indexes from a shared cursor until the range is drained. Chunks
+    // shrink with the remaining work, so workers done early keep taking work off slow ones and the tail stays
+    // balanced. `func` returns void or Status: the first failure stops the claiming of chunks and is returned.
+    // Exceptions are rethrown as with WaitAllSuccess. The cancel token of the calling thread is carried over to the
+    // tasks, once it is cancelled no more chunks are claimed and tasks still queued return right away.
+    template <typename Func>
+    Status
+    ParallelFor(size_t begin, size_t end, Func&& func, size_t min_chunk_size = 1) {
+        if (begin >= end) {
+            return Status::success;
+        }
+        min_chunk_size = std::max<size_t>(min_chunk_size, 1);
+        const size_t num_tasks =
+            std::max<size_t>(1, std::min(size(), (end - begin + min_chunk_size - 1) / min_chunk_size));
+        std::atomic<size_t> cursor = begin;
+        std::atomic<bool> stop = false;
+        const CancelToken* token = CancelToken::Current();
+        auto worker = [&]() -> Status {
+            CancelToken::ScopedSetter token_setter(token);
+            try {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    if (token != nullptr && token->IsCancelled()) {
+                        stop.store(true, std::memory_order_relaxed);
+                        return token->GetStatus();
+                    }
+                    size_t chunk_begin = cursor.load(std::memory_order_relaxed);
+                    size_t chunk_end;
+                    do {
+                        if (chunk_begin >= end) {
+                            return Status::success;
+                        }
+                        auto chunk_size = std::max(min_chunk_size, (end - chunk_begin) / (2 * num_tasks));
+                        chunk_end = std::min(end, chunk_begin + chunk_size);
+                    } while (!cursor.compare_exchange_weak(chunk_begin, chunk_end, std::memory_order_relaxed));
+                    for (size_t i = chunk_begin; i < chunk_end; ++i) {
+                        if constexpr (std::is_void_v<std::invoke_result_t<Func&, size_t>>) {
+                            func(i);
+                        } else {
+                            auto status = func(i);
+                            if (status != Status::success) {
+                                stop.store(true, std::memory_order_relaxed);
+                                return status;
+                            }
+                        }
+                    }
+                }
+            } catch (...) {
+                stop.store(true, std::memory_order_relaxed);
+                throw;
+            }
+            return Status::success;
+        };
+        std::vector<folly::Future<Status>> futs;
+        futs.reserve(num_tasks);
+        for (size_t i = 0; i < num_tasks; ++i) {
+            futs.emplace_back(push(worker));
+        }
+        return WaitAllSuccess(futs);
     }
 
     [[nodiscard]] size_t
@@ -141,6 +212,32 @@ class ThreadPool {
         return pool_.getPendingTaskCount();
     }
 
+    // pending tasks of one lane of a PRIORITY pool, all pending tasks otherwise
+    size_t
+    GetPendingTaskCount(TaskPriority priority) {
+        return priority_queue_ != nullptr ? priority_queue_->size(priority) : GetPendingTaskCount();
+    }
+
+    // whether a new request of `priority` is to be rejected, see SetSearchAdmissionLimit
+    bool
+    IsSaturated(TaskPriority priority) {
+        const auto limit = admission_limits_[static_cast<size_t>(priority)].load(std::memory_order_relaxed);
+        return limit > 0 && GetPendingTaskCount(priority) >= limit;
+    }
+
+    // Number of parts the work of each of `nq` queries is split into, so that a few queries against a large base keep
+    // the idle threads of the pool busy rather than running on one thread each. The parts hold at least
+    // `min_part_size` of the `work_size` units (rows, inverted lists) of a query. 1, i.e. no split, unless intra query
+    // parallelism is enabled, nq is at most half the pool size and no task is waiting in the pool.
+    size_t
+    IntraQuerySplits(size_t nq, size_t work_size, size_t min_part_size) {
+        if (!intra_query_parallelism_enabled_.load(std::memory_order_relaxed) || nq == 0 || nq * 2 > size() ||
+            GetPendingTaskCount() > 0) {
+            return 1;
+        }
+        return std::max<size_t>(1, std::min(size() / nq, work_size / std::max<size_t>(min_part_size, 1)));
+    }
+
     void
     SetNumThreads(uint32_t num_threads) {
         if (num_threads == 0) {
@@ -194,7 +291,7 @@ class ThreadPool {
         if (search_pool_ == nullptr) {
             std::lock_guard<std::mutex> lock(search_pool_mutex_);
             if (search_pool_ == nullptr) {
-                search_pool_ = std::make_shared<ThreadPool>(num_threads, "knowhere_search");
+                search_pool_ = std::make_shared<ThreadPool>(num_threads, "knowhere_search", QueueType::PRIORITY);
                 LOG_KNOWHERE_INFO_ << "Init global search thread pool with size " << num_threads;
                 return;
             }
@@ -229,15 +326,85 @@ class ThreadPool {
         } else {
             search_pool_->SetNumThreads(num_threads);
             LOG_KNOWHERE_INFO_ << "Global search thread pool size has already been set to " << search_pool_->size();
+            std::lock_guard<std::mutex> lock(search_pool_mutex_);
+            for (size_t node = 0; num_threads > 0 && node < numa_search_pools_.size(); ++node) {
+                if (numa_search_pools_[node] != nullptr) {
+                    numa_search_pools_[node]->SetNumThreads(NumaSearchThreadPoolSize(node, num_threads));
+                }
+            }
             return;
         }
     }
 
+    // Creates one search thread pool per NUMA node, its threads pinned to the cpus of the node and sized after the
+    // share of the node in the global search thread pool. Searches routed to a node with `ScopedNumaNodeSetter` run
+    // on the pool of the node, the global pool keeps serving the others.
+    static bool
+    SetNumaAwareSearchThreadPools(bool enable) {
+        if (!enable) {
+            numa_search_pools_enabled_.store(false, std::memory_order_release);
+            return true;
+        }
+        if (NumaTopology::NumNodes() <= 1) {
+            LOG_KNOWHERE_WARNING_ << "Single numa node, numa aware search thread pools are not enabled";
+            return false;
+        }
+        const auto num_threads = GetGlobalSearchThreadPool()->size();
+        std::lock_guard<std::mutex> lock(search_pool_mutex_);
+        if (numa_search_pools_.empty()) {
+            // the pools are never released, routing reads them without locking
+            numa_search_pools_.resize(NumaTopology::NumNodes());
+            for (int node = 0; node < NumaTopology::NumNodes(); ++node) {
+                if (!NumaTopology::IsValidNode(node)) {
+                    continue;
+                }
+                numa_search_pools_[node] = std::make_shared<ThreadPool>(
+                    NumaSearchThreadPoolSize(node, num_threads), "knowhere_search_n" + std::to_string(node),
+                    QueueType::PRIORITY, 10, NumaTopology::NodeCpus(node));
+                LOG_KNOWHERE_INFO_ << "Init search thread pool of numa node " << node << " with size "
+                                   << numa_search_pools_[node]->size();
+            }
+        }
+        numa_search_pools_enabled_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    static bool
+    IsNumaAwareSearchThreadPoolsEnabled() {
+        return numa_search_pools_enabled_.load(std::memory_order_acquire);
+    }
+
     static size_t
     GetGlobalSearchThreadPoolSize() {
         return (search_pool_ == nullptr ? 0 : search_pool_->size());
     }
 
+    // Weights of the priority lanes of the search pools, each lane gets a share of the threads proportional to its
+    // weight while the lanes compete. Defaults to 8:2:1.
+    static void
+    SetSearchPriorityWeights(uint32_t interactive, uint32_t batch, uint32_t background) {
+        PriorityTaskQueue<folly::CPUThreadPoolExecutor::CPUTask>::SetWeights(interactive, batch, background);
+        LOG_KNOWHERE_INFO_ << "Set search priority weights to " << interactive << ":" << batch << ":" << background;
+    }
+
+    // Requests of `priority` are rejected with Status::search_queue_full while their lane of the search pool has
+    // `max_pending_tasks` tasks or more waiting. 0 (the default) rejects nothing, submitters then block once the lane
+    // holds kTaskQueueFactor tasks per thread.
+    static void
+    SetSearchAdmissionLimit(TaskPriority priority, size_t max_pending_tasks) {
+        admission_limits_[static_cast<size_t>(priority)].store(max_pending_tasks, std::memory_order_relaxed);
+        LOG_KNOWHERE_INFO_ << "Set search admission limit of priority " << static_cast<int>(priority) << " to "
+                           << max_pending_tasks;
+    }
+
+    // Lets searches with few queries split each of them across the idle threads of the search pool, see
+    // IntraQuerySplits. Disabled by default.
+    static void
+    SetIntraQueryParallelism(bool enable) {
+        intra_query_parallelism_enabled_.store(enable, std::memory_order_relaxed);
+        LOG_KNOWHERE_INFO_ << "Set intra query parallelism to " << (enable ? "enabled" : "disabled");
+    }
+
     static size_t
     GetSearchThreadPoolPendingTaskCount() {
         return ThreadPool::GetGlobalSearchThreadPool()->GetPendingTaskCount();
@@ -256,14 +423,60 @@ class ThreadPool {
         return build_pool_;
     }
 
+    // returns the pool of the numa node the calling thread is routed to, if any
     static std::shared_ptr<ThreadPool>
     GetGlobalSearchThreadPool() {
+        if (current_numa_node_ >= 0) {
+            return GetGlobalSearchThreadPool(current_numa_node_);
+        }
         if (search_pool_ == nullptr) {
             InitGlobalSearchThreadPool(std::thread::hardware_concurrency());
         }
         return search_pool_;
     }
 
+    // falls back to the global search pool if numa aware pools are disabled or `numa_node` has no pool
+    static std::shared_ptr<ThreadPool>
+    GetGlobalSearchThreadPool(int numa_node) {
+        if (numa_node >= 0 && IsNumaAwareSearchThreadPoolsEnabled() && numa_node < (int)numa_search_pools_.size() &&
+            numa_search_pools_[numa_node] != nullptr) {
+            return numa_search_pools_[numa_node];
+        }
+        if (search_pool_ == nullptr) {
+            InitGlobalSearchThreadPool(std::thread::hardware_concurrency());
+        }
+        return search_pool_;
+    }
+
+    // routes GetGlobalSearchThreadPool() of the calling thread to the pool of `numa_node` for the scope, -1 for the
+    // global pool
+    class ScopedNumaNodeSetter {
+        int numa_node_before;
+
+     public:
+        explicit ScopedNumaNodeSetter(int numa_node) {
+            numa_node_before = current_numa_node_;
+            current_numa_node_ = numa_node;
+        }
+        ~ScopedNumaNodeSetter() {
+            current_numa_node_ = numa_node_before;
+        }
+    };
+
+    // sets the lane the tasks pushed to search pools by the calling thread go to, for the scope
+    class ScopedTaskPrioritySetter {
+        TaskPriority priority_before;
+
+     public:
+        explicit ScopedTaskPrioritySetter(TaskPriority priority) {
+            priority_before = current_priority_;
+            current_priority_ = priority;
+        }
+        ~ScopedTaskPrioritySetter() {
+            current_priority_ = priority_before;
+        }
+    };
+
     class ScopedBuildOmpSetter {
         int omp_before;
 #ifdef OPENBLAS_OS_LINUX
@@ -301,6 +514,31 @@ class ThreadPool {
     };
 
  private:
+    using TaskQueue = folly::BlockingQueue<folly::CPUThreadPoolExecutor::CPUTask>;
+
+    // also sets priority_queue_, which is declared before pool_ so that it is initialized first
+    std::unique_ptr<TaskQueue>
+    MakeTaskQueue(uint32_t num_threads, QueueType queueT) {
+        switch (queueT) {
+            case QueueType::LIFO:
+                return std::make_unique<folly::LifoSemMPMCQueue<folly::CPUThreadPoolExecutor::CPUTask,
+                                                                folly::QueueBehaviorIfFull::BLOCK>>(
+                    num_threads * kTaskQueueFactor);
+            case QueueType::FIFO:
+                return std::make_unique<folly::UnboundedBlockingQueue<folly::CPUThreadPoolExecutor::CPUTask>>();
+            default: {
+                // bounded like the LIFO queue, so that submitters are throttled under overload even without an
+                // admission limit
+                auto queue = std::make_unique<PriorityTaskQueue<folly::CPUThreadPoolExecutor::CPUTask>>(
+                    num_threads * kTaskQueueFactor);
+                priority_queue_ = queue.get();
+                return queue;
+            }
+        }
+    }
+
+    // owned by pool_, nullptr unless PRIORITY
+    PriorityTaskQueue<folly::CPUThreadPoolExecutor::CPUTask>* priority_queue_ = nullptr;
     folly::CPUThreadPoolExecutor pool_;
 
     inline static std::mutex build_pool_mutex_;
@@ -309,6 +547,23 @@ class ThreadPool {
     inline static std::mutex search_pool_mutex_;
     inline static std::shared_ptr<ThreadPool> search_pool_ = nullptr;
 
+    inline static std::atomic<bool> numa_search_pools_enabled_ = false;
+    inline static std::vector<std::shared_ptr<ThreadPool>> numa_search_pools_;
+    inline static thread_local int current_numa_node_ = -1;
+    inline static thread_local TaskPriority current_priority_ = TaskPriority::INTERACTIVE;
+    inline static std::array<std::atomic<size_t>, kNumTaskPriorities> admission_limits_{};
+    inline static std::atomic<bool> intra_query_parallelism_enabled_ = false;
+
+    static uint32_t
+    NumaSearchThreadPoolSize(int numa_node, size_t num_threads) {
+        size_t total_cpus = 0;
+        for (int node = 0; node < NumaTopology::NumNodes(); ++node) {
+            total_cpus += NumaTopology::NodeCpus(node).size();
+        }
+        auto node_cpus = NumaTopology::NodeCpus(numa_node).size();
+        return std::max<size_t>(1, (num_threads * node_cpus + total_cpus - 1) / std::max<size_t>(1, total_cpus));
+    }
+
     constexpr static size_t kTaskQueueFactor = 16;
 };
 
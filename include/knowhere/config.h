@@ -20,6 +20,7 @@
 #include <optional>
 #include <sstream>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <variant>
@@ -345,6 +346,16 @@ class Config {
 
     static Status
     Load(Config& cfg, const Json& json, PARAM_TYPE type, std::string* const err_msg = nullptr) {
+        auto status = LoadValues(cfg, json, type, err_msg);
+        if (status != Status::success) {
+            return status;
+        }
+        return Adjust(cfg, type, err_msg);
+    }
+
+    // Load without the final CheckAndAdjust, the fields hold the values of `json` or their defaults only.
+    static Status
+    LoadValues(Config& cfg, const Json& json, PARAM_TYPE type, std::string* const err_msg = nullptr) {
         for (const auto& it : cfg.__DICT__) {
             const auto& var = it.second;
 
@@ -542,7 +553,11 @@ class Config {
                 *ptr->val = json[it.first];
             }
         }
+        return Status::success;
+    }
 
+    static Status
+    Adjust(Config& cfg, PARAM_TYPE type, std::string* const err_msg = nullptr) {
         if (!err_msg) {
             std::string tem_msg;
             return cfg.CheckAndAdjust(type, &tem_msg);
@@ -550,6 +565,25 @@ class Config {
         return cfg.CheckAndAdjust(type, err_msg);
     }
 
+    // Copies the field values of `src` to the same fields of `dst`, both are expected to be of the same config type.
+    static void
+    CopyValues(const Config& src, Config& dst) {
+        for (const auto& it : src.__DICT__) {
+            auto dst_it = dst.__DICT__.find(it.first);
+            if (dst_it == dst.__DICT__.end()) {
+                continue;
+            }
+            std::visit(
+                [&dst_it](const auto& src_entry) {
+                    using EntryT = std::decay_t<decltype(src_entry)>;
+                    if (auto dst_entry = std::get_if<EntryT>(&dst_it->second)) {
+                        *dst_entry->val = *src_entry.val;
+                    }
+                },
+                it.second);
+        }
+    }
+
     virtual ~Config() {
     }
 
@@ -604,10 +638,14 @@ class BaseConfig : public Config {
     CFG_BOOL trace_visit;
     CFG_BOOL enable_mmap;
     CFG_BOOL enable_mmap_pop;
+    CFG_BOOL enable_hugepage;
+    CFG_BOOL enable_zero_copy;
+    CFG_INT numa_node;
     CFG_BOOL shuffle_build;
     CFG_STRING trace_id;
     CFG_STRING span_id;
     CFG_INT trace_flags;
+    CFG_INT search_priority;
     CFG_MATERIALIZED_VIEW_SEARCH_INFO_TYPE materialized_view_search_info;
     CFG_STRING opt_fields_path;
     CFG_FLOAT iterator_refine_ratio;
@@ -649,7 +687,7 @@ class BaseConfig : public Config {
             .for_static()
             .for_train();
         KNOWHERE_CONFIG_DECLARE_FIELD(data_path)
-            .description("raw data path.")
+            .description("raw data path, DiskANN builds from the vectors of the dataset if not set.")
             .allow_empty_without_default()
             .for_train();
         KNOWHERE_CONFIG_DECLARE_FIELD(index_prefix)
@@ -702,7 +740,22 @@ class BaseConfig : public Config {
             .for_deserialize_from_file();
         KNOWHERE_CONFIG_DECLARE_FIELD(enable_mmap_pop)
             .set_default(false)
-            .description("enable map_populate option for mmap")
+            .description("enable map_populate option for mmap, pre-faults the hot regions of mmapped faiss indexes")
+            .for_deserialize()
+            .for_deserialize_from_file();
+        KNOWHERE_CONFIG_DECLARE_FIELD(enable_hugepage)
+            .set_default(false)
+            .description("back the large regions of an index loaded without mmap with transparent huge pages")
+            .for_deserialize()
+            .for_deserialize_from_file();
+        KNOWHERE_CONFIG_DECLARE_FIELD(enable_zero_copy)
+            .set_default(false)
+            .description("let the index loaded by deserialize reference the binary set instead of copying it")
+            .for_deserialize();
+        KNOWHERE_CONFIG_DECLARE_FIELD(numa_node)
+            .set_default(-1)
+            .description("numa node to load the index on and to run its searches on, -1 to not bind the index")
+            .set_range(-1, std::numeric_limits<CFG_INT::value_type>::max())
             .for_deserialize()
             .for_deserialize_from_file();
         KNOWHERE_CONFIG_DECLARE_FIELD(shuffle_build)
@@ -724,6 +777,14 @@ class BaseConfig : public Config {
             .description("trace flags")
             .for_search()
             .for_range_search();
+        KNOWHERE_CONFIG_DECLARE_FIELD(search_priority)
+            .set_default(0)
+            .description("priority lane of the request on the search thread pool, 0 for interactive, 1 for batch and "
+                         "2 for background")
+            .set_range(0, 2)
+            .for_search()
+            .for_range_search()
+            .for_iterator();
         KNOWHERE_CONFIG_DECLARE_FIELD(materialized_view_search_info)
             .description("materialized view search info")
             .allow_empty_without_default()
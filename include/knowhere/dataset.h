@@ -160,6 +160,12 @@ class DataSet : public std::enable_shared_from_this<const DataSet> {
         this->data_[meta::JSON_ID_SET] = Var(std::in_place_index<5>, idset);
     }
 
+    void
+    SetJsonIoStats(const std::string& io_stats) {
+        std::unique_lock lock(mutex_);
+        this->data_[meta::JSON_IO_STATS] = Var(std::in_place_index<5>, io_stats);
+    }
+
     const float*
     GetDistance() const {
         std::shared_lock lock(mutex_);
@@ -248,6 +254,17 @@ class DataSet : public std::enable_shared_from_this<const DataSet> {
         return "";
     }
 
+    std::string
+    GetJsonIoStats() const {
+        std::shared_lock lock(mutex_);
+        auto it = this->data_.find(meta::JSON_IO_STATS);
+        if (it != this->data_.end()) {
+            std::string res = *std::get_if<5>(&it->second);
+            return res;
+        }
+        return "";
+    }
+
     void
     SetIsOwner(bool is_owner) {
         std::unique_lock lock(mutex_);
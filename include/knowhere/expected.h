@@ -50,6 +50,8 @@ enum class Status {
     invalid_serialized_index_type = 28,
     sparse_inner_error = 29,
     brute_force_inner_error = 30,
+    cancelled = 31,
+    search_queue_full = 32,
 };
 
 inline std::string
@@ -107,6 +109,12 @@ Status2String(knowhere::Status status) {
             return "sparse index inner error";
         case knowhere::Status::brute_force_inner_error:
             return "brute_force inner error";
+        case knowhere::Status::timeout:
+            return "the request timed out";
+        case knowhere::Status::cancelled:
+            return "the request was cancelled";
+        case knowhere::Status::search_queue_full:
+            return "the search queue of the request priority is full";
         default:
             return "unexpected status";
     }
@@ -13,6 +13,7 @@
 #define INDEX_H
 
 #include "knowhere/binaryset.h"
+#include "knowhere/comp/cancel_token.h"
 #include "knowhere/config.h"
 #include "knowhere/dataset.h"
 #include "knowhere/expected.h"
@@ -20,6 +21,54 @@
 #include "knowhere/index/interrupt.h"
 namespace knowhere {
 
+template <typename T1>
+class Index;
+
+// A search config parsed and validated once by Index::PrepareSearch, PrepareRangeSearch or PrepareAnnIterator, to be
+// reused across requests. The JSON is not parsed again, each request only copies the loaded values into a fresh config
+// of the index and runs its CheckAndAdjust, after applying the overrides of WithTopK or WithRadius if any. A prepared
+// config is immutable and may be shared between threads, it is only valid for the index type that prepared it.
+class PreparedConfig {
+ public:
+    PreparedConfig
+    WithTopK(int32_t k) const {
+        PreparedConfig prepared(*this);
+        prepared.k_ = k;
+        return prepared;
+    }
+
+    PreparedConfig
+    WithRadius(float radius, std::optional<float> range_filter = std::nullopt) const {
+        PreparedConfig prepared(*this);
+        prepared.radius_ = radius;
+        prepared.range_filter_ = range_filter;
+        return prepared;
+    }
+
+    PARAM_TYPE
+    Type() const {
+        return type_;
+    }
+
+ private:
+    template <typename T>
+    friend class Index;
+
+    PreparedConfig(std::shared_ptr<const Config> cfg, PARAM_TYPE type) : cfg_(std::move(cfg)), type_(type) {
+    }
+
+    // copies the prepared values and the overrides into `cfg`, a fresh config of the index, and adjusts it for `type`
+    Status
+    Instantiate(Config& cfg, PARAM_TYPE type, std::string* const msg) const;
+
+    // the values loaded from the JSON, before CheckAndAdjust, which may derive fields from the overridden ones
+    std::shared_ptr<const Config> cfg_;
+    PARAM_TYPE type_;
+    std::optional<int32_t> k_;
+    std::optional<float> radius_;
+    std::optional<float> range_filter_;
+};
+
 template <typename T1>
 class Index {
  public:
@@ -157,15 +206,51 @@ class Index {
     Status
     Add(const DataSetPtr dataset, const Json& json, bool use_knowhere_build_pool = true);
 
+    // Search, AnnIterator and RangeSearch stop early with Status::cancelled or Status::timeout once `token` is
+    // cancelled or past its deadline, see CancelToken. For AnnIterator, the token covers the initial search phase.
     expected<DataSetPtr>
-    Search(const DataSetPtr dataset, const Json& json, const BitsetView& bitset) const;
+    Search(const DataSetPtr dataset, const Json& json, const BitsetView& bitset,
+           const CancelTokenPtr& token = nullptr) const;
+
+    // Search writing the results into `ids` and `distances`, of at least rows * k entries each, rather than into a
+    // new result set, e.g. a query over many segments can have all of them write into one preallocated buffer.
+    Status
+    SearchInto(const DataSetPtr dataset, const Json& json, const BitsetView& bitset, int64_t* ids, float* distances,
+               const CancelTokenPtr& token = nullptr) const;
 
     expected<std::vector<IndexNode::IteratorPtr>>
     AnnIterator(const DataSetPtr dataset, const Json& json, const BitsetView& bitset,
-                bool use_knowhere_search_pool = true) const;
+                bool use_knowhere_search_pool = true, const CancelTokenPtr& token = nullptr) const;
 
     expected<DataSetPtr>
-    RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetView& bitset) const;
+    RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetView& bitset,
+                const CancelTokenPtr& token = nullptr) const;
+
+    // Parse and validate a search config once for many Search, RangeSearch or AnnIterator calls, see PreparedConfig.
+    expected<PreparedConfig>
+    PrepareSearch(const Json& json) const;
+
+    expected<PreparedConfig>
+    PrepareRangeSearch(const Json& json) const;
+
+    expected<PreparedConfig>
+    PrepareAnnIterator(const Json& json) const;
+
+    expected<DataSetPtr>
+    Search(const DataSetPtr dataset, const PreparedConfig& prepared, const BitsetView& bitset,
+           const CancelTokenPtr& token = nullptr) const;
+
+    Status
+    SearchInto(const DataSetPtr dataset, const PreparedConfig& prepared, const BitsetView& bitset, int64_t* ids,
+               float* distances, const CancelTokenPtr& token = nullptr) const;
+
+    expected<std::vector<IndexNode::IteratorPtr>>
+    AnnIterator(const DataSetPtr dataset, const PreparedConfig& prepared, const BitsetView& bitset,
+                bool use_knowhere_search_pool = true, const CancelTokenPtr& token = nullptr) const;
+
+    expected<DataSetPtr>
+    RangeSearch(const DataSetPtr dataset, const PreparedConfig& prepared, const BitsetView& bitset,
+                const CancelTokenPtr& token = nullptr) const;
 
     expected<DataSetPtr>
     GetVectorByIds(const DataSetPtr dataset) const;
@@ -182,6 +267,14 @@ class Index {
     Status
     Serialize(BinarySet& binset) const;
 
+    // streams the index into `writer` rather than into a binary set, see IndexNode::SerializeToWriter
+    Status
+    SerializeToWriter(faiss::IOWriter& writer) const;
+
+    // streams the index into the file `filename`, which DeserializeFromFile() can load
+    Status
+    SerializeToFile(const std::string& filename) const;
+
     Status
     Deserialize(const BinarySet& binset, const Json& json = {});
 
@@ -200,6 +293,10 @@ class Index {
     std::string
     Type() const;
 
+    // how much of the memory of the loaded index is mapped and anonymous, and resident in RAM
+    MemoryResidency
+    GetMemoryResidency() const;
+
     ~Index() {
         if (node == nullptr)
             return;
@@ -215,6 +312,25 @@ class Index {
         static_assert(std::is_base_of<IndexNode, T1>::value);
     }
 
+    expected<PreparedConfig>
+    Prepare(const Json& json, PARAM_TYPE type, const std::string& method) const;
+
+    expected<std::unique_ptr<BaseConfig>>
+    Instantiate(const PreparedConfig& prepared, PARAM_TYPE type) const;
+
+    // searches into `ids` and `distances` if set, the result set is null then
+    expected<DataSetPtr>
+    SearchWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                     const CancelTokenPtr& token, int64_t* ids = nullptr, float* distances = nullptr) const;
+
+    expected<std::vector<IndexNode::IteratorPtr>>
+    AnnIteratorWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                          bool use_knowhere_search_pool, const CancelTokenPtr& token) const;
+
+    expected<DataSetPtr>
+    RangeSearchWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                          const CancelTokenPtr& token) const;
+
     T1* node;
 };
 
@@ -22,6 +22,7 @@
 #include "knowhere/index/index_node_data_mock_wrapper.h"
 #include "knowhere/operands.h"
 #include "knowhere/utils.h"
+#include "knowhere/version.h"
 
 namespace knowhere {
 class IndexFactory {
@@ -101,6 +102,21 @@ class IndexFactory {
         },                                                                                                 \
         data_type, typeCheck<data_type>(features), features)
 
+// register an index whose `data_type` implementation is only used from `typed_version` on, older versions keep the
+// mocked one on MockData<data_type>::type, so that they still write the indexes they used to
+#define KNOWHERE_VERSIONED_MOCK_REGISTER_GLOBAL(name, index_node, data_type, features, typed_version, ...) \
+    KNOWHERE_REGISTER_STATIC(name, index_node, data_type, ##__VA_ARGS__)                                   \
+    KNOWHERE_REGISTER_GLOBAL(                                                                              \
+        name,                                                                                              \
+        [](const int32_t& version, const Object& object) -> Index<IndexNode> {                             \
+            if (typed_version <= Version(version)) {                                                       \
+                return (Index<index_node<data_type, ##__VA_ARGS__>>::Create(version, object));             \
+            }                                                                                              \
+            return (Index<IndexNodeDataMockWrapper<data_type>>::Create(                                    \
+                std::make_unique<index_node<MockData<data_type>::type, ##__VA_ARGS__>>(version, object))); \
+        },                                                                                                 \
+        data_type, typeCheck<data_type>(features), features)
+
 // Below are some group index registration methods for batch registration of indexes that support multiple data types.
 // Please review carefully and select with caution
 
@@ -149,6 +165,20 @@ class IndexFactory {
     KNOWHERE_MOCK_REGISTER_GLOBAL(name, index_node, fp16, (features | knowhere::feature::FP16), ##__VA_ARGS__); \
     KNOWHERE_SIMPLE_REGISTER_GLOBAL(name, index_node, fp32, (features | knowhere::feature::FLOAT32), ##__VA_ARGS__);
 
+// register vector index supporting int data type, mocked before `typed_version`
+#define KNOWHERE_VERSIONED_MOCK_REGISTER_DENSE_INT_GLOBAL(name, index_node, features, typed_version, ...) \
+    KNOWHERE_VERSIONED_MOCK_REGISTER_GLOBAL(name, index_node, int8, (features | knowhere::feature::INT8), \
+                                            typed_version, ##__VA_ARGS__);
+
+// register vector index supporting ALL_DENSE_FLOAT_TYPE(float32, bf16, fp16) data types, bf16 and fp16 mocked before
+// `typed_version`
+#define KNOWHERE_VERSIONED_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(name, index_node, features, typed_version, ...) \
+    KNOWHERE_VERSIONED_MOCK_REGISTER_GLOBAL(name, index_node, bf16, (features | knowhere::feature::BF16),       \
+                                            typed_version, ##__VA_ARGS__);                                      \
+    KNOWHERE_VERSIONED_MOCK_REGISTER_GLOBAL(name, index_node, fp16, (features | knowhere::feature::FP16),       \
+                                            typed_version, ##__VA_ARGS__);                                      \
+    KNOWHERE_SIMPLE_REGISTER_GLOBAL(name, index_node, fp32, (features | knowhere::feature::FLOAT32), ##__VA_ARGS__);
+
 #define KNOWHERE_REGISTER_GLOBAL_WITH_THREAD_POOL(name, index_node, data_type, features, thread_size)    \
     KNOWHERE_REGISTER_STATIC(name, index_node, data_type)                                                \
     KNOWHERE_REGISTER_GLOBAL(                                                                            \
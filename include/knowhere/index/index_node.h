@@ -12,6 +12,7 @@
 #ifndef INDEX_NODE_H
 #define INDEX_NODE_H
 
+#include <algorithm>
 #include <functional>
 #include <queue>
 #include <utility>
@@ -19,6 +20,7 @@
 
 #include "knowhere/binaryset.h"
 #include "knowhere/bitsetview.h"
+#include "knowhere/comp/memory_pages.h"
 #include "knowhere/config.h"
 #include "knowhere/dataset.h"
 #include "knowhere/expected.h"
@@ -32,6 +34,10 @@
 #include "knowhere/comp/thread_pool.h"
 #endif
 
+namespace faiss {
+struct IOWriter;
+}  // namespace faiss
+
 namespace knowhere {
 
 class Interrupt;
@@ -44,10 +50,10 @@ class IndexNode : public Object {
     IndexNode() : version_(Version::GetDefaultVersion()) {
     }
 
-    IndexNode(const IndexNode& other) : version_(other.version_) {
+    IndexNode(const IndexNode& other) : version_(other.version_), numa_node_(other.numa_node_) {
     }
 
-    IndexNode(const IndexNode&& other) : version_(other.version_) {
+    IndexNode(const IndexNode&& other) : version_(other.version_), numa_node_(other.numa_node_) {
     }
 
     /**
@@ -133,6 +139,32 @@ class IndexNode : public Object {
     virtual expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const = 0;
 
+    /**
+     * @brief Performs a search operation on the index, writing the results into caller-provided buffers.
+     *
+     * The default implementation copies the results of Search(), the indexes that can write their results in place
+     * override it to skip the allocation of a result set per request.
+     *
+     * @param dataset Query vectors.
+     * @param cfg
+     * @param bitset A BitsetView object for filtering results.
+     * @param ids The buffer of the ids, of at least rows * k entries, -1 where there are less than k results.
+     * @param distances The buffer of the distances, of at least rows * k entries.
+     * @return Status.
+     */
+    virtual Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const {
+        const auto len = static_cast<const BaseConfig&>(*cfg).k.value() * dataset->GetRows();
+        auto res = Search(dataset, std::move(cfg), bitset);
+        if (!res.has_value()) {
+            return res.error();
+        }
+        std::copy_n(res.value()->GetIds(), len, ids);
+        std::copy_n(res.value()->GetDistance(), len, distances);
+        return Status::success;
+    }
+
     // not thread safe.
     class iterator {
      public:
@@ -290,24 +322,18 @@ class IndexNode : public Object {
             }
         };
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
-        std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(nq);
+        auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
         if (retain_iterator_order) {
-            for (size_t i = 0; i < nq; i++) {
-                futs.emplace_back(ThreadPool::GetGlobalSearchThreadPool()->push([&, idx = i]() {
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-                    task_with_ordered_iterator(idx);
-                }));
-            }
+            search_pool->ParallelFor(0, nq, [&](size_t idx) {
+                ThreadPool::ScopedSearchOmpSetter setter(1);
+                task_with_ordered_iterator(idx);
+            });
         } else {
-            for (size_t i = 0; i < nq; i++) {
-                futs.emplace_back(ThreadPool::GetGlobalSearchThreadPool()->push([&, idx = i]() {
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-                    task_with_unordered_iterator(idx);
-                }));
-            }
+            search_pool->ParallelFor(0, nq, [&](size_t idx) {
+                ThreadPool::ScopedSearchOmpSetter setter(1);
+                task_with_unordered_iterator(idx);
+            });
         }
-        WaitAllSuccess(futs);
 #else
         if (retain_iterator_order) {
             for (size_t i = 0; i < nq; i++) {
@@ -371,6 +397,19 @@ class IndexNode : public Object {
     virtual Status
     Serialize(BinarySet& binset) const = 0;
 
+    /**
+     * @brief Serializes the index by streaming it into a writer, without materializing it in memory.
+     *
+     * @param writer The sink of the serialized index, e.g. a faiss::FileIOWriter. It receives the bytes of the binary
+     * Serialize() adds under Type(), which is also the file format of DeserializeFromFile().
+     * @return Status indicating success or failure of the serialization, Status::not_implemented for the indexes that
+     * do not support it.
+     */
+    virtual Status
+    SerializeToWriter(faiss::IOWriter& writer) const {
+        return Status::not_implemented;
+    }
+
     /**
      * @brief Deserializes the index from a binary set.
      *
@@ -433,11 +472,38 @@ class IndexNode : public Object {
     virtual std::string
     Type() const = 0;
 
+    /**
+     * @brief Gets the large memory regions of the loaded index, the graph links and the codes of faiss indexes for
+     * instance. Used for huge pages, pre-faulting and residency reports after a load.
+     *
+     * @return The regions, empty for the indexes that do not report them.
+     */
+    virtual std::vector<MemoryRegion>
+    GetMemoryRegions() const {
+        return {};
+    }
+
+    /**
+     * @brief Gets the NUMA node the index was loaded on, searches run on the search thread pool of this node.
+     *
+     * @return The NUMA node, -1 if the index is not bound to a node.
+     */
+    int
+    NumaNode() const {
+        return numa_node_;
+    }
+
+    void
+    SetNumaNode(int numa_node) {
+        numa_node_ = numa_node;
+    }
+
     virtual ~IndexNode() {
     }
 
  protected:
     Version version_;
+    int numa_node_ = -1;
 };
 
 // Common superclass for iterators that expand search range as needed. Subclasses need
@@ -490,6 +556,8 @@ class IndexIterator : public IndexNode::iterator {
         };
         if (use_knowhere_search_pool_) {
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
+            // draining an iterator is bulk work, it runs in the batch lane whatever the priority of the search
+            ThreadPool::ScopedTaskPrioritySetter priority_setter(TaskPriority::BATCH);
             std::vector<folly::Future<folly::Unit>> futs;
             futs.emplace_back(ThreadPool::GetGlobalSearchThreadPool()->push([&]() {
                 ThreadPool::ScopedSearchOmpSetter setter(1);
@@ -598,6 +666,7 @@ class PrecomputedDistanceIterator : public IndexNode::iterator {
         }
         if (use_knowhere_search_pool_) {
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
+            ThreadPool::ScopedTaskPrioritySetter priority_setter(TaskPriority::BATCH);
             std::vector<folly::Future<folly::Unit>> futs;
             futs.emplace_back(ThreadPool::GetGlobalSearchThreadPool()->push([&]() {
                 ThreadPool::ScopedSearchOmpSetter setter(1);
@@ -629,6 +698,7 @@ class PrecomputedDistanceIterator : public IndexNode::iterator {
         }
         if (use_knowhere_search_pool_) {
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
+            ThreadPool::ScopedTaskPrioritySetter priority_setter(TaskPriority::BATCH);
             std::vector<folly::Future<folly::Unit>> futs;
             futs.emplace_back(ThreadPool::GetGlobalSearchThreadPool()->push([&]() {
                 ThreadPool::ScopedSearchOmpSetter setter(1);
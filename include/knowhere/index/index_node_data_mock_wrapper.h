@@ -38,6 +38,10 @@ class IndexNodeDataMockWrapper : public IndexNode {
     expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override;
 
+    Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override;
+
     expected<DataSetPtr>
     RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override;
 
@@ -63,6 +67,11 @@ class IndexNodeDataMockWrapper : public IndexNode {
         return index_node_->Serialize(binset);
     }
 
+    Status
+    SerializeToWriter(faiss::IOWriter& writer) const override {
+        return index_node_->SerializeToWriter(writer);
+    }
+
     Status
     Deserialize(const BinarySet& binset, std::shared_ptr<Config> cfg) override {
         return index_node_->Deserialize(binset, std::move(cfg));
@@ -98,6 +107,11 @@ class IndexNodeDataMockWrapper : public IndexNode {
         return index_node_->Type();
     }
 
+    std::vector<MemoryRegion>
+    GetMemoryRegions() const override {
+        return index_node_->GetMemoryRegions();
+    }
+
  private:
     std::unique_ptr<IndexNode> index_node_;
 };
@@ -36,6 +36,10 @@ class IndexNodeThreadPoolWrapper : public IndexNode {
     expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override;
 
+    Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override;
+
     expected<DataSetPtr>
     RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override;
 
@@ -59,6 +63,11 @@ class IndexNodeThreadPoolWrapper : public IndexNode {
         return index_node_->Serialize(binset);
     }
 
+    Status
+    SerializeToWriter(faiss::IOWriter& writer) const override {
+        return index_node_->SerializeToWriter(writer);
+    }
+
     Status
     Deserialize(const BinarySet& binset, std::shared_ptr<Config> cfg) override {
         return index_node_->Deserialize(binset, std::move(cfg));
@@ -94,6 +103,11 @@ class IndexNodeThreadPoolWrapper : public IndexNode {
         return index_node_->Type();
     }
 
+    std::vector<MemoryRegion>
+    GetMemoryRegions() const override {
+        return index_node_->GetMemoryRegions();
+    }
+
  private:
     std::unique_ptr<IndexNode> index_node_;
     std::shared_ptr<ThreadPool> thread_pool_;
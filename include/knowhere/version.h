@@ -22,7 +22,11 @@ namespace {
 static constexpr int32_t default_version = 0;
 static constexpr int32_t minimal_version = 0;
 static constexpr int32_t current_version = 6;
-static constexpr int32_t maximum_version = 7;
+static constexpr int32_t maximum_version = 8;
+// the first version whose MV faiss HNSW indexes store the offsets of their partitions, so they load in parallel
+static constexpr int32_t mv_index_offsets_version = 8;
+// the first version whose FLAT indexes of fp16, bf16 and int8 vectors store them in their own type, not as fp32
+static constexpr int32_t flat_typed_storage_version = 8;
 }  // namespace
 
 class Version {
@@ -54,6 +58,18 @@ class Version {
         return Version(minimal_version);
     }
 
+    // MV faiss HNSW indexes of this version or later are written with the partition offsets in their header
+    static inline Version
+    GetMvIndexOffsetsVersion() {
+        return Version(mv_index_offsets_version);
+    }
+
+    // FLAT and IVF_FLAT indexes of fp16, bf16 and int8 vectors of this version or later keep them in their own type
+    static inline Version
+    GetFlatTypedStorageVersion() {
+        return Version(flat_typed_storage_version);
+    }
+
     static inline bool
     VersionSupport(const Version& version) {
         return GetMinimalVersion() <= version && version <= GetMaximumVersion();
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "common/metric.h"
+#include "common/split_search.h"
 #include "faiss/MetricType.h"
 #include "faiss/utils/binary_distances.h"
 #include "faiss/utils/distances.h"
@@ -85,21 +86,86 @@ GetVecNorms(const DataSetPtr& base) {
 
     // use build thread pool to compute norms
     auto pool = ThreadPool::GetGlobalSearchThreadPool();
-    std::vector<folly::Future<folly::Unit>> futs;
-    constexpr int64_t chunk_size = 8192;
-    auto chunk_num = (nb + chunk_size - 1) / chunk_size;
-    futs.reserve(chunk_num);
-    for (auto i = 0; i < nb; i += chunk_size) {
-        auto last = std::min(i + chunk_size, nb);
-        futs.emplace_back(pool->push([&, beg_id = i, end_id = last] {
-            for (auto j = beg_id; j < end_id; j++) {
-                norms[j] = std::sqrt(norm_computer(xb + j * dim, dim));
-            }
-        }));
-    }
-    WaitAllSuccess(futs);
+    constexpr int64_t min_chunk_size = 1024;
+    pool->ParallelFor(
+        0, nb, [&](int64_t j) { norms[j] = std::sqrt(norm_computer(xb + j * dim, dim)); }, min_chunk_size);
     return norms;
 }
+
+// rows of the base a part of a split query covers at least, below that the tasks cost more than they save
+constexpr size_t kIntraQueryMinRows = 16384;
+
+// Top-k of one dense query over the rows [begin, end) of the base. The labels are rows of the whole base, shifting
+// them by xb_id_offset is left to the caller as for queries that are not split.
+template <typename DataType>
+Status
+DenseKnnOnRows(faiss::MetricType metric_type, bool is_cosine, const DataType* query, const DataType* xb,
+               const float* norms, int64_t dim, size_t begin, size_t end, int topk, const BitsetView& bitset,
+               int64_t xb_id_offset, float* distances, int64_t* labels) {
+    BitsetViewIDSelector bw_idselector(bitset, xb_id_offset + begin);
+    faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+    auto part_xb = xb + begin * dim;
+    auto part_nb = end - begin;
+    auto part_norms = (norms == nullptr) ? nullptr : norms + begin;
+    if (metric_type == faiss::METRIC_L2) {
+        if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
+            faiss::knn_L2sqr(query, part_xb, dim, 1, part_nb, topk, distances, labels, nullptr, id_selector);
+        } else {
+            faiss::knn_L2sqr_typed(query, part_xb, dim, 1, part_nb, topk, distances, labels, nullptr, id_selector);
+        }
+    } else if (is_cosine) {
+        if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
+            auto copied_query = CopyAndNormalizeVecs(query, 1, dim);
+            faiss::knn_cosine(copied_query.get(), part_xb, part_norms, dim, 1, part_nb, topk, distances, labels,
+                              id_selector);
+        } else {
+            faiss::knn_cosine_typed(query, part_xb, part_norms, dim, 1, part_nb, topk, distances, labels,
+                                    id_selector);
+        }
+    } else {
+        if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
+            faiss::knn_inner_product(query, part_xb, dim, 1, part_nb, topk, distances, labels, id_selector);
+        } else {
+            faiss::knn_inner_product_typed(query, part_xb, dim, 1, part_nb, topk, distances, labels, id_selector);
+        }
+    }
+    for (int i = 0; i < topk; ++i) {
+        labels[i] = labels[i] == -1 ? -1 : labels[i] + begin;
+    }
+    return Status::success;
+}
+
+// Number of parts each query of a dense L2/IP/COSINE search is split into, 1 for the other metrics and types.
+template <typename DataType>
+size_t
+DenseIntraQuerySplits(ThreadPool* pool, faiss::MetricType metric_type, int64_t nq, int64_t nb) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp32> || KnowhereLowPrecisionTypeCheck<DataType>::value) {
+        if (metric_type == faiss::METRIC_L2 || metric_type == faiss::METRIC_INNER_PRODUCT) {
+            return pool->IntraQuerySplits(nq, nb, kIntraQueryMinRows);
+        }
+    }
+    return 1;
+}
+
+// Dense top-k search with every query split in `splits` ranges of base rows, searched in parallel and merged.
+template <typename DataType>
+Status
+SplitDenseSearch(ThreadPool* pool, size_t splits, faiss::MetricType metric_type, bool is_cosine, const void* xq,
+                 const void* xb, const float* norms, int64_t dim, int64_t nb, int64_t nq, int topk,
+                 const BitsetView& bitset, int64_t xb_id_offset, float* distances, int64_t* labels) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp32> || KnowhereLowPrecisionTypeCheck<DataType>::value) {
+        return SplitTopKSearch(
+            pool, nq, splits, topk, metric_type == faiss::METRIC_INNER_PRODUCT, distances, labels,
+            [&](size_t q, size_t part, float* part_distances, int64_t* part_labels) {
+                auto [begin, end] = SplitRange(nb, splits, part);
+                return DenseKnnOnRows<DataType>(metric_type, is_cosine, (const DataType*)xq + dim * q,
+                                                (const DataType*)xb, norms, dim, begin, end, topk, bitset,
+                                                xb_id_offset, part_distances, part_labels);
+            });
+    } else {
+        return Status::not_implemented;
+    }
+}
 }  // namespace
 
 template <typename DataType>
@@ -152,10 +218,12 @@ BruteForce::Search(const DataSetPtr base_dataset, const DataSetPtr query_dataset
     auto distances = std::make_unique<float[]>(nq * topk);
     std::unique_ptr<float[]> norms = is_cosine ? GetVecNorms<DataType>(base_dataset) : nullptr;
     auto pool = ThreadPool::GetGlobalSearchThreadPool();
-    std::vector<folly::Future<Status>> futs;
-    futs.reserve(nq);
-    for (int i = 0; i < nq; ++i) {
-        futs.emplace_back(pool->push([&, index = i, labels_ptr = labels.get(), distances_ptr = distances.get()] {
+    auto ret = Status::success;
+    if (auto splits = DenseIntraQuerySplits<DataType>(pool.get(), faiss_metric_type, nq, nb); splits > 1) {
+        ret = SplitDenseSearch<DataType>(pool.get(), splits, faiss_metric_type, is_cosine, xq, xb, norms.get(), dim,
+                                         nb, nq, topk, bitset, xb_id_offset, distances.get(), labels.get());
+    } else {
+        ret = pool->ParallelFor(0, nq, [&, labels_ptr = labels.get(), distances_ptr = distances.get()](int index) {
             ThreadPool::ScopedSearchOmpSetter setter(1);
             auto cur_labels = labels_ptr + topk * index;
             auto cur_distances = distances_ptr + topk * index;
@@ -238,9 +306,8 @@ BruteForce::Search(const DataSetPtr base_dataset, const DataSetPtr query_dataset
                 }
             }
             return Status::success;
-        }));
+        });
     }
-    auto ret = WaitAllSuccess(futs);
     if (ret != Status::success) {
         return expected<DataSetPtr>::Err(ret, "failed to brute force search");
     }
@@ -309,10 +376,12 @@ BruteForce::SearchWithBuf(const DataSetPtr base_dataset, const DataSetPtr query_
 
     std::unique_ptr<float[]> norms = is_cosine ? GetVecNorms<DataType>(base_dataset) : nullptr;
     auto pool = ThreadPool::GetGlobalSearchThreadPool();
-    std::vector<folly::Future<Status>> futs;
-    futs.reserve(nq);
-    for (int i = 0; i < nq; ++i) {
-        futs.emplace_back(pool->push([&, index = i] {
+    auto ret = Status::success;
+    if (auto splits = DenseIntraQuerySplits<DataType>(pool.get(), faiss_metric_type, nq, nb); splits > 1) {
+        ret = SplitDenseSearch<DataType>(pool.get(), splits, faiss_metric_type, is_cosine, xq, xb, norms.get(), dim,
+                                         nb, nq, topk, bitset, xb_id_offset, distances, labels);
+    } else {
+        ret = pool->ParallelFor(0, nq, [&](int index) {
             ThreadPool::ScopedSearchOmpSetter setter(1);
             auto cur_labels = labels + topk * index;
             auto cur_distances = distances + topk * index;
@@ -394,9 +463,9 @@ BruteForce::SearchWithBuf(const DataSetPtr base_dataset, const DataSetPtr query_
                 }
             }
             return Status::success;
-        }));
+        });
     }
-    RETURN_IF_ERROR(WaitAllSuccess(futs));
+    RETURN_IF_ERROR(ret);
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     // LCOV_EXCL_START
@@ -488,118 +557,113 @@ BruteForce::RangeSearch(const DataSetPtr base_dataset, const DataSetPtr query_da
     std::vector<std::vector<float>> result_dist_array(nq);
 
     std::unique_ptr<float[]> norms = is_cosine ? GetVecNorms<DataType>(base_dataset) : nullptr;
-    std::vector<folly::Future<Status>> futs;
-    futs.reserve(nq);
-    for (int i = 0; i < nq; ++i) {
-        futs.emplace_back(pool->push([&, index = i] {
-            if constexpr (std::is_same_v<DataType, knowhere::sparse::SparseRow<float>>) {
-                auto cur_query = (const sparse::SparseRow<float>*)xq + index;
-                auto xb_sparse = (const sparse::SparseRow<float>*)xb;
-                for (int j = 0; j < nb; ++j) {
-                    if (!bitset.empty() && bitset.test(j)) {
-                        continue;
-                    }
-                    float row_sum = 0;
-                    if (is_bm25) {
-                        for (size_t k = 0; k < xb_sparse[j].size(); ++k) {
-                            auto [d, v] = xb_sparse[j][k];
-                            row_sum += v;
-                        }
-                    }
-                    auto dist = cur_query->dot(xb_sparse[j], sparse_computer, row_sum);
-                    if (dist > radius && dist <= range_filter) {
-                        result_id_array[index].push_back(j);
-                        result_dist_array[index].push_back(dist);
+    auto ret = pool->ParallelFor(0, nq, [&](int index) {
+        if constexpr (std::is_same_v<DataType, knowhere::sparse::SparseRow<float>>) {
+            auto cur_query = (const sparse::SparseRow<float>*)xq + index;
+            auto xb_sparse = (const sparse::SparseRow<float>*)xb;
+            for (int j = 0; j < nb; ++j) {
+                if (!bitset.empty() && bitset.test(j)) {
+                    continue;
+                }
+                float row_sum = 0;
+                if (is_bm25) {
+                    for (size_t k = 0; k < xb_sparse[j].size(); ++k) {
+                        auto [d, v] = xb_sparse[j][k];
+                        row_sum += v;
                     }
                 }
-                return Status::success;
-            } else {
-                // else not sparse:
-                ThreadPool::ScopedSearchOmpSetter setter(1);
-                faiss::RangeSearchResult res(1);
+                auto dist = cur_query->dot(xb_sparse[j], sparse_computer, row_sum);
+                if (dist > radius && dist <= range_filter) {
+                    result_id_array[index].push_back(j);
+                    result_dist_array[index].push_back(dist);
+                }
+            }
+            return Status::success;
+        } else {
+            // else not sparse:
+            ThreadPool::ScopedSearchOmpSetter setter(1);
+            faiss::RangeSearchResult res(1);
 
-                BitsetViewIDSelector bw_idselector(bitset, xb_id_offset);
-                faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
-                switch (faiss_metric_type) {
-                    case faiss::METRIC_L2: {
-                        [[maybe_unused]] auto cur_query = (const DataType*)xq + dim * index;
+            BitsetViewIDSelector bw_idselector(bitset, xb_id_offset);
+            faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+            switch (faiss_metric_type) {
+                case faiss::METRIC_L2: {
+                    [[maybe_unused]] auto cur_query = (const DataType*)xq + dim * index;
+                    if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
+                        faiss::range_search_L2sqr(cur_query, (const float*)xb, dim, 1, nb, radius, &res,
+                                                  id_selector);
+                    } else if constexpr (KnowhereLowPrecisionTypeCheck<DataType>::value) {
+                        faiss::range_search_L2sqr_typed(cur_query, (const DataType*)xb, dim, 1, nb, radius, &res,
+                                                        id_selector);
+                    } else {
+                        LOG_KNOWHERE_ERROR_ << "Metric L2 not supported for current vector type";
+                        return Status::faiss_inner_error;
+                    }
+                    break;
+                }
+                case faiss::METRIC_INNER_PRODUCT: {
+                    [[maybe_unused]] auto cur_query = (const DataType*)xq + dim * index;
+                    is_ip = true;
+                    if (is_cosine) {
                         if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
-                            faiss::range_search_L2sqr(cur_query, (const float*)xb, dim, 1, nb, radius, &res,
-                                                      id_selector);
+                            auto copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                            faiss::range_search_cosine(copied_query.get(), (const float*)xb, norms.get(), dim, 1,
+                                                       nb, radius, &res, id_selector);
                         } else if constexpr (KnowhereLowPrecisionTypeCheck<DataType>::value) {
-                            faiss::range_search_L2sqr_typed(cur_query, (const DataType*)xb, dim, 1, nb, radius, &res,
-                                                            id_selector);
+                            // normalize query vector may cause precision loss, so div query norms in apply function
+                            faiss::range_search_cosine_typed(cur_query, (const DataType*)xb, norms.get(), dim, 1,
+                                                             nb, radius, &res, id_selector);
                         } else {
-                            LOG_KNOWHERE_ERROR_ << "Metric L2 not supported for current vector type";
+                            LOG_KNOWHERE_ERROR_ << "Metric COSINE not supported for current vector type";
                             return Status::faiss_inner_error;
                         }
-                        break;
-                    }
-                    case faiss::METRIC_INNER_PRODUCT: {
-                        [[maybe_unused]] auto cur_query = (const DataType*)xq + dim * index;
-                        is_ip = true;
-                        if (is_cosine) {
-                            if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
-                                auto copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                                faiss::range_search_cosine(copied_query.get(), (const float*)xb, norms.get(), dim, 1,
-                                                           nb, radius, &res, id_selector);
-                            } else if constexpr (KnowhereLowPrecisionTypeCheck<DataType>::value) {
-                                // normalize query vector may cause precision loss, so div query norms in apply function
-                                faiss::range_search_cosine_typed(cur_query, (const DataType*)xb, norms.get(), dim, 1,
-                                                                 nb, radius, &res, id_selector);
-                            } else {
-                                LOG_KNOWHERE_ERROR_ << "Metric COSINE not supported for current vector type";
-                                return Status::faiss_inner_error;
-                            }
+                    } else {
+                        if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
+                            faiss::range_search_inner_product(cur_query, (const DataType*)xb, dim, 1, nb, radius,
+                                                              &res, id_selector);
+                        } else if constexpr (KnowhereLowPrecisionTypeCheck<DataType>::value) {
+                            faiss::range_search_inner_product_typed(cur_query, (const DataType*)xb, dim, 1, nb,
+                                                                    radius, &res, id_selector);
                         } else {
-                            if constexpr (std::is_same_v<DataType, knowhere::fp32>) {
-                                faiss::range_search_inner_product(cur_query, (const DataType*)xb, dim, 1, nb, radius,
-                                                                  &res, id_selector);
-                            } else if constexpr (KnowhereLowPrecisionTypeCheck<DataType>::value) {
-                                faiss::range_search_inner_product_typed(cur_query, (const DataType*)xb, dim, 1, nb,
-                                                                        radius, &res, id_selector);
-                            } else {
-                                LOG_KNOWHERE_ERROR_ << "Metric IP not supported for current vector type";
-                                return Status::faiss_inner_error;
-                            }
+                            LOG_KNOWHERE_ERROR_ << "Metric IP not supported for current vector type";
+                            return Status::faiss_inner_error;
                         }
-                        break;
-                    }
-                    case faiss::METRIC_Jaccard: {
-                        auto cur_query = (const uint8_t*)xq + (dim / 8) * index;
-                        faiss::binary_range_search<faiss::CMin<float, int64_t>, float>(
-                            faiss::METRIC_Jaccard, cur_query, (const uint8_t*)xb, 1, nb, radius, dim / 8, &res,
-                            id_selector);
-                        break;
-                    }
-                    case faiss::METRIC_Hamming: {
-                        auto cur_query = (const uint8_t*)xq + (dim / 8) * index;
-                        faiss::binary_range_search<faiss::CMin<int, int64_t>, int>(
-                            faiss::METRIC_Hamming, cur_query, (const uint8_t*)xb, 1, nb, (int)radius, dim / 8, &res,
-                            id_selector);
-                        break;
-                    }
-                    default: {
-                        LOG_KNOWHERE_ERROR_ << "Invalid metric type: " << cfg.metric_type.value();
-                        return Status::invalid_metric_type;
                     }
+                    break;
                 }
-                auto elem_cnt = res.lims[1];
-                result_dist_array[index].resize(elem_cnt);
-                result_id_array[index].resize(elem_cnt);
-                for (size_t j = 0; j < elem_cnt; j++) {
-                    result_dist_array[index][j] = res.distances[j];
-                    result_id_array[index][j] = res.labels[j] + xb_id_offset;
+                case faiss::METRIC_Jaccard: {
+                    auto cur_query = (const uint8_t*)xq + (dim / 8) * index;
+                    faiss::binary_range_search<faiss::CMin<float, int64_t>, float>(
+                        faiss::METRIC_Jaccard, cur_query, (const uint8_t*)xb, 1, nb, radius, dim / 8, &res,
+                        id_selector);
+                    break;
                 }
-                if (cfg.range_filter.value() != defaultRangeFilter) {
-                    FilterRangeSearchResultForOneNq(result_dist_array[index], result_id_array[index], is_ip, radius,
-                                                    range_filter);
+                case faiss::METRIC_Hamming: {
+                    auto cur_query = (const uint8_t*)xq + (dim / 8) * index;
+                    faiss::binary_range_search<faiss::CMin<int, int64_t>, int>(
+                        faiss::METRIC_Hamming, cur_query, (const uint8_t*)xb, 1, nb, (int)radius, dim / 8, &res,
+                        id_selector);
+                    break;
+                }
+                default: {
+                    LOG_KNOWHERE_ERROR_ << "Invalid metric type: " << cfg.metric_type.value();
+                    return Status::invalid_metric_type;
                 }
-                return Status::success;
             }
-        }));
-    }
-    auto ret = WaitAllSuccess(futs);
+            auto elem_cnt = res.lims[1];
+            result_dist_array[index].resize(elem_cnt);
+            result_id_array[index].resize(elem_cnt);
+            for (size_t j = 0; j < elem_cnt; j++) {
+                result_dist_array[index][j] = res.distances[j];
+                result_id_array[index][j] = res.labels[j] + xb_id_offset;
+            }
+            if (cfg.range_filter.value() != defaultRangeFilter) {
+                FilterRangeSearchResultForOneNq(result_dist_array[index], result_id_array[index], is_ip, radius,
+                                                range_filter);
+            }
+            return Status::success;
+        }
+    });
     if (ret != Status::success) {
         return expected<DataSetPtr>::Err(ret, "failed to brute force search");
     }
@@ -670,44 +734,39 @@ BruteForce::SearchSparseWithBuf(const DataSetPtr base_dataset, const DataSetPtr
     std::fill(labels, labels + nq * topk, -1);
 
     auto pool = ThreadPool::GetGlobalSearchThreadPool();
-    std::vector<folly::Future<folly::Unit>> futs;
-    futs.reserve(nq);
-    for (int64_t i = 0; i < nq; ++i) {
-        futs.emplace_back(pool->push([&, index = i] {
-            auto cur_labels = labels + topk * index;
-            auto cur_distances = distances + topk * index;
+    pool->ParallelFor(0, nq, [&](int64_t index) {
+        auto cur_labels = labels + topk * index;
+        auto cur_distances = distances + topk * index;
 
-            const auto& row = xq[index];
-            if (row.size() == 0) {
-                return;
+        const auto& row = xq[index];
+        if (row.size() == 0) {
+            return;
+        }
+        sparse::MaxMinHeap<float> heap(topk);
+        for (int64_t j = 0; j < rows; ++j) {
+            auto x_id = j + xb_id_offset;
+            if (!bitset.empty() && bitset.test(x_id)) {
+                continue;
             }
-            sparse::MaxMinHeap<float> heap(topk);
-            for (int64_t j = 0; j < rows; ++j) {
-                auto x_id = j + xb_id_offset;
-                if (!bitset.empty() && bitset.test(x_id)) {
-                    continue;
-                }
-                float row_sum = 0;
-                if (is_bm25) {
-                    for (size_t k = 0; k < base[j].size(); ++k) {
-                        auto [d, v] = base[j][k];
-                        row_sum += v;
-                    }
-                }
-                float dist = row.dot(base[j], computer, row_sum);
-                if (dist > 0) {
-                    heap.push(x_id, dist);
+            float row_sum = 0;
+            if (is_bm25) {
+                for (size_t k = 0; k < base[j].size(); ++k) {
+                    auto [d, v] = base[j][k];
+                    row_sum += v;
                 }
             }
-            int result_size = heap.size();
-            for (int j = result_size - 1; j >= 0; --j) {
-                cur_labels[j] = heap.top().id;
-                cur_distances[j] = heap.top().val;
-                heap.pop();
+            float dist = row.dot(base[j], computer, row_sum);
+            if (dist > 0) {
+                heap.push(x_id, dist);
             }
-        }));
-    }
-    WaitAllSuccess(futs);
+        }
+        int result_size = heap.size();
+        for (int j = result_size - 1; j >= 0; --j) {
+            cur_labels[j] = heap.top().id;
+            cur_distances[j] = heap.top().val;
+            heap.pop();
+        }
+    });
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     // LCOV_EXCL_START
@@ -0,0 +1,60 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "knowhere/comp/cancel_token.h"
+
+#include "faiss/impl/AuxIndexStructures.h"
+#include "knowhere/log.h"
+
+namespace knowhere {
+
+namespace {
+
+// faiss polls the global interrupt callback in its search loops, route it to the token of the calling thread. The
+// token is thread-local, so faiss may poll without its global lock.
+struct CancelTokenInterruptCallback : faiss::InterruptCallback {
+    bool
+    want_interrupt() override {
+        return CancelToken::CurrentIsCancelled();
+    }
+
+    bool
+    is_thread_safe() const override {
+        return true;
+    }
+};
+
+// installed with the first token only, faiss does not poll at all as long as no callback is set
+void
+InstallFaissInterruptCallback() {
+    static const bool installed = [] {
+        std::lock_guard<std::mutex> guard(faiss::InterruptCallback::lock);
+        if (faiss::InterruptCallback::instance != nullptr) {
+            LOG_KNOWHERE_WARNING_ << "A faiss interrupt callback is already set, faiss searches are not cancellable";
+            return false;
+        }
+        faiss::InterruptCallback::instance = std::make_unique<CancelTokenInterruptCallback>();
+        return true;
+    }();
+    (void)installed;
+}
+
+}  // namespace
+
+CancelToken::CancelToken() {
+    InstallFaissInterruptCallback();
+}
+
+CancelToken::CancelToken(Clock::time_point deadline) : has_deadline_(true), deadline_(deadline) {
+    InstallFaissInterruptCallback();
+}
+
+}  // namespace knowhere
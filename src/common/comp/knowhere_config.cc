@@ -15,6 +15,9 @@
 
 #ifdef KNOWHERE_WITH_DISKANN
 #include "diskann/aio_context_pool.h"
+#ifdef KNOWHERE_WITH_LIBURING
+#include "diskann/uring_aligned_file_reader.h"
+#endif
 #endif
 #include "faiss/Clustering.h"
 #include "faiss/utils/distances.h"
@@ -90,6 +93,23 @@ KnowhereConfig::SetSimdType(const SimdType simd_type) {
     return simd_str;
 }
 
+std::vector<std::string>
+KnowhereConfig::CalibrateSimdKernels() {
+    auto table = faiss::fvec_hook_calibrate();
+    if (table.empty()) {
+        LOG_KNOWHERE_INFO_ << "FAISS simd calibration has no alternative kernels to choose from";
+    }
+    for (const auto& line : table) {
+        LOG_KNOWHERE_INFO_ << "FAISS simd calibration " << line;
+    }
+    return table;
+}
+
+std::vector<std::string>
+KnowhereConfig::GetSimdCalibrationTable() {
+    return faiss::fvec_hook_calibration_table();
+}
+
 void
 KnowhereConfig::EnablePatchForComputeFP32AsBF16() {
     LOG_KNOWHERE_INFO_ << "Enable patch for compute fp32 as bf16";
@@ -146,6 +166,26 @@ KnowhereConfig::SetAioContextPool(size_t num_ctx) {
     return true;
 }
 
+bool
+KnowhereConfig::SetDiskIOEngine(const DiskIOEngine engine, const bool enable_sqpoll, const uint32_t sq_thread_idle_ms) {
+    if (engine == DiskIOEngine::LIBAIO) {
+#if defined(KNOWHERE_WITH_DISKANN) && defined(KNOWHERE_WITH_LIBURING)
+        UringAlignedFileReader::InitGlobalUringConfig(false, false, 0);
+#endif
+        LOG_KNOWHERE_INFO_ << "Set disk I/O engine to libaio";
+        return true;
+    }
+#if defined(KNOWHERE_WITH_DISKANN) && defined(KNOWHERE_WITH_LIBURING)
+    if (UringAlignedFileReader::InitGlobalUringConfig(true, enable_sqpoll, sq_thread_idle_ms)) {
+        LOG_KNOWHERE_INFO_ << "Set disk I/O engine to io_uring, sqpoll: " << enable_sqpoll;
+        return true;
+    }
+#else
+    LOG_KNOWHERE_WARNING_ << "Knowhere is built without io_uring support, keep using libaio";
+#endif
+    return false;
+}
+
 void
 KnowhereConfig::SetBuildThreadPoolSize(size_t num_threads) {
     knowhere::ThreadPool::SetGlobalBuildThreadPoolSize(num_threads);
@@ -166,6 +206,28 @@ KnowhereConfig::GetSearchThreadPoolSize() {
     return knowhere::ThreadPool::GetGlobalSearchThreadPoolSize();
 }
 
+bool
+KnowhereConfig::SetNumaAwareSearchThreadPool(bool enable) {
+    return knowhere::ThreadPool::SetNumaAwareSearchThreadPools(enable);
+}
+
+void
+KnowhereConfig::SetSearchPriorityWeights(uint32_t interactive, uint32_t batch, uint32_t background) {
+    knowhere::ThreadPool::SetSearchPriorityWeights(interactive, batch, background);
+}
+
+void
+KnowhereConfig::SetSearchAdmissionLimits(size_t interactive, size_t batch, size_t background) {
+    knowhere::ThreadPool::SetSearchAdmissionLimit(knowhere::TaskPriority::INTERACTIVE, interactive);
+    knowhere::ThreadPool::SetSearchAdmissionLimit(knowhere::TaskPriority::BATCH, batch);
+    knowhere::ThreadPool::SetSearchAdmissionLimit(knowhere::TaskPriority::BACKGROUND, background);
+}
+
+void
+KnowhereConfig::SetIntraQueryParallelism(bool enable) {
+    knowhere::ThreadPool::SetIntraQueryParallelism(enable);
+}
+
 void
 KnowhereConfig::InitGPUResource(int64_t gpu_id, int64_t res_num) {
 #ifdef KNOWHERE_WITH_GPU
@@ -0,0 +1,171 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "knowhere/comp/memory_pages.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "knowhere/comp/thread_pool.h"
+#include "knowhere/log.h"
+
+namespace knowhere {
+
+namespace {
+
+#ifdef __linux__
+constexpr size_t kHugePageSize = 2UL << 20;
+// the unit of work of the prefault tasks
+constexpr size_t kPrefaultChunkSize = 16UL << 20;
+// mincore() is called on windows of at most this many pages, bounds the size of its output
+constexpr size_t kResidencyWindowPages = 1UL << 16;
+
+size_t
+PageSize() {
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+    return page_size;
+}
+
+// the largest range within [addr, addr + size) with both ends aligned to `alignment`, empty if there is none
+std::pair<uintptr_t, uintptr_t>
+AlignInward(const void* addr, size_t size, size_t alignment) {
+    const auto begin = (reinterpret_cast<uintptr_t>(addr) + alignment - 1) / alignment * alignment;
+    const auto end = (reinterpret_cast<uintptr_t>(addr) + size) / alignment * alignment;
+    return {begin, std::max(begin, end)};
+}
+
+// the pages [addr, addr + size) is on
+std::pair<uintptr_t, uintptr_t>
+AlignOutward(const void* addr, size_t size, size_t alignment) {
+    const auto begin = reinterpret_cast<uintptr_t>(addr) / alignment * alignment;
+    const auto end = (reinterpret_cast<uintptr_t>(addr) + size + alignment - 1) / alignment * alignment;
+    return {begin, end};
+}
+
+void
+PrefaultPages(uintptr_t begin, uintptr_t end) {
+#ifdef MADV_POPULATE_READ
+    // linux 5.14+, populates the page tables without touching the memory
+    if (madvise(reinterpret_cast<void*>(begin), end - begin, MADV_POPULATE_READ) == 0) {
+        return;
+    }
+#endif
+    const size_t page_size = PageSize();
+    for (auto page = begin; page < end; page += page_size) {
+        (void)*reinterpret_cast<const volatile char*>(page);
+    }
+}
+
+size_t
+ResidentBytes(const MemoryRegion& region) {
+    const size_t page_size = PageSize();
+    const auto [begin, end] = AlignOutward(region.addr, region.size, page_size);
+    std::vector<unsigned char> resident(std::min(kResidencyWindowPages, (end - begin) / page_size));
+    size_t resident_pages = 0;
+    for (auto window = begin; window < end; window += kResidencyWindowPages * page_size) {
+        const auto window_end = std::min(end, window + kResidencyWindowPages * page_size);
+        if (mincore(reinterpret_cast<void*>(window), window_end - window, resident.data()) != 0) {
+            LOG_KNOWHERE_WARNING_ << "Failed to get the residency of a memory region: " << strerror(errno);
+            return 0;
+        }
+        for (size_t i = 0; i < (window_end - window) / page_size; ++i) {
+            resident_pages += resident[i] & 1;
+        }
+    }
+    return std::min(region.size, resident_pages * page_size);
+}
+#endif
+
+}  // namespace
+
+size_t
+AdviseHugePages(const std::vector<MemoryRegion>& regions) {
+    size_t advised = 0;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    for (const auto& region : regions) {
+        if (region.mapped) {
+            continue;
+        }
+        const auto [begin, end] = AlignInward(region.addr, region.size, kHugePageSize);
+        if (begin == end) {
+            continue;
+        }
+        auto addr = reinterpret_cast<void*>(begin);
+        if (madvise(addr, end - begin, MADV_HUGEPAGE) != 0) {
+            // EINVAL if the kernel has no transparent huge pages, no use to go on
+            LOG_KNOWHERE_WARNING_ << "Failed to madvise huge pages: " << strerror(errno);
+            break;
+        }
+#ifdef MADV_COLLAPSE
+        // may fail under memory pressure, khugepaged collapses the region later then
+        madvise(addr, end - begin, MADV_COLLAPSE);
+#endif
+        advised += end - begin;
+    }
+#endif
+    return advised;
+}
+
+Status
+PrefaultMappedRegions(const std::vector<MemoryRegion>& regions) {
+#ifdef __linux__
+    std::vector<std::pair<uintptr_t, uintptr_t>> chunks;
+    for (const auto& region : regions) {
+        if (!region.mapped || !region.hot || region.size == 0) {
+            continue;
+        }
+        const auto [begin, end] = AlignOutward(region.addr, region.size, PageSize());
+        // starts the read ahead of the region while the tasks are queued
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_WILLNEED);
+        for (auto chunk = begin; chunk < end; chunk += kPrefaultChunkSize) {
+            chunks.emplace_back(chunk, std::min(end, chunk + kPrefaultChunkSize));
+        }
+    }
+    if (chunks.empty()) {
+        return Status::success;
+    }
+    ThreadPool::ScopedTaskPrioritySetter priority_setter(TaskPriority::BACKGROUND);
+    return ThreadPool::GetGlobalSearchThreadPool()->ParallelFor(
+        0, chunks.size(), [&chunks](size_t i) { PrefaultPages(chunks[i].first, chunks[i].second); });
+#else
+    return Status::success;
+#endif
+}
+
+MemoryResidency
+GetMemoryResidency(const std::vector<MemoryRegion>& regions) {
+    MemoryResidency residency;
+    for (const auto& region : regions) {
+#ifdef __linux__
+        const size_t resident = ResidentBytes(region);
+#else
+        const size_t resident = region.size;
+#endif
+        if (region.mapped) {
+            residency.mapped_bytes += region.size;
+            residency.mapped_resident_bytes += resident;
+        } else {
+            residency.anonymous_bytes += region.size;
+            residency.anonymous_resident_bytes += resident;
+        }
+    }
+    return residency;
+}
+
+}  // namespace knowhere
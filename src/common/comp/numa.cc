@@ -0,0 +1,195 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "knowhere/comp/numa.h"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "knowhere/log.h"
+
+namespace knowhere {
+
+namespace {
+
+constexpr const char* kNodeDir = "/sys/devices/system/node";
+
+// memory policy constants of <numaif.h>, which comes with libnuma
+constexpr int kMpolDefault = 0;
+constexpr int kMpolPreferred = 1;
+constexpr size_t kMaxNodes = 1024;
+constexpr size_t kBitsPerMask = 8 * sizeof(unsigned long);
+
+// parses a sysfs cpu list such as "0-3,8-11"
+std::vector<int>
+ParseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        auto dash = range.find('-');
+        int begin = std::stoi(range.substr(0, dash));
+        int end = dash == std::string::npos ? begin : std::stoi(range.substr(dash + 1));
+        for (int cpu = begin; cpu <= end; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::vector<unsigned long>
+NodeMask(int node) {
+    std::vector<unsigned long> mask(kMaxNodes / kBitsPerMask, 0);
+    mask[node / kBitsPerMask] |= 1UL << (node % kBitsPerMask);
+    return mask;
+}
+
+}  // namespace
+
+NumaTopology::NumaTopology() {
+#ifdef __linux__
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(kNodeDir, ec)) {
+        const auto name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+        }
+        const int node = std::stoi(name.substr(4));
+        if (node >= (int)kMaxNodes) {
+            continue;
+        }
+        std::ifstream in(entry.path() / "cpulist");
+        std::string list;
+        if (!in || !std::getline(in, list)) {
+            continue;
+        }
+        if (node >= (int)node_cpus_.size()) {
+            node_cpus_.resize(node + 1);
+        }
+        try {
+            node_cpus_[node] = ParseCpuList(list);
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "Failed to parse cpus of numa node " << node << ": " << e.what();
+        }
+    }
+#endif
+    if (node_cpus_.empty()) {
+        std::vector<int> cpus(std::thread::hardware_concurrency());
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            cpus[i] = i;
+        }
+        node_cpus_.push_back(std::move(cpus));
+    }
+    LOG_KNOWHERE_INFO_ << "Detected " << node_cpus_.size() << " numa node(s)";
+}
+
+const NumaTopology&
+NumaTopology::Instance() {
+    static NumaTopology topology;
+    return topology;
+}
+
+int
+NumaTopology::NumNodes() {
+    return Instance().node_cpus_.size();
+}
+
+const std::vector<int>&
+NumaTopology::NodeCpus(int node) {
+    static const std::vector<int> empty;
+    const auto& node_cpus = Instance().node_cpus_;
+    return node >= 0 && node < (int)node_cpus.size() ? node_cpus[node] : empty;
+}
+
+bool
+NumaTopology::SetCurrentThreadAffinity(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        LOG_KNOWHERE_WARNING_ << "Failed to set cpu affinity: " << std::strerror(errno);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+ScopedNumaBind::ScopedNumaBind(int node) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    if (node < 0 || NumaTopology::NumNodes() == 1) {
+        return;
+    }
+    if (!NumaTopology::IsValidNode(node)) {
+        LOG_KNOWHERE_WARNING_ << "Invalid numa node " << node << ", the index is not bound";
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus_before_.push_back(cpu);
+        }
+    }
+    mask_before_.assign(kMaxNodes / kBitsPerMask, 0);
+    if (syscall(SYS_get_mempolicy, &mode_before_, mask_before_.data(), kMaxNodes + 1, nullptr, 0) != 0) {
+        mode_before_ = kMpolDefault;
+    }
+    if (!NumaTopology::SetCurrentThreadAffinity(NumaTopology::NodeCpus(node))) {
+        return;
+    }
+    auto mask = NodeMask(node);
+    if (syscall(SYS_set_mempolicy, kMpolPreferred, mask.data(), kMaxNodes + 1) != 0) {
+        LOG_KNOWHERE_WARNING_ << "Failed to set memory policy: " << std::strerror(errno);
+    }
+    bound_ = true;
+#endif
+}
+
+ScopedNumaBind::~ScopedNumaBind() {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    if (!bound_) {
+        return;
+    }
+    if (mode_before_ == kMpolDefault) {
+        syscall(SYS_set_mempolicy, kMpolDefault, nullptr, 0);
+    } else {
+        syscall(SYS_set_mempolicy, mode_before_, mask_before_.data(), kMaxNodes + 1);
+    }
+    NumaTopology::SetCurrentThreadAffinity(cpus_before_);
+#endif
+}
+
+}  // namespace knowhere
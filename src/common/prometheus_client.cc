@@ -66,9 +66,11 @@ DEFINE_PROMETHEUS_HISTOGRAM_FAMILY(raw_compute_cnt, "raw compute cnt per request
 DEFINE_PROMETHEUS_HISTOGRAM(raw_compute_cnt, PROMETHEUS_LABEL_CARDINAL)
 
 DEFINE_PROMETHEUS_HISTOGRAM_FAMILY(cache_hit_cnt, "cache hit cnt per request")
+DEFINE_PROMETHEUS_HISTOGRAM(cache_hit_cnt, PROMETHEUS_LABEL_KNOWHERE)
 DEFINE_PROMETHEUS_HISTOGRAM(cache_hit_cnt, PROMETHEUS_LABEL_CARDINAL)
 
 DEFINE_PROMETHEUS_HISTOGRAM_FAMILY(io_cnt, "io cnt per request")
+DEFINE_PROMETHEUS_HISTOGRAM(io_cnt, PROMETHEUS_LABEL_KNOWHERE)
 DEFINE_PROMETHEUS_HISTOGRAM(io_cnt, PROMETHEUS_LABEL_CARDINAL)
 
 DEFINE_PROMETHEUS_HISTOGRAM_FAMILY(queue_latency, "queue latency per request")
@@ -117,6 +119,12 @@ DEFINE_PROMETHEUS_HISTOGRAM_WITH_BUCKETS(diskann_bitset_ratio, PROMETHEUS_LABEL_
 DEFINE_PROMETHEUS_HISTOGRAM_FAMILY(diskann_search_hops, "DISKANN search hops")
 DEFINE_PROMETHEUS_HISTOGRAM(diskann_search_hops, PROMETHEUS_LABEL_KNOWHERE)
 
+DEFINE_PROMETHEUS_HISTOGRAM_FAMILY(diskann_filtered_io_cnt, "DISKANN io cnt of filtered nodes per request")
+DEFINE_PROMETHEUS_HISTOGRAM(diskann_filtered_io_cnt, PROMETHEUS_LABEL_KNOWHERE)
+
+DEFINE_PROMETHEUS_HISTOGRAM_FAMILY(diskann_sector_cache_hit_cnt, "DISKANN dynamic sector cache hit cnt per request")
+DEFINE_PROMETHEUS_HISTOGRAM(diskann_sector_cache_hit_cnt, PROMETHEUS_LABEL_KNOWHERE)
+
 const prometheus::Histogram::BucketBoundaries diskannRangeSearchIterBuckets = {2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22};
 DEFINE_PROMETHEUS_HISTOGRAM_FAMILY(diskann_range_search_iters, "DISKANN range search iterations")
 DEFINE_PROMETHEUS_HISTOGRAM_WITH_BUCKETS(diskann_range_search_iters, PROMETHEUS_LABEL_KNOWHERE,
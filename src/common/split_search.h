@@ -0,0 +1,67 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#ifndef COMMON_SPLIT_SEARCH_H
+#define COMMON_SPLIT_SEARCH_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "faiss/utils/Heap.h"
+#include "knowhere/comp/thread_pool.h"
+#include "knowhere/expected.h"
+
+namespace knowhere {
+
+// [begin, end) of part `part` out of `splits` even parts of `size` units
+inline std::pair<size_t, size_t>
+SplitRange(size_t size, size_t splits, size_t part) {
+    return {size * part / splits, size * (part + 1) / splits};
+}
+
+// Top-k search of `nq` queries, each of them split in `splits` parts (see ThreadPool::IntraQuerySplits) that run as
+// separate tasks of `pool`. `search_part(q, part, distances, labels)` writes the sorted top-k of part `part` of query
+// `q`, labels padded with -1 and in the id space of the whole index. The parts of a query are then merged into its k
+// entries of `distances` and `labels`. All the (query, part) pairs go through a single ParallelFor from the calling
+// thread, the tasks never wait on each other.
+template <typename SearchPart>
+Status
+SplitTopKSearch(ThreadPool* pool, size_t nq, size_t splits, size_t k, bool is_similarity, float* distances,
+                int64_t* labels, SearchPart&& search_part) {
+    std::vector<float> part_distances(nq * splits * k);
+    std::vector<int64_t> part_labels(nq * splits * k);
+    auto status = pool->ParallelFor(0, nq * splits, [&](size_t i) {
+        ThreadPool::ScopedSearchOmpSetter setter(1);
+        return search_part(i / splits, i % splits, part_distances.data() + i * k, part_labels.data() + i * k);
+    });
+    if (status != Status::success) {
+        return status;
+    }
+    // the comparator is reversed w.r.t. the top-k heaps, the best results come first
+    for (size_t q = 0; q < nq; ++q) {
+        const auto offset = q * splits * k;
+        if (is_similarity) {
+            faiss::merge_knn_results<int64_t, faiss::CMax<float, int>>(
+                1, k, splits, part_distances.data() + offset, part_labels.data() + offset, distances + q * k,
+                labels + q * k);
+        } else {
+            faiss::merge_knn_results<int64_t, faiss::CMin<float, int>>(
+                1, k, splits, part_distances.data() + offset, part_labels.data() + offset, distances + q * k,
+                labels + q * k);
+        }
+    }
+    return Status::success;
+}
+
+}  // namespace knowhere
+
+#endif /* COMMON_SPLIT_SEARCH_H */
@@ -0,0 +1,38 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License.
+
+#ifndef COMMON_TYPED_STORAGE_H
+#define COMMON_TYPED_STORAGE_H
+
+#include <type_traits>
+
+#include "faiss/impl/ScalarQuantizer.h"
+#include "knowhere/operands.h"
+
+namespace knowhere {
+
+// the scalar quantizer that keeps fp16, bf16 and int8 vectors losslessly, its codes are the vectors as they are
+template <typename DataType>
+constexpr faiss::ScalarQuantizer::QuantizerType
+TypedQuantizerType() {
+    static_assert(KnowhereLowPrecisionTypeCheck<DataType>::value, "only fp16, bf16 and int8 are stored typed");
+    if constexpr (std::is_same_v<DataType, fp16>) {
+        return faiss::ScalarQuantizer::QT_fp16;
+    } else if constexpr (std::is_same_v<DataType, bf16>) {
+        return faiss::ScalarQuantizer::QT_bf16;
+    } else {
+        return faiss::ScalarQuantizer::QT_8bit_direct_signed_raw;
+    }
+}
+
+}  // namespace knowhere
+
+#endif /* COMMON_TYPED_STORAGE_H */
@@ -321,88 +321,74 @@ DataViewIndexFlat::Search(const idx_t n, const void* __restrict x, const idx_t k
                           idx_t* __restrict labels, const BitsetView& bitset, const bool use_quant) const {
     // todo: need more test to check
     const auto& search_pool = ThreadPool::GetGlobalSearchThreadPool();
-    std::vector<folly::Future<folly::Unit>> futs;
-    futs.reserve(n);
     if (k < faiss::distance_compute_min_k_reservoir) {
         if (metric_type_ == metric::L2) {
             faiss::HeapBlockResultHandler<CMAX> res(n, distances, labels, k);
-            for (auto i = 0; i < n; i++) {
-                futs.emplace_back(search_pool->push([&] {
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-                    faiss::HeapBlockResultHandler<CMAX>::SingleResultHandler resi(res);
-                    auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
-                                                           use_quant ? quant_data_ : nullptr);
-                    computer->set_query((const float*)((const char*)x + code_size_ * i));
-                    resi.begin(i);
-                    if (bitset.empty()) {
-                        exhaustive_search_in_one_query_impl(computer, n, resi, faiss::IDSelectorAll());
-                    } else {
-                        exhaustive_search_in_one_query_impl(computer, n, resi, BitsetViewIDSelector(bitset));
-                    }
-                    resi.end();
-                }));
-            }
-            WaitAllSuccess(futs);
+            search_pool->ParallelFor(0, n, [&](idx_t i) {
+                ThreadPool::ScopedSearchOmpSetter setter(1);
+                faiss::HeapBlockResultHandler<CMAX>::SingleResultHandler resi(res);
+                auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
+                                                       use_quant ? quant_data_ : nullptr);
+                computer->set_query((const float*)((const char*)x + code_size_ * i));
+                resi.begin(i);
+                if (bitset.empty()) {
+                    exhaustive_search_in_one_query_impl(computer, n, resi, faiss::IDSelectorAll());
+                } else {
+                    exhaustive_search_in_one_query_impl(computer, n, resi, BitsetViewIDSelector(bitset));
+                }
+                resi.end();
+            });
         } else {
             faiss::HeapBlockResultHandler<CMIN> res(n, distances, labels, k);
-            for (auto i = 0; i < n; i++) {
-                futs.emplace_back(search_pool->push([&] {
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-                    faiss::HeapBlockResultHandler<CMIN>::SingleResultHandler resi(res);
-                    auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
-                                                           use_quant ? quant_data_ : nullptr);
-                    computer->set_query((const float*)((const char*)x + code_size_ * i));
-                    resi.begin(i);
-                    if (bitset.empty()) {
-                        exhaustive_search_in_one_query_impl(computer, n, resi, faiss::IDSelectorAll());
-                    } else {
-                        exhaustive_search_in_one_query_impl(computer, n, resi, BitsetViewIDSelector(bitset));
-                    }
-                    resi.end();
-                }));
-            }
-            WaitAllSuccess(futs);
+            search_pool->ParallelFor(0, n, [&](idx_t i) {
+                ThreadPool::ScopedSearchOmpSetter setter(1);
+                faiss::HeapBlockResultHandler<CMIN>::SingleResultHandler resi(res);
+                auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
+                                                       use_quant ? quant_data_ : nullptr);
+                computer->set_query((const float*)((const char*)x + code_size_ * i));
+                resi.begin(i);
+                if (bitset.empty()) {
+                    exhaustive_search_in_one_query_impl(computer, n, resi, faiss::IDSelectorAll());
+                } else {
+                    exhaustive_search_in_one_query_impl(computer, n, resi, BitsetViewIDSelector(bitset));
+                }
+                resi.end();
+            });
         }
     } else {
         if (metric_type_ == metric::L2) {
             faiss::ReservoirBlockResultHandler<CMAX> res(n, distances, labels, k);
 
-            for (auto i = 0; i < n; i++) {
-                futs.emplace_back(search_pool->push([&] {
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-                    faiss::ReservoirBlockResultHandler<CMAX>::SingleResultHandler resi(res);
-                    auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
-                                                           use_quant ? quant_data_ : nullptr);
-                    computer->set_query((const float*)((const char*)x + code_size_ * i));
-                    resi.begin(i);
-                    if (bitset.empty()) {
-                        exhaustive_search_in_one_query_impl(computer, n, resi, faiss::IDSelectorAll());
-                    } else {
-                        exhaustive_search_in_one_query_impl(computer, n, resi, BitsetViewIDSelector(bitset));
-                    }
-                    resi.end();
-                }));
-            }
-            WaitAllSuccess(futs);
+            search_pool->ParallelFor(0, n, [&](idx_t i) {
+                ThreadPool::ScopedSearchOmpSetter setter(1);
+                faiss::ReservoirBlockResultHandler<CMAX>::SingleResultHandler resi(res);
+                auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
+                                                       use_quant ? quant_data_ : nullptr);
+                computer->set_query((const float*)((const char*)x + code_size_ * i));
+                resi.begin(i);
+                if (bitset.empty()) {
+                    exhaustive_search_in_one_query_impl(computer, n, resi, faiss::IDSelectorAll());
+                } else {
+                    exhaustive_search_in_one_query_impl(computer, n, resi, BitsetViewIDSelector(bitset));
+                }
+                resi.end();
+            });
         } else {
             faiss::ReservoirBlockResultHandler<CMIN> res(n, distances, labels, k);
-            for (auto i = 0; i < n; i++) {
-                futs.emplace_back(search_pool->push([&] {
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-                    faiss::ReservoirBlockResultHandler<CMIN>::SingleResultHandler resi(res);
-                    auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
-                                                           use_quant ? quant_data_ : nullptr);
-                    computer->set_query((const float*)((const char*)x + code_size_ * i));
-                    resi.begin(i);
-                    if (bitset.empty()) {
-                        exhaustive_search_in_one_query_impl(computer, n, resi, faiss::IDSelectorAll());
-                    } else {
-                        exhaustive_search_in_one_query_impl(computer, n, resi, BitsetViewIDSelector(bitset));
-                    }
-                    resi.end();
-                }));
-            }
-            WaitAllSuccess(futs);
+            search_pool->ParallelFor(0, n, [&](idx_t i) {
+                ThreadPool::ScopedSearchOmpSetter setter(1);
+                faiss::ReservoirBlockResultHandler<CMIN>::SingleResultHandler resi(res);
+                auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
+                                                       use_quant ? quant_data_ : nullptr);
+                computer->set_query((const float*)((const char*)x + code_size_ * i));
+                resi.begin(i);
+                if (bitset.empty()) {
+                    exhaustive_search_in_one_query_impl(computer, n, resi, faiss::IDSelectorAll());
+                } else {
+                    exhaustive_search_in_one_query_impl(computer, n, resi, BitsetViewIDSelector(bitset));
+                }
+                resi.end();
+            });
         }
     }
 }
@@ -412,41 +398,36 @@ DataViewIndexFlat::SearchWithIds(const idx_t n, const void* __restrict x, const
                                  const idx_t* __restrict ids, const idx_t k, float* __restrict out_dist,
                                  idx_t* __restrict out_ids, const bool use_quant) const {
     const auto& search_pool = ThreadPool::GetGlobalSearchThreadPool();
-    std::vector<folly::Future<folly::Unit>> futs;
-    futs.reserve(n);
-    for (auto i = 0; i < n; i++) {
-        futs.emplace_back(search_pool->push([&, i = i] {
-            ThreadPool::ScopedSearchOmpSetter setter(1);
-            auto base_ids = ids + ids_num_lims[i];
-            auto base_n = ids_num_lims[i + 1] - ids_num_lims[i];
-            auto base_dist = std::unique_ptr<float[]>(new float[base_n]);
-            if (metric_type_ == metric::L2) {
-                std::fill(base_dist.get(), base_dist.get() + base_n, CMAX::neutral());
-            } else {
-                std::fill(base_dist.get(), base_dist.get() + base_n, CMIN::neutral());
-            }
-            auto x_i = (const char*)x + code_size_ * i;
-
-            assert(base_n >= k);
-            ComputeDistanceSubset(x_i, base_n, base_dist.get(), base_ids, use_quant);
-            if (is_cosine_) {
-                std::shared_lock lock(norms_mutex_);
-                for (auto j = 0; j < base_n; j++) {
-                    if (base_ids[j] != -1) {
-                        base_dist[j] = base_dist[j] / norms_[base_ids[j]];
-                    }
+    search_pool->ParallelFor(0, n, [&](idx_t i) {
+        ThreadPool::ScopedSearchOmpSetter setter(1);
+        auto base_ids = ids + ids_num_lims[i];
+        auto base_n = ids_num_lims[i + 1] - ids_num_lims[i];
+        auto base_dist = std::unique_ptr<float[]>(new float[base_n]);
+        if (metric_type_ == metric::L2) {
+            std::fill(base_dist.get(), base_dist.get() + base_n, CMAX::neutral());
+        } else {
+            std::fill(base_dist.get(), base_dist.get() + base_n, CMIN::neutral());
+        }
+        auto x_i = (const char*)x + code_size_ * i;
+
+        assert(base_n >= k);
+        ComputeDistanceSubset(x_i, base_n, base_dist.get(), base_ids, use_quant);
+        if (is_cosine_) {
+            std::shared_lock lock(norms_mutex_);
+            for (auto j = 0; j < base_n; j++) {
+                if (base_ids[j] != -1) {
+                    base_dist[j] = base_dist[j] / norms_[base_ids[j]];
                 }
             }
-            if (metric_type_ == metric::L2) {
-                faiss::reorder_2_heaps<CMAX>(1, k, out_ids + i * k, out_dist + i * k, base_n, base_ids,
-                                             base_dist.get());
-            } else {
-                faiss::reorder_2_heaps<CMIN>(1, k, out_ids + i * k, out_dist + i * k, base_n, base_ids,
-                                             base_dist.get());
-            }
-        }));
-    }
-    WaitAllSuccess(futs);
+        }
+        if (metric_type_ == metric::L2) {
+            faiss::reorder_2_heaps<CMAX>(1, k, out_ids + i * k, out_dist + i * k, base_n, base_ids,
+                                         base_dist.get());
+        } else {
+            faiss::reorder_2_heaps<CMIN>(1, k, out_ids + i * k, out_dist + i * k, base_n, base_ids,
+                                         base_dist.get());
+        }
+    });
     return;
 }
 
@@ -466,70 +447,62 @@ DataViewIndexFlat::RangeSearch(const idx_t n, const void* __restrict x, const fl
     auto is_ip = metric_type_ == metric::IP;
 
     const auto& search_pool = ThreadPool::GetGlobalSearchThreadPool();
-    std::vector<folly::Future<folly::Unit>> futs;
-    futs.reserve(n);
     if (metric_type_ == metric::L2) {
-        for (auto i = 0; i < n; i++) {
-            futs.emplace_back(search_pool->push([&, i = i] {
-                ThreadPool::ScopedSearchOmpSetter setter(1);
-                auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
-                                                       use_quant ? quant_data_ : nullptr);
-                faiss::RangeSearchResult res(1);
-                faiss::RangeSearchBlockResultHandler<CMAX> resh(&res, radius);
-                faiss::RangeSearchBlockResultHandler<CMAX>::SingleResultHandler reshi(resh);
-                computer->set_query(((const float*)x + code_size_ * i));
-                reshi.begin(i);
-                if (bitset.empty()) {
-                    exhaustive_search_in_one_query_impl(computer, n, reshi, faiss::IDSelectorAll());
-                } else {
-                    exhaustive_search_in_one_query_impl(computer, n, reshi, BitsetViewIDSelector(bitset));
-                }
-                reshi.end();
-                auto elem_cnt = res.lims[1];
-                result_dist_array[i].resize(elem_cnt);
-                result_id_array[i].resize(elem_cnt);
-                for (size_t j = 0; j < elem_cnt; j++) {
-                    result_dist_array[i][j] = res.distances[j];
-                    result_id_array[i][j] = res.labels[j];
-                }
-                if (range_filter != defaultRangeFilter) {
-                    FilterRangeSearchResultForOneNq(result_dist_array[i], result_id_array[i], is_ip, radius,
-                                                    range_filter);
-                }
-            }));
-        }
-        WaitAllSuccess(futs);
+        search_pool->ParallelFor(0, n, [&](idx_t i) {
+            ThreadPool::ScopedSearchOmpSetter setter(1);
+            auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
+                                                   use_quant ? quant_data_ : nullptr);
+            faiss::RangeSearchResult res(1);
+            faiss::RangeSearchBlockResultHandler<CMAX> resh(&res, radius);
+            faiss::RangeSearchBlockResultHandler<CMAX>::SingleResultHandler reshi(resh);
+            computer->set_query(((const float*)x + code_size_ * i));
+            reshi.begin(i);
+            if (bitset.empty()) {
+                exhaustive_search_in_one_query_impl(computer, n, reshi, faiss::IDSelectorAll());
+            } else {
+                exhaustive_search_in_one_query_impl(computer, n, reshi, BitsetViewIDSelector(bitset));
+            }
+            reshi.end();
+            auto elem_cnt = res.lims[1];
+            result_dist_array[i].resize(elem_cnt);
+            result_id_array[i].resize(elem_cnt);
+            for (size_t j = 0; j < elem_cnt; j++) {
+                result_dist_array[i][j] = res.distances[j];
+                result_id_array[i][j] = res.labels[j];
+            }
+            if (range_filter != defaultRangeFilter) {
+                FilterRangeSearchResultForOneNq(result_dist_array[i], result_id_array[i], is_ip, radius,
+                                                range_filter);
+            }
+        });
     } else {
-        for (auto i = 0; i < n; i++) {
-            futs.emplace_back(search_pool->push([&, i = i] {
-                ThreadPool::ScopedSearchOmpSetter setter(1);
-                auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
-                                                       use_quant ? quant_data_ : nullptr);
-                faiss::RangeSearchResult res(1);
-                faiss::RangeSearchBlockResultHandler<CMIN> resh(&res, radius);
-                faiss::RangeSearchBlockResultHandler<CMIN>::SingleResultHandler reshi(resh);
-                computer->set_query(((const float*)x + code_size_ * i));
-                reshi.begin(i);
-                if (bitset.empty()) {
-                    exhaustive_search_in_one_query_impl(computer, n, reshi, faiss::IDSelectorAll());
-                } else {
-                    exhaustive_search_in_one_query_impl(computer, n, reshi, BitsetViewIDSelector(bitset));
-                }
-                reshi.end();
-                auto elem_cnt = res.lims[1];
-                result_dist_array[i].resize(elem_cnt);
-                result_id_array[i].resize(elem_cnt);
-                for (size_t j = 0; j < elem_cnt; j++) {
-                    result_dist_array[i][j] = res.distances[j];
-                    result_id_array[i][j] = res.labels[j];
-                }
-                if (range_filter != defaultRangeFilter) {
-                    FilterRangeSearchResultForOneNq(result_dist_array[i], result_id_array[i], is_ip, radius,
-                                                    range_filter);
-                }
-            }));
-        }
-        WaitAllSuccess(futs);
+        search_pool->ParallelFor(0, n, [&](idx_t i) {
+            ThreadPool::ScopedSearchOmpSetter setter(1);
+            auto computer = SelectDataViewComputer(view_data_, data_type_, metric_type_, d_, is_cosine_,
+                                                   use_quant ? quant_data_ : nullptr);
+            faiss::RangeSearchResult res(1);
+            faiss::RangeSearchBlockResultHandler<CMIN> resh(&res, radius);
+            faiss::RangeSearchBlockResultHandler<CMIN>::SingleResultHandler reshi(resh);
+            computer->set_query(((const float*)x + code_size_ * i));
+            reshi.begin(i);
+            if (bitset.empty()) {
+                exhaustive_search_in_one_query_impl(computer, n, reshi, faiss::IDSelectorAll());
+            } else {
+                exhaustive_search_in_one_query_impl(computer, n, reshi, BitsetViewIDSelector(bitset));
+            }
+            reshi.end();
+            auto elem_cnt = res.lims[1];
+            result_dist_array[i].resize(elem_cnt);
+            result_id_array[i].resize(elem_cnt);
+            for (size_t j = 0; j < elem_cnt; j++) {
+                result_dist_array[i][j] = res.distances[j];
+                result_id_array[i][j] = res.labels[j];
+            }
+            if (range_filter != defaultRangeFilter) {
+                FilterRangeSearchResultForOneNq(result_dist_array[i], result_id_array[i], is_ip, radius,
+                                                range_filter);
+            }
+        });
     }
     return GetRangeSearchResult(result_dist_array, result_id_array, is_ip, n, radius, range_filter);
 }
@@ -542,41 +515,36 @@ DataViewIndexFlat::RangeSearchWithIds(const idx_t n, const void* __restrict x, c
     std::vector<std::vector<idx_t>> result_id_array(n);
     auto is_ip = metric_type_ == metric::IP;
     const auto& search_pool = ThreadPool::GetGlobalSearchThreadPool();
-    std::vector<folly::Future<folly::Unit>> futs;
-    futs.reserve(n);
-    for (auto i = 0; i < n; i++) {
-        futs.emplace_back(search_pool->push([&, i = i] {
-            ThreadPool::ScopedSearchOmpSetter setter(1);
-            auto base_ids = ids + ids_num_lims[i];
-            auto base_n = ids_num_lims[i + 1] - ids_num_lims[i];
-            auto base_dist = std::unique_ptr<float[]>(new float[base_n]);
-            auto x_i = (const char*)x + code_size_ * i;
-            ComputeDistanceSubset((const void*)x_i, base_n, base_dist.get(), base_ids, use_quant);
-            if (is_cosine_) {
-                std::shared_lock lock(norms_mutex_);
-                for (auto j = 0; j < base_n; j++) {
-                    base_dist[j] = base_dist[j] / norms_[base_ids[j]];
-                }
-            }
+    search_pool->ParallelFor(0, n, [&](idx_t i) {
+        ThreadPool::ScopedSearchOmpSetter setter(1);
+        auto base_ids = ids + ids_num_lims[i];
+        auto base_n = ids_num_lims[i + 1] - ids_num_lims[i];
+        auto base_dist = std::unique_ptr<float[]>(new float[base_n]);
+        auto x_i = (const char*)x + code_size_ * i;
+        ComputeDistanceSubset((const void*)x_i, base_n, base_dist.get(), base_ids, use_quant);
+        if (is_cosine_) {
+            std::shared_lock lock(norms_mutex_);
             for (auto j = 0; j < base_n; j++) {
-                if (!is_ip) {
-                    if (base_dist[j] < radius) {
-                        result_dist_array[i].emplace_back(base_dist[j]);
-                        result_id_array[i].emplace_back(base_ids[j]);
-                    }
-                } else {
-                    if (base_dist[j] > radius) {
-                        result_dist_array[i].emplace_back(base_dist[j]);
-                        result_id_array[i].emplace_back(base_ids[j]);
-                    }
-                }
+                base_dist[j] = base_dist[j] / norms_[base_ids[j]];
             }
-            if (range_filter != defaultRangeFilter) {
-                FilterRangeSearchResultForOneNq(result_dist_array[i], result_id_array[i], is_ip, radius, range_filter);
+        }
+        for (auto j = 0; j < base_n; j++) {
+            if (!is_ip) {
+                if (base_dist[j] < radius) {
+                    result_dist_array[i].emplace_back(base_dist[j]);
+                    result_id_array[i].emplace_back(base_ids[j]);
+                }
+            } else {
+                if (base_dist[j] > radius) {
+                    result_dist_array[i].emplace_back(base_dist[j]);
+                    result_id_array[i].emplace_back(base_ids[j]);
+                }
             }
-        }));
-    }
-    WaitAllSuccess(futs);
+        }
+        if (range_filter != defaultRangeFilter) {
+            FilterRangeSearchResultForOneNq(result_dist_array[i], result_id_array[i], is_ip, radius, range_filter);
+        }
+    });
     return GetRangeSearchResult(result_dist_array, result_id_array, is_ip, n, radius, range_filter);
 }
 
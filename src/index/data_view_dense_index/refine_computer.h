@@ -46,6 +46,53 @@ convert_data(const void* in_data, float* out_data, const DataFormatEnum data_typ
     }
     return false;
 }
+
+// distances of a fp32 query to the codes of a QT_fp16 or QT_bf16 quantizer, which are the vectors themselves
+template <typename DataType>
+float
+code_inner_product(const float* q, const uint8_t* code, size_t d) {
+    if constexpr (std::is_same_v<DataType, fp16>) {
+        return faiss::fvec_fp16_inner_product(q, (const fp16*)code, d);
+    } else {
+        return faiss::fvec_bf16_inner_product(q, (const bf16*)code, d);
+    }
+}
+
+template <typename DataType>
+float
+code_L2sqr(const float* q, const uint8_t* code, size_t d) {
+    if constexpr (std::is_same_v<DataType, fp16>) {
+        return faiss::fvec_fp16_L2sqr(q, (const fp16*)code, d);
+    } else {
+        return faiss::fvec_bf16_L2sqr(q, (const bf16*)code, d);
+    }
+}
+
+template <typename DataType>
+void
+code_inner_product_batch_4(const float* q, const uint8_t* c0, const uint8_t* c1, const uint8_t* c2, const uint8_t* c3,
+                           size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
+    if constexpr (std::is_same_v<DataType, fp16>) {
+        faiss::fvec_fp16_inner_product_batch_4(q, (const fp16*)c0, (const fp16*)c1, (const fp16*)c2, (const fp16*)c3,
+                                               d, dis0, dis1, dis2, dis3);
+    } else {
+        faiss::fvec_bf16_inner_product_batch_4(q, (const bf16*)c0, (const bf16*)c1, (const bf16*)c2, (const bf16*)c3,
+                                               d, dis0, dis1, dis2, dis3);
+    }
+}
+
+template <typename DataType>
+void
+code_L2sqr_batch_4(const float* q, const uint8_t* c0, const uint8_t* c1, const uint8_t* c2, const uint8_t* c3, size_t d,
+                   float& dis0, float& dis1, float& dis2, float& dis3) {
+    if constexpr (std::is_same_v<DataType, fp16>) {
+        faiss::fvec_fp16_L2sqr_batch_4(q, (const fp16*)c0, (const fp16*)c1, (const fp16*)c2, (const fp16*)c3, d, dis0,
+                                       dis1, dis2, dis3);
+    } else {
+        faiss::fvec_bf16_L2sqr_batch_4(q, (const bf16*)c0, (const bf16*)c1, (const bf16*)c2, (const bf16*)c3, d, dis0,
+                                       dis1, dis2, dis3);
+    }
+}
 }  // namespace
 /*
 Quantify the streaming data with a thread safe mode, only support fp32 vector
@@ -123,6 +170,10 @@ struct QuantRefine {
     GetOriginDataType() {
         return origin_data_type;
     }
+    RefineType
+    GetRefineType() {
+        return refine_type;
+    }
 
     ~QuantRefine() {
         if (storage != nullptr) {
@@ -152,17 +203,38 @@ struct QuantDataDistanceComputer : faiss::DistanceComputer {
     std::unique_ptr<faiss::ScalarQuantizer::SQDistanceComputer> qc;
     float q_norm;
     size_t dim;
+    // the fp16 and bf16 codes are compared to the fp32 query directly, the uint8 ones go through the quantizer
+    float (*code_dist1)(const float*, const uint8_t*, size_t) = nullptr;
+    void (*code_dist4)(const float*, const uint8_t*, const uint8_t*, const uint8_t*, const uint8_t*, size_t, float&,
+                       float&, float&, float&) = nullptr;
 
     QuantDataDistanceComputer(const std::shared_ptr<QuantRefine> quant_data, const size_t dim,
                               const float* query = nullptr)
         : quant_data(quant_data), dim(dim) {
         qc = quant_data->GetQuantComputer();
+        if (quant_data->GetRefineType() == RefineType::FLOAT16_QUANT) {
+            set_code_distances<fp16>();
+        } else if (quant_data->GetRefineType() == RefineType::BFLOAT16_QUANT) {
+            set_code_distances<bf16>();
+        }
         if (query != nullptr) {
             set_query(query);
         }
         return;
     }
 
+    template <typename DataType>
+    void
+    set_code_distances() {
+        if (quant_data->GetMetric() == faiss::MetricType::METRIC_INNER_PRODUCT) {
+            code_dist1 = &code_inner_product<DataType>;
+            code_dist4 = &code_inner_product_batch_4<DataType>;
+        } else {
+            code_dist1 = &code_L2sqr<DataType>;
+            code_dist4 = &code_L2sqr_batch_4<DataType>;
+        }
+    }
+
     void
     set_query(const float* x) override {
         if (quant_data->GetOriginDataType() == DataFormatEnum::fp32) {
@@ -185,10 +257,11 @@ struct QuantDataDistanceComputer : faiss::DistanceComputer {
     float
     operator()(idx_t i) override {
         auto code_i = quant_data->GetCode(i);
+        float dis = code_dist1 != nullptr ? code_dist1(qc->q, code_i, dim) : qc->distance_to_code(code_i);
         if constexpr (NeedNormalize) {
-            return qc->distance_to_code(code_i) / q_norm;
+            return dis / q_norm;
         } else {
-            return qc->distance_to_code(code_i);
+            return dis;
         }
     }
 
@@ -199,7 +272,11 @@ struct QuantDataDistanceComputer : faiss::DistanceComputer {
         auto code_1 = quant_data->GetCode(idx1);
         auto code_2 = quant_data->GetCode(idx2);
         auto code_3 = quant_data->GetCode(idx3);
-        qc->query_to_codes_batch_4(code_0, code_1, code_2, code_3, dis0, dis1, dis2, dis3);
+        if (code_dist4 != nullptr) {
+            code_dist4(qc->q, code_0, code_1, code_2, code_3, dim, dis0, dis1, dis2, dis3);
+        } else {
+            qc->query_to_codes_batch_4(code_0, code_1, code_2, code_3, dis0, dis1, dis2, dis3);
+        }
         if constexpr (NeedNormalize) {
             dis0 /= q_norm;
             dis1 /= q_norm;
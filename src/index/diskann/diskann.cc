@@ -11,11 +11,16 @@
 
 #include "knowhere/feder/DiskANN.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <numeric>
 
 #include "diskann/aux_utils.h"
 #include "diskann/linux_aligned_file_reader.h"
 #include "diskann/pq_flash_index.h"
+#ifdef KNOWHERE_WITH_LIBURING
+#include "diskann/uring_aligned_file_reader.h"
+#endif
 #include "fmt/core.h"
 #include "index/diskann/diskann_config.h"
 #include "knowhere/comp/index_param.h"
@@ -61,6 +66,13 @@ class DiskANNIndexNode : public IndexNode {
     expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override;
 
+    Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override;
+
+    expected<DataSetPtr>
+    RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override;
+
     expected<DataSetPtr>
     GetVectorByIds(const DataSetPtr dataset) const override;
 
@@ -206,6 +218,13 @@ class DiskANNIndexNode : public IndexNode {
     uint64_t
     GetCachedNodeNum(const float cache_dram_budget, const uint64_t data_dim, const uint64_t max_degree);
 
+    // searches into `ids` and `distances`, of k * nq entries each, the visits and the I/O stats of each query are
+    // recorded into `feder_result` and `query_stats` (nq entries) if set
+    Status
+    SearchImpl(const DataSetPtr dataset, const DiskANNConfig& search_conf, const BitsetView& bitset, int64_t* ids,
+               DistType* distances, const feder::diskann::FederResultUniq& feder_result,
+               diskann::QueryStats* query_stats, std::string* msg) const;
+
     std::string index_prefix_;
     mutable std::mutex preparation_lock_;
     std::atomic_bool is_prepared_;
@@ -213,7 +232,6 @@ class DiskANNIndexNode : public IndexNode {
     std::unique_ptr<diskann::PQFlashIndex<DataType>> pq_flash_index_;
     std::atomic_int64_t dim_;
     std::atomic_int64_t count_;
-    std::shared_ptr<ThreadPool> search_pool_;
 };
 
 }  // namespace knowhere
@@ -239,6 +257,15 @@ TryDiskANNCall(std::function<void()>&& diskann_call) {
     }
 }
 
+// the error of a search into caller-provided buffers, which may have no use for the message
+Status
+SearchError(std::string* msg, const std::string& what, Status status) {
+    if (msg != nullptr) {
+        *msg = what;
+    }
+    return status;
+}
+
 std::vector<std::string>
 GetNecessaryFilenames(const std::string& prefix, const bool need_norm, const bool use_sample_cache,
                       const bool use_sample_warmup) {
@@ -268,6 +295,7 @@ GetOptionalFilenames(const std::string& prefix) {
     filenames.push_back(diskann::get_disk_index_centroids_filename(disk_index_filename));
     filenames.push_back(diskann::get_disk_index_medoids_filename(disk_index_filename));
     filenames.push_back(diskann::get_cached_nodes_file(prefix));
+    filenames.push_back(diskann::get_disk_index_layout_filename(disk_index_filename));
     return filenames;
 }
 
@@ -311,7 +339,9 @@ DiskANNIndexNode<DataType>::Build(const DataSetPtr dataset, std::shared_ptr<Conf
         LOG_KNOWHERE_ERROR_ << "Invalid metric type: " << build_conf.metric_type.value();
         return Status::invalid_metric_type;
     }
-    if (!(build_conf.index_prefix.has_value() && build_conf.data_path.has_value())) {
+    // without a raw data file, the index is built from the vectors of the dataset kept in memory
+    bool from_memory = !build_conf.data_path.has_value() && dataset != nullptr && dataset->GetTensor() != nullptr;
+    if (!(build_conf.index_prefix.has_value() && (build_conf.data_path.has_value() || from_memory))) {
         LOG_KNOWHERE_ERROR_ << "DiskANN file path for build is empty." << std::endl;
         return Status::invalid_param_in_json;
     }
@@ -319,17 +349,22 @@ DiskANNIndexNode<DataType>::Build(const DataSetPtr dataset, std::shared_ptr<Conf
         LOG_KNOWHERE_ERROR_ << "This index prefix already has index files." << std::endl;
         return Status::disk_file_error;
     }
-    if (!LoadFile(build_conf.data_path.value())) {
+    if (!from_memory && !LoadFile(build_conf.data_path.value())) {
         LOG_KNOWHERE_ERROR_ << "Failed load the raw data before building." << std::endl;
         return Status::disk_file_error;
     }
-    auto data_path = build_conf.data_path.value();
+    auto data_path = from_memory ? std::string() : build_conf.data_path.value();
 
     index_prefix_ = build_conf.index_prefix.value();
 
     size_t count;
     size_t dim;
-    diskann::get_bin_metadata(build_conf.data_path.value(), count, dim);
+    if (from_memory) {
+        count = dataset->GetRows();
+        dim = dataset->GetDim();
+    } else {
+        diskann::get_bin_metadata(data_path, count, dim);
+    }
     count_.store(count);
     dim_.store(dim);
 
@@ -357,7 +392,13 @@ DiskANNIndexNode<DataType>::Build(const DataSetPtr dataset, std::shared_ptr<Conf
                                                        false,
                                                        build_conf.accelerate_build.value(),
                                                        static_cast<uint32_t>(num_nodes_to_cache),
-                                                       build_conf.shuffle_build.value()};
+                                                       build_conf.shuffle_build.value(),
+                                                       build_conf.use_locality_layout.value()};
+    if (from_memory) {
+        diskann_internal_build_config.base_data = dataset->GetTensor();
+        diskann_internal_build_config.base_num = count;
+        diskann_internal_build_config.base_dim = dim;
+    }
     RETURN_IF_ERROR(TryDiskANNCall([&]() {
         int res = diskann::build_disk_index<DataType>(diskann_internal_build_config);
         if (res != 0)
@@ -431,17 +472,29 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
         }
     }
 
-    // set thread pool
-    search_pool_ = ThreadPool::GetGlobalSearchThreadPool();
+    // the search pool is fetched per call, an index bound to a numa node searches on the pool of the node only as
+    // long as numa aware pools are enabled. Size the scratch for the larger of the two pools.
+    const auto num_search_threads =
+        std::max(ThreadPool::GetGlobalSearchThreadPool()->size(), ThreadPool::GetGlobalSearchThreadPool(-1)->size());
 
     // load diskann pq code and meta info
     std::shared_ptr<AlignedFileReader> reader = nullptr;
 
-    reader.reset(new LinuxAlignedFileReader());
+#ifdef KNOWHERE_WITH_LIBURING
+    if (UringAlignedFileReader::IsEnabled()) {
+        if (TryDiskANNCall([&]() { reader.reset(new UringAlignedFileReader()); }) !=
+            Status::success) {
+            LOG_KNOWHERE_WARNING_ << "Failed to create io_uring reader, fall back to libaio.";
+        }
+    }
+#endif
+    if (reader == nullptr) {
+        reader.reset(new LinuxAlignedFileReader());
+    }
 
     pq_flash_index_ = std::make_unique<diskann::PQFlashIndex<DataType>>(reader, diskann_metric);
     auto disk_ann_call = [&]() {
-        int res = pq_flash_index_->load(search_pool_->size(), index_prefix_.c_str());
+        int res = pq_flash_index_->load(num_search_threads, index_prefix_.c_str());
         if (res != 0) {
             throw diskann::ANNException("pq_flash_index_->load returned non-zero value: " + std::to_string(res), -1);
         }
@@ -507,6 +560,22 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
         }
     }
 
+    if (prep_conf.search_dynamic_cache_budget_gb.value() > 0) {
+        auto budget_bytes =
+            static_cast<uint64_t>(1024 * 1024 * 1024 * prep_conf.search_dynamic_cache_budget_gb.value());
+        if (TryDiskANNCall([&]() { pq_flash_index_->enable_sector_cache(budget_bytes); }) != Status::success) {
+            LOG_KNOWHERE_ERROR_ << "Failed to enable dynamic sector cache for DiskANN.";
+            return Status::diskann_inner_error;
+        }
+    }
+
+    if (prep_conf.use_pq_fast_scan.value()) {
+        if (TryDiskANNCall([&]() { pq_flash_index_->enable_fast_scan(); }) != Status::success) {
+            LOG_KNOWHERE_ERROR_ << "Failed to enable fast-scan PQ for DiskANN.";
+            return Status::diskann_inner_error;
+        }
+    }
+
     // warmup
     if (prep_conf.warm_up.value()) {
         LOG_KNOWHERE_INFO_ << "Warming up.";
@@ -525,17 +594,15 @@ DiskANNIndexNode<DataType>::Deserialize(const BinarySet& binset, std::shared_ptr
         std::vector<int64_t> warmup_result_ids_64(warmup_num, 0);
         std::vector<DistType> warmup_result_dists(warmup_num, 0);
 
-        std::vector<folly::Future<folly::Unit>> futures;
-        futures.reserve(warmup_num);
-        for (_s64 i = 0; i < (int64_t)warmup_num; ++i) {
-            futures.emplace_back(search_pool_->push([&, index = i]() {
+        // warmup shares the search pool with live traffic, keep it out of the way of the searches
+        ThreadPool::ScopedTaskPrioritySetter priority_setter(TaskPriority::BACKGROUND);
+        bool failed = TryDiskANNCall([&]() {
+            ThreadPool::GetGlobalSearchThreadPool()->ParallelFor(0, warmup_num, [&](_s64 index) {
                 pq_flash_index_->cached_beam_search(warmup + (index * warmup_aligned_dim), 1, warmup_L,
                                                     warmup_result_ids_64.data() + (index * 1),
                                                     warmup_result_dists.data() + (index * 1), 4);
-            }));
-        }
-
-        bool failed = TryDiskANNCall([&]() { WaitAllSuccess(futures); }) != Status::success;
+            });
+        }) != Status::success;
 
         if (warmup != nullptr) {
             diskann::aligned_free(warmup);
@@ -598,23 +665,9 @@ template <typename DataType>
 expected<DataSetPtr>
 DiskANNIndexNode<DataType>::Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg,
                                    const BitsetView& bitset) const {
-    if (!is_prepared_.load() || !pq_flash_index_) {
-        LOG_KNOWHERE_ERROR_ << "Failed to load diskann.";
-        return expected<DataSetPtr>::Err(Status::empty_index, "DiskANN not loaded");
-    }
-
-    auto search_conf = static_cast<const DiskANNConfig&>(*cfg);
-    if (!CheckMetric(search_conf.metric_type.value())) {
-        return expected<DataSetPtr>::Err(Status::invalid_metric_type, "unsupported metric type");
-    }
+    const auto& search_conf = static_cast<const DiskANNConfig&>(*cfg);
     auto k = static_cast<uint64_t>(search_conf.k.value());
-    auto lsearch = static_cast<uint64_t>(search_conf.search_list_size.value());
-    auto beamwidth = static_cast<uint64_t>(search_conf.beamwidth.value());
-    auto filter_ratio = static_cast<float>(search_conf.filter_threshold.value());
-
     auto nq = dataset->GetRows();
-    auto dim = dataset->GetDim();
-    auto xq = static_cast<const DataType*>(dataset->GetTensor());
 
     feder::diskann::FederResultUniq feder_result;
     if (search_conf.trace_visit.value()) {
@@ -629,22 +682,14 @@ DiskANNIndexNode<DataType>::Search(const DataSetPtr dataset, std::unique_ptr<Con
     auto p_id = std::make_unique<int64_t[]>(k * nq);
     auto p_dist = std::make_unique<DistType[]>(k * nq);
 
-    std::vector<folly::Future<folly::Unit>> futures;
-    futures.reserve(nq);
-    for (int64_t row = 0; row < nq; ++row) {
-        futures.emplace_back(search_pool_->push([&, index = row, p_id_ptr = p_id.get(), p_dist_ptr = p_dist.get()]() {
-            diskann::QueryStats stats;
-            pq_flash_index_->cached_beam_search(xq + (index * dim), k, lsearch, p_id_ptr + (index * k),
-                                                p_dist_ptr + (index * k), beamwidth, false, &stats, feder_result,
-                                                bitset, filter_ratio);
-#ifdef NOT_COMPILE_FOR_SWIG
-            knowhere_diskann_search_hops.Observe(stats.n_hops);
-#endif
-        }));
-    }
+    // per query I/O stats, kept for trace_io
+    std::vector<diskann::QueryStats> query_stats(nq);
 
-    if (TryDiskANNCall([&]() { WaitAllSuccess(futures); }) != Status::success) {
-        return expected<DataSetPtr>::Err(Status::diskann_inner_error, "some search failed");
+    std::string msg;
+    auto status =
+        SearchImpl(dataset, search_conf, bitset, p_id.get(), p_dist.get(), feder_result, query_stats.data(), &msg);
+    if (status != Status::success) {
+        return expected<DataSetPtr>::Err(status, msg);
     }
 
     auto res = GenResultDataSet(nq, k, std::move(p_id), std::move(p_dist));
@@ -657,9 +702,175 @@ DiskANNIndexNode<DataType>::Search(const DataSetPtr dataset, std::unique_ptr<Con
         res->SetJsonInfo(json_visit_info.dump());
         res->SetJsonIdSet(json_id_set.dump());
     }
+    if (search_conf.trace_io.value()) {
+        std::vector<unsigned> io_cnt(nq), filtered_io_cnt(nq), cache_hit_cnt(nq), sector_cache_hit_cnt(nq);
+        for (int64_t i = 0; i < nq; ++i) {
+            io_cnt[i] = query_stats[i].n_ios;
+            filtered_io_cnt[i] = query_stats[i].n_filtered_ios;
+            cache_hit_cnt[i] = query_stats[i].n_cache_hits;
+            sector_cache_hit_cnt[i] = query_stats[i].n_sector_cache_hits;
+        }
+        Json json_io_stats;
+        json_io_stats["io_cnt"] = io_cnt;
+        json_io_stats["filtered_io_cnt"] = filtered_io_cnt;
+        json_io_stats["cache_hit_cnt"] = cache_hit_cnt;
+        json_io_stats["sector_cache_hit_cnt"] = sector_cache_hit_cnt;
+        res->SetJsonIoStats(json_io_stats.dump());
+    }
     return res;
 }
 
+// the visits and the sector reads are not traced, there is no result set to report them in
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
+                                       int64_t* ids, float* distances) const {
+    feder::diskann::FederResultUniq feder_result;
+    return SearchImpl(dataset, static_cast<const DiskANNConfig&>(*cfg), bitset, ids, distances, feder_result, nullptr,
+                      nullptr);
+}
+
+template <typename DataType>
+Status
+DiskANNIndexNode<DataType>::SearchImpl(const DataSetPtr dataset, const DiskANNConfig& search_conf,
+                                       const BitsetView& bitset, int64_t* ids, DistType* distances,
+                                       const feder::diskann::FederResultUniq& feder_result,
+                                       diskann::QueryStats* query_stats, std::string* msg) const {
+    if (!is_prepared_.load() || !pq_flash_index_) {
+        LOG_KNOWHERE_ERROR_ << "Failed to load diskann.";
+        return SearchError(msg, "DiskANN not loaded", Status::empty_index);
+    }
+
+    if (!CheckMetric(search_conf.metric_type.value())) {
+        return SearchError(msg, "unsupported metric type", Status::invalid_metric_type);
+    }
+    auto k = static_cast<uint64_t>(search_conf.k.value());
+    auto lsearch = static_cast<uint64_t>(search_conf.search_list_size.value());
+    auto beamwidth = static_cast<uint64_t>(search_conf.beamwidth.value());
+    auto filter_ratio = static_cast<float>(search_conf.filter_threshold.value());
+    auto pipelined = search_conf.use_pipelined_search.value();
+    auto score_full_sector = search_conf.score_full_sector.value();
+    auto coalesce_io = search_conf.coalesce_io.value();
+    auto filter_aware_ratio = static_cast<float>(search_conf.filter_aware_threshold.value());
+
+    auto nq = dataset->GetRows();
+    auto dim = dataset->GetDim();
+    auto xq = static_cast<const DataType*>(dataset->GetTensor());
+
+    // sectors read by one query of the batch are reused by the others
+    std::unique_ptr<diskann::SectorCache> batch_cache = nullptr;
+    if (coalesce_io && !pipelined) {
+        batch_cache = pq_flash_index_->new_batch_sector_cache(nq, lsearch);
+    }
+
+    auto status = TryDiskANNCall([&]() {
+        ThreadPool::GetGlobalSearchThreadPool()->ParallelFor(0, nq, [&](int64_t index) {
+            diskann::QueryStats stats;
+            pq_flash_index_->cached_beam_search(xq + (index * dim), k, lsearch, ids + (index * k),
+                                                distances + (index * k), beamwidth, false, &stats, feder_result,
+                                                bitset, filter_ratio, pipelined, score_full_sector,
+                                                coalesce_io && !pipelined, batch_cache.get(), filter_aware_ratio);
+            if (query_stats != nullptr) {
+                query_stats[index] = stats;
+            }
+#ifdef NOT_COMPILE_FOR_SWIG
+            knowhere_diskann_search_hops.Observe(stats.n_hops);
+            knowhere_cache_hit_cnt.Observe(stats.n_cache_hits);
+            knowhere_diskann_sector_cache_hit_cnt.Observe(stats.n_sector_cache_hits);
+            knowhere_io_cnt.Observe(stats.n_ios);
+            if (!bitset.empty()) {
+                knowhere_diskann_filtered_io_cnt.Observe(stats.n_filtered_ios);
+            }
+#endif
+        });
+    });
+    if (status != Status::success) {
+        return SearchError(msg, "some search failed", Status::diskann_inner_error);
+    }
+    return Status::success;
+}
+
+/*
+ * Range search runs natively on the graph: the beam keeps expanding while the PQ distances of the frontier stay within
+ * the radius, and the results are scored with the full precision vectors of the fetched sectors.
+ */
+template <typename DataType>
+expected<DataSetPtr>
+DiskANNIndexNode<DataType>::RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg,
+                                        const BitsetView& bitset) const {
+    if (!is_prepared_.load() || !pq_flash_index_) {
+        LOG_KNOWHERE_ERROR_ << "Failed to load diskann.";
+        return expected<DataSetPtr>::Err(Status::empty_index, "DiskANN not loaded");
+    }
+
+    auto search_conf = static_cast<const DiskANNConfig&>(*cfg);
+    if (!CheckMetric(search_conf.metric_type.value())) {
+        return expected<DataSetPtr>::Err(Status::invalid_metric_type, "unsupported metric type");
+    }
+    auto is_ip = IsMetricType(search_conf.metric_type.value(), metric::IP) ||
+                 IsMetricType(search_conf.metric_type.value(), metric::COSINE);
+    auto radius = search_conf.radius.value();
+    auto range_filter = search_conf.range_filter.value();
+    auto num_points = pq_flash_index_->get_num_points();
+    auto min_l_search = std::min<uint64_t>(search_conf.min_k.value(), num_points);
+    auto max_l_search = std::max<uint64_t>(std::min<uint64_t>(search_conf.max_k.value(), num_points), min_l_search);
+    auto beamwidth = static_cast<uint64_t>(search_conf.beamwidth.value());
+    auto range_search_k = search_conf.range_search_k.value();
+
+    auto nq = dataset->GetRows();
+    auto dim = dataset->GetDim();
+    auto xq = static_cast<const DataType*>(dataset->GetTensor());
+
+    std::vector<std::vector<int64_t>> result_id_array(nq);
+    std::vector<std::vector<float>> result_dist_array(nq);
+    if (range_search_k == 0) {
+        auto range_search_result = GetRangeSearchResult(result_dist_array, result_id_array, is_ip, nq, radius,
+                                                        range_filter);
+        return GenResultDataSet(nq, std::move(range_search_result));
+    }
+
+    auto status = TryDiskANNCall([&]() {
+        ThreadPool::GetGlobalSearchThreadPool()->ParallelFor(0, nq, [&](int64_t index) {
+            auto& ids = result_id_array[index];
+            auto& dists = result_dist_array[index];
+            diskann::QueryStats stats;
+            pq_flash_index_->range_search(xq + (index * dim), radius, min_l_search, max_l_search, beamwidth, ids,
+                                          dists, &stats, bitset);
+            FilterRangeSearchResultForOneNq(dists, ids, is_ip, radius, range_filter);
+            // keep the range_search_k closest results
+            if (range_search_k > 0 && ids.size() > static_cast<size_t>(range_search_k)) {
+                std::vector<size_t> order(ids.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::nth_element(order.begin(), order.begin() + range_search_k, order.end(),
+                                 [&](size_t a, size_t b) { return is_ip ? dists[a] > dists[b] : dists[a] < dists[b]; });
+                order.resize(range_search_k);
+                std::vector<int64_t> top_ids(range_search_k);
+                std::vector<float> top_dists(range_search_k);
+                for (int32_t i = 0; i < range_search_k; ++i) {
+                    top_ids[i] = ids[order[i]];
+                    top_dists[i] = dists[order[i]];
+                }
+                ids.swap(top_ids);
+                dists.swap(top_dists);
+            }
+#ifdef NOT_COMPILE_FOR_SWIG
+            knowhere_diskann_search_hops.Observe(stats.n_hops);
+            knowhere_diskann_range_search_iters.Observe(stats.n_iters);
+            knowhere_cache_hit_cnt.Observe(stats.n_cache_hits);
+            knowhere_diskann_sector_cache_hit_cnt.Observe(stats.n_sector_cache_hits);
+            knowhere_io_cnt.Observe(stats.n_ios);
+#endif
+        });
+    });
+    if (status != Status::success) {
+        return expected<DataSetPtr>::Err(Status::diskann_inner_error, "some search failed");
+    }
+
+    auto range_search_result =
+        GetRangeSearchResult(result_dist_array, result_id_array, is_ip, nq, radius, range_filter);
+    return GenResultDataSet(nq, std::move(range_search_result));
+}
+
 /*
  * Get raw vector data given their ids.
  * It first tries to get data from cache, if failed, it will try to get data from disk.
@@ -64,6 +64,16 @@ class DiskANNConfig : public BaseConfig {
     // While serving the index, the entire graph is stored on SSD. For faster search performance, you can cache a few
     // frequently accessed nodes in memory.
     CFG_FLOAT search_cache_budget_gb;
+    // Reorder nodes on disk during build so that graph neighbors share a sector, fewer distinct sectors are then
+    // read per query. Costs 8 bytes per node of memory while serving.
+    CFG_BOOL use_locality_layout;
+    // Memory in GB for a cache that keeps the sectors read by recent searches. Unlike search_cache_budget_gb, which is
+    // filled once while loading, it follows the live query distribution. 0 disables it.
+    CFG_FLOAT search_dynamic_cache_budget_gb;
+    // Score neighbor candidates with 4-bit PQ codes derived from the 8-bit ones at load time, using the SIMD
+    // fast-scan kernels with register resident look-up tables. Cheaper per candidate but less accurate, the results are
+    // still re-ranked with full precision vectors.
+    CFG_BOOL use_pq_fast_scan;
     // Should we do warm-up before searching.
     CFG_BOOL warm_up;
     // Should we use the bfs strategy to cache. We have two cache strategies: 1. use sample queries to do searches and
@@ -75,14 +85,33 @@ class DiskANNConfig : public BaseConfig {
     // slightly higher total number of IO requests to SSD per query. For the highest query throughput with a fixed SSD
     // IOps rating, use W=1. For best latency, use W=4,8 or higher complexity search.
     CFG_INT beamwidth;
-    // DiskANN uses TopK search to simulate range search by double the K in every round. This is the start K.
+    // Range search expands at least min_k nodes before it may stop at the radius, which absorbs the error of the PQ
+    // distances used to order the frontier.
     CFG_INT min_k;
-    // DiskANN uses TopK search to simulate range search by double the K in every round. This is the largest K.
+    // Range search never expands more than max_k nodes, whatever the radius.
     CFG_INT max_k;
     // The threshold which determines when to switch to PQ + Refine strategy based on the number of bits set. The
     // value should be in range of [0.0, 1.0] which means when greater or equal to x% of the bits are set,
     // use PQ + Refine. Default to -1.0f, negative vlaues will use dynamic threshold calculator given topk.
     CFG_FLOAT filter_threshold;
+    // Overlap disk I/O with computation during search. Instead of reading a whole beam and waiting for all of its
+    // sectors, keep up to beamwidth reads in flight and expand each node as soon as its sector arrives. This mostly
+    // helps tail latency on NVMe devices at moderate QPS.
+    CFG_BOOL use_pipelined_search;
+    // Besides the node being expanded, score all other nodes of every fetched sector with full precision. Works best
+    // with indexes built with use_locality_layout.
+    CFG_BOOL score_full_sector;
+    // Let concurrent searches share sector reads: a search joins a read of the same sector that is already in flight
+    // and, for nq > 1, the queries of one batch reuse each other's sectors. Applies to the non-pipelined search.
+    CFG_BOOL coalesce_io;
+    // Once at least this ratio of the points is filtered out (and below filter_threshold), the search expands the
+    // unfiltered candidates first and reads the sectors of filtered ones only when no unfiltered candidate is left,
+    // which saves the reads of the filtered candidates that drop out of the search list meanwhile. Opt-in: the
+    // default of 1.0 disables it.
+    CFG_FLOAT filter_aware_threshold;
+    // Attach the number of sector reads of every query, how many of them were for filtered nodes, and the hits of the
+    // static and of the dynamic sector caches to the search result.
+    CFG_BOOL trace_io;
     KNOHWERE_DECLARE_CONFIG(DiskANNConfig) {
         KNOWHERE_CONFIG_DECLARE_FIELD(max_degree)
             .description("the degree of the graph index.")
@@ -132,6 +161,19 @@ class DiskANNConfig : public BaseConfig {
             .set_range(0, std::numeric_limits<CFG_FLOAT::value_type>::max())
             .for_train()
             .for_deserialize();
+        KNOWHERE_CONFIG_DECLARE_FIELD(use_locality_layout)
+            .description("co-locate graph neighbors in the same disk sector.")
+            .set_default(false)
+            .for_train();
+        KNOWHERE_CONFIG_DECLARE_FIELD(search_dynamic_cache_budget_gb)
+            .description("the size of the dynamic sector cache in GB.")
+            .set_default(0)
+            .set_range(0, std::numeric_limits<CFG_FLOAT::value_type>::max())
+            .for_deserialize();
+        KNOWHERE_CONFIG_DECLARE_FIELD(use_pq_fast_scan)
+            .description("score candidates with 4-bit fast-scan PQ codes.")
+            .set_default(false)
+            .for_deserialize();
         KNOWHERE_CONFIG_DECLARE_FIELD(warm_up)
             .description("should do warm up before search.")
             .set_default(false)
@@ -148,12 +190,12 @@ class DiskANNConfig : public BaseConfig {
             .for_range_search()
             .for_iterator();
         KNOWHERE_CONFIG_DECLARE_FIELD(min_k)
-            .description("the min l_search size used in range search.")
+            .description("the min number of nodes expanded by range search.")
             .set_default(100)
             .set_range(1, std::numeric_limits<CFG_INT::value_type>::max())
             .for_range_search();
         KNOWHERE_CONFIG_DECLARE_FIELD(max_k)
-            .description("the max l_search size used in range search.")
+            .description("the max number of nodes expanded by range search.")
             .set_default(std::numeric_limits<CFG_INT::value_type>::max())
             .set_range(1, std::numeric_limits<CFG_INT::value_type>::max())
             .for_range_search();
@@ -163,6 +205,27 @@ class DiskANNConfig : public BaseConfig {
             .set_range(-1.0f, 1.0f)
             .for_search()
             .for_iterator();
+        KNOWHERE_CONFIG_DECLARE_FIELD(use_pipelined_search)
+            .description("overlap disk reads with computation during search.")
+            .set_default(false)
+            .for_search();
+        KNOWHERE_CONFIG_DECLARE_FIELD(score_full_sector)
+            .description("score all nodes of every fetched sector.")
+            .set_default(false)
+            .for_search();
+        KNOWHERE_CONFIG_DECLARE_FIELD(coalesce_io)
+            .description("share sector reads among concurrent searches.")
+            .set_default(false)
+            .for_search();
+        KNOWHERE_CONFIG_DECLARE_FIELD(filter_aware_threshold)
+            .description("the filter ratio from which the reads of filtered nodes are deferred, 1.0 disables it.")
+            .set_default(1.0f)
+            .set_range(0.0f, 1.0f)
+            .for_search();
+        KNOWHERE_CONFIG_DECLARE_FIELD(trace_io)
+            .description("attach the sector reads and cache hits of every query to the search result.")
+            .set_default(false)
+            .for_search();
     }
 
     Status
@@ -0,0 +1,102 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#include "index/faiss_memory_regions.h"
+
+#include "faiss/IndexBinaryFlat.h"
+#include "faiss/IndexBinaryIVF.h"
+#include "faiss/IndexFlatCodes.h"
+#include "faiss/IndexHNSW.h"
+#include "faiss/IndexIVF.h"
+#include "faiss/IndexPreTransform.h"
+#include "faiss/IndexRefine.h"
+#include "faiss/impl/mapped_io.h"
+#include "faiss/invlists/InvertedLists.h"
+#include "faiss/invlists/OnDiskInvertedLists.h"
+#include "index/ivf/ivfrbq_wrapper.h"
+
+namespace knowhere {
+
+namespace {
+
+template <typename T>
+void
+AddVectorRegion(const faiss::MaybeOwnedVector<T>& vec, bool hot, std::vector<MemoryRegion>& regions) {
+    if (vec.size() == 0) {
+        return;
+    }
+    const bool mapped = !vec.is_owned;
+    if (mapped && dynamic_cast<const faiss::MmappedFileMappingOwner*>(vec.owner.get()) == nullptr) {
+        return;
+    }
+    regions.push_back({vec.data(), vec.size() * sizeof(T), mapped, hot});
+}
+
+template <typename T>
+void
+AddVectorRegion(const std::vector<T>& vec, bool hot, std::vector<MemoryRegion>& regions) {
+    if (!vec.empty()) {
+        regions.push_back({vec.data(), vec.size() * sizeof(T), false, hot});
+    }
+}
+
+void
+CollectInvertedListsRegions(const faiss::InvertedLists* invlists, std::vector<MemoryRegion>& regions, bool hot) {
+    if (auto ails = dynamic_cast<const faiss::ArrayInvertedLists*>(invlists)) {
+        for (size_t i = 0; i < ails->nlist; ++i) {
+            AddVectorRegion(ails->codes[i], hot, regions);
+            AddVectorRegion(ails->ids[i], hot, regions);
+        }
+    } else if (auto odil = dynamic_cast<const faiss::OnDiskInvertedLists*>(invlists)) {
+        // a read only mapping of the whole index file, see IO_FLAG_MMAP
+        if (odil->ptr != nullptr && odil->totsize > 0) {
+            regions.push_back({odil->ptr, odil->totsize, true, hot});
+        }
+    }
+}
+
+}  // namespace
+
+void
+CollectFaissMemoryRegions(const faiss::Index* index, std::vector<MemoryRegion>& regions, bool hot) {
+    if (index == nullptr) {
+        return;
+    }
+    if (auto refine = dynamic_cast<const faiss::IndexRefine*>(index)) {
+        CollectFaissMemoryRegions(refine->base_index, regions, hot);
+        CollectFaissMemoryRegions(refine->refine_index, regions, false);
+    } else if (auto hnsw = dynamic_cast<const faiss::IndexHNSW*>(index)) {
+        AddVectorRegion(hnsw->hnsw.neighbors, hot, regions);
+        AddVectorRegion(hnsw->hnsw.offsets, hot, regions);
+        CollectFaissMemoryRegions(hnsw->storage, regions, hot);
+    } else if (auto ivf = dynamic_cast<const faiss::IndexIVF*>(index)) {
+        CollectFaissMemoryRegions(ivf->quantizer, regions, hot);
+        CollectInvertedListsRegions(ivf->invlists, regions, hot);
+    } else if (auto flat_codes = dynamic_cast<const faiss::IndexFlatCodes*>(index)) {
+        AddVectorRegion(flat_codes->codes, hot, regions);
+    } else if (auto pre_transform = dynamic_cast<const faiss::IndexPreTransform*>(index)) {
+        CollectFaissMemoryRegions(pre_transform->index, regions, hot);
+    } else if (auto rabitq = dynamic_cast<const IndexIVFRaBitQWrapper*>(index)) {
+        CollectFaissMemoryRegions(rabitq->index.get(), regions, hot);
+    }
+}
+
+void
+CollectFaissMemoryRegions(const faiss::IndexBinary* index, std::vector<MemoryRegion>& regions, bool hot) {
+    if (auto flat = dynamic_cast<const faiss::IndexBinaryFlat*>(index)) {
+        AddVectorRegion(flat->xb, hot, regions);
+    } else if (auto ivf = dynamic_cast<const faiss::IndexBinaryIVF*>(index)) {
+        CollectFaissMemoryRegions(ivf->quantizer, regions, hot);
+        CollectInvertedListsRegions(ivf->invlists, regions, hot);
+    }
+}
+
+}  // namespace knowhere
@@ -0,0 +1,34 @@
+// Copyright (C) 2019-2023 Zilliz. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance
+// with the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under the License
+
+#ifndef INDEX_FAISS_MEMORY_REGIONS_H
+#define INDEX_FAISS_MEMORY_REGIONS_H
+
+#include <vector>
+
+#include "faiss/Index.h"
+#include "faiss/IndexBinary.h"
+#include "knowhere/comp/memory_pages.h"
+
+namespace knowhere {
+
+// Appends the large memory regions of `index` to `regions`, the graph links of HNSW indexes before their codes. The
+// refine data of IndexRefine is flagged cold. Views of a buffer that is neither owned by the index nor a mapped file,
+// such as the binary set of a zero copy Deserialize, are left out.
+void
+CollectFaissMemoryRegions(const faiss::Index* index, std::vector<MemoryRegion>& regions, bool hot = true);
+
+void
+CollectFaissMemoryRegions(const faiss::IndexBinary* index, std::vector<MemoryRegion>& regions, bool hot = true);
+
+}  // namespace knowhere
+
+#endif /* INDEX_FAISS_MEMORY_REGIONS_H */
@@ -10,33 +10,57 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include "common/metric.h"
+#include "common/split_search.h"
+#include "common/typed_storage.h"
 #include "faiss/IndexBinaryFlat.h"
+#include "faiss/IndexCosine.h"
 #include "faiss/IndexFlat.h"
+#include "faiss/IndexScalarQuantizer.h"
 #include "faiss/impl/AuxIndexStructures.h"
 #include "faiss/index_io.h"
+#include "faiss/utils/distances.h"
+#include "faiss/utils/distances_typed.h"
+#include "index/faiss_memory_regions.h"
 #include "index/flat/flat_config.h"
 #include "io/memory_io.h"
 #include "knowhere/bitsetview_idselector.h"
 #include "knowhere/comp/thread_pool.h"
 #include "knowhere/feature.h"
 #include "knowhere/index/index_factory.h"
-#include "knowhere/index/index_node_data_mock_wrapper.h"
 #include "knowhere/log.h"
 #include "knowhere/range_util.h"
 #include "knowhere/utils.h"
 
 namespace knowhere {
 
+namespace {
+
+template <typename DataType>
+std::unique_ptr<faiss::IndexScalarQuantizer>
+MakeTypedStorage(int64_t dim, faiss::MetricType metric, bool is_cosine) {
+    if (is_cosine) {
+        return std::make_unique<faiss::IndexScalarQuantizerCosine>(dim, TypedQuantizerType<DataType>());
+    }
+    return std::make_unique<faiss::IndexScalarQuantizer>(dim, TypedQuantizerType<DataType>(), metric);
+}
+
+}  // namespace
+
 template <typename DataType, typename IndexType>
 class FlatIndexNode : public IndexNode {
+    // the vectors of fp16, bf16 and int8 indexes are stored as they are, not converted to fp32
+    static constexpr bool kTypedStorage = KnowhereLowPrecisionTypeCheck<DataType>::value;
+    using StorageType = std::conditional_t<kTypedStorage, faiss::IndexScalarQuantizer, IndexType>;
+
  public:
     FlatIndexNode(const int32_t version, const Object& object) : IndexNode(version), index_(nullptr) {
         static_assert(
             std::is_same<IndexType, faiss::IndexFlat>::value || std::is_same<IndexType, faiss::IndexBinaryFlat>::value,
             "not support");
-        static_assert(std::is_same_v<DataType, fp32> || std::is_same_v<DataType, bin1>,
-                      "FlatIndexNode only support float/binary");
-        search_pool_ = ThreadPool::GetGlobalSearchThreadPool();
+        static_assert(std::is_same_v<DataType, fp32> || std::is_same_v<DataType, bin1> || kTypedStorage,
+                      "FlatIndexNode only support float/fp16/bf16/int8/binary");
+        static_assert(!kTypedStorage || std::is_same_v<IndexType, faiss::IndexFlat>,
+                      "fp16/bf16/int8 only support faiss::IndexFlat");
     }
 
     Status
@@ -48,21 +72,40 @@ class FlatIndexNode : public IndexNode {
             LOG_KNOWHERE_ERROR_ << "unsupported metric type: " << f_cfg.metric_type.value();
             return metric.error();
         }
+        zero_copy_ = false;
         if constexpr (std::is_same<faiss::IndexBinaryFlat, IndexType>::value) {
             index_ = std::make_unique<faiss::IndexBinaryFlat>(dataset->GetDim(), metric.value());
         }
         if constexpr (std::is_same<faiss::IndexFlat, IndexType>::value) {
             bool is_cosine = IsMetricType(f_cfg.metric_type.value(), knowhere::metric::COSINE);
-            index_ = std::make_unique<faiss::IndexFlat>(dataset->GetDim(), metric.value(), is_cosine);
+            if constexpr (kTypedStorage) {
+                index_ = MakeTypedStorage<DataType>(dataset->GetDim(), metric.value(), is_cosine);
+            } else {
+                index_ = std::make_unique<faiss::IndexFlat>(dataset->GetDim(), metric.value(), is_cosine);
+            }
         }
         return Status::success;
     }
 
     Status
     Add(const DataSetPtr dataset, std::shared_ptr<Config> cfg, bool use_knowhere_build_pool) override {
+        if (zero_copy_) {
+            LOG_KNOWHERE_ERROR_ << "Can not add data to an index loaded with enable_zero_copy.";
+            return Status::not_implemented;
+        }
         auto x = dataset->GetTensor();
         auto n = dataset->GetRows();
-        index_->add(n, (const DataType*)x);
+        if constexpr (kTypedStorage) {
+            // the quantizer encodes from fp32, only a block of the vectors is converted at a time
+            for (int64_t begin = 0; begin < n; begin += kAddBlockRows) {
+                auto count = std::min<int64_t>(kAddBlockRows, n - begin);
+                auto block = ConvertFromDataTypeIfNeeded<DataType>(dataset, begin, count);
+                index_->add(count, (const float*)block->GetTensor());
+            }
+            UpdateNorms();
+        } else {
+            index_->add(n, (const DataType*)x);
+        }
         return Status::success;
     }
 
@@ -73,71 +116,27 @@ class FlatIndexNode : public IndexNode {
             return expected<DataSetPtr>::Err(Status::empty_index, "index not loaded");
         }
 
-        DataSetPtr results = std::make_shared<DataSet>();
-        const FlatConfig& f_cfg = static_cast<const FlatConfig&>(*cfg);
-        bool is_cosine = IsMetricType(f_cfg.metric_type.value(), knowhere::metric::COSINE);
-
-        auto k = f_cfg.k.value();
+        auto k = static_cast<const FlatConfig&>(*cfg).k.value();
         auto nq = dataset->GetRows();
-        auto x = dataset->GetTensor();
-        auto dim = dataset->GetDim();
-
         auto len = k * nq;
-        int64_t* ids = nullptr;
-        float* distances = nullptr;
-        try {
-            ids = new (std::nothrow) int64_t[len];
-            distances = new (std::nothrow) float[len];
-            std::vector<folly::Future<folly::Unit>> futs;
-            futs.reserve(nq);
-            for (int i = 0; i < nq; ++i) {
-                futs.emplace_back(search_pool_->push([&, index = i] {
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-                    auto cur_ids = ids + k * index;
-                    auto cur_dis = distances + k * index;
-
-                    BitsetViewIDSelector bw_idselector(bitset);
-                    faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
-
-                    if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
-                        auto cur_query = (const DataType*)x + dim * index;
-                        std::unique_ptr<DataType[]> copied_query = nullptr;
-                        if (is_cosine) {
-                            copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                            cur_query = copied_query.get();
-                        }
-
-                        faiss::SearchParameters search_params;
-                        search_params.sel = id_selector;
-
-                        index_->search(1, cur_query, k, cur_dis, cur_ids, &search_params);
-                    }
-                    if constexpr (std::is_same<IndexType, faiss::IndexBinaryFlat>::value) {
-                        auto cur_i_dis = reinterpret_cast<int32_t*>(cur_dis);
-
-                        faiss::SearchParameters search_params;
-                        search_params.sel = id_selector;
-
-                        index_->search(1, (const uint8_t*)x + index * ((dim + 7) / 8), k, cur_i_dis, cur_ids,
-                                       &search_params);
+        std::unique_ptr<int64_t[]> ids(new (std::nothrow) int64_t[len]);
+        std::unique_ptr<float[]> distances(new (std::nothrow) float[len]);
+        std::string msg;
+        auto status = SearchImpl(dataset, std::move(cfg), bitset, ids.get(), distances.get(), &msg);
+        if (status != Status::success) {
+            return expected<DataSetPtr>::Err(status, msg);
+        }
+        return GenResultDataSet(nq, k, ids.release(), distances.release());
+    }
 
-                        if (index_->metric_type == faiss::METRIC_Hamming) {
-                            for (int64_t j = 0; j < k; j++) {
-                                cur_dis[j] = static_cast<float>(cur_i_dis[j]);
-                            }
-                        }
-                    }
-                }));
-            }
-            // wait for the completion
-            WaitAllSuccess(futs);
-        } catch (const std::exception& e) {
-            std::unique_ptr<int64_t[]> auto_delete_ids(ids);
-            std::unique_ptr<float[]> auto_delete_dis(distances);
-            LOG_KNOWHERE_WARNING_ << "error inner faiss: " << e.what();
-            return expected<DataSetPtr>::Err(Status::faiss_inner_error, e.what());
+    Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override {
+        if (!index_) {
+            LOG_KNOWHERE_WARNING_ << "search on empty index";
+            return Status::empty_index;
         }
-        return GenResultDataSet(nq, k, ids, distances);
+        return SearchImpl(dataset, std::move(cfg), bitset, ids, distances, nullptr);
     }
 
     expected<DataSetPtr>
@@ -164,36 +163,38 @@ class FlatIndexNode : public IndexNode {
         std::vector<std::vector<float>> result_dist_array(nq);
 
         try {
-            std::vector<folly::Future<folly::Unit>> futs;
-            futs.reserve(nq);
-            for (int i = 0; i < nq; ++i) {
-                futs.emplace_back(search_pool_->push([&, index = i] {
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-                    faiss::RangeSearchResult res(1);
-
-                    BitsetViewIDSelector bw_idselector(bitset);
-                    faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
-
-                    if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
-                        auto cur_query = (const DataType*)xq + dim * index;
-                        std::unique_ptr<DataType[]> copied_query = nullptr;
-                        if (is_cosine) {
-                            copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                            cur_query = copied_query.get();
-                        }
+            auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
+            search_pool->ParallelFor(0, nq, [&](int index) {
+                ThreadPool::ScopedSearchOmpSetter setter(1);
+                faiss::RangeSearchResult res(1);
+
+                BitsetViewIDSelector bw_idselector(bitset);
+                faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+
+                if constexpr (kTypedStorage) {
+                    TypedRangeSearchOnRows((const DataType*)xq + dim * index, radius, bitset, result_dist_array[index],
+                                           result_id_array[index]);
+                } else if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
+                    auto cur_query = (const DataType*)xq + dim * index;
+                    std::unique_ptr<DataType[]> copied_query = nullptr;
+                    if (is_cosine) {
+                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                        cur_query = copied_query.get();
+                    }
 
-                        faiss::SearchParameters search_params;
-                        search_params.sel = id_selector;
+                    faiss::SearchParameters search_params;
+                    search_params.sel = id_selector;
 
-                        index_->range_search(1, cur_query, radius, &res, &search_params);
-                    }
-                    if constexpr (std::is_same<IndexType, faiss::IndexBinaryFlat>::value) {
-                        faiss::SearchParameters search_params;
-                        search_params.sel = id_selector;
+                    index_->range_search(1, cur_query, radius, &res, &search_params);
+                }
+                if constexpr (std::is_same<IndexType, faiss::IndexBinaryFlat>::value) {
+                    faiss::SearchParameters search_params;
+                    search_params.sel = id_selector;
 
-                        index_->range_search(1, (const uint8_t*)xq + index * ((dim + 7) / 8), radius, &res,
-                                             &search_params);
-                    }
+                    index_->range_search(1, (const uint8_t*)xq + index * ((dim + 7) / 8), radius, &res,
+                                         &search_params);
+                }
+                if constexpr (!kTypedStorage) {
                     auto elem_cnt = res.lims[1];
                     result_dist_array[index].resize(elem_cnt);
                     result_id_array[index].resize(elem_cnt);
@@ -201,14 +202,12 @@ class FlatIndexNode : public IndexNode {
                         result_dist_array[index][j] = res.distances[j];
                         result_id_array[index][j] = res.labels[j];
                     }
-                    if (f_cfg.range_filter.value() != defaultRangeFilter) {
-                        FilterRangeSearchResultForOneNq(result_dist_array[index], result_id_array[index], is_ip, radius,
-                                                        range_filter);
-                    }
-                }));
-            }
-            // wait for the completion
-            WaitAllSuccess(futs);
+                }
+                if (f_cfg.range_filter.value() != defaultRangeFilter) {
+                    FilterRangeSearchResultForOneNq(result_dist_array[index], result_id_array[index], is_ip, radius,
+                                                    range_filter);
+                }
+            });
             range_search_result =
                 GetRangeSearchResult(result_dist_array, result_id_array, is_ip, nq, radius, range_filter);
         } catch (const std::exception& e) {
@@ -228,8 +227,14 @@ class FlatIndexNode : public IndexNode {
             DataType* data = nullptr;
             try {
                 data = new DataType[rows * dim];
-                for (int64_t i = 0; i < rows; i++) {
-                    index_->reconstruct(ids[i], data + i * dim);
+                if constexpr (kTypedStorage) {
+                    for (int64_t i = 0; i < rows; i++) {
+                        std::copy_n(TypedVectors() + ids[i] * dim, dim, data + i * dim);
+                    }
+                } else {
+                    for (int64_t i = 0; i < rows; i++) {
+                        index_->reconstruct(ids[i], data + i * dim);
+                    }
                 }
                 return GenResultDataSet(rows, dim, data);
             } catch (const std::exception& e) {
@@ -291,20 +296,28 @@ class FlatIndexNode : public IndexNode {
 
     Status
     Serialize(BinarySet& binset) const override {
+        MemoryIOWriter writer;
+        auto status = SerializeToWriter(writer);
+        std::shared_ptr<uint8_t[]> data(writer.data());
+        if (status == Status::success) {
+            binset.Append(Type(), data, writer.tellg());
+        }
+        return status;
+    }
+
+    Status
+    SerializeToWriter(faiss::IOWriter& writer) const override {
         if (!index_) {
             LOG_KNOWHERE_ERROR_ << "Can not serialize empty index.";
             return Status::empty_index;
         }
         try {
-            MemoryIOWriter writer;
             if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
                 faiss::write_index(index_.get(), &writer);
             }
             if constexpr (std::is_same<IndexType, faiss::IndexBinaryFlat>::value) {
                 faiss::write_index_binary(index_.get(), &writer);
             }
-            std::shared_ptr<uint8_t[]> data(writer.data());
-            binset.Append(Type(), data, writer.tellg());
             return Status::success;
         } catch (const std::exception& e) {
             LOG_KNOWHERE_WARNING_ << "error inner faiss: " << e.what();
@@ -313,7 +326,7 @@ class FlatIndexNode : public IndexNode {
     }
 
     Status
-    Deserialize(const BinarySet& binset, std::shared_ptr<Config>) override {
+    Deserialize(const BinarySet& binset, std::shared_ptr<Config> cfg) override {
         std::vector<std::string> names = {"IVF",        // compatible with knowhere-1.x
                                           "BinaryIVF",  // compatible with knowhere-1.x
                                           Type()};
@@ -323,13 +336,14 @@ class FlatIndexNode : public IndexNode {
             return Status::invalid_binary_set;
         }
 
-        MemoryIOReader reader(binary->data.get(), binary->size);
+        const auto& base_cfg = static_cast<const BaseConfig&>(*cfg);
+        zero_copy_ = base_cfg.enable_zero_copy.value();
+        auto reader = MakeFaissIndexReader(binary->data, binary->size, zero_copy_);
         if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
-            faiss::Index* index = faiss::read_index(&reader);
-            index_.reset(static_cast<IndexType*>(index));
+            return ResetIndex(faiss::read_index(reader.get()));
         }
         if constexpr (std::is_same<IndexType, faiss::IndexBinaryFlat>::value) {
-            faiss::IndexBinary* index = faiss::read_index_binary(&reader);
+            faiss::IndexBinary* index = faiss::read_index_binary(reader.get());
             index_.reset(static_cast<IndexType*>(index));
         }
         return Status::success;
@@ -339,14 +353,14 @@ class FlatIndexNode : public IndexNode {
     DeserializeFromFile(const std::string& filename, std::shared_ptr<Config> cfg) override {
         auto flat_cfg = static_cast<const knowhere::BaseConfig&>(*cfg);
 
+        zero_copy_ = false;
         int io_flags = 0;
         if (flat_cfg.enable_mmap.value()) {
             io_flags |= faiss::IO_FLAG_MMAP_IFC;
         }
 
         if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
-            faiss::Index* index = faiss::read_index(filename.data(), io_flags);
-            index_.reset(static_cast<IndexType*>(index));
+            return ResetIndex(faiss::read_index(filename.data(), io_flags));
         }
         if constexpr (std::is_same<IndexType, faiss::IndexBinaryFlat>::value) {
             faiss::IndexBinary* index = faiss::read_index_binary(filename.data(), io_flags);
@@ -380,6 +394,13 @@ class FlatIndexNode : public IndexNode {
         return index_->ntotal;
     }
 
+    std::vector<MemoryRegion>
+    GetMemoryRegions() const override {
+        std::vector<MemoryRegion> regions;
+        CollectFaissMemoryRegions(index_.get(), regions);
+        return regions;
+    }
+
     std::string
     Type() const override {
         if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
@@ -391,18 +412,237 @@ class FlatIndexNode : public IndexNode {
     }
 
  private:
-    std::unique_ptr<IndexType> index_;
-    std::shared_ptr<ThreadPool> search_pool_;
+    // rows of the base a part of a split query covers at least
+    static constexpr size_t kIntraQueryMinRows = 16384;
+    // rows of a typed dataset converted to fp32 at a time by Add()
+    static constexpr int64_t kAddBlockRows = 65536;
+
+    // takes the index read by faiss. FLAT indexes of fp16, bf16 and int8 vectors of versions before
+    // Version::GetFlatTypedStorageVersion() are built on fp32 copies of the vectors, these are encoded to the typed
+    // storage at load. So are the int8 ones stored with the codes shifted by 128 (QT_8bit_direct_signed).
+    Status
+    ResetIndex(faiss::Index* index) {
+        std::unique_ptr<faiss::Index> loaded(index);
+        if constexpr (kTypedStorage) {
+            if (auto flat = dynamic_cast<const faiss::IndexFlat*>(loaded.get())) {
+                LOG_KNOWHERE_INFO_ << "encoding a fp32 FLAT index of " << flat->ntotal << " vectors to "
+                                   << sizeof(DataType) << " bytes per dimension";
+                index_ = MakeTypedStorage<DataType>(flat->d, flat->metric_type, flat->is_cosine);
+                index_->add(flat->ntotal, flat->get_xb());
+                UpdateNorms();
+                return Status::success;
+            }
+            auto sq = dynamic_cast<const faiss::IndexScalarQuantizer*>(loaded.get());
+            if (sq == nullptr) {
+                LOG_KNOWHERE_ERROR_ << "Invalid binary set, not a FLAT index.";
+                return Status::invalid_binary_set;
+            }
+            if (sq->sq.qtype != TypedQuantizerType<DataType>()) {
+                LOG_KNOWHERE_INFO_ << "re-encoding a FLAT index of " << sq->ntotal
+                                   << " vectors stored as quantizer type " << sq->sq.qtype;
+                index_ = MakeTypedStorage<DataType>(sq->d, sq->metric_type, sq->is_cosine);
+                std::vector<float> block(std::min<int64_t>(kAddBlockRows, sq->ntotal) * sq->d);
+                for (int64_t begin = 0; begin < sq->ntotal; begin += kAddBlockRows) {
+                    auto count = std::min<int64_t>(kAddBlockRows, sq->ntotal - begin);
+                    sq->sa_decode(count, sq->codes.data() + begin * sq->code_size, block.data());
+                    index_->add(count, block.data());
+                }
+                UpdateNorms();
+                return Status::success;
+            }
+        } else if (dynamic_cast<faiss::IndexFlat*>(loaded.get()) == nullptr) {
+            LOG_KNOWHERE_ERROR_ << "Invalid binary set, not a fp32 FLAT index.";
+            return Status::invalid_binary_set;
+        }
+        index_.reset(static_cast<StorageType*>(loaded.release()));
+        UpdateNorms();
+        return Status::success;
+    }
+
+    // the L2 norms the typed cosine kernels take, kept next to the inverse norms of the cosine storage
+    void
+    UpdateNorms() {
+        if constexpr (kTypedStorage) {
+            if (auto cosine = dynamic_cast<const faiss::IndexScalarQuantizerCosine*>(index_.get())) {
+                norms_ = cosine->inverse_norms_storage.as_l2_norms();
+            }
+        }
+    }
+
+    // the codes of the fp16, bf16 and int8 quantizers are the vectors, the typed kernels read them in place
+    const DataType*
+    TypedVectors() const {
+        return reinterpret_cast<const DataType*>(index_->codes.data());
+    }
+
+    // top-k of a query over the rows [begin, end), ids relative to `begin`. The typed kernels divide by the query norm
+    // themselves.
+    void
+    TypedKnnOnRows(const DataType* query, size_t begin, size_t end, int64_t k, const BitsetView& bitset,
+                   float* distances, int64_t* ids) const {
+        const auto dim = index_->d;
+        const DataType* xb = TypedVectors() + begin * dim;
+        BitsetViewIDSelector bw_idselector(bitset, begin);
+        faiss::IDSelector* sel = (bitset.empty()) ? nullptr : &bw_idselector;
+        if (index_->metric_type != faiss::METRIC_INNER_PRODUCT) {
+            faiss::knn_L2sqr_typed(query, xb, dim, 1, end - begin, k, distances, ids, nullptr, sel);
+        } else if (index_->is_cosine) {
+            faiss::knn_cosine_typed(query, xb, norms_.data() + begin, dim, 1, end - begin, k, distances, ids, sel);
+        } else {
+            faiss::knn_inner_product_typed(query, xb, dim, 1, end - begin, k, distances, ids, sel);
+        }
+    }
+
+    // appends the rows of all the vectors within `radius` of a query to `distances` and `ids`
+    void
+    TypedRangeSearchOnRows(const DataType* query, float radius, const BitsetView& bitset, std::vector<float>& distances,
+                           std::vector<int64_t>& ids) const {
+        const auto dim = index_->d;
+        const auto nb = index_->ntotal;
+        faiss::RangeSearchResult res(1);
+        BitsetViewIDSelector bw_idselector(bitset);
+        faiss::IDSelector* sel = (bitset.empty()) ? nullptr : &bw_idselector;
+        if (index_->metric_type != faiss::METRIC_INNER_PRODUCT) {
+            faiss::range_search_L2sqr_typed(query, TypedVectors(), dim, 1, nb, radius, &res, sel);
+        } else if (index_->is_cosine) {
+            faiss::range_search_cosine_typed(query, TypedVectors(), norms_.data(), dim, 1, nb, radius, &res, sel);
+        } else {
+            faiss::range_search_inner_product_typed(query, TypedVectors(), dim, 1, nb, radius, &res, sel);
+        }
+        distances.assign(res.distances, res.distances + res.lims[1]);
+        ids.assign(res.labels, res.labels + res.lims[1]);
+    }
+
+    // searches into `ids` and `distances`, of k * nq entries each
+    Status
+    SearchImpl(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances, std::string* msg) const {
+        const FlatConfig& f_cfg = static_cast<const FlatConfig&>(*cfg);
+        bool is_cosine = IsMetricType(f_cfg.metric_type.value(), knowhere::metric::COSINE);
+
+        auto k = f_cfg.k.value();
+        auto nq = dataset->GetRows();
+        auto x = dataset->GetTensor();
+        auto dim = dataset->GetDim();
+
+        try {
+            auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
+            if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
+                // few queries against a large base, split the rows of each query across the idle threads
+                size_t splits = 1;
+                if (index_->metric_type == faiss::METRIC_L2 || index_->metric_type == faiss::METRIC_INNER_PRODUCT) {
+                    splits = search_pool->IntraQuerySplits(nq, index_->ntotal, kIntraQueryMinRows);
+                }
+                if (splits > 1) {
+                    return SplitSearch((const DataType*)x, nq, k, is_cosine, bitset, splits, distances, ids);
+                }
+            }
+            return search_pool->ParallelFor(0, nq, [&](int index) {
+                ThreadPool::ScopedSearchOmpSetter setter(1);
+                auto cur_ids = ids + k * index;
+                auto cur_dis = distances + k * index;
+
+                BitsetViewIDSelector bw_idselector(bitset);
+                faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+
+                if constexpr (kTypedStorage) {
+                    TypedKnnOnRows((const DataType*)x + dim * index, 0, index_->ntotal, k, bitset, cur_dis, cur_ids);
+                } else if constexpr (std::is_same<IndexType, faiss::IndexFlat>::value) {
+                    auto cur_query = (const DataType*)x + dim * index;
+                    std::unique_ptr<DataType[]> copied_query = nullptr;
+                    if (is_cosine) {
+                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                        cur_query = copied_query.get();
+                    }
+
+                    faiss::SearchParameters search_params;
+                    search_params.sel = id_selector;
+
+                    index_->search(1, cur_query, k, cur_dis, cur_ids, &search_params);
+                }
+                if constexpr (std::is_same<IndexType, faiss::IndexBinaryFlat>::value) {
+                    auto cur_i_dis = reinterpret_cast<int32_t*>(cur_dis);
+
+                    faiss::SearchParameters search_params;
+                    search_params.sel = id_selector;
+
+                    index_->search(1, (const uint8_t*)x + index * ((dim + 7) / 8), k, cur_i_dis, cur_ids,
+                                   &search_params);
+
+                    if (index_->metric_type == faiss::METRIC_Hamming) {
+                        for (int64_t j = 0; j < k; j++) {
+                            cur_dis[j] = static_cast<float>(cur_i_dis[j]);
+                        }
+                    }
+                }
+            });
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "error inner faiss: " << e.what();
+            if (msg != nullptr) {
+                *msg = e.what();
+            }
+            return Status::faiss_inner_error;
+        }
+    }
+
+    // IndexFlat::search() of `nq` queries, with the rows of each query split in `splits` parts that run in parallel
+    Status
+    SplitSearch(const DataType* x, int64_t nq, int64_t k, bool is_cosine, const BitsetView& bitset, size_t splits,
+                float* distances, int64_t* ids) const {
+        const auto dim = index_->d;
+        const auto is_ip = index_->metric_type == faiss::METRIC_INNER_PRODUCT;
+        return SplitTopKSearch(
+            ThreadPool::GetGlobalSearchThreadPool().get(), nq, splits, k, is_ip, distances, ids,
+            [&](size_t q, size_t part, float* part_dis, int64_t* part_ids) {
+                auto [begin, end] = SplitRange(index_->ntotal, splits, part);
+                auto cur_query = x + dim * q;
+
+                if constexpr (kTypedStorage) {
+                    TypedKnnOnRows(cur_query, begin, end, k, bitset, part_dis, part_ids);
+                } else {
+                    BitsetViewIDSelector bw_idselector(bitset, begin);
+                    faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+                    std::unique_ptr<float[]> copied_query = nullptr;
+                    if (is_cosine) {
+                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                        cur_query = copied_query.get();
+                    }
+                    auto part_xb = index_->get_xb() + begin * dim;
+                    if (!is_ip) {
+                        faiss::knn_L2sqr(cur_query, part_xb, dim, 1, end - begin, k, part_dis, part_ids, nullptr,
+                                         id_selector);
+                    } else if (index_->is_cosine) {
+                        faiss::knn_cosine(cur_query, part_xb, index_->get_norms() + begin, dim, 1, end - begin, k,
+                                          part_dis, part_ids, id_selector);
+                    } else {
+                        faiss::knn_inner_product(cur_query, part_xb, dim, 1, end - begin, k, part_dis, part_ids,
+                                                 id_selector);
+                    }
+                }
+                for (int64_t i = 0; i < k; ++i) {
+                    part_ids[i] = part_ids[i] == -1 ? -1 : part_ids[i] + begin;
+                }
+                return Status::success;
+            });
+    }
+
+    std::unique_ptr<StorageType> index_;
+    // the vectors are views into the binary set loaded with enable_zero_copy, the index cannot grow
+    bool zero_copy_ = false;
+    // L2 norms of the vectors of fp16, bf16 and int8 cosine indexes
+    std::vector<float> norms_;
 };
 
-KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(FLAT, FlatIndexNode,
-                                              knowhere::feature::NO_TRAIN | knowhere::feature::KNN |
-                                                  knowhere::feature::MMAP,
-                                              faiss::IndexFlat);
+// older versions keep building fp16, bf16 and int8 FLAT indexes on fp32 copies of the vectors
+KNOWHERE_VERSIONED_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(FLAT, FlatIndexNode,
+                                                        knowhere::feature::NO_TRAIN | knowhere::feature::KNN |
+                                                            knowhere::feature::MMAP,
+                                                        Version::GetFlatTypedStorageVersion(), faiss::IndexFlat);
 
-KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(FLAT, FlatIndexNode,
-                                        knowhere::feature::NO_TRAIN | knowhere::feature::KNN | knowhere::feature::MMAP,
-                                        faiss::IndexFlat);
+KNOWHERE_VERSIONED_MOCK_REGISTER_DENSE_INT_GLOBAL(FLAT, FlatIndexNode,
+                                                  knowhere::feature::NO_TRAIN | knowhere::feature::KNN |
+                                                      knowhere::feature::MMAP,
+                                                  Version::GetFlatTypedStorageVersion(), faiss::IndexFlat);
 
 KNOWHERE_SIMPLE_REGISTER_DENSE_BIN_GLOBAL(BINFLAT, FlatIndexNode,
                                           knowhere::feature::NO_TRAIN | knowhere::feature::KNN |
@@ -14,8 +14,12 @@
 #include <faiss/cppcontrib/knowhere/utils/Bitset.h>
 #include <faiss/utils/Heap.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <functional>
 #include <limits>
 #include <map>
@@ -29,9 +33,11 @@
 #include "faiss/IndexCosine.h"
 #include "faiss/IndexHNSW.h"
 #include "faiss/IndexRefine.h"
+#include "faiss/IndexScalarQuantizer.h"
 #include "faiss/impl/ScalarQuantizer.h"
 #include "faiss/impl/mapped_io.h"
 #include "faiss/index_io.h"
+#include "index/faiss_memory_regions.h"
 #include "index/hnsw/faiss_hnsw_config.h"
 #include "index/hnsw/hnsw.h"
 #include "index/hnsw/impl/DummyVisitor.h"
@@ -53,6 +59,7 @@
 #include "knowhere/log.h"
 #include "knowhere/range_util.h"
 #include "knowhere/utils.h"
+#include "simd/hook.h"
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
 #include "knowhere/prometheus_client.h"
@@ -63,9 +70,8 @@ namespace knowhere {
 //
 class BaseFaissIndexNode : public IndexNode {
  public:
-    BaseFaissIndexNode(const int32_t& /*version*/, const Object& object) {
+    BaseFaissIndexNode(const int32_t& version, const Object& object) : IndexNode(version) {
         build_pool = ThreadPool::GetGlobalBuildThreadPool();
-        search_pool = ThreadPool::GetGlobalSearchThreadPool();
     }
 
     bool
@@ -81,6 +87,7 @@ class BaseFaissIndexNode : public IndexNode {
     Train(const DataSetPtr dataset, std::shared_ptr<Config> cfg, bool use_knowhere_build_pool) override {
         // config
         const BaseConfig& base_cfg = static_cast<const FaissHnswConfig&>(*cfg);
+        zero_copy_ = false;
 
         // use build_pool_ to make sure the OMP threads spawned by index_->train etc
         // can inherit the low nice value of threads in build_pool_.
@@ -107,6 +114,10 @@ class BaseFaissIndexNode : public IndexNode {
 
     Status
     Add(const DataSetPtr dataset, std::shared_ptr<Config> cfg, bool use_knowhere_build_pool) override {
+        if (zero_copy_) {
+            LOG_KNOWHERE_ERROR_ << "Can not add data to an index loaded with enable_zero_copy.";
+            return Status::not_implemented;
+        }
         const BaseConfig& base_cfg = static_cast<const FaissHnswConfig&>(*cfg);
 
         // use build_pool_ to make sure the OMP threads spawned by index_->train etc
@@ -140,7 +151,8 @@ class BaseFaissIndexNode : public IndexNode {
 
  protected:
     std::shared_ptr<ThreadPool> build_pool;
-    std::shared_ptr<ThreadPool> search_pool;
+    // the graph and the vectors are views into the binary set loaded with enable_zero_copy, the index cannot grow
+    bool zero_copy_ = false;
 
     // train impl
     virtual Status
@@ -174,27 +186,32 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
 
     Status
     Serialize(BinarySet& binset) const override {
+        MemoryIOWriter writer;
+        auto status = SerializeToWriter(writer);
+        std::shared_ptr<uint8_t[]> data(writer.data());
+        if (status == Status::success) {
+            binset.Append(Type(), data, writer.tellg());
+        }
+        return status;
+    }
+
+    Status
+    SerializeToWriter(faiss::IOWriter& writer) const override {
         if (isIndexEmpty()) {
             return Status::empty_index;
         }
 
         try {
-            MemoryIOWriter writer;
             if (indexes.size() > 1) {
                 // this is a hack for compatibility, faiss index has 4-byte header to indicate index category
                 // create a new one to distinguish MV faiss hnsw from faiss hnsw
                 faiss::write_mv(&writer);
-                writeHeader(&writer);
+                writeHeader(&writer, writesIndexOffsets() ? getIndexOffsets() : std::vector<uint64_t>());
                 for (const auto& index : indexes) {
                     faiss::write_index(index.get(), &writer);
                 }
-
-                std::shared_ptr<uint8_t[]> data(writer.data());
-                binset.Append(Type(), data, writer.tellg());
             } else {
                 faiss::write_index(indexes[0].get(), &writer);
-                std::shared_ptr<uint8_t[]> data(writer.data());
-                binset.Append(Type(), data, writer.tellg());
             }
         } catch (const std::exception& e) {
             LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
@@ -212,23 +229,38 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
             return Status::invalid_binary_set;
         }
 
-        MemoryIOReader reader(binary->data.get(), binary->size);
+        const auto& base_cfg = static_cast<const BaseConfig&>(*config);
+        zero_copy_ = base_cfg.enable_zero_copy.value();
+        auto reader = MakeFaissIndexReader(binary->data, binary->size, zero_copy_);
         try {
             // this is a hack for compatibility, faiss index has 4-byte header to indicate index category
             // create a new one to distinguish MV faiss hnsw from faiss hnsw
-            bool is_mv = faiss::read_is_mv(&reader);
+            bool is_mv = faiss::read_is_mv(reader.get());
             if (is_mv) {
                 LOG_KNOWHERE_INFO_ << "start to load index by mv";
-                uint32_t v = readHeader(&reader);
+                std::vector<uint64_t> index_offsets;
+                uint32_t v = readHeader(reader.get(), index_offsets);
                 indexes.resize(v);
                 LOG_KNOWHERE_INFO_ << "read " << v << " mvs";
-                for (auto i = 0; i < v; ++i) {
-                    auto read_index = std::unique_ptr<faiss::Index>(faiss::read_index(&reader));
-                    indexes[i].reset(read_index.release());
+                if (index_offsets.empty()) {
+                    for (auto i = 0; i < v; ++i) {
+                        auto read_index = std::unique_ptr<faiss::Index>(faiss::read_index(reader.get()));
+                        indexes[i].reset(read_index.release());
+                    }
+                } else {
+                    if (!isValidIndexOffsets(index_offsets, binary->size)) {
+                        LOG_KNOWHERE_ERROR_ << "Invalid partition offsets in the header of the mv index";
+                        return Status::invalid_binary_set;
+                    }
+                    return readIndexesInParallel(0, [&](size_t i) {
+                        return MakeFaissIndexReader(binary->data, index_offsets[i + 1] - index_offsets[i], zero_copy_,
+                                                    index_offsets[i]);
+                    });
                 }
             } else {
-                reader.reset();
-                auto read_index = std::unique_ptr<faiss::Index>(faiss::read_index(&reader));
+                // read again from the start
+                reader = MakeFaissIndexReader(binary->data, binary->size, zero_copy_);
+                auto read_index = std::unique_ptr<faiss::Index>(faiss::read_index(reader.get()));
                 indexes[0].reset(read_index.release());
             }
         } catch (const std::exception& e) {
@@ -248,6 +280,7 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
     DeserializeFromFile(const std::string& filename, std::shared_ptr<Config> config) override {
         auto cfg = static_cast<const knowhere::BaseConfig&>(*config);
 
+        zero_copy_ = false;
         int io_flags = 0;
         if (cfg.enable_mmap.value()) {
             io_flags |= faiss::IO_FLAG_MMAP_IFC;
@@ -258,25 +291,45 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
             // create a new one to distinguish MV faiss hnsw from faiss hnsw
             bool is_mv = faiss::read_is_mv(filename.data());
             if (is_mv) {
-                auto read_index = [&](faiss::IOReader* r) {
+                // the partitions of a header of version 1 are read in parallel, each with its own reader
+                auto read_index = [&](faiss::IOReader* r, size_t file_size, auto&& make_reader) {
                     LOG_KNOWHERE_INFO_ << "start to load index by mv";
                     read_is_mv(r);
-                    uint32_t v = readHeader(r);
+                    std::vector<uint64_t> index_offsets;
+                    uint32_t v = readHeader(r, index_offsets);
                     LOG_KNOWHERE_INFO_ << "read " << v << " mvs";
                     indexes.resize(v);
-                    for (auto i = 0; i < v; ++i) {
-                        auto read_index = std::unique_ptr<faiss::Index>(faiss::read_index(r, io_flags));
-                        indexes[i].reset(read_index.release());
+                    if (index_offsets.empty()) {
+                        for (auto i = 0; i < v; ++i) {
+                            auto read_index = std::unique_ptr<faiss::Index>(faiss::read_index(r, io_flags));
+                            indexes[i].reset(read_index.release());
+                        }
+                        return Status::success;
                     }
+                    if (!isValidIndexOffsets(index_offsets, file_size)) {
+                        LOG_KNOWHERE_ERROR_ << "Invalid partition offsets in the header of the mv index " << filename;
+                        return Status::invalid_serialized_index_type;
+                    }
+                    return readIndexesInParallel(io_flags, [&](size_t i) { return make_reader(index_offsets[i]); });
                 };
                 if ((io_flags & faiss::IO_FLAG_MMAP_IFC) == faiss::IO_FLAG_MMAP_IFC) {
                     // enable mmap-supporting IOReader
                     auto owner = std::make_shared<faiss::MmappedFileMappingOwner>(filename.data());
                     faiss::MappedFileIOReader reader(owner);
-                    read_index(&reader);
+                    return read_index(&reader, owner->size(), [&](uint64_t offset) {
+                        auto partition_reader = std::make_unique<faiss::MappedFileIOReader>(owner);
+                        partition_reader->pos = offset;
+                        return partition_reader;
+                    });
                 } else {
                     faiss::FileIOReader reader(filename.data());
-                    read_index(&reader);
+                    return read_index(&reader, std::filesystem::file_size(filename), [&](uint64_t offset) {
+                        auto partition_reader = std::make_unique<faiss::FileIOReader>(filename.data());
+                        if (fseek(partition_reader->f, offset, SEEK_SET) != 0) {
+                            throw std::runtime_error("failed to seek in " + filename + ": " + strerror(errno));
+                        }
+                        return partition_reader;
+                    });
                 }
             } else {
                 auto read_index = std::unique_ptr<faiss::Index>(faiss::read_index(filename.data(), io_flags));
@@ -319,6 +372,15 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
         return count;
     }
 
+    std::vector<MemoryRegion>
+    GetMemoryRegions() const override {
+        std::vector<MemoryRegion> regions;
+        for (const auto& index : indexes) {
+            CollectFaissMemoryRegions(index.get(), regions);
+        }
+        return regions;
+    }
+
     int64_t
     Size() const override {
         if (isIndexEmpty()) {
@@ -371,9 +433,52 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
         return std::distance(index_rows_sum.begin(), it) - 1;
     }
 
+    // the offsets of the partitions in the serialized index, which start with the IHMV fourcc and the header, followed
+    // by the end of the last partition
+    std::vector<uint64_t>
+    getIndexOffsets() const {
+        std::vector<uint64_t> index_offsets(indexes.size() + 1, 0);
+        faiss::cppcontrib::knowhere::CountSizeIOWriter header_size;
+        faiss::write_mv(&header_size);
+        writeHeader(&header_size, index_offsets);
+        index_offsets[0] = header_size.total_size;
+        for (size_t i = 0; i < indexes.size(); ++i) {
+            faiss::cppcontrib::knowhere::CountSizeIOWriter index_size;
+            faiss::write_index(indexes[i].get(), &index_size);
+            index_offsets[i + 1] = index_offsets[i] + index_size.total_size;
+        }
+        return index_offsets;
+    }
+
+    bool
+    isValidIndexOffsets(const std::vector<uint64_t>& index_offsets, size_t total_size) const {
+        if (index_offsets.size() != indexes.size() + 1 || index_offsets.back() > total_size) {
+            return false;
+        }
+        return std::is_sorted(index_offsets.begin(), index_offsets.end());
+    }
+
+    // reads the partitions on the build pool, `make_reader(i)` returns a reader positioned at partition i
+    template <typename MakeReader>
+    Status
+    readIndexesInParallel(int io_flags, MakeReader&& make_reader) {
+        auto pool = ThreadPool::GetGlobalBuildThreadPool();
+        return pool->ParallelFor(0, indexes.size(), [&](size_t i) {
+            auto reader = make_reader(i);
+            indexes[i].reset(faiss::read_index(reader.get(), io_flags));
+        });
+    }
+
+    // version 1 appends the offsets of the partitions, see getIndexOffsets(). Indexes of an older index version keep
+    // the version 0 header, which older readers understand.
+    bool
+    writesIndexOffsets() const {
+        return Version::GetMvIndexOffsetsVersion() <= this->version_;
+    }
+
     void
-    writeHeader(faiss::IOWriter* f) const {
-        uint32_t version = 0;
+    writeHeader(faiss::IOWriter* f, const std::vector<uint64_t>& index_offsets) const {
+        uint32_t version = writesIndexOffsets() ? 1 : 0;
         faiss::write_value(version, f);
         uint32_t size = indexes.size();
         faiss::write_value(size, f);
@@ -384,11 +489,15 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
         }
         faiss::write_vector(index_rows_sum, f);
         faiss::write_vector(label_to_internal_offset, f);
+        if (version >= 1) {
+            faiss::write_vector(index_offsets, f);
+        }
     }
 
+    // `index_offsets` is left empty for the headers of version 0, whose partitions are read sequentially
     uint32_t
-    readHeader(faiss::IOReader* f) {
-        [[maybe_unused]] uint32_t version = faiss::read_value(f);
+    readHeader(faiss::IOReader* f, std::vector<uint64_t>& index_offsets) {
+        uint32_t version = faiss::read_value(f);
         uint32_t size = faiss::read_value(f);
         uint32_t cluster_size = faiss::read_value(f);
         labels.resize(cluster_size);
@@ -398,6 +507,10 @@ class BaseFaissRegularIndexNode : public BaseFaissIndexNode {
         }
         faiss::read_vector(index_rows_sum, f);
         faiss::read_vector(label_to_internal_offset, f);
+        index_offsets.clear();
+        if (version >= 1) {
+            faiss::read_vector(index_offsets, f);
+        }
         return size;
     }
 
@@ -657,6 +770,87 @@ storage_distance_computer(const faiss::Index* storage) {
     }
 }
 
+// distances of a fp32 query to the vectors of a QT_fp16 or QT_bf16 IndexScalarQuantizer, whose codes are the vectors
+// themselves, without decoding them through the quantizer
+template <typename DataType>
+struct TypedCodesDistanceComputer : faiss::DistanceComputer {
+    const DataType* codes;
+    size_t dim;
+    bool is_ip;
+    const float* q = nullptr;
+
+    explicit TypedCodesDistanceComputer(const faiss::IndexScalarQuantizer* index)
+        : codes(reinterpret_cast<const DataType*>(index->codes.data())),
+          dim(index->d),
+          is_ip(index->metric_type == faiss::METRIC_INNER_PRODUCT) {
+    }
+
+    void
+    set_query(const float* x) override {
+        q = x;
+    }
+
+    float
+    operator()(faiss::idx_t i) override {
+        if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+            return is_ip ? faiss::fvec_fp16_inner_product(q, codes + i * dim, dim)
+                         : faiss::fvec_fp16_L2sqr(q, codes + i * dim, dim);
+        } else {
+            return is_ip ? faiss::fvec_bf16_inner_product(q, codes + i * dim, dim)
+                         : faiss::fvec_bf16_L2sqr(q, codes + i * dim, dim);
+        }
+    }
+
+    void
+    distances_batch_4(const faiss::idx_t idx0, const faiss::idx_t idx1, const faiss::idx_t idx2,
+                      const faiss::idx_t idx3, float& dis0, float& dis1, float& dis2, float& dis3) override {
+        const DataType* y0 = codes + idx0 * dim;
+        const DataType* y1 = codes + idx1 * dim;
+        const DataType* y2 = codes + idx2 * dim;
+        const DataType* y3 = codes + idx3 * dim;
+        if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+            if (is_ip) {
+                faiss::fvec_fp16_inner_product_batch_4(q, y0, y1, y2, y3, dim, dis0, dis1, dis2, dis3);
+            } else {
+                faiss::fvec_fp16_L2sqr_batch_4(q, y0, y1, y2, y3, dim, dis0, dis1, dis2, dis3);
+            }
+        } else {
+            if (is_ip) {
+                faiss::fvec_bf16_inner_product_batch_4(q, y0, y1, y2, y3, dim, dis0, dis1, dis2, dis3);
+            } else {
+                faiss::fvec_bf16_L2sqr_batch_4(q, y0, y1, y2, y3, dim, dis0, dis1, dis2, dis3);
+            }
+        }
+    }
+
+    float
+    symmetric_dis(faiss::idx_t i, faiss::idx_t j) override {
+        if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+            return is_ip ? faiss::fp16_vec_inner_product(codes + i * dim, codes + j * dim, dim)
+                         : faiss::fp16_vec_L2sqr(codes + i * dim, codes + j * dim, dim);
+        } else {
+            return is_ip ? faiss::bf16_vec_inner_product(codes + i * dim, codes + j * dim, dim)
+                         : faiss::bf16_vec_L2sqr(codes + i * dim, codes + j * dim, dim);
+        }
+    }
+};
+
+// the distance computer of a refine index, fp16 and bf16 vectors are compared to the fp32 query directly
+faiss::DistanceComputer*
+refine_distance_computer(const faiss::Index* refine_index) {
+    const auto* index_sq = dynamic_cast<const faiss::IndexScalarQuantizer*>(refine_index);
+    if (index_sq != nullptr && dynamic_cast<const faiss::HasInverseL2Norms*>(refine_index) == nullptr &&
+        (index_sq->metric_type == faiss::METRIC_L2 || index_sq->metric_type == faiss::METRIC_INNER_PRODUCT)) {
+        if (index_sq->sq.qtype == faiss::ScalarQuantizer::QT_fp16) {
+            return new TypedCodesDistanceComputer<knowhere::fp16>(index_sq);
+        }
+        if (index_sq->sq.qtype == faiss::ScalarQuantizer::QT_bf16) {
+            return new TypedCodesDistanceComputer<knowhere::bf16>(index_sq);
+        }
+    }
+    return refine_index->get_distance_computer();
+}
+
 // there are chances that each partition split by scalar distribution is too small that we could not even train pq on it
 // bcz 256 points are needed for a 8-bit pq training in faiss
 // combine some small partitions to get a bigger one
@@ -697,6 +891,15 @@ combine_partitions(const std::vector<std::vector<uint32_t>>& scalar_info, const
     return res;
 }
 
+// the error of a search into caller-provided buffers, which may have no use for the message
+Status
+search_error(std::string* msg, const std::string& what, Status status) {
+    if (msg != nullptr) {
+        *msg = what;
+    }
+    return status;
+}
+
 }  // namespace
 
 // Contains an iterator state
@@ -794,12 +997,12 @@ class FaissHnswIterator : public IndexIterator {
                         std::unique_ptr<faiss::DistanceComputer>(new faiss::WithCosineNormDistanceComputer(
                             has_l2_norms->get_inverse_l2_norms(), index->d,
                             std::unique_ptr<faiss::DistanceComputer>(
-                                index_refine->refine_index->get_distance_computer())));
+                                refine_distance_computer(index_refine->refine_index))));
                 } else {
                     // use it as is
                     // DO NOT WRAP A SIGN, by design
                     workspace.qdis_refine =
-                        std::unique_ptr<faiss::DistanceComputer>(index_refine->refine_index->get_distance_computer());
+                        std::unique_ptr<faiss::DistanceComputer>(refine_distance_computer(index_refine->refine_index));
                 }
             } else {
                 // the refine is not needed
@@ -1142,6 +1345,49 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
 
     expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override {
+        const auto& hnsw_cfg = static_cast<const FaissHnswConfig&>(*cfg);
+        const auto rows = dataset->GetRows();
+        const auto k = hnsw_cfg.k.value();
+        feder::hnsw::FederResultUniq feder_result;
+        if (hnsw_cfg.trace_visit.value()) {
+            if (rows != 1) {
+                return expected<DataSetPtr>::Err(Status::invalid_args, "a single query vector is required");
+            }
+            feder_result = std::make_unique<feder::hnsw::FederResult>();
+        }
+
+        auto ids = std::make_unique<faiss::idx_t[]>(rows * k);
+        auto distances = std::make_unique<float[]>(rows * k);
+        std::string msg;
+        auto status =
+            SearchImpl(dataset, std::move(cfg), bitset, ids.get(), distances.get(), feder_result.get(), &msg);
+        if (status != Status::success) {
+            return expected<DataSetPtr>::Err(status, msg);
+        }
+
+        auto res = GenResultDataSet(rows, k, std::move(ids), std::move(distances));
+
+        // set visit_info json string into result dataset
+        if (feder_result != nullptr) {
+            Json json_visit_info, json_id_set;
+            nlohmann::to_json(json_visit_info, feder_result->visit_info_);
+            nlohmann::to_json(json_id_set, feder_result->id_set_);
+            res->SetJsonInfo(json_visit_info.dump());
+            res->SetJsonIdSet(json_id_set.dump());
+        }
+
+        return res;
+    }
+
+    // the visits are not traced, there is no result set to report them in
+    Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override {
+        return SearchImpl(dataset, std::move(cfg), bitset, ids, distances, nullptr, nullptr);
+    }
+
+    expected<DataSetPtr>
+    RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override {
         if (this->indexes.empty()) {
             return expected<DataSetPtr>::Err(Status::empty_index, "index not loaded");
         }
@@ -1159,11 +1405,16 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         const auto* data = dataset->GetTensor();
 
         const auto hnsw_cfg = static_cast<const FaissHnswConfig&>(*cfg);
-        const auto k = hnsw_cfg.k.value();
         auto index_id = getIndexToSearchByScalarInfo(hnsw_cfg, bitset);
         if (index_id < 0) {
             return expected<DataSetPtr>::Err(Status::invalid_args, "partition key value not correctly set");
         }
+
+        const bool is_similarity_metric = faiss::is_similarity_metric(indexes[index_id]->metric_type);
+
+        const float radius = hnsw_cfg.radius.value();
+        const float range_filter = hnsw_cfg.range_filter.value();
+
         feder::hnsw::FederResultUniq feder_result;
         if (hnsw_cfg.trace_visit.value()) {
             if (rows != 1) {
@@ -1173,14 +1424,14 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         }
 
         // check for brute-force search
-        auto whether_bf_search = WhetherPerformBruteForceSearch(indexes[index_id].get(), hnsw_cfg, bitset);
+        auto whether_bf_search = WhetherPerformBruteForceRangeSearch(indexes[index_id].get(), hnsw_cfg, bitset);
 
         if (!whether_bf_search.has_value()) {
-            return expected<DataSetPtr>::Err(Status::invalid_args, "k parameter is missing");
+            return expected<DataSetPtr>::Err(Status::invalid_args, "ef parameter is missing");
         }
 
         // whether a user wants a refine
-        const bool whether_to_enable_refine = hnsw_cfg.refine_k.has_value();
+        const bool whether_to_enable_refine = true;
 
         // set up an index wrapper
         auto [index_wrapper, is_refined] = create_conditional_hnsw_wrapper(
@@ -1190,22 +1441,11 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
             return expected<DataSetPtr>::Err(Status::invalid_args, "an input index seems to be unrelated to HNSW");
         }
 
-        // set up a bf wrapper as fallback
-        std::unique_ptr<faiss::Index> bf_index_wrapper = nullptr;
-        faiss::Index* bf_index_wrapper_ptr = nullptr;
-        if (!whether_bf_search.value_or(false)) {
-            std::tie(bf_index_wrapper, is_refined) =
-                create_conditional_hnsw_wrapper(indexes[index_id].get(), hnsw_cfg, true, whether_to_enable_refine);
-            if (bf_index_wrapper == nullptr) {
-                return expected<DataSetPtr>::Err(Status::invalid_args, "an input index seems to be unrelated to HNSW");
-            }
-            bf_index_wrapper_ptr = bf_index_wrapper.get();
-        }
-
         faiss::Index* index_wrapper_ptr = index_wrapper.get();
 
         // set up faiss search parameters
         knowhere::SearchParametersHNSWWrapper hnsw_search_params;
+
         if (hnsw_cfg.ef.has_value()) {
             hnsw_search_params.efSearch = hnsw_cfg.ef.value();
         }
@@ -1231,112 +1471,95 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         }
         hnsw_search_params.sel = id_selector;
 
+        ////////////////////////////////////////////////////////////////
         // run
-        auto ids = std::make_unique<faiss::idx_t[]>(rows * k);
-        auto distances = std::make_unique<float[]>(rows * k);
+        std::vector<std::vector<int64_t>> result_id_array(rows);
+        std::vector<std::vector<float>> result_dist_array(rows);
 
-        try {
-            std::vector<folly::Future<folly::Unit>> futs;
-            futs.reserve(rows);
-
-            for (int64_t i = 0; i < rows; ++i) {
-                futs.emplace_back(search_pool->push([&, idx = i, is_refined = is_refined,
-                                                     index_wrapper_ptr = index_wrapper_ptr,
-                                                     bf_index_wrapper_ptr = bf_index_wrapper_ptr]() {
-                    // 1 thread per element
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
-
-                    // set up a query
-                    const float* cur_query = nullptr;
-
-                    std::vector<float> cur_query_tmp(dim);
-                    if (data_format == DataFormatEnum::fp32) {
-                        cur_query = (const float*)data + idx * dim;
-                    } else {
-                        convert_rows_to_fp32(data, cur_query_tmp.data(), data_format, idx, 1, dim);
-                        cur_query = cur_query_tmp.data();
-                    }
+        auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
 
-                    // set up local results
-                    faiss::idx_t* const __restrict local_ids = ids.get() + k * idx;
-                    float* const __restrict local_distances = distances.get() + k * idx;
-
-                    // check if we need to perform a brute-force search bcz of the lack of results
-                    auto bf_search_needed = [&]() -> bool {
-                        size_t real_topk = 0;
-                        for (auto j = 0; j < k; ++j) {
-                            if (local_ids[j] < 0) {
-                                continue;
-                            }
-                            real_topk++;
-                        }
-                        if (real_topk < k && real_topk < bitset.size() - bitset.count() &&
-                            bf_index_wrapper_ptr != nullptr) {
-                            return true;
-                        }
-                        return false;
-                    };
-
-                    // perform the search
-                    if (is_refined) {
-                        faiss::IndexRefineSearchParameters refine_params;
-                        refine_params.k_factor = hnsw_cfg.refine_k.value_or(1);
-                        // a refine procedure itself does not need to care about filtering
-                        refine_params.sel = nullptr;
-                        refine_params.base_index_params = &hnsw_search_params;
-
-                        index_wrapper_ptr->search(1, cur_query, k, local_distances, local_ids, &refine_params);
-                        if (bf_search_needed()) {
-                            bf_index_wrapper_ptr->search(1, cur_query, k, local_distances, local_ids, &refine_params);
-                        }
-                    } else {
-                        index_wrapper_ptr->search(1, cur_query, k, local_distances, local_ids, &hnsw_search_params);
-                        if (bf_search_needed()) {
-                            bf_index_wrapper_ptr->search(1, cur_query, k, local_distances, local_ids,
-                                                         &hnsw_search_params);
-                        }
-                    }
+        // a sequential version
+        search_pool->ParallelFor(0, rows, [&, is_refined = is_refined,
+                                           index_wrapper_ptr = index_wrapper_ptr](int64_t idx) {
+            // 1 thread per element
+            ThreadPool::ScopedSearchOmpSetter setter(1);
 
-                    if (!labels.empty()) {
-                        for (auto j = 0; j < k; ++j) {
-                            local_ids[j] = local_ids[j] < 0 ? local_ids[j] : labels[index_id]->operator[](local_ids[j]);
-                        }
-                    }
-                }));
+            // set up a query
+            const float* cur_query = nullptr;
+
+            std::vector<float> cur_query_tmp(dim);
+            if (data_format == DataFormatEnum::fp32) {
+                cur_query = (const float*)data + idx * dim;
+            } else {
+                convert_rows_to_fp32(data, cur_query_tmp.data(), data_format, idx, 1, dim);
+                cur_query = cur_query_tmp.data();
             }
 
-            // wait for the completion
-            WaitAllSuccess(futs);
-        } catch (const std::exception& e) {
-            LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
-            return expected<DataSetPtr>::Err(Status::faiss_inner_error, e.what());
-        }
+            // initialize a buffer
+            faiss::RangeSearchResult res(1);
 
-        auto res = GenResultDataSet(rows, k, std::move(ids), std::move(distances));
+            // perform the search
+            if (is_refined) {
+                faiss::IndexRefineSearchParameters refine_params;
+                refine_params.k_factor = hnsw_cfg.refine_k.value_or(1);
+                // a refine procedure itself does not need to care about filtering
+                refine_params.sel = nullptr;
+                refine_params.base_index_params = &hnsw_search_params;
 
-        // set visit_info json string into result dataset
-        if (feder_result != nullptr) {
-            Json json_visit_info, json_id_set;
-            nlohmann::to_json(json_visit_info, feder_result->visit_info_);
-            nlohmann::to_json(json_id_set, feder_result->id_set_);
-            res->SetJsonInfo(json_visit_info.dump());
-            res->SetJsonIdSet(json_id_set.dump());
-        }
+                index_wrapper_ptr->range_search(1, cur_query, radius, &res, &refine_params);
+            } else {
+                index_wrapper_ptr->range_search(1, cur_query, radius, &res, &hnsw_search_params);
+            }
 
-        return res;
+            // post-process
+            const size_t elem_cnt = res.lims[1];
+            result_dist_array[idx].resize(elem_cnt);
+            result_id_array[idx].resize(elem_cnt);
+
+            if (labels.empty()) {
+                for (size_t j = 0; j < elem_cnt; j++) {
+                    result_dist_array[idx][j] = res.distances[j];
+                    result_id_array[idx][j] = res.labels[j];
+                }
+            } else {
+                for (size_t j = 0; j < elem_cnt; j++) {
+                    result_dist_array[idx][j] = res.distances[j];
+                    result_id_array[idx][j] =
+                        res.labels[j] < 0 ? res.labels[j] : labels[index_id]->operator[](res.labels[j]);
+                }
+            }
+
+            if (hnsw_cfg.range_filter.value() != defaultRangeFilter) {
+                FilterRangeSearchResultForOneNq(result_dist_array[idx], result_id_array[idx],
+                                                is_similarity_metric, radius, range_filter);
+            }
+        });
+
+        //
+        RangeSearchResult range_search_result =
+            GetRangeSearchResult(result_dist_array, result_id_array, is_similarity_metric, rows, radius, range_filter);
+
+        return GenResultDataSet(rows, std::move(range_search_result));
     }
 
-    expected<DataSetPtr>
-    RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override {
+ protected:
+    DataFormatEnum data_format;
+
+    std::vector<std::vector<int>> tmp_combined_scalar_ids;
+
+    // searches into `ids` and `distances`, of k * rows entries each, and records the visits into `feder_result` if set
+    Status
+    SearchImpl(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, faiss::idx_t* ids,
+               float* distances, feder::hnsw::FederResult* feder_result, std::string* msg) const {
         if (this->indexes.empty()) {
-            return expected<DataSetPtr>::Err(Status::empty_index, "index not loaded");
+            return search_error(msg, "index not loaded", Status::empty_index);
         }
         for (const auto& index : indexes) {
             if (index == nullptr) {
-                return expected<DataSetPtr>::Err(Status::empty_index, "index not loaded");
+                return search_error(msg, "index not loaded", Status::empty_index);
             }
             if (!index->is_trained) {
-                return expected<DataSetPtr>::Err(Status::index_not_trained, "index not trained");
+                return search_error(msg, "index not trained", Status::index_not_trained);
             }
         }
 
@@ -1345,47 +1568,45 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         const auto* data = dataset->GetTensor();
 
         const auto hnsw_cfg = static_cast<const FaissHnswConfig&>(*cfg);
+        const auto k = hnsw_cfg.k.value();
         auto index_id = getIndexToSearchByScalarInfo(hnsw_cfg, bitset);
         if (index_id < 0) {
-            return expected<DataSetPtr>::Err(Status::invalid_args, "partition key value not correctly set");
+            return search_error(msg, "partition key value not correctly set", Status::invalid_args);
         }
-
-        const bool is_similarity_metric = faiss::is_similarity_metric(indexes[index_id]->metric_type);
-
-        const float radius = hnsw_cfg.radius.value();
-        const float range_filter = hnsw_cfg.range_filter.value();
-
-        feder::hnsw::FederResultUniq feder_result;
-        if (hnsw_cfg.trace_visit.value()) {
-            if (rows != 1) {
-                return expected<DataSetPtr>::Err(Status::invalid_args, "a single query vector is required");
-            }
-            feder_result = std::make_unique<feder::hnsw::FederResult>();
-        }
-
         // check for brute-force search
-        auto whether_bf_search = WhetherPerformBruteForceRangeSearch(indexes[index_id].get(), hnsw_cfg, bitset);
+        auto whether_bf_search = WhetherPerformBruteForceSearch(indexes[index_id].get(), hnsw_cfg, bitset);
 
         if (!whether_bf_search.has_value()) {
-            return expected<DataSetPtr>::Err(Status::invalid_args, "ef parameter is missing");
+            return search_error(msg, "k parameter is missing", Status::invalid_args);
         }
 
         // whether a user wants a refine
-        const bool whether_to_enable_refine = true;
+        const bool whether_to_enable_refine = hnsw_cfg.refine_k.has_value();
 
         // set up an index wrapper
         auto [index_wrapper, is_refined] = create_conditional_hnsw_wrapper(
             indexes[index_id].get(), hnsw_cfg, whether_bf_search.value_or(false), whether_to_enable_refine);
 
         if (index_wrapper == nullptr) {
-            return expected<DataSetPtr>::Err(Status::invalid_args, "an input index seems to be unrelated to HNSW");
+            return search_error(msg, "an input index seems to be unrelated to HNSW", Status::invalid_args);
+        }
+
+        // set up a bf wrapper as fallback
+        std::unique_ptr<faiss::Index> bf_index_wrapper = nullptr;
+        faiss::Index* bf_index_wrapper_ptr = nullptr;
+        if (!whether_bf_search.value_or(false)) {
+            std::tie(bf_index_wrapper, is_refined) =
+                create_conditional_hnsw_wrapper(indexes[index_id].get(), hnsw_cfg, true, whether_to_enable_refine);
+            if (bf_index_wrapper == nullptr) {
+                return search_error(msg, "an input index seems to be unrelated to HNSW", Status::invalid_args);
+            }
+            bf_index_wrapper_ptr = bf_index_wrapper.get();
         }
 
         faiss::Index* index_wrapper_ptr = index_wrapper.get();
 
         // set up faiss search parameters
         knowhere::SearchParametersHNSWWrapper hnsw_search_params;
-
         if (hnsw_cfg.ef.has_value()) {
             hnsw_search_params.efSearch = hnsw_cfg.ef.value();
         }
@@ -1393,7 +1614,7 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         // do not collect HNSW stats
         hnsw_search_params.hnsw_stats = nullptr;
         // set up feder
-        hnsw_search_params.feder = feder_result.get();
+        hnsw_search_params.feder = feder_result;
         // set up kAlpha
         hnsw_search_params.kAlpha = bitset.filter_ratio() * 0.7f;
 
@@ -1411,91 +1632,79 @@ class BaseFaissRegularIndexHNSWNode : public BaseFaissRegularIndexNode {
         }
         hnsw_search_params.sel = id_selector;
 
-        ////////////////////////////////////////////////////////////////
         // run
-        std::vector<std::vector<int64_t>> result_id_array(rows);
-        std::vector<std::vector<float>> result_dist_array(rows);
+        try {
+            auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
 
-        std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(rows);
+            return search_pool->ParallelFor(0, rows,
+                                            [&, is_refined = is_refined, index_wrapper_ptr = index_wrapper_ptr,
+                                             bf_index_wrapper_ptr = bf_index_wrapper_ptr](int64_t idx) {
+                // 1 thread per element
+                ThreadPool::ScopedSearchOmpSetter setter(1);
 
-        // a sequential version
-        for (int64_t i = 0; i < rows; ++i) {
-            // const int64_t idx = i;
-            // {
+                // set up a query
+                const float* cur_query = nullptr;
 
-            futs.emplace_back(
-                search_pool->push([&, idx = i, is_refined = is_refined, index_wrapper_ptr = index_wrapper_ptr] {
-                    // 1 thread per element
-                    ThreadPool::ScopedSearchOmpSetter setter(1);
+                std::vector<float> cur_query_tmp(dim);
+                if (data_format == DataFormatEnum::fp32) {
+                    cur_query = (const float*)data + idx * dim;
+                } else {
+                    convert_rows_to_fp32(data, cur_query_tmp.data(), data_format, idx, 1, dim);
+                    cur_query = cur_query_tmp.data();
+                }
 
-                    // set up a query
-                    const float* cur_query = nullptr;
+                // set up local results
+                faiss::idx_t* const __restrict local_ids = ids + k * idx;
+                float* const __restrict local_distances = distances + k * idx;
 
-                    std::vector<float> cur_query_tmp(dim);
-                    if (data_format == DataFormatEnum::fp32) {
-                        cur_query = (const float*)data + idx * dim;
-                    } else {
-                        convert_rows_to_fp32(data, cur_query_tmp.data(), data_format, idx, 1, dim);
-                        cur_query = cur_query_tmp.data();
+                // check if we need to perform a brute-force search bcz of the lack of results
+                auto bf_search_needed = [&]() -> bool {
+                    size_t real_topk = 0;
+                    for (auto j = 0; j < k; ++j) {
+                        if (local_ids[j] < 0) {
+                            continue;
+                        }
+                        real_topk++;
                     }
-
-                    // initialize a buffer
-                    faiss::RangeSearchResult res(1);
-
-                    // perform the search
-                    if (is_refined) {
-                        faiss::IndexRefineSearchParameters refine_params;
-                        refine_params.k_factor = hnsw_cfg.refine_k.value_or(1);
-                        // a refine procedure itself does not need to care about filtering
-                        refine_params.sel = nullptr;
-                        refine_params.base_index_params = &hnsw_search_params;
-
-                        index_wrapper_ptr->range_search(1, cur_query, radius, &res, &refine_params);
-                    } else {
-                        index_wrapper_ptr->range_search(1, cur_query, radius, &res, &hnsw_search_params);
+                    if (real_topk < k && real_topk < bitset.size() - bitset.count() &&
+                        bf_index_wrapper_ptr != nullptr) {
+                        return true;
                     }
+                    return false;
+                };
 
-                    // post-process
-                    const size_t elem_cnt = res.lims[1];
-                    result_dist_array[idx].resize(elem_cnt);
-                    result_id_array[idx].resize(elem_cnt);
-
-                    if (labels.empty()) {
-                        for (size_t j = 0; j < elem_cnt; j++) {
-                            result_dist_array[idx][j] = res.distances[j];
-                            result_id_array[idx][j] = res.labels[j];
-                        }
-                    } else {
-                        for (size_t j = 0; j < elem_cnt; j++) {
-                            result_dist_array[idx][j] = res.distances[j];
-                            result_id_array[idx][j] =
-                                res.labels[j] < 0 ? res.labels[j] : labels[index_id]->operator[](res.labels[j]);
-                        }
+                // perform the search
+                if (is_refined) {
+                    faiss::IndexRefineSearchParameters refine_params;
+                    refine_params.k_factor = hnsw_cfg.refine_k.value_or(1);
+                    // a refine procedure itself does not need to care about filtering
+                    refine_params.sel = nullptr;
+                    refine_params.base_index_params = &hnsw_search_params;
+
+                    index_wrapper_ptr->search(1, cur_query, k, local_distances, local_ids, &refine_params);
+                    if (bf_search_needed()) {
+                        bf_index_wrapper_ptr->search(1, cur_query, k, local_distances, local_ids, &refine_params);
                     }
+                } else {
+                    index_wrapper_ptr->search(1, cur_query, k, local_distances, local_ids, &hnsw_search_params);
+                    if (bf_search_needed()) {
+                        bf_index_wrapper_ptr->search(1, cur_query, k, local_distances, local_ids,
+                                                     &hnsw_search_params);
+                    }
+                }
 
-                    if (hnsw_cfg.range_filter.value() != defaultRangeFilter) {
-                        FilterRangeSearchResultForOneNq(result_dist_array[idx], result_id_array[idx],
-                                                        is_similarity_metric, radius, range_filter);
+                if (!labels.empty()) {
+                    for (auto j = 0; j < k; ++j) {
+                        local_ids[j] = local_ids[j] < 0 ? local_ids[j] : labels[index_id]->operator[](local_ids[j]);
                     }
-                }));
+                }
+            });
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
+            return search_error(msg, e.what(), Status::faiss_inner_error);
         }
-
-        // wait for the completion
-        WaitAllSuccess(futs);
-
-        //
-        RangeSearchResult range_search_result =
-            GetRangeSearchResult(result_dist_array, result_id_array, is_similarity_metric, rows, radius, range_filter);
-
-        return GenResultDataSet(rows, std::move(range_search_result));
     }
 
- protected:
-    DataFormatEnum data_format;
-
-    std::vector<std::vector<int>> tmp_combined_scalar_ids;
-
     Status
     AddInternal(const DataSetPtr dataset, const Config&) override {
         if (isIndexEmpty()) {
@@ -1903,6 +2112,15 @@ class HNSWIndexNodeWithFallback : public IndexNode {
         }
     }
 
+    Status
+    SerializeToWriter(faiss::IOWriter& writer) const override {
+        if (use_base_index) {
+            return base_index->SerializeToWriter(writer);
+        } else {
+            return fallback_search_index->SerializeToWriter(writer);
+        }
+    }
+
     Status
     Deserialize(const BinarySet& binset, std::shared_ptr<Config> config) override {
         if (use_base_index) {
@@ -1948,6 +2166,15 @@ class HNSWIndexNodeWithFallback : public IndexNode {
         }
     }
 
+    std::vector<MemoryRegion>
+    GetMemoryRegions() const override {
+        if (use_base_index) {
+            return base_index->GetMemoryRegions();
+        } else {
+            return fallback_search_index->GetMemoryRegions();
+        }
+    }
+
     std::string
     Type() const override {
         if (use_base_index) {
@@ -1984,6 +2211,16 @@ class HNSWIndexNodeWithFallback : public IndexNode {
         }
     }
 
+    Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override {
+        if (use_base_index) {
+            return base_index->SearchInto(dataset, std::move(cfg), bitset, ids, distances);
+        } else {
+            return fallback_search_index->SearchInto(dataset, std::move(cfg), bitset, ids, distances);
+        }
+    }
+
     expected<DataSetPtr>
     RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override {
         if (use_base_index) {
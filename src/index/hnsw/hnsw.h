@@ -39,7 +39,6 @@ class HnswIndexNode : public IndexNode {
  public:
     using DistType = float;
     HnswIndexNode(const int32_t& /*version*/, const Object& object) : index_(nullptr) {
-        search_pool_ = ThreadPool::GetGlobalSearchThreadPool();
     }
 
     Status
@@ -224,27 +223,23 @@ class HnswIndexNode : public IndexNode {
         bool transform =
             (index_->metric_type_ == hnswlib::Metric::INNER_PRODUCT || index_->metric_type_ == hnswlib::Metric::COSINE);
 
-        std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(nq);
-        for (int i = 0; i < nq; ++i) {
-            futs.emplace_back(search_pool_->push([&, idx = i, p_id_ptr = p_id.get(), p_dist_ptr = p_dist.get()]() {
-                auto single_query = (const char*)xq + idx * index_->data_size_;
-                auto rst = index_->searchKnn(single_query, k, bitset, &param, feder_result);
-                size_t rst_size = rst.size();
-                auto p_single_dis = p_dist_ptr + idx * k;
-                auto p_single_id = p_id_ptr + idx * k;
-                for (size_t idx = 0; idx < rst_size; ++idx) {
-                    const auto& [dist, id] = rst[idx];
-                    p_single_dis[idx] = transform ? (-dist) : dist;
-                    p_single_id[idx] = id;
-                }
-                for (size_t idx = rst_size; idx < (size_t)k; idx++) {
-                    p_single_dis[idx] = DistType(1.0 / 0.0);
-                    p_single_id[idx] = -1;
-                }
-            }));
-        }
-        WaitAllSuccess(futs);
+        auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
+        search_pool->ParallelFor(0, nq, [&, p_id_ptr = p_id.get(), p_dist_ptr = p_dist.get()](int idx) {
+            auto single_query = (const char*)xq + idx * index_->data_size_;
+            auto rst = index_->searchKnn(single_query, k, bitset, &param, feder_result);
+            size_t rst_size = rst.size();
+            auto p_single_dis = p_dist_ptr + idx * k;
+            auto p_single_id = p_id_ptr + idx * k;
+            for (size_t idx = 0; idx < rst_size; ++idx) {
+                const auto& [dist, id] = rst[idx];
+                p_single_dis[idx] = transform ? (-dist) : dist;
+                p_single_id[idx] = id;
+            }
+            for (size_t idx = rst_size; idx < (size_t)k; idx++) {
+                p_single_dis[idx] = DistType(1.0 / 0.0);
+                p_single_id[idx] = -1;
+            }
+        });
 
         auto res = GenResultDataSet(nq, k, std::move(p_id), std::move(p_dist));
 
@@ -364,27 +359,23 @@ class HnswIndexNode : public IndexNode {
         std::vector<std::vector<int64_t>> result_id_array(nq);
         std::vector<std::vector<DistType>> result_dist_array(nq);
 
-        std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(nq);
-        for (int64_t i = 0; i < nq; ++i) {
-            futs.emplace_back(search_pool_->push([&, idx = i]() {
-                auto single_query = (const char*)xq + idx * index_->data_size_;
-                auto rst = index_->searchRange(single_query, radius_for_calc, bitset, &param, feder_result);
-                auto elem_cnt = rst.size();
-                result_dist_array[idx].resize(elem_cnt);
-                result_id_array[idx].resize(elem_cnt);
-                for (size_t j = 0; j < elem_cnt; j++) {
-                    auto& p = rst[j];
-                    result_dist_array[idx][j] = (is_ip ? (-p.first) : p.first);
-                    result_id_array[idx][j] = p.second;
-                }
-                if (hnsw_cfg.range_filter.value() != defaultRangeFilter) {
-                    FilterRangeSearchResultForOneNq(result_dist_array[idx], result_id_array[idx], is_ip,
-                                                    radius_for_filter, range_filter);
-                }
-            }));
-        }
-        WaitAllSuccess(futs);
+        auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
+        search_pool->ParallelFor(0, nq, [&](int64_t idx) {
+            auto single_query = (const char*)xq + idx * index_->data_size_;
+            auto rst = index_->searchRange(single_query, radius_for_calc, bitset, &param, feder_result);
+            auto elem_cnt = rst.size();
+            result_dist_array[idx].resize(elem_cnt);
+            result_id_array[idx].resize(elem_cnt);
+            for (size_t j = 0; j < elem_cnt; j++) {
+                auto& p = rst[j];
+                result_dist_array[idx][j] = (is_ip ? (-p.first) : p.first);
+                result_id_array[idx][j] = p.second;
+            }
+            if (hnsw_cfg.range_filter.value() != defaultRangeFilter) {
+                FilterRangeSearchResultForOneNq(result_dist_array[idx], result_id_array[idx], is_ip,
+                                                radius_for_filter, range_filter);
+            }
+        });
 
         // filter range search result
         auto range_search_result =
@@ -612,7 +603,6 @@ class HnswIndexNode : public IndexNode {
 
  private:
     hnswlib::HierarchicalNSW<DataType, DistType, quant_type>* index_;
-    std::shared_ptr<ThreadPool> search_pool_;
 };
 
 }  // namespace knowhere
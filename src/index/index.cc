@@ -11,8 +11,17 @@
 
 #include "knowhere/index/index.h"
 
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <typeinfo>
+
+#include "faiss/impl/io.h"
 #include "fmt/format.h"
 #include "folly/futures/Future.h"
+#include "knowhere/comp/cancel_token.h"
+#include "knowhere/comp/memory_pages.h"
+#include "knowhere/comp/numa.h"
 #include "knowhere/comp/thread_pool.h"
 #include "knowhere/comp/time_recorder.h"
 #include "knowhere/dataset.h"
@@ -31,11 +40,41 @@ LoadConfig(BaseConfig* cfg, const Json& json, knowhere::PARAM_TYPE param_type, c
            std::string* const msg = nullptr) {
     Json json_(json);
     auto res = Config::FormatAndCheck(*cfg, json_, msg);
-    LOG_KNOWHERE_DEBUG_ << method << " config dump: " << json_.dump();
+    LOG_KNOWHERE_DEBUG_ << method << " config dump: " << json_;
     RETURN_IF_ERROR(res);
     return Config::Load(*cfg, json_, param_type, msg);
 }
 
+// a request cancelled while it runs may have been cut short anywhere, so whatever it returns is dropped
+template <typename T>
+inline expected<T>
+DropIfCancelled(const CancelTokenPtr& token, expected<T>&& res) {
+    if (token != nullptr && token->IsCancelled()) {
+        const auto status = token->GetStatus();
+        return expected<T>::Err(status, Status2String(status));
+    }
+    return std::move(res);
+}
+
+// huge pages and pre-faulting of the memory of a freshly loaded index, neither of them fails the load
+inline void
+AdviseLoadedMemory(const IndexNode& node, bool enable_hugepage, bool enable_prefault) {
+    if (!enable_hugepage && !enable_prefault) {
+        return;
+    }
+    const auto regions = node.GetMemoryRegions();
+    if (enable_hugepage) {
+        const auto advised = AdviseHugePages(regions);
+        LOG_KNOWHERE_INFO_ << node.Type() << " advised " << advised << " bytes to use huge pages";
+    }
+    if (enable_prefault) {
+        const auto status = PrefaultMappedRegions(regions);
+        if (status != Status::success) {
+            LOG_KNOWHERE_WARNING_ << node.Type() << " failed to pre-fault its mapped memory: " << Status2String(status);
+        }
+    }
+}
+
 #ifdef KNOWHERE_WITH_CARDINAL
 template <typename T>
 inline const std::shared_ptr<Interrupt>
@@ -106,15 +145,137 @@ Index<T>::Add(const DataSetPtr dataset, const Json& json, bool use_knowhere_buil
     return this->node->Add(dataset, std::move(cfg), use_knowhere_build_pool);
 }
 
+Status
+PreparedConfig::Instantiate(Config& cfg, PARAM_TYPE type, std::string* const msg) const {
+    if (typeid(cfg) != typeid(*cfg_)) {
+        *msg = "the config was prepared for another index type";
+        LOG_KNOWHERE_ERROR_ << *msg;
+        return Status::invalid_args;
+    }
+    if (type != type_) {
+        *msg = "the config was prepared for another kind of search";
+        LOG_KNOWHERE_ERROR_ << *msg;
+        return Status::invalid_args;
+    }
+    Config::CopyValues(*cfg_, cfg);
+    auto& base_cfg = static_cast<BaseConfig&>(cfg);
+    if (k_.has_value()) {
+        if (k_.value() < 1) {
+            *msg = fmt::format("k should be >= 1, but we get {}", k_.value());
+            LOG_KNOWHERE_ERROR_ << *msg;
+            return Status::out_of_range_in_json;
+        }
+        base_cfg.k = k_;
+    }
+    if (radius_.has_value()) {
+        base_cfg.radius = radius_;
+        base_cfg.range_filter = range_filter_.value_or(defaultRangeFilter);
+    }
+    return Config::Adjust(cfg, type, msg);
+}
+
+template <typename T>
+inline expected<PreparedConfig>
+Index<T>::Prepare(const Json& json, PARAM_TYPE type, const std::string& method) const {
+    auto cfg = this->node->CreateConfig();
+    std::string msg;
+    Json json_(json);
+    auto status = Config::FormatAndCheck(*cfg, json_, &msg);
+    LOG_KNOWHERE_DEBUG_ << method << " prepared config dump: " << json_;
+    if (status == Status::success) {
+        status = Config::LoadValues(*cfg, json_, type, &msg);
+    }
+    if (status != Status::success) {
+        return expected<PreparedConfig>::Err(status, msg);
+    }
+    PreparedConfig prepared(std::shared_ptr<const Config>(std::move(cfg)), type);
+    // rejects the configs any request would fail on now, rather than on each request
+    auto checked = Instantiate(prepared, type);
+    if (!checked.has_value()) {
+        return expected<PreparedConfig>::Err(checked.error(), checked.what());
+    }
+    return prepared;
+}
+
+template <typename T>
+inline expected<std::unique_ptr<BaseConfig>>
+Index<T>::Instantiate(const PreparedConfig& prepared, PARAM_TYPE type) const {
+    auto cfg = this->node->CreateConfig();
+    std::string msg;
+    auto status = prepared.Instantiate(*cfg, type, &msg);
+    if (status != Status::success) {
+        return expected<std::unique_ptr<BaseConfig>>::Err(status, msg);
+    }
+    return std::move(cfg);
+}
+
+template <typename T>
+inline expected<PreparedConfig>
+Index<T>::PrepareSearch(const Json& json) const {
+    return Prepare(json, knowhere::SEARCH, "Search");
+}
+
+template <typename T>
+inline expected<PreparedConfig>
+Index<T>::PrepareRangeSearch(const Json& json) const {
+    return Prepare(json, knowhere::RANGE_SEARCH, "RangeSearch");
+}
+
+template <typename T>
+inline expected<PreparedConfig>
+Index<T>::PrepareAnnIterator(const Json& json) const {
+    return Prepare(json, knowhere::ITERATOR, "Iterator");
+}
+
 template <typename T>
 inline expected<DataSetPtr>
-Index<T>::Search(const DataSetPtr dataset, const Json& json, const BitsetView& bitset_) const {
+Index<T>::Search(const DataSetPtr dataset, const Json& json, const BitsetView& bitset_,
+                 const CancelTokenPtr& token) const {
     auto cfg = this->node->CreateConfig();
     std::string msg;
     const Status load_status = LoadConfig(cfg.get(), json, knowhere::SEARCH, "Search", &msg);
     if (load_status != Status::success) {
         return expected<DataSetPtr>::Err(load_status, msg);
     }
+    return SearchWithConfig(dataset, std::move(cfg), bitset_, token);
+}
+
+template <typename T>
+inline expected<DataSetPtr>
+Index<T>::Search(const DataSetPtr dataset, const PreparedConfig& prepared, const BitsetView& bitset_,
+                 const CancelTokenPtr& token) const {
+    auto cfg = Instantiate(prepared, knowhere::SEARCH);
+    if (!cfg.has_value()) {
+        return expected<DataSetPtr>::Err(cfg.error(), cfg.what());
+    }
+    return SearchWithConfig(dataset, std::move(cfg.value()), bitset_, token);
+}
+
+template <typename T>
+inline Status
+Index<T>::SearchInto(const DataSetPtr dataset, const Json& json, const BitsetView& bitset_, int64_t* ids,
+                     float* distances, const CancelTokenPtr& token) const {
+    auto cfg = this->node->CreateConfig();
+    RETURN_IF_ERROR(LoadConfig(cfg.get(), json, knowhere::SEARCH, "Search"));
+    return SearchWithConfig(dataset, std::move(cfg), bitset_, token, ids, distances).error();
+}
+
+template <typename T>
+inline Status
+Index<T>::SearchInto(const DataSetPtr dataset, const PreparedConfig& prepared, const BitsetView& bitset_,
+                     int64_t* ids, float* distances, const CancelTokenPtr& token) const {
+    auto cfg = Instantiate(prepared, knowhere::SEARCH);
+    if (!cfg.has_value()) {
+        return cfg.error();
+    }
+    return SearchWithConfig(dataset, std::move(cfg.value()), bitset_, token, ids, distances).error();
+}
+
+template <typename T>
+inline expected<DataSetPtr>
+Index<T>::SearchWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                           const CancelTokenPtr& token, int64_t* ids, float* distances) const {
+    std::string msg;
     // when index is immutable, bitset size should always equal to data count in index
     // when index is mutable, it could happen that data count larger than bitset size, see
     // https://github.com/zilliztech/knowhere/issues/70
@@ -127,6 +288,26 @@ Index<T>::Search(const DataSetPtr dataset, const Json& json, const BitsetView& b
     }
 
     const auto bitset = BitsetView(bitset_.data(), bitset_.size(), bitset_.get_filtered_out_num_());
+    ThreadPool::ScopedNumaNodeSetter numa_setter(this->node->NumaNode());
+    if (token != nullptr && token->IsCancelled()) {
+        return expected<DataSetPtr>::Err(token->GetStatus(), Status2String(token->GetStatus()));
+    }
+    CancelToken::ScopedSetter token_setter(token.get());
+    const auto priority = static_cast<TaskPriority>(cfg->search_priority.value());
+    if (ThreadPool::GetGlobalSearchThreadPool()->IsSaturated(priority)) {
+        return expected<DataSetPtr>::Err(Status::search_queue_full, Status2String(Status::search_queue_full));
+    }
+    ThreadPool::ScopedTaskPrioritySetter priority_setter(priority);
+    auto search = [&](std::unique_ptr<Config> cfg) -> expected<DataSetPtr> {
+        if (ids == nullptr) {
+            return this->node->Search(dataset, std::move(cfg), bitset);
+        }
+        auto status = this->node->SearchInto(dataset, std::move(cfg), bitset, ids, distances);
+        if (status != Status::success) {
+            return expected<DataSetPtr>::Err(status, Status2String(status));
+        }
+        return DataSetPtr(nullptr);
+    };
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     const BaseConfig& b_cfg = static_cast<const BaseConfig&>(*cfg);
@@ -149,7 +330,7 @@ Index<T>::Search(const DataSetPtr dataset, const Json& json, const BitsetView& b
     TimeRecorder rc("Search");
     bool has_trace_id = b_cfg.trace_id.has_value();
     auto k = cfg->k.value();
-    auto res = this->node->Search(dataset, std::move(cfg), bitset);
+    auto res = search(std::move(cfg));
     auto time = rc.ElapseFromBegin("done");
     time *= 0.001;  // convert to ms
     knowhere_search_latency.Observe(time);
@@ -161,21 +342,40 @@ Index<T>::Search(const DataSetPtr dataset, const Json& json, const BitsetView& b
     }
     // LCOV_EXCL_STOP
 #else
-    auto res = this->node->Search(dataset, std::move(cfg), bitset);
+    auto res = search(std::move(cfg));
 #endif
-    return res;
+    return DropIfCancelled(token, std::move(res));
 }
 
 template <typename T>
 inline expected<std::vector<std::shared_ptr<IndexNode::iterator>>>
 Index<T>::AnnIterator(const DataSetPtr dataset, const Json& json, const BitsetView& bitset_,
-                      bool use_knowhere_search_pool) const {
+                      bool use_knowhere_search_pool, const CancelTokenPtr& token) const {
     auto cfg = this->node->CreateConfig();
     std::string msg;
     Status status = LoadConfig(cfg.get(), json, knowhere::ITERATOR, "Iterator", &msg);
     if (status != Status::success) {
         return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(status, msg);
     }
+    return AnnIteratorWithConfig(dataset, std::move(cfg), bitset_, use_knowhere_search_pool, token);
+}
+
+template <typename T>
+inline expected<std::vector<std::shared_ptr<IndexNode::iterator>>>
+Index<T>::AnnIterator(const DataSetPtr dataset, const PreparedConfig& prepared, const BitsetView& bitset_,
+                      bool use_knowhere_search_pool, const CancelTokenPtr& token) const {
+    auto cfg = Instantiate(prepared, knowhere::ITERATOR);
+    if (!cfg.has_value()) {
+        return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(cfg.error(), cfg.what());
+    }
+    return AnnIteratorWithConfig(dataset, std::move(cfg.value()), bitset_, use_knowhere_search_pool, token);
+}
+
+template <typename T>
+inline expected<std::vector<std::shared_ptr<IndexNode::iterator>>>
+Index<T>::AnnIteratorWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                                bool use_knowhere_search_pool, const CancelTokenPtr& token) const {
+    std::string msg;
     // when index is immutable, bitset size should always equal to data count in index
     // when index is mutable, it could happen that data count larger than bitset size, see
     // https://github.com/zilliztech/knowhere/issues/70
@@ -188,6 +388,18 @@ Index<T>::AnnIterator(const DataSetPtr dataset, const Json& json, const BitsetVi
     }
 
     const auto bitset = BitsetView(bitset_.data(), bitset_.size(), bitset_.get_filtered_out_num_());
+    ThreadPool::ScopedNumaNodeSetter numa_setter(this->node->NumaNode());
+    if (token != nullptr && token->IsCancelled()) {
+        return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(token->GetStatus(),
+                                                                                Status2String(token->GetStatus()));
+    }
+    CancelToken::ScopedSetter token_setter(token.get());
+    const auto priority = static_cast<TaskPriority>(cfg->search_priority.value());
+    if (ThreadPool::GetGlobalSearchThreadPool()->IsSaturated(priority)) {
+        return expected<std::vector<std::shared_ptr<IndexNode::iterator>>>::Err(
+            Status::search_queue_full, Status2String(Status::search_queue_full));
+    }
+    ThreadPool::ScopedTaskPrioritySetter priority_setter(priority);
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     // note that this time includes only the initial search phase of iterator.
@@ -199,18 +411,38 @@ Index<T>::AnnIterator(const DataSetPtr dataset, const Json& json, const BitsetVi
 #else
     auto res = this->node->AnnIterator(dataset, std::move(cfg), bitset, use_knowhere_search_pool);
 #endif
-    return res;
+    return DropIfCancelled(token, std::move(res));
 }
 
 template <typename T>
 inline expected<DataSetPtr>
-Index<T>::RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetView& bitset_) const {
+Index<T>::RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetView& bitset_,
+                      const CancelTokenPtr& token) const {
     auto cfg = this->node->CreateConfig();
     std::string msg;
     auto status = LoadConfig(cfg.get(), json, knowhere::RANGE_SEARCH, "RangeSearch", &msg);
     if (status != Status::success) {
         return expected<DataSetPtr>::Err(status, std::move(msg));
     }
+    return RangeSearchWithConfig(dataset, std::move(cfg), bitset_, token);
+}
+
+template <typename T>
+inline expected<DataSetPtr>
+Index<T>::RangeSearch(const DataSetPtr dataset, const PreparedConfig& prepared, const BitsetView& bitset_,
+                      const CancelTokenPtr& token) const {
+    auto cfg = Instantiate(prepared, knowhere::RANGE_SEARCH);
+    if (!cfg.has_value()) {
+        return expected<DataSetPtr>::Err(cfg.error(), cfg.what());
+    }
+    return RangeSearchWithConfig(dataset, std::move(cfg.value()), bitset_, token);
+}
+
+template <typename T>
+inline expected<DataSetPtr>
+Index<T>::RangeSearchWithConfig(const DataSetPtr dataset, std::unique_ptr<BaseConfig> cfg, const BitsetView& bitset_,
+                                const CancelTokenPtr& token) const {
+    std::string msg;
     // when index is immutable, bitset size should always equal to data count in index
     // when index is mutable, it could happen that data count larger than bitset size, see
     // https://github.com/zilliztech/knowhere/issues/70
@@ -223,6 +455,16 @@ Index<T>::RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetVi
     }
 
     const auto bitset = BitsetView(bitset_.data(), bitset_.size(), bitset_.get_filtered_out_num_());
+    ThreadPool::ScopedNumaNodeSetter numa_setter(this->node->NumaNode());
+    if (token != nullptr && token->IsCancelled()) {
+        return expected<DataSetPtr>::Err(token->GetStatus(), Status2String(token->GetStatus()));
+    }
+    CancelToken::ScopedSetter token_setter(token.get());
+    const auto priority = static_cast<TaskPriority>(cfg->search_priority.value());
+    if (ThreadPool::GetGlobalSearchThreadPool()->IsSaturated(priority)) {
+        return expected<DataSetPtr>::Err(Status::search_queue_full, Status2String(Status::search_queue_full));
+    }
+    ThreadPool::ScopedTaskPrioritySetter priority_setter(priority);
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     const BaseConfig& b_cfg = static_cast<const BaseConfig&>(*cfg);
@@ -260,7 +502,7 @@ Index<T>::RangeSearch(const DataSetPtr dataset, const Json& json, const BitsetVi
 #else
     auto res = this->node->RangeSearch(dataset, std::move(cfg), bitset);
 #endif
-    return res;
+    return DropIfCancelled(token, std::move(res));
 }
 
 template <typename T>
@@ -299,6 +541,35 @@ Index<T>::Serialize(BinarySet& binset) const {
     return this->node->Serialize(binset);
 }
 
+template <typename T>
+inline Status
+Index<T>::SerializeToWriter(faiss::IOWriter& writer) const {
+    return this->node->SerializeToWriter(writer);
+}
+
+template <typename T>
+inline Status
+Index<T>::SerializeToFile(const std::string& filename) const {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        LOG_KNOWHERE_ERROR_ << "Failed to open " << filename << " for writing: " << strerror(errno);
+        return Status::disk_file_error;
+    }
+    Status status;
+    {
+        faiss::FileIOWriter writer(file);
+        status = this->node->SerializeToWriter(writer);
+    }
+    if (fclose(file) != 0 && status == Status::success) {
+        LOG_KNOWHERE_ERROR_ << "Failed to write " << filename << ": " << strerror(errno);
+        status = Status::disk_file_error;
+    }
+    if (status != Status::success) {
+        std::remove(filename.c_str());
+    }
+    return status;
+}
+
 template <typename T>
 inline Status
 Index<T>::Deserialize(const BinarySet& binset, const Json& json) {
@@ -315,6 +586,13 @@ Index<T>::Deserialize(const BinarySet& binset, const Json& json) {
     if (res != Status::success) {
         return res;
     }
+    const auto& base_cfg = static_cast<const BaseConfig&>(*cfg);
+    const bool enable_hugepage = base_cfg.enable_hugepage.value();
+    const bool enable_prefault = base_cfg.enable_mmap_pop.value();
+    // load the index with the memory and the search thread pool of its numa node
+    const auto numa_node = base_cfg.numa_node.value();
+    ThreadPool::ScopedNumaNodeSetter numa_setter(numa_node);
+    ScopedNumaBind numa_bind(numa_node);
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     TimeRecorder rc("Load index", 2);
@@ -325,6 +603,10 @@ Index<T>::Deserialize(const BinarySet& binset, const Json& json) {
 #else
     res = this->node->Deserialize(binset, std::move(cfg));
 #endif
+    if (res == Status::success) {
+        this->node->SetNumaNode(numa_node);
+        AdviseLoadedMemory(*this->node, enable_hugepage, enable_prefault);
+    }
     return res;
 }
 
@@ -344,6 +626,13 @@ Index<T>::DeserializeFromFile(const std::string& filename, const Json& json) {
     if (res != Status::success) {
         return res;
     }
+    const auto& base_cfg = static_cast<const BaseConfig&>(*cfg);
+    const bool enable_hugepage = base_cfg.enable_hugepage.value();
+    const bool enable_prefault = base_cfg.enable_mmap_pop.value();
+    // load the index with the memory and the search thread pool of its numa node
+    const auto numa_node = base_cfg.numa_node.value();
+    ThreadPool::ScopedNumaNodeSetter numa_setter(numa_node);
+    ScopedNumaBind numa_bind(numa_node);
 
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
     TimeRecorder rc("Load index from file", 2);
@@ -354,6 +643,10 @@ Index<T>::DeserializeFromFile(const std::string& filename, const Json& json) {
 #else
     res = this->node->DeserializeFromFile(filename, std::move(cfg));
 #endif
+    if (res == Status::success) {
+        this->node->SetNumaNode(numa_node);
+        AdviseLoadedMemory(*this->node, enable_hugepage, enable_prefault);
+    }
     return res;
 }
 
@@ -381,6 +674,12 @@ Index<T>::Type() const {
     return this->node->Type();
 }
 
+template <typename T>
+inline MemoryResidency
+Index<T>::GetMemoryResidency() const {
+    return knowhere::GetMemoryResidency(this->node->GetMemoryRegions());
+}
+
 template class Index<IndexNode>;
 
 }  // namespace knowhere
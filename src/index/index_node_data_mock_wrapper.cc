@@ -52,6 +52,14 @@ IndexNodeDataMockWrapper<DataType>::Search(const DataSetPtr dataset, std::unique
     return index_node_->Search(ds_ptr, std::move(cfg), bitset);
 }
 
+template <typename DataType>
+Status
+IndexNodeDataMockWrapper<DataType>::SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg,
+                                               const BitsetView& bitset, int64_t* ids, float* distances) const {
+    auto ds_ptr = ConvertFromDataTypeIfNeeded<DataType>(dataset);
+    return index_node_->SearchInto(ds_ptr, std::move(cfg), bitset, ids, distances);
+}
+
 template <typename DataType>
 expected<DataSetPtr>
 IndexNodeDataMockWrapper<DataType>::RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg,
@@ -41,6 +41,14 @@ IndexNodeThreadPoolWrapper::Search(const DataSetPtr dataset, std::unique_ptr<Con
     return thread_pool_->push([&]() { return this->index_node_->Search(dataset, std::move(cfg), bitset); }).get();
 }
 
+Status
+IndexNodeThreadPoolWrapper::SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
+                                       int64_t* ids, float* distances) const {
+    return thread_pool_
+        ->push([&]() { return this->index_node_->SearchInto(dataset, std::move(cfg), bitset, ids, distances); })
+        .get();
+}
+
 expected<DataSetPtr>
 IndexNodeThreadPoolWrapper::RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg,
                                         const BitsetView& bitset) const {
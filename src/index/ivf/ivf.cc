@@ -10,6 +10,8 @@
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
 #include "common/metric.h"
+#include "common/split_search.h"
+#include "common/typed_storage.h"
 #include "faiss/IndexBinaryFlat.h"
 #include "faiss/IndexBinaryIVF.h"
 #include "faiss/IndexFlat.h"
@@ -24,6 +26,7 @@
 #include "faiss/VectorTransform.h"
 #include "faiss/index_io.h"
 #include "index/data_view_dense_index/index_node_with_data_view_refiner.h"
+#include "index/faiss_memory_regions.h"
 #include "index/ivf/ivf_config.h"
 #include "index/ivf/ivfrbq_wrapper.h"
 #include "io/memory_io.h"
@@ -55,6 +58,10 @@ struct IndexDispatch<faiss::IndexIVFFlat> {
 
 template <typename DataType, typename IndexType>
 class IvfIndexNode : public IndexNode {
+    // the lists of fp16, bf16 and int8 IVF_FLAT indexes keep the vectors as they are, not converted to fp32
+    static constexpr bool kTypedStorage =
+        KnowhereLowPrecisionTypeCheck<DataType>::value && std::is_same_v<IndexType, faiss::IndexIVFFlat>;
+
  public:
     IvfIndexNode(const int32_t version, const Object& object) : IndexNode(version), index_(nullptr) {
         static_assert(std::is_same<IndexType, faiss::IndexIVFFlat>::value ||
@@ -66,9 +73,8 @@ class IvfIndexNode : public IndexNode {
                           std::is_same<IndexType, faiss::IndexIVFScalarQuantizerCC>::value ||
                           std::is_same<IndexType, IndexIVFRaBitQWrapper>::value,
                       "not support");
-        static_assert(std::is_same_v<DataType, fp32> || std::is_same_v<DataType, bin1>,
-                      "IvfIndexNode only support float/binary");
-        search_pool_ = ThreadPool::GetGlobalSearchThreadPool();
+        static_assert(std::is_same_v<DataType, fp32> || std::is_same_v<DataType, bin1> || kTypedStorage,
+                      "IvfIndexNode only support float/binary, and fp16/bf16/int8 for IVF_FLAT");
         build_pool_ = ThreadPool::GetGlobalBuildThreadPool();
     }
     Status
@@ -77,6 +83,9 @@ class IvfIndexNode : public IndexNode {
     Add(const DataSetPtr dataset, std::shared_ptr<Config> cfg, bool use_knowhere_build_pool) override;
     expected<DataSetPtr>
     Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override;
+    Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override;
     expected<DataSetPtr>
     RangeSearch(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset) const override;
     expected<std::vector<IndexNode::IteratorPtr>>
@@ -170,6 +179,8 @@ class IvfIndexNode : public IndexNode {
         return this->SerializeImpl(binset, typename IndexDispatch<IndexType>::Tag{});
     }
     Status
+    SerializeToWriter(faiss::IOWriter& writer) const override;
+    Status
     Deserialize(const BinarySet& binset, std::shared_ptr<Config> cfg) override;
     Status
     DeserializeFromFile(const std::string& filename, std::shared_ptr<Config> cfg) override;
@@ -275,6 +286,12 @@ class IvfIndexNode : public IndexNode {
         }
         return index_->ntotal;
     };
+    std::vector<MemoryRegion>
+    GetMemoryRegions() const override {
+        std::vector<MemoryRegion> regions;
+        CollectFaissMemoryRegions(index_.get(), regions);
+        return regions;
+    }
     std::string
     Type() const override {
         if constexpr (std::is_same<IndexType, faiss::IndexIVFFlat>::value) {
@@ -320,6 +337,22 @@ class IvfIndexNode : public IndexNode {
     Status
     TrainInternal(const DataSetPtr dataset, std::shared_ptr<Config> cfg);
 
+    // searches into `ids` and `distances`, of k * rows entries each
+    Status
+    SearchImpl(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances, std::string* msg) const;
+
+    // the typed lists convert the fp32 queries back to their type, so these are not normalized for cosine: the
+    // distances are divided by the norm of the query instead
+    static DataSetPtr
+    QueriesAsFp32(const DataSetPtr& dataset) {
+        if constexpr (kTypedStorage) {
+            return ConvertFromDataTypeIfNeeded<DataType>(dataset);
+        } else {
+            return dataset;
+        }
+    }
+
     static constexpr bool
     IsQuantized() {
         return std::is_same_v<IndexType, faiss::IndexIVFPQ> ||
@@ -380,8 +413,12 @@ class IvfIndexNode : public IndexNode {
         faiss::IVFSearchParameters ivf_search_params_;
     };
 
+    // rows of a typed dataset converted to fp32 at a time when it is added
+    static constexpr int64_t kAddBlockRows = 65536;
+
     std::unique_ptr<IndexType> index_;
-    std::shared_ptr<ThreadPool> search_pool_;
+    // the inverted lists are views into the binary set loaded with enable_zero_copy, the index cannot grow
+    bool zero_copy_ = false;
     // Faiss uses OpenMP for training/building the index and we have no control
     // over those threads. build_pool_ is used to make sure the OMP threads
     // spawded during index training/building can inherit the low nice value of
@@ -450,6 +487,48 @@ get_ivf_sq_quantizer_type(int code_size) {
                 Status::invalid_args, fmt::format("current code size {} not in (4, 6, 8, 16)", code_size));
     }
 }
+
+// the error of a search into caller-provided buffers, which may have no use for the message
+Status
+search_error(std::string* msg, const std::string& what, Status status) {
+    if (msg != nullptr) {
+        *msg = what;
+    }
+    return status;
+}
+
+// inverted lists a part of a split query probes at least
+constexpr size_t kIntraQueryMinLists = 8;
+
+// IndexIVF::search() of `nq` queries, with the lists each query probes split in `splits` parts that are scanned in
+// parallel. The coarse quantization runs once per query, before the split.
+Status
+split_ivf_search(const faiss::IndexIVF* index, const float* x, int64_t nq, int64_t k, size_t nprobe,
+                 const BitsetView& bitset, size_t splits, float* distances, int64_t* ids) {
+    auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
+    nprobe = std::min(nprobe, index->nlist);
+    std::vector<faiss::idx_t> assign(nq * nprobe);
+    std::vector<float> centroid_dis(nq * nprobe);
+    RETURN_IF_ERROR(search_pool->ParallelFor(0, nq, [&](size_t q) {
+        ThreadPool::ScopedSearchOmpSetter setter(1);
+        index->quantizer->search(1, x + q * index->d, nprobe, centroid_dis.data() + q * nprobe,
+                                 assign.data() + q * nprobe);
+    }));
+    return SplitTopKSearch(
+        search_pool.get(), nq, splits, k, index->metric_type == faiss::METRIC_INNER_PRODUCT, distances, ids,
+        [&](size_t q, size_t part, float* part_dis, int64_t* part_ids) {
+            auto [begin, end] = SplitRange(nprobe, splits, part);
+            BitsetViewIDSelector bw_idselector(bitset);
+            faiss::IVFSearchParameters ivf_search_params;
+            ivf_search_params.nprobe = end - begin;
+            ivf_search_params.max_codes = 0;
+            ivf_search_params.sel = (bitset.empty()) ? nullptr : &bw_idselector;
+            index->search_preassigned(1, x + q * index->d, k, assign.data() + q * nprobe + begin,
+                                      centroid_dis.data() + q * nprobe + begin, part_dis, part_ids, false,
+                                      &ivf_search_params);
+            return Status::success;
+        });
+}
 }  // namespace
 
 template <typename DataType, typename IndexType>
@@ -521,9 +600,17 @@ IvfIndexNode<DataType, IndexType>::TrainInternal(const DataSetPtr dataset, std::
         std::unique_ptr<faiss::IndexFlat> qzr =
             std::make_unique<faiss::IndexFlatElkan>(dim, metric.value(), false, use_elkan);
         // create index. Index does not own qzr
-        index = std::make_unique<faiss::IndexIVFFlat>(qzr.get(), dim, nlist, metric.value(), is_cosine);
-        // train
-        index->train(rows, (const float*)data);
+        if constexpr (kTypedStorage) {
+            index = std::make_unique<faiss::IndexIVFFlatTyped>(qzr.get(), dim, nlist, TypedQuantizerType<DataType>(),
+                                                               metric.value(), is_cosine);
+            // train on the vectors converted to fp32
+            auto fp32_dataset = ConvertFromDataTypeIfNeeded<DataType>(dataset);
+            index->train(rows, (const float*)fp32_dataset->GetTensor());
+        } else {
+            index = std::make_unique<faiss::IndexIVFFlat>(qzr.get(), dim, nlist, metric.value(), is_cosine);
+            // train
+            index->train(rows, (const float*)data);
+        }
         // replace quantizer with a regular IndexFlat
         qzr = to_index_flat(std::move(qzr));
         // transfer ownership of qzr to index
@@ -681,6 +768,7 @@ IvfIndexNode<DataType, IndexType>::TrainInternal(const DataSetPtr dataset, std::
         index->train(rows, (const float*)data);
     }
     index_ = std::move(index);
+    zero_copy_ = false;
 
     return Status::success;
 }
@@ -693,6 +781,10 @@ IvfIndexNode<DataType, IndexType>::Add(const DataSetPtr dataset, std::shared_ptr
         LOG_KNOWHERE_ERROR_ << "Can not add data to empty IVF index.";
         return Status::empty_index;
     }
+    if (zero_copy_) {
+        LOG_KNOWHERE_ERROR_ << "Can not add data to an IVF index loaded with enable_zero_copy.";
+        return Status::not_implemented;
+    }
     auto data = dataset->GetTensor();
     auto rows = dataset->GetRows();
     const BaseConfig& base_cfg = static_cast<const IvfConfig&>(*cfg);
@@ -710,6 +802,13 @@ IvfIndexNode<DataType, IndexType>::Add(const DataSetPtr dataset, std::shared_ptr
                           }
                           if constexpr (std::is_same<faiss::IndexBinaryIVF, IndexType>::value) {
                               index_->add(rows, (const uint8_t*)data);
+                          } else if constexpr (kTypedStorage) {
+                              // the lists encode from fp32, only a block of the vectors is converted at a time
+                              for (int64_t begin = 0; begin < rows; begin += kAddBlockRows) {
+                                  auto count = std::min<int64_t>(kAddBlockRows, rows - begin);
+                                  auto block = ConvertFromDataTypeIfNeeded<DataType>(dataset, begin, count);
+                                  index_->add(count, (const float*)block->GetTensor());
+                              }
                           } else {
                               index_->add(rows, (const float*)data);
                           }
@@ -726,175 +825,211 @@ template <typename DataType, typename IndexType>
 expected<DataSetPtr>
 IvfIndexNode<DataType, IndexType>::Search(const DataSetPtr dataset, std::unique_ptr<Config> cfg,
                                           const BitsetView& bitset) const {
+    auto rows = dataset->GetRows();
+    auto k = static_cast<const IvfConfig&>(*cfg).k.value();
+    auto ids = std::make_unique<int64_t[]>(rows * k);
+    auto distances = std::make_unique<float[]>(rows * k);
+    std::string msg;
+    auto status = SearchImpl(dataset, std::move(cfg), bitset, ids.get(), distances.get(), &msg);
+    if (status != Status::success) {
+        return expected<DataSetPtr>::Err(status, msg);
+    }
+    return GenResultDataSet(rows, k, std::move(ids), std::move(distances));
+}
+
+template <typename DataType, typename IndexType>
+Status
+IvfIndexNode<DataType, IndexType>::SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg,
+                                              const BitsetView& bitset, int64_t* ids, float* distances) const {
+    return SearchImpl(dataset, std::move(cfg), bitset, ids, distances, nullptr);
+}
+
+template <typename DataType, typename IndexType>
+Status
+IvfIndexNode<DataType, IndexType>::SearchImpl(const DataSetPtr dataset, std::unique_ptr<Config> cfg,
+                                              const BitsetView& bitset, int64_t* ids, float* distances,
+                                              std::string* msg) const {
     if (!this->index_) {
         LOG_KNOWHERE_WARNING_ << "search on empty index";
-        return expected<DataSetPtr>::Err(Status::empty_index, "index not loaded");
+        return search_error(msg, "index not loaded", Status::empty_index);
     }
     if (!this->index_->is_trained) {
         LOG_KNOWHERE_WARNING_ << "index not trained";
-        return expected<DataSetPtr>::Err(Status::index_not_trained, "index not trained");
+        return search_error(msg, "index not trained", Status::index_not_trained);
     }
 
-    auto dim = dataset->GetDim();
-    auto rows = dataset->GetRows();
-    auto data = dataset->GetTensor();
+    auto fp32_dataset = QueriesAsFp32(dataset);
+    auto dim = fp32_dataset->GetDim();
+    auto rows = fp32_dataset->GetRows();
+    auto data = fp32_dataset->GetTensor();
 
     const IvfConfig& ivf_cfg = static_cast<const IvfConfig&>(*cfg);
-    bool is_cosine = IsMetricType(ivf_cfg.metric_type.value(), knowhere::metric::COSINE);
+    bool is_cosine = !kTypedStorage && IsMetricType(ivf_cfg.metric_type.value(), knowhere::metric::COSINE);
 
     auto k = ivf_cfg.k.value();
     auto nprobe = ivf_cfg.nprobe.value();
 
-    auto ids = std::make_unique<int64_t[]>(rows * k);
-    auto distances = std::make_unique<float[]>(rows * k);
     try {
-        std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(rows);
-        for (int i = 0; i < rows; ++i) {
-            futs.emplace_back(search_pool_->push([&, index = i] {
-                ThreadPool::ScopedSearchOmpSetter setter(1);
-                auto offset = k * index;
-                std::unique_ptr<float[]> copied_query = nullptr;
+        auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
+        if constexpr (std::is_same<IndexType, faiss::IndexIVFFlat>::value ||
+                      std::is_same<IndexType, faiss::IndexIVFPQ>::value ||
+                      std::is_same<IndexType, faiss::IndexIVFScalarQuantizer>::value) {
+            // few queries probing many lists, split the lists of each query across the idle threads
+            auto splits = search_pool->IntraQuerySplits(rows, std::min<size_t>(nprobe, index_->nlist),
+                                                        kIntraQueryMinLists);
+            if (splits > 1) {
+                auto queries = (const float*)data;
+                std::unique_ptr<float[]> copied_queries = nullptr;
+                if (is_cosine) {
+                    copied_queries = CopyAndNormalizeVecs(queries, rows, dim);
+                    queries = copied_queries.get();
+                }
+                auto status =
+                    split_ivf_search(index_.get(), queries, rows, k, nprobe, bitset, splits, distances, ids);
+                if (status != Status::success) {
+                    return search_error(msg, "failed to search split queries", status);
+                }
+                return Status::success;
+            }
+        }
+        return search_pool->ParallelFor(0, rows, [&](int index) {
+            ThreadPool::ScopedSearchOmpSetter setter(1);
+            auto offset = k * index;
+            std::unique_ptr<float[]> copied_query = nullptr;
 
-                BitsetViewIDSelector bw_idselector(bitset);
-                faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+            BitsetViewIDSelector bw_idselector(bitset);
+            faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
 
-                if constexpr (std::is_same<IndexType, faiss::IndexBinaryIVF>::value) {
-                    auto cur_data = (const uint8_t*)data + index * ((dim + 7) / 8);
+            if constexpr (std::is_same<IndexType, faiss::IndexBinaryIVF>::value) {
+                auto cur_data = (const uint8_t*)data + index * ((dim + 7) / 8);
 
-                    int32_t* i_distances = reinterpret_cast<int32_t*>(distances.get());
+                int32_t* i_distances = reinterpret_cast<int32_t*>(distances);
 
-                    faiss::IVFSearchParameters ivf_search_params;
-                    ivf_search_params.nprobe = nprobe;
-                    ivf_search_params.sel = id_selector;
-                    index_->search(1, cur_data, k, i_distances + offset, ids.get() + offset, &ivf_search_params);
-
-                    if (index_->metric_type == faiss::METRIC_Hamming) {
-                        // this is an in-place conversion int32_t -> float
-                        for (int64_t i = 0; i < k; i++) {
-                            distances[i + offset] = static_cast<float>(i_distances[i + offset]);
-                        }
-                    }
-                } else if constexpr (std::is_same<IndexType, faiss::IndexIVFFlatCC>::value ||
-                                     std::is_same<IndexType, faiss::IndexIVFScalarQuantizerCC>::value) {
-                    auto cur_query = (const float*)data + index * dim;
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                        cur_query = copied_query.get();
+                faiss::IVFSearchParameters ivf_search_params;
+                ivf_search_params.nprobe = nprobe;
+                ivf_search_params.sel = id_selector;
+                index_->search(1, cur_data, k, i_distances + offset, ids + offset, &ivf_search_params);
+
+                if (index_->metric_type == faiss::METRIC_Hamming) {
+                    // this is an in-place conversion int32_t -> float
+                    for (int64_t i = 0; i < k; i++) {
+                        distances[i + offset] = static_cast<float>(i_distances[i + offset]);
                     }
+                }
+            } else if constexpr (std::is_same<IndexType, faiss::IndexIVFFlatCC>::value ||
+                                 std::is_same<IndexType, faiss::IndexIVFScalarQuantizerCC>::value) {
+                auto cur_query = (const float*)data + index * dim;
+                if (is_cosine) {
+                    copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    cur_query = copied_query.get();
+                }
 
-                    faiss::IVFSearchParameters ivf_search_params;
+                faiss::IVFSearchParameters ivf_search_params;
 
-                    ivf_search_params.sel = id_selector;
-                    ivf_search_params.ensure_topk_full = ivf_cfg.ensure_topk_full.value();
-                    if (ivf_search_params.ensure_topk_full) {
-                        ivf_search_params.nprobe = index_->nlist;
-                        // use max_codes to early termination
-                        ivf_search_params.max_codes =
-                            (nprobe * 1.0 / index_->nlist) * (index_->ntotal - bitset.count());
-                    } else {
-                        ivf_search_params.nprobe = nprobe;
-                        ivf_search_params.max_codes = 0;
-                    }
+                ivf_search_params.sel = id_selector;
+                ivf_search_params.ensure_topk_full = ivf_cfg.ensure_topk_full.value();
+                if (ivf_search_params.ensure_topk_full) {
+                    ivf_search_params.nprobe = index_->nlist;
+                    // use max_codes to early termination
+                    ivf_search_params.max_codes =
+                        (nprobe * 1.0 / index_->nlist) * (index_->ntotal - bitset.count());
+                } else {
+                    ivf_search_params.nprobe = nprobe;
+                    ivf_search_params.max_codes = 0;
+                }
 
-                    index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset, &ivf_search_params);
-                } else if constexpr (std::is_same<IndexType, faiss::IndexScaNN>::value) {
-                    auto cur_query = (const float*)data + index * dim;
-                    const ScannConfig& scann_cfg = static_cast<const ScannConfig&>(*cfg);
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                        cur_query = copied_query.get();
-                    }
+                index_->search(1, cur_query, k, distances + offset, ids + offset, &ivf_search_params);
+            } else if constexpr (std::is_same<IndexType, faiss::IndexScaNN>::value) {
+                auto cur_query = (const float*)data + index * dim;
+                const ScannConfig& scann_cfg = static_cast<const ScannConfig&>(*cfg);
+                if (is_cosine) {
+                    copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    cur_query = copied_query.get();
+                }
 
-                    // todo aguzhva: this is somewhat alogical. Refactor?
-                    faiss::IVFSearchParameters base_search_params;
-                    base_search_params.sel = id_selector;
-                    base_search_params.nprobe = nprobe;
-                    base_search_params.ensure_topk_full = scann_cfg.ensure_topk_full.value();
-                    if (base_search_params.ensure_topk_full) {
-                        if (auto base_index_ptr = reinterpret_cast<faiss::IndexIVFPQFastScan*>(index_->base_index)) {
-                            auto nlist = base_index_ptr->nlist;
-                            base_search_params.nprobe = nlist;
-                            // use max_codes to early termination
-                            base_search_params.max_codes = (nprobe * 1.0 / nlist) * (index_->ntotal - bitset.count());
-                            base_search_params.max_lists_num = nprobe;
-                        } else {
-                            throw std::runtime_error("invalid base index type of scann base index");
-                        }
+                // todo aguzhva: this is somewhat alogical. Refactor?
+                faiss::IVFSearchParameters base_search_params;
+                base_search_params.sel = id_selector;
+                base_search_params.nprobe = nprobe;
+                base_search_params.ensure_topk_full = scann_cfg.ensure_topk_full.value();
+                if (base_search_params.ensure_topk_full) {
+                    if (auto base_index_ptr = reinterpret_cast<faiss::IndexIVFPQFastScan*>(index_->base_index)) {
+                        auto nlist = base_index_ptr->nlist;
+                        base_search_params.nprobe = nlist;
+                        // use max_codes to early termination
+                        base_search_params.max_codes = (nprobe * 1.0 / nlist) * (index_->ntotal - bitset.count());
+                        base_search_params.max_lists_num = nprobe;
                     } else {
-                        base_search_params.nprobe = nprobe;
-                        base_search_params.max_codes = 0;
+                        throw std::runtime_error("invalid base index type of scann base index");
                     }
+                } else {
+                    base_search_params.nprobe = nprobe;
+                    base_search_params.max_codes = 0;
+                }
 
-                    faiss::IndexScaNNSearchParameters scann_search_params;
-                    scann_search_params.base_index_params = &base_search_params;
-                    scann_search_params.reorder_k = scann_cfg.reorder_k.value();
+                faiss::IndexScaNNSearchParameters scann_search_params;
+                scann_search_params.base_index_params = &base_search_params;
+                scann_search_params.reorder_k = scann_cfg.reorder_k.value();
 
-                    index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset, &scann_search_params);
-                } else if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
-                    auto cur_query = (const float*)data + index * dim;
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                        cur_query = copied_query.get();
-                    }
+                index_->search(1, cur_query, k, distances + offset, ids + offset, &scann_search_params);
+            } else if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
+                auto cur_query = (const float*)data + index * dim;
+                if (is_cosine) {
+                    copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    cur_query = copied_query.get();
+                }
 
-                    const IvfRaBitQConfig& ivf_rabitq_cfg = static_cast<const IvfRaBitQConfig&>(*cfg);
+                const IvfRaBitQConfig& ivf_rabitq_cfg = static_cast<const IvfRaBitQConfig&>(*cfg);
 
-                    // use refine?
-                    bool use_refine = false;
+                // use refine?
+                bool use_refine = false;
 
-                    const bool whether_to_enable_refine = ivf_rabitq_cfg.refine_k.has_value();
-                    if (const auto wrapper_index = dynamic_cast<const IndexIVFRaBitQWrapper*>(index_.get());
-                        wrapper_index != nullptr) {
-                        const faiss::IndexRefine* refine_index = wrapper_index->get_refine_index();
-                        use_refine = (refine_index != nullptr);
-                    }
+                const bool whether_to_enable_refine = ivf_rabitq_cfg.refine_k.has_value();
+                if (const auto wrapper_index = dynamic_cast<const IndexIVFRaBitQWrapper*>(index_.get());
+                    wrapper_index != nullptr) {
+                    const faiss::IndexRefine* refine_index = wrapper_index->get_refine_index();
+                    use_refine = (refine_index != nullptr);
+                }
 
-                    faiss::IVFRaBitQSearchParameters ivf_search_params;
-                    ivf_search_params.nprobe = nprobe;
-                    ivf_search_params.max_codes = 0;
-                    ivf_search_params.sel = id_selector;
-                    ivf_search_params.qb = ivf_rabitq_cfg.rbq_bits_query.value_or(0);
-
-                    if (use_refine && whether_to_enable_refine) {
-                        // yes, use refine
-                        faiss::IndexRefineSearchParameters refine_search_params;
-                        refine_search_params.sel = id_selector;
-                        refine_search_params.k_factor = ivf_rabitq_cfg.refine_k.value_or(1);
-                        refine_search_params.base_index_params = &ivf_search_params;
-
-                        index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset,
-                                       &refine_search_params);
-                    } else {
-                        // do not use refine
-                        index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset,
-                                       &ivf_search_params);
-                    }
+                faiss::IVFRaBitQSearchParameters ivf_search_params;
+                ivf_search_params.nprobe = nprobe;
+                ivf_search_params.max_codes = 0;
+                ivf_search_params.sel = id_selector;
+                ivf_search_params.qb = ivf_rabitq_cfg.rbq_bits_query.value_or(0);
+
+                if (use_refine && whether_to_enable_refine) {
+                    // yes, use refine
+                    faiss::IndexRefineSearchParameters refine_search_params;
+                    refine_search_params.sel = id_selector;
+                    refine_search_params.k_factor = ivf_rabitq_cfg.refine_k.value_or(1);
+                    refine_search_params.base_index_params = &ivf_search_params;
+
+                    index_->search(1, cur_query, k, distances + offset, ids + offset,
+                                   &refine_search_params);
                 } else {
-                    auto cur_query = (const float*)data + index * dim;
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                        cur_query = copied_query.get();
-                    }
+                    // do not use refine
+                    index_->search(1, cur_query, k, distances + offset, ids + offset,
+                                   &ivf_search_params);
+                }
+            } else {
+                auto cur_query = (const float*)data + index * dim;
+                if (is_cosine) {
+                    copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    cur_query = copied_query.get();
+                }
 
-                    faiss::IVFSearchParameters ivf_search_params;
-                    ivf_search_params.nprobe = nprobe;
-                    ivf_search_params.max_codes = 0;
-                    ivf_search_params.sel = id_selector;
+                faiss::IVFSearchParameters ivf_search_params;
+                ivf_search_params.nprobe = nprobe;
+                ivf_search_params.max_codes = 0;
+                ivf_search_params.sel = id_selector;
 
-                    index_->search(1, cur_query, k, distances.get() + offset, ids.get() + offset, &ivf_search_params);
-                }
-            }));
-        }
-        // wait for the completion
-        WaitAllSuccess(futs);
+                index_->search(1, cur_query, k, distances + offset, ids + offset, &ivf_search_params);
+            }
+        });
     } catch (const std::exception& e) {
         LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
-        return expected<DataSetPtr>::Err(Status::faiss_inner_error, e.what());
+        return search_error(msg, e.what(), Status::faiss_inner_error);
     }
-
-    auto res = GenResultDataSet(rows, k, std::move(ids), std::move(distances));
-    return res;
 }
 
 template <typename DataType, typename IndexType>
@@ -910,12 +1045,13 @@ IvfIndexNode<DataType, IndexType>::RangeSearch(const DataSetPtr dataset, std::un
         return expected<DataSetPtr>::Err(Status::index_not_trained, "index not trained");
     }
 
-    auto nq = dataset->GetRows();
-    auto xq = dataset->GetTensor();
-    auto dim = dataset->GetDim();
+    auto fp32_dataset = QueriesAsFp32(dataset);
+    auto nq = fp32_dataset->GetRows();
+    auto xq = fp32_dataset->GetTensor();
+    auto dim = fp32_dataset->GetDim();
 
     const IvfConfig& ivf_cfg = static_cast<const IvfConfig&>(*cfg);
-    bool is_cosine = IsMetricType(ivf_cfg.metric_type.value(), knowhere::metric::COSINE);
+    bool is_cosine = !kTypedStorage && IsMetricType(ivf_cfg.metric_type.value(), knowhere::metric::COSINE);
 
     float radius = ivf_cfg.radius.value();
     float range_filter = ivf_cfg.range_filter.value();
@@ -927,122 +1063,117 @@ IvfIndexNode<DataType, IndexType>::RangeSearch(const DataSetPtr dataset, std::un
     std::vector<std::vector<float>> result_dist_array(nq);
 
     try {
-        std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(nq);
-        for (int i = 0; i < nq; ++i) {
-            futs.emplace_back(search_pool_->push([&, index = i] {
-                ThreadPool::ScopedSearchOmpSetter setter(1);
-                faiss::RangeSearchResult res(1);
-                std::unique_ptr<float[]> copied_query = nullptr;
+        auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
+        search_pool->ParallelFor(0, nq, [&](int index) {
+            ThreadPool::ScopedSearchOmpSetter setter(1);
+            faiss::RangeSearchResult res(1);
+            std::unique_ptr<float[]> copied_query = nullptr;
 
-                BitsetViewIDSelector bw_idselector(bitset);
-                faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
+            BitsetViewIDSelector bw_idselector(bitset);
+            faiss::IDSelector* id_selector = (bitset.empty()) ? nullptr : &bw_idselector;
 
-                if constexpr (std::is_same<IndexType, faiss::IndexBinaryIVF>::value) {
-                    auto cur_data = (const uint8_t*)xq + index * ((dim + 7) / 8);
+            if constexpr (std::is_same<IndexType, faiss::IndexBinaryIVF>::value) {
+                auto cur_data = (const uint8_t*)xq + index * ((dim + 7) / 8);
 
-                    faiss::IVFSearchParameters ivf_search_params;
-                    ivf_search_params.nprobe = index_->nlist;
-                    ivf_search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
-                    ivf_search_params.sel = id_selector;
-
-                    index_->range_search(1, cur_data, radius, &res, &ivf_search_params);
-                } else if constexpr (std::is_same<IndexType, faiss::IndexIVFFlat>::value) {
-                    auto cur_query = (const float*)xq + index * dim;
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                        cur_query = copied_query.get();
-                    }
+                faiss::IVFSearchParameters ivf_search_params;
+                ivf_search_params.nprobe = index_->nlist;
+                ivf_search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
+                ivf_search_params.sel = id_selector;
 
-                    faiss::IVFSearchParameters ivf_search_params;
-                    ivf_search_params.nprobe = index_->nlist;
-                    ivf_search_params.max_codes = 0;
-                    ivf_search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
-                    ivf_search_params.sel = id_selector;
+                index_->range_search(1, cur_data, radius, &res, &ivf_search_params);
+            } else if constexpr (std::is_same<IndexType, faiss::IndexIVFFlat>::value) {
+                auto cur_query = (const float*)xq + index * dim;
+                if (is_cosine) {
+                    copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    cur_query = copied_query.get();
+                }
 
-                    index_->range_search(1, cur_query, radius, &res, &ivf_search_params);
-                } else if constexpr (std::is_same<IndexType, faiss::IndexScaNN>::value) {
-                    auto cur_query = (const float*)xq + index * dim;
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                        cur_query = copied_query.get();
-                    }
+                faiss::IVFSearchParameters ivf_search_params;
+                ivf_search_params.nprobe = index_->nlist;
+                ivf_search_params.max_codes = 0;
+                ivf_search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
+                ivf_search_params.sel = id_selector;
 
-                    // todo aguzhva: this is somewhat alogical. Refactor?
-                    faiss::IVFSearchParameters search_params;
-                    search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
-                    search_params.sel = id_selector;
-
-                    index_->range_search(1, cur_query, radius, &res, &search_params);
-                } else if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
-                    auto cur_query = (const float*)xq + index * dim;
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                        cur_query = copied_query.get();
-                    }
+                index_->range_search(1, cur_query, radius, &res, &ivf_search_params);
+            } else if constexpr (std::is_same<IndexType, faiss::IndexScaNN>::value) {
+                auto cur_query = (const float*)xq + index * dim;
+                if (is_cosine) {
+                    copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    cur_query = copied_query.get();
+                }
 
-                    const IvfRaBitQConfig& ivf_rabitq_cfg = static_cast<const IvfRaBitQConfig&>(*cfg);
+                // todo aguzhva: this is somewhat alogical. Refactor?
+                faiss::IVFSearchParameters search_params;
+                search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
+                search_params.sel = id_selector;
 
-                    const faiss::IndexIVFRaBitQ* uindex_ = index_->get_ivfrabitq_index();
+                index_->range_search(1, cur_query, radius, &res, &search_params);
+            } else if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
+                auto cur_query = (const float*)xq + index * dim;
+                if (is_cosine) {
+                    copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    cur_query = copied_query.get();
+                }
 
-                    faiss::IVFRaBitQSearchParameters ivf_search_params;
-                    ivf_search_params.nprobe = uindex_->nlist;
-                    ivf_search_params.max_codes = 0;
-                    ivf_search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
-                    ivf_search_params.sel = id_selector;
-                    ivf_search_params.qb = ivf_rabitq_cfg.rbq_bits_query.value_or(0);
-
-                    // use refine?
-                    bool use_refine = false;
-
-                    const bool whether_to_enable_refine = ivf_rabitq_cfg.refine_k.has_value();
-                    if (const auto wrapper_index = dynamic_cast<const IndexIVFRaBitQWrapper*>(index_.get());
-                        wrapper_index != nullptr) {
-                        const faiss::IndexRefine* refine_index = wrapper_index->get_refine_index();
-                        use_refine = (refine_index != nullptr);
-                    }
+                const IvfRaBitQConfig& ivf_rabitq_cfg = static_cast<const IvfRaBitQConfig&>(*cfg);
 
-                    if (use_refine && whether_to_enable_refine) {
-                        // yes, use refine
-                        faiss::IndexRefineSearchParameters refine_search_params;
-                        refine_search_params.sel = id_selector;
-                        refine_search_params.k_factor = ivf_rabitq_cfg.refine_k.value_or(1);
-                        refine_search_params.base_index_params = &ivf_search_params;
+                const faiss::IndexIVFRaBitQ* uindex_ = index_->get_ivfrabitq_index();
 
-                        index_->range_search(1, cur_query, radius, &res, &refine_search_params);
-                    } else {
-                        index_->range_search(1, cur_query, radius, &res, &ivf_search_params);
-                    }
-                } else {
-                    auto cur_query = (const float*)xq + index * dim;
-                    if (is_cosine) {
-                        copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
-                        cur_query = copied_query.get();
-                    }
+                faiss::IVFRaBitQSearchParameters ivf_search_params;
+                ivf_search_params.nprobe = uindex_->nlist;
+                ivf_search_params.max_codes = 0;
+                ivf_search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
+                ivf_search_params.sel = id_selector;
+                ivf_search_params.qb = ivf_rabitq_cfg.rbq_bits_query.value_or(0);
 
-                    faiss::IVFSearchParameters ivf_search_params;
-                    ivf_search_params.nprobe = index_->nlist;
-                    ivf_search_params.max_codes = 0;
-                    ivf_search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
-                    ivf_search_params.sel = id_selector;
+                // use refine?
+                bool use_refine = false;
 
-                    index_->range_search(1, cur_query, radius, &res, &ivf_search_params);
+                const bool whether_to_enable_refine = ivf_rabitq_cfg.refine_k.has_value();
+                if (const auto wrapper_index = dynamic_cast<const IndexIVFRaBitQWrapper*>(index_.get());
+                    wrapper_index != nullptr) {
+                    const faiss::IndexRefine* refine_index = wrapper_index->get_refine_index();
+                    use_refine = (refine_index != nullptr);
                 }
-                auto elem_cnt = res.lims[1];
-                result_dist_array[index].resize(elem_cnt);
-                result_id_array[index].resize(elem_cnt);
-                for (size_t j = 0; j < elem_cnt; j++) {
-                    result_dist_array[index][j] = res.distances[j];
-                    result_id_array[index][j] = res.labels[j];
+
+                if (use_refine && whether_to_enable_refine) {
+                    // yes, use refine
+                    faiss::IndexRefineSearchParameters refine_search_params;
+                    refine_search_params.sel = id_selector;
+                    refine_search_params.k_factor = ivf_rabitq_cfg.refine_k.value_or(1);
+                    refine_search_params.base_index_params = &ivf_search_params;
+
+                    index_->range_search(1, cur_query, radius, &res, &refine_search_params);
+                } else {
+                    index_->range_search(1, cur_query, radius, &res, &ivf_search_params);
                 }
-                if (range_filter != defaultRangeFilter) {
-                    FilterRangeSearchResultForOneNq(result_dist_array[index], result_id_array[index], is_ip, radius,
-                                                    range_filter);
+            } else {
+                auto cur_query = (const float*)xq + index * dim;
+                if (is_cosine) {
+                    copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
+                    cur_query = copied_query.get();
                 }
-            }));
-        }
-        // wait for the completion
-        WaitAllSuccess(futs);
+
+                faiss::IVFSearchParameters ivf_search_params;
+                ivf_search_params.nprobe = index_->nlist;
+                ivf_search_params.max_codes = 0;
+                ivf_search_params.max_empty_result_buckets = ivf_cfg.max_empty_result_buckets.value();
+                ivf_search_params.sel = id_selector;
+
+                index_->range_search(1, cur_query, radius, &res, &ivf_search_params);
+            }
+            auto elem_cnt = res.lims[1];
+            result_dist_array[index].resize(elem_cnt);
+            result_id_array[index].resize(elem_cnt);
+            for (size_t j = 0; j < elem_cnt; j++) {
+                result_dist_array[index][j] = res.distances[j];
+                result_id_array[index][j] = res.labels[j];
+            }
+            if (range_filter != defaultRangeFilter) {
+                FilterRangeSearchResultForOneNq(result_dist_array[index], result_id_array[index], is_ip, radius,
+                                                range_filter);
+            }
+        });
         range_search_result = GetRangeSearchResult(result_dist_array, result_id_array, is_ip, nq, radius, range_filter);
     } catch (const std::exception& e) {
         LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
@@ -1075,9 +1206,10 @@ IvfIndexNode<DataType, IndexType>::AnnIterator(const DataSetPtr dataset, std::un
                               << ", only IVFFlat, IVFFlatCC, IVF_SQ8, IVF_SQ_CC, SCANN and IVFRABITQ support Iterator.";
         return expected<std::vector<IndexNode::IteratorPtr>>::Err(Status::not_implemented, "index not supported");
     } else {
-        auto dim = dataset->GetDim();
-        auto rows = dataset->GetRows();
-        auto data = dataset->GetTensor();
+        auto fp32_dataset = QueriesAsFp32(dataset);
+        auto dim = fp32_dataset->GetDim();
+        auto rows = fp32_dataset->GetRows();
+        auto data = fp32_dataset->GetTensor();
 
         auto vec = std::vector<IndexNode::IteratorPtr>(rows, nullptr);
 
@@ -1098,7 +1230,7 @@ IvfIndexNode<DataType, IndexType>::AnnIterator(const DataSetPtr dataset, std::un
                 auto cur_query = (const float*)data + i * dim;
                 // if cosine, need normalize
                 std::unique_ptr<float[]> copied_query = nullptr;
-                if (is_cosine) {
+                if (is_cosine && !kTypedStorage) {
                     copied_query = CopyAndNormalizeVecs(cur_query, 1, dim);
                 } else {
                     copied_query = std::make_unique<float[]>(dim);
@@ -1145,6 +1277,26 @@ IvfIndexNode<DataType, IndexType>::GetVectorByIds(const DataSetPtr dataset) cons
             LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
             return expected<DataSetPtr>::Err(Status::faiss_inner_error, e.what());
         }
+    } else if constexpr (kTypedStorage) {
+        auto dim = Dim();
+        auto rows = dataset->GetRows();
+        auto ids = dataset->GetIds();
+
+        try {
+            // the codes of the lists are the vectors
+            auto data = std::make_unique<DataType[]>(dim * rows);
+            for (int64_t i = 0; i < rows; i++) {
+                int64_t id = ids[i];
+                assert(id >= 0 && id < index_->ntotal);
+                auto lo = index_->direct_map.get(id);
+                faiss::InvertedLists::ScopedCodes code(index_->invlists, faiss::lo_listno(lo), faiss::lo_offset(lo));
+                std::copy_n((const DataType*)code.get(), dim, data.get() + i * dim);
+            }
+            return GenResultDataSet(rows, dim, std::move(data));
+        } catch (const std::exception& e) {
+            LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
+            return expected<DataSetPtr>::Err(Status::faiss_inner_error, e.what());
+        }
     } else if constexpr (std::is_same<IndexType, faiss::IndexIVFFlat>::value ||
                          std::is_same<IndexType, faiss::IndexIVFFlatCC>::value) {
         auto dim = Dim();
@@ -1232,12 +1384,29 @@ IvfIndexNode<DataType, IndexType>::GetIndexMetaImpl(std::unique_ptr<Config>, IVF
 template <typename DataType, typename IndexType>
 Status
 IvfIndexNode<DataType, IndexType>::SerializeImpl(BinarySet& binset, IVFBaseTag) const {
+    MemoryIOWriter writer;
+    auto status = SerializeToWriter(writer);
+    std::shared_ptr<uint8_t[]> data(writer.data());
+    if (status == Status::success) {
+        binset.Append(Type(), data, writer.tellg());
+    }
+    return status;
+}
+
+template <typename DataType, typename IndexType>
+Status
+IvfIndexNode<DataType, IndexType>::SerializeToWriter(faiss::IOWriter& writer) const {
+    if constexpr (std::is_same_v<typename IndexDispatch<IndexType>::Tag, IVFFlatTag>) {
+        if (this->version_ <= Version::GetMinimalVersion()) {
+            LOG_KNOWHERE_WARNING_ << "IVF_FLAT_NM keeps its raw data in a separate binary, it can not be streamed";
+            return Status::not_implemented;
+        }
+    }
     try {
         if (!this->index_) {
             LOG_KNOWHERE_WARNING_ << "index can not be serialized for empty index";
             return Status::empty_index;
         }
-        MemoryIOWriter writer;
         if constexpr (std::is_same<IndexType, faiss::IndexBinaryIVF>::value) {
             faiss::write_index_binary(index_.get(), &writer);
         } else if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
@@ -1245,8 +1414,6 @@ IvfIndexNode<DataType, IndexType>::SerializeImpl(BinarySet& binset, IVFBaseTag)
         } else {
             faiss::write_index(index_.get(), &writer);
         }
-        std::shared_ptr<uint8_t[]> data(writer.data());
-        binset.Append(Type(), data, writer.tellg());
         return Status::success;
     } catch (const std::exception& e) {
         LOG_KNOWHERE_WARNING_ << "faiss inner error: " << e.what();
@@ -1313,13 +1480,19 @@ IvfIndexNode<DataType, IndexType>::Deserialize(const BinarySet& binset, std::sha
         return Status::invalid_binary_set;
     }
 
-    MemoryIOReader reader(binary->data.get(), binary->size);
+    const BaseConfig& base_cfg = static_cast<const BaseConfig&>(*cfg);
+    // IVF_FLAT_CC and IVF_SQ_CC keep growing after the load, they need their own copy of the data
+    const bool zero_copy = base_cfg.enable_zero_copy.value() &&
+                           !std::is_same_v<IndexType, faiss::IndexIVFFlatCC> &&
+                           !std::is_same_v<IndexType, faiss::IndexIVFScalarQuantizerCC>;
+    zero_copy_ = zero_copy;
+    auto reader = MakeFaissIndexReader(binary->data, binary->size, zero_copy);
     try {
         if constexpr (std::is_same<IndexType, IndexIVFRaBitQWrapper>::value) {
             // a special case for IVFRaBitQ, bcz a wrapper is involved.
 
             // deserialize
-            auto index_raw = std::unique_ptr<faiss::Index>(faiss::read_index(&reader));
+            auto index_raw = std::unique_ptr<faiss::Index>(faiss::read_index(reader.get()));
             auto index_wr = IndexIVFRaBitQWrapper::from_deserialized(std::move(index_raw));
             if (index_wr == nullptr) {
                 LOG_KNOWHERE_ERROR_ << "The deserialized index does not look like an IVFRaBitQ";
@@ -1333,22 +1506,26 @@ IvfIndexNode<DataType, IndexType>::Deserialize(const BinarySet& binset, std::sha
             if constexpr (std::is_same<IndexType, faiss::IndexIVFFlat>::value) {
                 if (this->version_ <= Version::GetMinimalVersion()) {
                     auto raw_binary = binset.GetByName("RAW_DATA");
-                    const BaseConfig& base_cfg = static_cast<const BaseConfig&>(*cfg);
                     ConvertIVFFlat(binset, base_cfg.metric_type.value(), raw_binary->data.get(), raw_binary->size);
                     // after conversion, binary size and data will be updated
-                    reader.data_ = binary->data.get();
-                    reader.total_ = binary->size;
+                    reader = MakeFaissIndexReader(binary->data, binary->size, zero_copy);
+                }
+                index_.reset(static_cast<faiss::IndexIVFFlat*>(faiss::read_index(reader.get())));
+                if constexpr (kTypedStorage) {
+                    if (dynamic_cast<faiss::IndexIVFFlatTyped*>(index_.get()) == nullptr) {
+                        LOG_KNOWHERE_ERROR_ << "Invalid binary set, not a typed IVF_FLAT index.";
+                        index_ = nullptr;
+                        return Status::invalid_binary_set;
+                    }
                 }
-                index_.reset(static_cast<faiss::IndexIVFFlat*>(faiss::read_index(&reader)));
             } else if constexpr (std::is_same<IndexType, faiss::IndexBinaryIVF>::value) {
-                index_.reset(static_cast<IndexType*>(faiss::read_index_binary(&reader)));
+                index_.reset(static_cast<IndexType*>(faiss::read_index_binary(reader.get())));
             } else {
-                index_.reset(static_cast<IndexType*>(faiss::read_index(&reader)));
+                index_.reset(static_cast<IndexType*>(faiss::read_index(reader.get())));
             }
 
             if constexpr (!std::is_same_v<IndexType, faiss::IndexScaNN> &&
                           !std::is_same_v<IndexType, faiss::IndexIVFScalarQuantizerCC>) {
-                const BaseConfig& base_cfg = static_cast<const BaseConfig&>(*cfg);
                 if (HasRawData(base_cfg.metric_type.value())) {
                     index_->make_direct_map(true);
                 }
@@ -1366,6 +1543,7 @@ Status
 IvfIndexNode<DataType, IndexType>::DeserializeFromFile(const std::string& filename, std::shared_ptr<Config> config) {
     auto cfg = static_cast<const knowhere::BaseConfig&>(*config);
 
+    zero_copy_ = false;
     int io_flags = 0;
     if (cfg.enable_mmap.value()) {
         io_flags |= faiss::IO_FLAG_MMAP;
@@ -1391,6 +1569,13 @@ IvfIndexNode<DataType, IndexType>::DeserializeFromFile(const std::string& filena
             } else {
                 index_.reset(static_cast<IndexType*>(faiss::read_index(filename.data(), io_flags)));
             }
+            if constexpr (kTypedStorage) {
+                if (dynamic_cast<faiss::IndexIVFFlatTyped*>(index_.get()) == nullptr) {
+                    LOG_KNOWHERE_ERROR_ << "Invalid index file, not a typed IVF_FLAT index.";
+                    index_ = nullptr;
+                    return Status::invalid_binary_set;
+                }
+            }
 
             if constexpr (!std::is_same_v<IndexType, faiss::IndexScaNN>) {
                 const BaseConfig& base_cfg = static_cast<const BaseConfig&>(*config);
@@ -1410,8 +1595,10 @@ KNOWHERE_SIMPLE_REGISTER_DENSE_BIN_GLOBAL(IVFBIN, IvfIndexNode, knowhere::featur
 KNOWHERE_SIMPLE_REGISTER_DENSE_BIN_GLOBAL(BIN_IVF_FLAT, IvfIndexNode, knowhere::feature::MMAP, faiss::IndexBinaryIVF)
 
 // float
-KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFFLAT, IvfIndexNode, knowhere::feature::MMAP, faiss::IndexIVFFlat)
-KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_FLAT, IvfIndexNode, knowhere::feature::MMAP, faiss::IndexIVFFlat)
+KNOWHERE_VERSIONED_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFFLAT, IvfIndexNode, knowhere::feature::MMAP,
+                                                        Version::GetFlatTypedStorageVersion(), faiss::IndexIVFFlat)
+KNOWHERE_VERSIONED_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_FLAT, IvfIndexNode, knowhere::feature::MMAP,
+                                                        Version::GetFlatTypedStorageVersion(), faiss::IndexIVFFlat)
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFFLATCC, IvfIndexNode, knowhere::feature::NONE, faiss::IndexIVFFlatCC)
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_FLAT_CC, IvfIndexNode, knowhere::feature::NONE, faiss::IndexIVFFlatCC)
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(SCANN, IvfIndexNode, knowhere::feature::MMAP, faiss::IndexScaNN)
@@ -1428,8 +1615,10 @@ KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_SQ_CC, IvfIndexNode, knowhere:
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVFRABITQ, IvfIndexNode, knowhere::feature::MMAP, IndexIVFRaBitQWrapper)
 KNOWHERE_MOCK_REGISTER_DENSE_FLOAT_ALL_GLOBAL(IVF_RABITQ, IvfIndexNode, knowhere::feature::MMAP, IndexIVFRaBitQWrapper)
 // int
-KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVFFLAT, IvfIndexNode, knowhere::feature::MMAP, faiss::IndexIVFFlat)
-KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVF_FLAT, IvfIndexNode, knowhere::feature::MMAP, faiss::IndexIVFFlat)
+KNOWHERE_VERSIONED_MOCK_REGISTER_DENSE_INT_GLOBAL(IVFFLAT, IvfIndexNode, knowhere::feature::MMAP,
+                                                  Version::GetFlatTypedStorageVersion(), faiss::IndexIVFFlat)
+KNOWHERE_VERSIONED_MOCK_REGISTER_DENSE_INT_GLOBAL(IVF_FLAT, IvfIndexNode, knowhere::feature::MMAP,
+                                                  Version::GetFlatTypedStorageVersion(), faiss::IndexIVFFlat)
 KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVFFLATCC, IvfIndexNode, knowhere::feature::NONE, faiss::IndexIVFFlatCC)
 KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(IVF_FLAT_CC, IvfIndexNode, knowhere::feature::NONE, faiss::IndexIVFFlatCC)
 KNOWHERE_MOCK_REGISTER_DENSE_INT_GLOBAL(SCANN, IvfIndexNode, knowhere::feature::MMAP, faiss::IndexScaNN)
@@ -41,7 +41,7 @@ class SparseInvertedIndexNode : public IndexNode {
 
  public:
     explicit SparseInvertedIndexNode(const int32_t& /*version*/, const Object& /*object*/)
-        : search_pool_(ThreadPool::GetGlobalSearchThreadPool()), build_pool_(ThreadPool::GetGlobalBuildThreadPool()) {
+        : build_pool_(ThreadPool::GetGlobalBuildThreadPool()) {
     }
 
     ~SparseInvertedIndexNode() override {
@@ -97,11 +97,41 @@ class SparseInvertedIndexNode : public IndexNode {
             return expected<DataSetPtr>::Err(Status::empty_index, "index not loaded");
         }
 
+        auto nq = dataset->GetRows();
+        auto k = static_cast<const SparseInvertedIndexConfig&>(*config).k.value();
+        auto p_id = std::make_unique<sparse::label_t[]>(nq * k);
+        auto p_dist = std::make_unique<float[]>(nq * k);
+        std::string msg;
+        auto status = SearchImpl(dataset, std::move(config), bitset, p_id.get(), p_dist.get(), &msg);
+        if (status != Status::success) {
+            return expected<DataSetPtr>::Err(status, msg);
+        }
+        return GenResultDataSet(nq, k, p_id.release(), p_dist.release());
+    }
+
+    [[nodiscard]] Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> config, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override {
+        if (!index_) {
+            LOG_KNOWHERE_ERROR_ << "Could not search empty " << Type();
+            return Status::empty_index;
+        }
+        return SearchImpl(dataset, std::move(config), bitset, ids, distances, nullptr);
+    }
+
+ private:
+    // searches into `ids` and `distances`, of k * nq entries each
+    Status
+    SearchImpl(const DataSetPtr dataset, std::unique_ptr<Config> config, const BitsetView& bitset,
+               sparse::label_t* ids, float* distances, std::string* msg) const {
         auto cfg = static_cast<const SparseInvertedIndexConfig&>(*config);
 
         auto computer_or = index_->GetDocValueComputer(cfg);
         if (!computer_or.has_value()) {
-            return expected<DataSetPtr>::Err(computer_or.error(), computer_or.what());
+            if (msg != nullptr) {
+                *msg = computer_or.what();
+            }
+            return computer_or.error();
         }
         auto computer = computer_or.value();
         auto dim_max_score_ratio = cfg.dim_max_score_ratio.value();
@@ -121,21 +151,13 @@ class SparseInvertedIndexNode : public IndexNode {
         auto queries = static_cast<const sparse::SparseRow<T>*>(dataset->GetTensor());
         auto nq = dataset->GetRows();
         auto k = cfg.k.value();
-        auto p_id = std::make_unique<sparse::label_t[]>(nq * k);
-        auto p_dist = std::make_unique<float[]>(nq * k);
 
-        std::vector<folly::Future<folly::Unit>> futs;
-        futs.reserve(nq);
-        for (int64_t idx = 0; idx < nq; ++idx) {
-            futs.emplace_back(search_pool_->push([&, idx = idx, p_id = p_id.get(), p_dist = p_dist.get()]() {
-                index_->Search(queries[idx], k, p_dist + idx * k, p_id + idx * k, bitset, computer, approx_params);
-            }));
-        }
-        WaitAllSuccess(futs);
-        return GenResultDataSet(nq, k, p_id.release(), p_dist.release());
+        auto search_pool = ThreadPool::GetGlobalSearchThreadPool();
+        return search_pool->ParallelFor(0, nq, [&](int64_t idx) {
+            index_->Search(queries[idx], k, distances + idx * k, ids + idx * k, bitset, computer, approx_params);
+        });
     }
 
- private:
     class RefineIterator : public IndexIterator {
      public:
         RefineIterator(const sparse::BaseInvertedIndex<T>* index, sparse::SparseRow<T>&& query,
@@ -262,10 +284,21 @@ class SparseInvertedIndexNode : public IndexNode {
             return Status::empty_index;
         }
         MemoryIOWriter writer;
-        RETURN_IF_ERROR(index_->Save(writer));
+        auto status = index_->Save(writer);
         std::shared_ptr<uint8_t[]> data(writer.data());
-        binset.Append(Type(), data, writer.tellg());
-        return Status::success;
+        if (status == Status::success) {
+            binset.Append(Type(), data, writer.tellg());
+        }
+        return status;
+    }
+
+    Status
+    SerializeToWriter(faiss::IOWriter& writer) const override {
+        if (!index_) {
+            LOG_KNOWHERE_ERROR_ << "Could not serialize empty " << Type();
+            return Status::empty_index;
+        }
+        return index_->Save(writer);
     }
 
     Status
@@ -355,6 +388,11 @@ class SparseInvertedIndexNode : public IndexNode {
         return index_ ? index_->n_rows() : 0;
     }
 
+    [[nodiscard]] std::vector<MemoryRegion>
+    GetMemoryRegions() const override {
+        return index_ ? index_->memory_regions() : std::vector<MemoryRegion>{};
+    }
+
     [[nodiscard]] std::string
     Type() const override {
         return use_wand ? knowhere::IndexEnum::INDEX_SPARSE_WAND : knowhere::IndexEnum::INDEX_SPARSE_INVERTED_INDEX;
@@ -424,7 +462,6 @@ class SparseInvertedIndexNode : public IndexNode {
     }
 
     sparse::BaseInvertedIndex<T>* index_{};
-    std::shared_ptr<ThreadPool> search_pool_;
     std::shared_ptr<ThreadPool> build_pool_;
 };  // class SparseInvertedIndexNode
 
@@ -470,6 +507,13 @@ class SparseInvertedIndexNodeCC : public SparseInvertedIndexNode<T, use_wand> {
         return SparseInvertedIndexNode<T, use_wand>::Search(dataset, std::move(cfg), bitset);
     }
 
+    Status
+    SearchInto(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset, int64_t* ids,
+               float* distances) const override {
+        ReadPermission permission(*this);
+        return SparseInvertedIndexNode<T, use_wand>::SearchInto(dataset, std::move(cfg), bitset, ids, distances);
+    }
+
     expected<std::vector<IndexNode::IteratorPtr>>
     AnnIterator(const DataSetPtr dataset, std::unique_ptr<Config> cfg, const BitsetView& bitset,
                 bool use_knowhere_search_pool) const override {
@@ -27,7 +27,9 @@
 #include "index/sparse/sparse_inverted_index_config.h"
 #include "io/memory_io.h"
 #include "knowhere/bitsetview.h"
+#include "knowhere/comp/cancel_token.h"
 #include "knowhere/comp/index_param.h"
+#include "knowhere/comp/memory_pages.h"
 #include "knowhere/expected.h"
 #include "knowhere/log.h"
 #include "knowhere/sparse_utils.h"
@@ -41,6 +43,9 @@ enum class InvertedIndexAlgo {
     DAAT_MAXSCORE,
 };
 
+// candidates scored by the DAAT searches between two polls of the cancel token of the request
+constexpr size_t kCancelCheckPeriod = 1024;
+
 struct InvertedIndexApproxSearchParams {
     int refine_factor;
     float drop_ratio_search;
@@ -52,8 +57,9 @@ class BaseInvertedIndex {
  public:
     virtual ~BaseInvertedIndex() = default;
 
+    // writer may be a MemoryIOWriter or a writer streaming to a file
     virtual Status
-    Save(MemoryIOWriter& writer) = 0;
+    Save(faiss::IOWriter& writer) = 0;
 
     // supplement_target_filename: when in mmap mode, we need an extra file to store the mmapped index data structure.
     // this file will be created during loading and deleted in the destructor.
@@ -88,6 +94,12 @@ class BaseInvertedIndex {
 
     [[nodiscard]] virtual size_t
     n_cols() const = 0;
+
+    // the mmapped inverted lists, see Load()
+    [[nodiscard]] virtual std::vector<MemoryRegion>
+    memory_regions() const {
+        return {};
+    }
 };
 
 template <typename DType, typename QType, InvertedIndexAlgo algo, bool mmapped = false>
@@ -164,7 +176,7 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
     }
 
     Status
-    Save(MemoryIOWriter& writer) override {
+    Save(faiss::IOWriter& writer) override {
         /**
          * Layout:
          *
@@ -184,10 +196,11 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
          *
          * Data are densely packed in serialized bytes and no padding is added.
          */
+        IOWriterAdapter out(writer);
         DType deprecated_value_threshold = 0;
-        writeBinaryPOD(writer, n_rows_internal_);
-        writeBinaryPOD(writer, max_dim_);
-        writeBinaryPOD(writer, deprecated_value_threshold);
+        writeBinaryPOD(out, n_rows_internal_);
+        writeBinaryPOD(out, max_dim_);
+        writeBinaryPOD(out, deprecated_value_threshold);
         BitsetView bitset(nullptr, 0);
 
         auto dim_map_reverse = std::unordered_map<uint32_t, table_t>();
@@ -218,12 +231,16 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         }
 
         for (table_t vec_id = 0; vec_id < n_rows_internal_; ++vec_id) {
-            writeBinaryPOD(writer, raw_rows[vec_id].size());
+            writeBinaryPOD(out, raw_rows[vec_id].size());
             if (raw_rows[vec_id].size() > 0) {
-                writer.write(raw_rows[vec_id].data(), raw_rows[vec_id].size() * SparseRow<DType>::element_size());
+                out.write(raw_rows[vec_id].data(), raw_rows[vec_id].size() * SparseRow<DType>::element_size());
             }
         }
 
+        if (!out.ok_) {
+            LOG_KNOWHERE_ERROR_ << "Failed to write the sparse inverted index";
+            return Status::disk_file_error;
+        }
         return Status::success;
     }
 
@@ -544,6 +561,16 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         return max_dim_;
     }
 
+    [[nodiscard]] std::vector<MemoryRegion>
+    memory_regions() const override {
+        if constexpr (mmapped) {
+            if (map_ != nullptr) {
+                return {MemoryRegion{map_, map_byte_size_, true, true}};
+            }
+        }
+        return {};
+    }
+
  private:
     // Given a vector of values, returns the threshold value.
     // All values strictly smaller than the threshold will be ignored.
@@ -566,6 +593,9 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
                           const DocValueComputer<float>& computer) const {
         std::vector<float> scores(n_rows_internal_, 0.0f);
         for (size_t i = 0; i < q_vec.size(); ++i) {
+            if (CancelToken::CurrentIsCancelled()) {
+                break;
+            }
             auto& plist_ids = inverted_index_ids_[q_vec[i].first];
             auto& plist_vals = inverted_index_vals_[q_vec[i].first];
             // TODO: improve with SIMD
@@ -712,7 +742,11 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         };
         sort_cursors();
 
+        size_t num_iters = 0;
         while (true) {
+            if (++num_iters % kCancelCheckPeriod == 0 && CancelToken::CurrentIsCancelled()) {
+                break;
+            }
             float threshold = heap.full() ? heap.top().val : 0;
             float upper_bound = 0;
             size_t pivot;
@@ -800,7 +834,11 @@ class InvertedIndex : public BaseInvertedIndex<DType> {
         float curr_cand_score = 0.0f;
         table_t curr_cand_vec_id = 0;
 
+        size_t num_iters = 0;
         while (curr_cand_vec_id < n_rows_internal_) {
+            if (++num_iters % kCancelCheckPeriod == 0 && CancelToken::CurrentIsCancelled()) {
+                return;
+            }
             auto found_cand = false;
             while (found_cand == false) {
                 // start find from next_vec_id
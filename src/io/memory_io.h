@@ -12,6 +12,11 @@
 #pragma once
 
 #include <faiss/impl/io.h>
+#include <faiss/impl/maybe_owned_vector.h>
+#include <faiss/impl/zerocopy_io.h>
+
+#include <memory>
+#include <utility>
 
 namespace knowhere {
 
@@ -102,6 +107,31 @@ struct MemoryIOWriter : public faiss::IOWriter {
     }
 };
 
+// the write() of MemoryIOWriter, byte order handling included, on top of any faiss writer, e.g. one streaming to a
+// file. writeBinaryPOD() then produces the same bytes through either of them.
+struct IOWriterAdapter {
+    faiss::IOWriter& writer_;
+    // false once a write came short
+    bool ok_ = true;
+
+    explicit IOWriterAdapter(faiss::IOWriter& writer) : writer_(writer) {
+    }
+
+    template <typename T>
+    size_t
+    write(T* ptr, size_t size, size_t nitems = 1) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        for (size_t i = 0; i < nitems; ++i) {
+            *(ptr + i) = getSwappedBytes(*(ptr + i));
+        }
+
+#endif
+        const auto written = writer_((const void*)ptr, size, nitems);
+        ok_ = ok_ && written == nitems;
+        return written;
+    }
+};
+
 struct MemoryIOReader : public faiss::IOReader {
     uint8_t* data_;
     size_t rp_ = 0;
@@ -162,4 +192,25 @@ struct MemoryIOReader : public faiss::IOReader {
     }
 };
 
+// shares the buffer of a binary with the faiss vectors viewing into it
+struct BinaryDataOwner : public faiss::MaybeOwnedVectorOwner {
+    explicit BinaryDataOwner(std::shared_ptr<uint8_t[]> data) : data_(std::move(data)) {
+    }
+
+    std::shared_ptr<uint8_t[]> data_;
+};
+
+// Reader of a faiss index serialized into `data`. With `zero_copy`, the codes, graph neighbors and inverted lists of
+// the index read are views into `data` instead of copies of it, which halves the peak memory of the load. The views
+// keep `data` alive, it must not be modified as long as the index is in use. Such an index cannot grow.
+// a reader of the `size` bytes of `data` starting at `offset`
+inline std::unique_ptr<faiss::IOReader>
+MakeFaissIndexReader(const std::shared_ptr<uint8_t[]>& data, size_t size, bool zero_copy, size_t offset = 0) {
+    if (zero_copy) {
+        return std::make_unique<faiss::ZeroCopyIOReader>(data.get() + offset, size,
+                                                         std::make_shared<BinaryDataOwner>(data));
+    }
+    return std::make_unique<MemoryIOReader>(data.get() + offset, size);
+}
+
 }  // namespace knowhere
@@ -15,6 +15,7 @@
 
 #include <immintrin.h>
 
+#include <algorithm>
 #include <cassert>
 
 #include "faiss/impl/platform_macros.h"
@@ -965,6 +966,650 @@ int8_vec_L2sqr_batch_4_avx(const int8_t* x, const int8_t* y0, const int8_t* y1,
 }
 FAISS_PRAGMA_IMPRECISE_FUNCTION_END
 
+///////////////////////////////////////////////////////////////////////////////
+// fp32 query against fp16, bf16 and int8 vectors
+
+namespace {
+// converts 8 consecutive elements to fp32
+inline __m256
+mm256_load_fp32(const float* x) {
+    return _mm256_loadu_ps(x);
+}
+
+inline __m256
+mm256_load_fp32(const knowhere::fp16* x) {
+    return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)x));
+}
+
+inline __m256
+mm256_load_fp32(const knowhere::bf16* x) {
+    return _mm256_bf16_to_fp32(_mm_loadu_si128((const __m128i*)x));
+}
+
+inline __m256
+mm256_load_fp32(const int8_t* x) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)x)));
+}
+
+// converts 0 <= d < 8 elements to fp32, the other lanes are zeros
+template <typename T>
+inline __m256
+mm256_masked_load_fp32(size_t d, const T* x) {
+    assert(d < 8);
+    T buf[8] = {};
+    std::copy_n(x, d, buf);
+    return mm256_load_fp32(buf);
+}
+
+template <typename T>
+float
+typed_avx_inner_product(const float* x, const T* y, size_t d) {
+    __m256 msum_0 = _mm256_setzero_ps();
+    __m256 msum_1 = _mm256_setzero_ps();
+    while (d >= 16) {
+        msum_0 = _mm256_fmadd_ps(mm256_load_fp32(x), mm256_load_fp32(y), msum_0);
+        msum_1 = _mm256_fmadd_ps(mm256_load_fp32(x + 8), mm256_load_fp32(y + 8), msum_1);
+        x += 16;
+        y += 16;
+        d -= 16;
+    }
+    if (d >= 8) {
+        msum_0 = _mm256_fmadd_ps(mm256_load_fp32(x), mm256_load_fp32(y), msum_0);
+        x += 8;
+        y += 8;
+        d -= 8;
+    }
+    if (d > 0) {
+        msum_1 = _mm256_fmadd_ps(mm256_masked_load_fp32(d, x), mm256_masked_load_fp32(d, y), msum_1);
+    }
+    return _mm256_reduce_add_ps(_mm256_add_ps(msum_0, msum_1));
+}
+
+template <typename T>
+float
+typed_avx_L2sqr(const float* x, const T* y, size_t d) {
+    __m256 msum_0 = _mm256_setzero_ps();
+    __m256 msum_1 = _mm256_setzero_ps();
+    while (d >= 16) {
+        auto diff_0 = _mm256_sub_ps(mm256_load_fp32(x), mm256_load_fp32(y));
+        auto diff_1 = _mm256_sub_ps(mm256_load_fp32(x + 8), mm256_load_fp32(y + 8));
+        msum_0 = _mm256_fmadd_ps(diff_0, diff_0, msum_0);
+        msum_1 = _mm256_fmadd_ps(diff_1, diff_1, msum_1);
+        x += 16;
+        y += 16;
+        d -= 16;
+    }
+    if (d >= 8) {
+        auto diff = _mm256_sub_ps(mm256_load_fp32(x), mm256_load_fp32(y));
+        msum_0 = _mm256_fmadd_ps(diff, diff, msum_0);
+        x += 8;
+        y += 8;
+        d -= 8;
+    }
+    if (d > 0) {
+        auto diff = _mm256_sub_ps(mm256_masked_load_fp32(d, x), mm256_masked_load_fp32(d, y));
+        msum_1 = _mm256_fmadd_ps(diff, diff, msum_1);
+    }
+    return _mm256_reduce_add_ps(_mm256_add_ps(msum_0, msum_1));
+}
+
+template <typename T>
+void
+typed_avx_inner_product_batch_4(const float* x, const T* y0, const T* y1, const T* y2, const T* y3, const size_t d,
+                                float& dis0, float& dis1, float& dis2, float& dis3) {
+    __m256 msum_0 = _mm256_setzero_ps();
+    __m256 msum_1 = _mm256_setzero_ps();
+    __m256 msum_2 = _mm256_setzero_ps();
+    __m256 msum_3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= d; i += 8) {
+        auto mx = mm256_load_fp32(x + i);
+        msum_0 = _mm256_fmadd_ps(mx, mm256_load_fp32(y0 + i), msum_0);
+        msum_1 = _mm256_fmadd_ps(mx, mm256_load_fp32(y1 + i), msum_1);
+        msum_2 = _mm256_fmadd_ps(mx, mm256_load_fp32(y2 + i), msum_2);
+        msum_3 = _mm256_fmadd_ps(mx, mm256_load_fp32(y3 + i), msum_3);
+    }
+    if (i < d) {
+        auto mx = mm256_masked_load_fp32(d - i, x + i);
+        msum_0 = _mm256_fmadd_ps(mx, mm256_masked_load_fp32(d - i, y0 + i), msum_0);
+        msum_1 = _mm256_fmadd_ps(mx, mm256_masked_load_fp32(d - i, y1 + i), msum_1);
+        msum_2 = _mm256_fmadd_ps(mx, mm256_masked_load_fp32(d - i, y2 + i), msum_2);
+        msum_3 = _mm256_fmadd_ps(mx, mm256_masked_load_fp32(d - i, y3 + i), msum_3);
+    }
+    dis0 = _mm256_reduce_add_ps(msum_0);
+    dis1 = _mm256_reduce_add_ps(msum_1);
+    dis2 = _mm256_reduce_add_ps(msum_2);
+    dis3 = _mm256_reduce_add_ps(msum_3);
+}
+
+template <typename T>
+void
+typed_avx_L2sqr_batch_4(const float* x, const T* y0, const T* y1, const T* y2, const T* y3, const size_t d,
+                        float& dis0, float& dis1, float& dis2, float& dis3) {
+    __m256 msum_0 = _mm256_setzero_ps();
+    __m256 msum_1 = _mm256_setzero_ps();
+    __m256 msum_2 = _mm256_setzero_ps();
+    __m256 msum_3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= d; i += 8) {
+        auto mx = mm256_load_fp32(x + i);
+        auto diff_0 = _mm256_sub_ps(mx, mm256_load_fp32(y0 + i));
+        auto diff_1 = _mm256_sub_ps(mx, mm256_load_fp32(y1 + i));
+        auto diff_2 = _mm256_sub_ps(mx, mm256_load_fp32(y2 + i));
+        auto diff_3 = _mm256_sub_ps(mx, mm256_load_fp32(y3 + i));
+        msum_0 = _mm256_fmadd_ps(diff_0, diff_0, msum_0);
+        msum_1 = _mm256_fmadd_ps(diff_1, diff_1, msum_1);
+        msum_2 = _mm256_fmadd_ps(diff_2, diff_2, msum_2);
+        msum_3 = _mm256_fmadd_ps(diff_3, diff_3, msum_3);
+    }
+    if (i < d) {
+        auto mx = mm256_masked_load_fp32(d - i, x + i);
+        auto diff_0 = _mm256_sub_ps(mx, mm256_masked_load_fp32(d - i, y0 + i));
+        auto diff_1 = _mm256_sub_ps(mx, mm256_masked_load_fp32(d - i, y1 + i));
+        auto diff_2 = _mm256_sub_ps(mx, mm256_masked_load_fp32(d - i, y2 + i));
+        auto diff_3 = _mm256_sub_ps(mx, mm256_masked_load_fp32(d - i, y3 + i));
+        msum_0 = _mm256_fmadd_ps(diff_0, diff_0, msum_0);
+        msum_1 = _mm256_fmadd_ps(diff_1, diff_1, msum_1);
+        msum_2 = _mm256_fmadd_ps(diff_2, diff_2, msum_2);
+        msum_3 = _mm256_fmadd_ps(diff_3, diff_3, msum_3);
+    }
+    dis0 = _mm256_reduce_add_ps(msum_0);
+    dis1 = _mm256_reduce_add_ps(msum_1);
+    dis2 = _mm256_reduce_add_ps(msum_2);
+    dis3 = _mm256_reduce_add_ps(msum_3);
+}
+
+// sums each of a0..a7 and stores the 8 sums to dis[0..7]
+inline void
+mm256_reduce_add_8_ps(float* dis, __m256 a0, __m256 a1, __m256 a2, __m256 a3, __m256 a4, __m256 a5, __m256 a6,
+                      __m256 a7) {
+    // [a0 a1 a2 a3 | a0 a1 a2 a3] and [a4 a5 a6 a7 | a4 a5 a6 a7] partial sums
+    const __m256 s_0 = _mm256_hadd_ps(_mm256_hadd_ps(a0, a1), _mm256_hadd_ps(a2, a3));
+    const __m256 s_1 = _mm256_hadd_ps(_mm256_hadd_ps(a4, a5), _mm256_hadd_ps(a6, a7));
+    _mm256_storeu_ps(dis,
+                     _mm256_add_ps(_mm256_permute2f128_ps(s_0, s_1, 0x20), _mm256_permute2f128_ps(s_0, s_1, 0x31)));
+}
+
+// accumulates x * y, or (x - y)^2 for L2
+template <bool L2>
+inline __m256
+mm256_accumulate(__m256 msum, __m256 mx, __m256 my) {
+    if constexpr (L2) {
+        const __m256 diff = _mm256_sub_ps(mx, my);
+        return _mm256_fmadd_ps(diff, diff, msum);
+    } else {
+        return _mm256_fmadd_ps(mx, my, msum);
+    }
+}
+
+// ny distances in blocks of 8 rows: each chunk of x is loaded and converted once and accumulated against the 8 rows
+// in registers, and the 8 sums are reduced together. The rows that do not fill a block go through batch_4 and single.
+template <bool L2, auto single, auto batch_4, typename TX, typename TY>
+void
+typed_avx_ny(float* dis, const TX* x, const TY* y, size_t d, size_t ny) {
+    size_t i = 0;
+    for (; i + 8 <= ny; i += 8) {
+        const TY* y0 = y;
+        const TY* y1 = y0 + d;
+        const TY* y2 = y1 + d;
+        const TY* y3 = y2 + d;
+        const TY* y4 = y3 + d;
+        const TY* y5 = y4 + d;
+        const TY* y6 = y5 + d;
+        const TY* y7 = y6 + d;
+        __m256 msum_0 = _mm256_setzero_ps();
+        __m256 msum_1 = _mm256_setzero_ps();
+        __m256 msum_2 = _mm256_setzero_ps();
+        __m256 msum_3 = _mm256_setzero_ps();
+        __m256 msum_4 = _mm256_setzero_ps();
+        __m256 msum_5 = _mm256_setzero_ps();
+        __m256 msum_6 = _mm256_setzero_ps();
+        __m256 msum_7 = _mm256_setzero_ps();
+        size_t j = 0;
+        for (; j + 8 <= d; j += 8) {
+            const __m256 mx = mm256_load_fp32(x + j);
+            msum_0 = mm256_accumulate<L2>(msum_0, mx, mm256_load_fp32(y0 + j));
+            msum_1 = mm256_accumulate<L2>(msum_1, mx, mm256_load_fp32(y1 + j));
+            msum_2 = mm256_accumulate<L2>(msum_2, mx, mm256_load_fp32(y2 + j));
+            msum_3 = mm256_accumulate<L2>(msum_3, mx, mm256_load_fp32(y3 + j));
+            msum_4 = mm256_accumulate<L2>(msum_4, mx, mm256_load_fp32(y4 + j));
+            msum_5 = mm256_accumulate<L2>(msum_5, mx, mm256_load_fp32(y5 + j));
+            msum_6 = mm256_accumulate<L2>(msum_6, mx, mm256_load_fp32(y6 + j));
+            msum_7 = mm256_accumulate<L2>(msum_7, mx, mm256_load_fp32(y7 + j));
+        }
+        if (j < d) {
+            const __m256 mx = mm256_masked_load_fp32(d - j, x + j);
+            msum_0 = mm256_accumulate<L2>(msum_0, mx, mm256_masked_load_fp32(d - j, y0 + j));
+            msum_1 = mm256_accumulate<L2>(msum_1, mx, mm256_masked_load_fp32(d - j, y1 + j));
+            msum_2 = mm256_accumulate<L2>(msum_2, mx, mm256_masked_load_fp32(d - j, y2 + j));
+            msum_3 = mm256_accumulate<L2>(msum_3, mx, mm256_masked_load_fp32(d - j, y3 + j));
+            msum_4 = mm256_accumulate<L2>(msum_4, mx, mm256_masked_load_fp32(d - j, y4 + j));
+            msum_5 = mm256_accumulate<L2>(msum_5, mx, mm256_masked_load_fp32(d - j, y5 + j));
+            msum_6 = mm256_accumulate<L2>(msum_6, mx, mm256_masked_load_fp32(d - j, y6 + j));
+            msum_7 = mm256_accumulate<L2>(msum_7, mx, mm256_masked_load_fp32(d - j, y7 + j));
+        }
+        mm256_reduce_add_8_ps(dis + i, msum_0, msum_1, msum_2, msum_3, msum_4, msum_5, msum_6, msum_7);
+        y += 8 * d;
+    }
+    if (i + 4 <= ny) {
+        batch_4(x, y, y + d, y + 2 * d, y + 3 * d, d, dis[i], dis[i + 1], dis[i + 2], dis[i + 3]);
+        y += 4 * d;
+        i += 4;
+    }
+    for (; i < ny; i++) {
+        dis[i] = single(x, y, d);
+        y += d;
+    }
+}
+
+// sums the int32 lanes of each of a0..a7 and stores the 8 sums to dis[0..7] as floats
+inline void
+mm256_reduce_add_8_epi32(float* dis, __m256i a0, __m256i a1, __m256i a2, __m256i a3, __m256i a4, __m256i a5,
+                         __m256i a6, __m256i a7) {
+    const __m256i s_0 = _mm256_hadd_epi32(_mm256_hadd_epi32(a0, a1), _mm256_hadd_epi32(a2, a3));
+    const __m256i s_1 = _mm256_hadd_epi32(_mm256_hadd_epi32(a4, a5), _mm256_hadd_epi32(a6, a7));
+    const __m256i sum =
+        _mm256_add_epi32(_mm256_permute2x128_si256(s_0, s_1, 0x20), _mm256_permute2x128_si256(s_0, s_1, 0x31));
+    _mm256_storeu_ps(dis, _mm256_cvtepi32_ps(sum));
+}
+
+// accumulates x * y, or (x - y)^2 for L2, of 16 int16 lanes into 8 int32 lanes
+template <bool L2>
+inline __m256i
+mm256_accumulate_epi16(__m256i msum, __m256i mx, __m256i my) {
+    if constexpr (L2) {
+        const __m256i diff = _mm256_sub_epi16(mx, my);
+        return _mm256_add_epi32(msum, _mm256_madd_epi16(diff, diff));
+    } else {
+        return _mm256_add_epi32(msum, _mm256_madd_epi16(mx, my));
+    }
+}
+
+// converts 16 consecutive int8 to int16
+inline __m256i
+mm256_load_epi16(const int8_t* x) {
+    return _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)x));
+}
+
+// converts 0 <= d < 16 int8 to int16, the other lanes are zeros
+inline __m256i
+mm256_masked_load_epi16(size_t d, const int8_t* x) {
+    assert(d < 16);
+    int8_t buf[16] = {};
+    std::copy_n(x, d, buf);
+    return mm256_load_epi16(buf);
+}
+
+// int8 ny distances in blocks of 8 rows like typed_avx_ny, the products are summed exactly in int32
+template <bool L2, auto single, auto batch_4>
+void
+int8_avx_ny(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+    size_t i = 0;
+    for (; i + 8 <= ny; i += 8) {
+        const int8_t* y0 = y;
+        const int8_t* y1 = y0 + d;
+        const int8_t* y2 = y1 + d;
+        const int8_t* y3 = y2 + d;
+        const int8_t* y4 = y3 + d;
+        const int8_t* y5 = y4 + d;
+        const int8_t* y6 = y5 + d;
+        const int8_t* y7 = y6 + d;
+        __m256i msum_0 = _mm256_setzero_si256();
+        __m256i msum_1 = _mm256_setzero_si256();
+        __m256i msum_2 = _mm256_setzero_si256();
+        __m256i msum_3 = _mm256_setzero_si256();
+        __m256i msum_4 = _mm256_setzero_si256();
+        __m256i msum_5 = _mm256_setzero_si256();
+        __m256i msum_6 = _mm256_setzero_si256();
+        __m256i msum_7 = _mm256_setzero_si256();
+        size_t j = 0;
+        for (; j + 16 <= d; j += 16) {
+            const __m256i mx = mm256_load_epi16(x + j);
+            msum_0 = mm256_accumulate_epi16<L2>(msum_0, mx, mm256_load_epi16(y0 + j));
+            msum_1 = mm256_accumulate_epi16<L2>(msum_1, mx, mm256_load_epi16(y1 + j));
+            msum_2 = mm256_accumulate_epi16<L2>(msum_2, mx, mm256_load_epi16(y2 + j));
+            msum_3 = mm256_accumulate_epi16<L2>(msum_3, mx, mm256_load_epi16(y3 + j));
+            msum_4 = mm256_accumulate_epi16<L2>(msum_4, mx, mm256_load_epi16(y4 + j));
+            msum_5 = mm256_accumulate_epi16<L2>(msum_5, mx, mm256_load_epi16(y5 + j));
+            msum_6 = mm256_accumulate_epi16<L2>(msum_6, mx, mm256_load_epi16(y6 + j));
+            msum_7 = mm256_accumulate_epi16<L2>(msum_7, mx, mm256_load_epi16(y7 + j));
+        }
+        if (j < d) {
+            const __m256i mx = mm256_masked_load_epi16(d - j, x + j);
+            msum_0 = mm256_accumulate_epi16<L2>(msum_0, mx, mm256_masked_load_epi16(d - j, y0 + j));
+            msum_1 = mm256_accumulate_epi16<L2>(msum_1, mx, mm256_masked_load_epi16(d - j, y1 + j));
+            msum_2 = mm256_accumulate_epi16<L2>(msum_2, mx, mm256_masked_load_epi16(d - j, y2 + j));
+            msum_3 = mm256_accumulate_epi16<L2>(msum_3, mx, mm256_masked_load_epi16(d - j, y3 + j));
+            msum_4 = mm256_accumulate_epi16<L2>(msum_4, mx, mm256_masked_load_epi16(d - j, y4 + j));
+            msum_5 = mm256_accumulate_epi16<L2>(msum_5, mx, mm256_masked_load_epi16(d - j, y5 + j));
+            msum_6 = mm256_accumulate_epi16<L2>(msum_6, mx, mm256_masked_load_epi16(d - j, y6 + j));
+            msum_7 = mm256_accumulate_epi16<L2>(msum_7, mx, mm256_masked_load_epi16(d - j, y7 + j));
+        }
+        mm256_reduce_add_8_epi32(dis + i, msum_0, msum_1, msum_2, msum_3, msum_4, msum_5, msum_6, msum_7);
+        y += 8 * d;
+    }
+    if (i + 4 <= ny) {
+        batch_4(x, y, y + d, y + 2 * d, y + 3 * d, d, dis[i], dis[i + 1], dis[i + 2], dis[i + 3]);
+        y += 4 * d;
+        i += 4;
+    }
+    for (; i < ny; i++) {
+        dis[i] = single(x, y, d);
+        y += d;
+    }
+}
+}  // namespace
+
+float
+fvec_fp16_inner_product_avx(const float* x, const knowhere::fp16* y, size_t d) {
+    return typed_avx_inner_product(x, y, d);
+}
+
+float
+fvec_fp16_L2sqr_avx(const float* x, const knowhere::fp16* y, size_t d) {
+    return typed_avx_L2sqr(x, y, d);
+}
+
+void
+fvec_fp16_inner_product_batch_4_avx(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                                    const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                                    float& dis1, float& dis2, float& dis3) {
+    typed_avx_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_fp16_L2sqr_batch_4_avx(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                            const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                            float& dis1, float& dis2, float& dis3) {
+    typed_avx_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_fp16_inner_products_ny_avx(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_avx_ny<false, typed_avx_inner_product<knowhere::fp16>, typed_avx_inner_product_batch_4<knowhere::fp16>>(
+        dis, x, y, d, ny);
+}
+
+void
+fvec_fp16_L2sqr_ny_avx(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_avx_ny<true, typed_avx_L2sqr<knowhere::fp16>, typed_avx_L2sqr_batch_4<knowhere::fp16>>(dis, x, y, d, ny);
+}
+
+float
+fvec_bf16_inner_product_avx(const float* x, const knowhere::bf16* y, size_t d) {
+    return typed_avx_inner_product(x, y, d);
+}
+
+float
+fvec_bf16_L2sqr_avx(const float* x, const knowhere::bf16* y, size_t d) {
+    return typed_avx_L2sqr(x, y, d);
+}
+
+void
+fvec_bf16_inner_product_batch_4_avx(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                                    const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                                    float& dis1, float& dis2, float& dis3) {
+    typed_avx_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_bf16_L2sqr_batch_4_avx(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                            const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                            float& dis1, float& dis2, float& dis3) {
+    typed_avx_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_bf16_inner_products_ny_avx(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_avx_ny<false, typed_avx_inner_product<knowhere::bf16>, typed_avx_inner_product_batch_4<knowhere::bf16>>(
+        dis, x, y, d, ny);
+}
+
+void
+fvec_bf16_L2sqr_ny_avx(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_avx_ny<true, typed_avx_L2sqr<knowhere::bf16>, typed_avx_L2sqr_batch_4<knowhere::bf16>>(dis, x, y, d, ny);
+}
+
+float
+fvec_int8_inner_product_avx(const float* x, const int8_t* y, size_t d) {
+    return typed_avx_inner_product(x, y, d);
+}
+
+float
+fvec_int8_L2sqr_avx(const float* x, const int8_t* y, size_t d) {
+    return typed_avx_L2sqr(x, y, d);
+}
+
+void
+fvec_int8_inner_product_batch_4_avx(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                    const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                    float& dis3) {
+    typed_avx_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_int8_L2sqr_batch_4_avx(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
+                            const size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
+    typed_avx_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_int8_inner_products_ny_avx(float* dis, const float* x, const int8_t* y, size_t d, size_t ny) {
+    typed_avx_ny<false, typed_avx_inner_product<int8_t>, typed_avx_inner_product_batch_4<int8_t>>(dis, x, y, d, ny);
+}
+
+void
+fvec_int8_L2sqr_ny_avx(float* dis, const float* x, const int8_t* y, size_t d, size_t ny) {
+    typed_avx_ny<true, typed_avx_L2sqr<int8_t>, typed_avx_L2sqr_batch_4<int8_t>>(dis, x, y, d, ny);
+}
+
+// fp16, bf16 and int8 queries against vectors of the same type
+void
+fp16_vec_inner_products_ny_avx(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_avx_ny<false, fp16_vec_inner_product_avx, fp16_vec_inner_product_batch_4_avx>(dis, x, y, d, ny);
+}
+
+void
+fp16_vec_L2sqr_ny_avx(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_avx_ny<true, fp16_vec_L2sqr_avx, fp16_vec_L2sqr_batch_4_avx>(dis, x, y, d, ny);
+}
+
+void
+bf16_vec_inner_products_ny_avx(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_avx_ny<false, bf16_vec_inner_product_avx, bf16_vec_inner_product_batch_4_avx>(dis, x, y, d, ny);
+}
+
+void
+bf16_vec_L2sqr_ny_avx(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_avx_ny<true, bf16_vec_L2sqr_avx, bf16_vec_L2sqr_batch_4_avx>(dis, x, y, d, ny);
+}
+
+void
+int8_vec_inner_products_ny_avx(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+    int8_avx_ny<false, int8_vec_inner_product_avx, int8_vec_inner_product_batch_4_avx>(dis, x, y, d, ny);
+}
+
+void
+int8_vec_L2sqr_ny_avx(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+    int8_avx_ny<true, int8_vec_L2sqr_avx, int8_vec_L2sqr_batch_4_avx>(dis, x, y, d, ny);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// fp32 kernels for fixed dimensions
+
+namespace {
+// D is a multiple of 32, so the loops have a constant trip count and no tail
+template <size_t D>
+float
+fvec_L2sqr_fixed(const float* x, const float* y, size_t) {
+    __m256 msum_0 = _mm256_setzero_ps();
+    __m256 msum_1 = _mm256_setzero_ps();
+    __m256 msum_2 = _mm256_setzero_ps();
+    __m256 msum_3 = _mm256_setzero_ps();
+    for (size_t i = 0; i < D; i += 32) {
+        const __m256 diff_0 = _mm256_sub_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i));
+        const __m256 diff_1 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8));
+        const __m256 diff_2 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y + i + 16));
+        const __m256 diff_3 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y + i + 24));
+        msum_0 = _mm256_fmadd_ps(diff_0, diff_0, msum_0);
+        msum_1 = _mm256_fmadd_ps(diff_1, diff_1, msum_1);
+        msum_2 = _mm256_fmadd_ps(diff_2, diff_2, msum_2);
+        msum_3 = _mm256_fmadd_ps(diff_3, diff_3, msum_3);
+    }
+    return _mm256_reduce_add_ps(_mm256_add_ps(_mm256_add_ps(msum_0, msum_1), _mm256_add_ps(msum_2, msum_3)));
+}
+
+template <size_t D>
+float
+fvec_inner_product_fixed(const float* x, const float* y, size_t) {
+    __m256 msum_0 = _mm256_setzero_ps();
+    __m256 msum_1 = _mm256_setzero_ps();
+    __m256 msum_2 = _mm256_setzero_ps();
+    __m256 msum_3 = _mm256_setzero_ps();
+    for (size_t i = 0; i < D; i += 32) {
+        msum_0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), msum_0);
+        msum_1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(y + i + 8), msum_1);
+        msum_2 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 16), _mm256_loadu_ps(y + i + 16), msum_2);
+        msum_3 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 24), _mm256_loadu_ps(y + i + 24), msum_3);
+    }
+    return _mm256_reduce_add_ps(_mm256_add_ps(_mm256_add_ps(msum_0, msum_1), _mm256_add_ps(msum_2, msum_3)));
+}
+
+template <size_t D>
+void
+fvec_L2sqr_batch_4_fixed(const float* x, const float* y0, const float* y1, const float* y2, const float* y3,
+                         const size_t, float& dis0, float& dis1, float& dis2, float& dis3) {
+    __m256 msum_0 = _mm256_setzero_ps();
+    __m256 msum_1 = _mm256_setzero_ps();
+    __m256 msum_2 = _mm256_setzero_ps();
+    __m256 msum_3 = _mm256_setzero_ps();
+    for (size_t i = 0; i < D; i += 8) {
+        const __m256 mx = _mm256_loadu_ps(x + i);
+        const __m256 diff_0 = _mm256_sub_ps(mx, _mm256_loadu_ps(y0 + i));
+        const __m256 diff_1 = _mm256_sub_ps(mx, _mm256_loadu_ps(y1 + i));
+        const __m256 diff_2 = _mm256_sub_ps(mx, _mm256_loadu_ps(y2 + i));
+        const __m256 diff_3 = _mm256_sub_ps(mx, _mm256_loadu_ps(y3 + i));
+        msum_0 = _mm256_fmadd_ps(diff_0, diff_0, msum_0);
+        msum_1 = _mm256_fmadd_ps(diff_1, diff_1, msum_1);
+        msum_2 = _mm256_fmadd_ps(diff_2, diff_2, msum_2);
+        msum_3 = _mm256_fmadd_ps(diff_3, diff_3, msum_3);
+    }
+    dis0 = _mm256_reduce_add_ps(msum_0);
+    dis1 = _mm256_reduce_add_ps(msum_1);
+    dis2 = _mm256_reduce_add_ps(msum_2);
+    dis3 = _mm256_reduce_add_ps(msum_3);
+}
+
+template <size_t D>
+void
+fvec_inner_product_batch_4_fixed(const float* x, const float* y0, const float* y1, const float* y2, const float* y3,
+                                 const size_t, float& dis0, float& dis1, float& dis2, float& dis3) {
+    __m256 msum_0 = _mm256_setzero_ps();
+    __m256 msum_1 = _mm256_setzero_ps();
+    __m256 msum_2 = _mm256_setzero_ps();
+    __m256 msum_3 = _mm256_setzero_ps();
+    for (size_t i = 0; i < D; i += 8) {
+        const __m256 mx = _mm256_loadu_ps(x + i);
+        msum_0 = _mm256_fmadd_ps(mx, _mm256_loadu_ps(y0 + i), msum_0);
+        msum_1 = _mm256_fmadd_ps(mx, _mm256_loadu_ps(y1 + i), msum_1);
+        msum_2 = _mm256_fmadd_ps(mx, _mm256_loadu_ps(y2 + i), msum_2);
+        msum_3 = _mm256_fmadd_ps(mx, _mm256_loadu_ps(y3 + i), msum_3);
+    }
+    dis0 = _mm256_reduce_add_ps(msum_0);
+    dis1 = _mm256_reduce_add_ps(msum_1);
+    dis2 = _mm256_reduce_add_ps(msum_2);
+    dis3 = _mm256_reduce_add_ps(msum_3);
+}
+}  // namespace
+
+decltype(&fvec_L2sqr_avx)
+fvec_L2sqr_fixed_dim_avx(size_t d) {
+    switch (d) {
+    case 128:
+        return fvec_L2sqr_fixed<128>;
+    case 256:
+        return fvec_L2sqr_fixed<256>;
+    case 384:
+        return fvec_L2sqr_fixed<384>;
+    case 512:
+        return fvec_L2sqr_fixed<512>;
+    case 768:
+        return fvec_L2sqr_fixed<768>;
+    case 1024:
+        return fvec_L2sqr_fixed<1024>;
+    case 1536:
+        return fvec_L2sqr_fixed<1536>;
+    default:
+        return nullptr;
+    }
+}
+
+decltype(&fvec_inner_product_avx)
+fvec_inner_product_fixed_dim_avx(size_t d) {
+    switch (d) {
+    case 128:
+        return fvec_inner_product_fixed<128>;
+    case 256:
+        return fvec_inner_product_fixed<256>;
+    case 384:
+        return fvec_inner_product_fixed<384>;
+    case 512:
+        return fvec_inner_product_fixed<512>;
+    case 768:
+        return fvec_inner_product_fixed<768>;
+    case 1024:
+        return fvec_inner_product_fixed<1024>;
+    case 1536:
+        return fvec_inner_product_fixed<1536>;
+    default:
+        return nullptr;
+    }
+}
+
+decltype(&fvec_L2sqr_batch_4_avx)
+fvec_L2sqr_batch_4_fixed_dim_avx(size_t d) {
+    switch (d) {
+    case 128:
+        return fvec_L2sqr_batch_4_fixed<128>;
+    case 256:
+        return fvec_L2sqr_batch_4_fixed<256>;
+    case 384:
+        return fvec_L2sqr_batch_4_fixed<384>;
+    case 512:
+        return fvec_L2sqr_batch_4_fixed<512>;
+    case 768:
+        return fvec_L2sqr_batch_4_fixed<768>;
+    case 1024:
+        return fvec_L2sqr_batch_4_fixed<1024>;
+    case 1536:
+        return fvec_L2sqr_batch_4_fixed<1536>;
+    default:
+        return nullptr;
+    }
+}
+
+decltype(&fvec_inner_product_batch_4_avx)
+fvec_inner_product_batch_4_fixed_dim_avx(size_t d) {
+    switch (d) {
+    case 128:
+        return fvec_inner_product_batch_4_fixed<128>;
+    case 256:
+        return fvec_inner_product_batch_4_fixed<256>;
+    case 384:
+        return fvec_inner_product_batch_4_fixed<384>;
+    case 512:
+        return fvec_inner_product_batch_4_fixed<512>;
+    case 768:
+        return fvec_inner_product_batch_4_fixed<768>;
+    case 1024:
+        return fvec_inner_product_batch_4_fixed<1024>;
+    case 1536:
+        return fvec_inner_product_batch_4_fixed<1536>;
+    default:
+        return nullptr;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // for cardinal
 
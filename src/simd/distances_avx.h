@@ -84,6 +84,12 @@ fp16_vec_L2sqr_batch_4_avx(const knowhere::fp16* x, const knowhere::fp16* y0, co
                            const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0, float& dis1,
                            float& dis2, float& dis3);
 
+void
+fp16_vec_inner_products_ny_avx(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny);
+
+void
+fp16_vec_L2sqr_ny_avx(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny);
+
 ///////////////////////////////////////////////////////////////////////////////
 // bf16
 
@@ -106,6 +112,12 @@ bf16_vec_L2sqr_batch_4_avx(const knowhere::bf16* x, const knowhere::bf16* y0, co
                            const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0, float& dis1,
                            float& dis2, float& dis3);
 
+void
+bf16_vec_inner_products_ny_avx(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny);
+
+void
+bf16_vec_L2sqr_ny_avx(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny);
+
 ///////////////////////////////////////////////////////////////////////////////
 // int8
 
@@ -127,6 +139,94 @@ void
 int8_vec_L2sqr_batch_4_avx(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
                            const size_t d, float& dis0, float& dis1, float& dis2, float& dis3);
 
+void
+int8_vec_inner_products_ny_avx(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+
+void
+int8_vec_L2sqr_ny_avx(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+
+///////////////////////////////////////////////////////////////////////////////
+// fp32 query against fp16, bf16 and int8 vectors
+float
+fvec_fp16_inner_product_avx(const float* x, const knowhere::fp16* y, size_t d);
+
+float
+fvec_fp16_L2sqr_avx(const float* x, const knowhere::fp16* y, size_t d);
+
+void
+fvec_fp16_inner_product_batch_4_avx(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                                    const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                                    float& dis1, float& dis2, float& dis3);
+
+void
+fvec_fp16_L2sqr_batch_4_avx(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                            const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                            float& dis1, float& dis2, float& dis3);
+
+void
+fvec_fp16_inner_products_ny_avx(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny);
+
+void
+fvec_fp16_L2sqr_ny_avx(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny);
+
+float
+fvec_bf16_inner_product_avx(const float* x, const knowhere::bf16* y, size_t d);
+
+float
+fvec_bf16_L2sqr_avx(const float* x, const knowhere::bf16* y, size_t d);
+
+void
+fvec_bf16_inner_product_batch_4_avx(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                                    const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                                    float& dis1, float& dis2, float& dis3);
+
+void
+fvec_bf16_L2sqr_batch_4_avx(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                            const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                            float& dis1, float& dis2, float& dis3);
+
+void
+fvec_bf16_inner_products_ny_avx(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny);
+
+void
+fvec_bf16_L2sqr_ny_avx(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny);
+
+float
+fvec_int8_inner_product_avx(const float* x, const int8_t* y, size_t d);
+
+float
+fvec_int8_L2sqr_avx(const float* x, const int8_t* y, size_t d);
+
+void
+fvec_int8_inner_product_batch_4_avx(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                    const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                    float& dis3);
+
+void
+fvec_int8_L2sqr_batch_4_avx(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
+                            const size_t d, float& dis0, float& dis1, float& dis2, float& dis3);
+
+void
+fvec_int8_inner_products_ny_avx(float* dis, const float* x, const int8_t* y, size_t d, size_t ny);
+
+void
+fvec_int8_L2sqr_ny_avx(float* dis, const float* x, const int8_t* y, size_t d, size_t ny);
+
+///////////////////////////////////////////////////////////////////////////////
+// fp32 kernels unrolled for the dimensions 128, 256, 384, 512, 768, 1024 and 1536,
+// return nullptr for the other dimensions
+decltype(&fvec_L2sqr_avx)
+fvec_L2sqr_fixed_dim_avx(size_t d);
+
+decltype(&fvec_inner_product_avx)
+fvec_inner_product_fixed_dim_avx(size_t d);
+
+decltype(&fvec_L2sqr_batch_4_avx)
+fvec_L2sqr_batch_4_fixed_dim_avx(size_t d);
+
+decltype(&fvec_inner_product_batch_4_avx)
+fvec_inner_product_batch_4_fixed_dim_avx(size_t d);
+
 ///////////////////////////////////////////////////////////////////////////////
 // for cardinal
 
@@ -17,6 +17,9 @@
 #include <arm_neon.h>
 #include <math.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace faiss {
 
 namespace {
@@ -2762,6 +2765,637 @@ int8_vec_L2sqr_batch_4_neon(const int8_t* x, const int8_t* y0, const int8_t* y1,
     dis3 = static_cast<float>(vaddvq_s32(sum3) + rem_sum3);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// fp32 query against fp16, bf16 and int8 vectors
+
+namespace {
+// converts 4 consecutive elements to fp32
+inline float32x4_t
+vload_fp32(const float* x) {
+    return vld1q_f32(x);
+}
+
+inline float32x4_t
+vload_fp32(const knowhere::fp16* x) {
+    return vcvt_f32_f16(vld1_f16((const __fp16*)x));
+}
+
+inline float32x4_t
+vload_fp32(const knowhere::bf16* x) {
+    return vcvt_f32_half(vld1_u16((const uint16_t*)x));
+}
+
+inline float32x4_t
+vload_fp32(const int8_t* x) {
+    int32_t bits;
+    memcpy(&bits, x, sizeof(bits));
+    const int16x8_t x_16 = vmovl_s8(vreinterpret_s8_s32(vdup_n_s32(bits)));
+    return vcvtq_f32_s32(vmovl_s16(vget_low_s16(x_16)));
+}
+
+// converts 0 <= d < 4 elements to fp32, the other lanes are zeros
+template <typename T>
+inline float32x4_t
+vmasked_load_fp32(size_t d, const T* x) {
+    T buf[4] = {};
+    std::copy_n(x, d, buf);
+    return vload_fp32(buf);
+}
+
+template <typename T>
+float
+typed_neon_inner_product(const float* x, const T* y, size_t d) {
+    float32x4_t msum_0 = vdupq_n_f32(0.0f);
+    float32x4_t msum_1 = vdupq_n_f32(0.0f);
+    while (d >= 8) {
+        msum_0 = vmlaq_f32(msum_0, vload_fp32(x), vload_fp32(y));
+        msum_1 = vmlaq_f32(msum_1, vload_fp32(x + 4), vload_fp32(y + 4));
+        x += 8;
+        y += 8;
+        d -= 8;
+    }
+    if (d >= 4) {
+        msum_0 = vmlaq_f32(msum_0, vload_fp32(x), vload_fp32(y));
+        x += 4;
+        y += 4;
+        d -= 4;
+    }
+    if (d > 0) {
+        msum_1 = vmlaq_f32(msum_1, vmasked_load_fp32(d, x), vmasked_load_fp32(d, y));
+    }
+    return vaddvq_f32(vaddq_f32(msum_0, msum_1));
+}
+
+template <typename T>
+float
+typed_neon_L2sqr(const float* x, const T* y, size_t d) {
+    float32x4_t msum_0 = vdupq_n_f32(0.0f);
+    float32x4_t msum_1 = vdupq_n_f32(0.0f);
+    while (d >= 8) {
+        const float32x4_t diff_0 = vsubq_f32(vload_fp32(x), vload_fp32(y));
+        const float32x4_t diff_1 = vsubq_f32(vload_fp32(x + 4), vload_fp32(y + 4));
+        msum_0 = vmlaq_f32(msum_0, diff_0, diff_0);
+        msum_1 = vmlaq_f32(msum_1, diff_1, diff_1);
+        x += 8;
+        y += 8;
+        d -= 8;
+    }
+    if (d >= 4) {
+        const float32x4_t diff = vsubq_f32(vload_fp32(x), vload_fp32(y));
+        msum_0 = vmlaq_f32(msum_0, diff, diff);
+        x += 4;
+        y += 4;
+        d -= 4;
+    }
+    if (d > 0) {
+        const float32x4_t diff = vsubq_f32(vmasked_load_fp32(d, x), vmasked_load_fp32(d, y));
+        msum_1 = vmlaq_f32(msum_1, diff, diff);
+    }
+    return vaddvq_f32(vaddq_f32(msum_0, msum_1));
+}
+
+template <typename T>
+void
+typed_neon_inner_product_batch_4(const float* x, const T* y0, const T* y1, const T* y2, const T* y3, const size_t d,
+                                 float& dis0, float& dis1, float& dis2, float& dis3) {
+    float32x4_t msum_0 = vdupq_n_f32(0.0f);
+    float32x4_t msum_1 = vdupq_n_f32(0.0f);
+    float32x4_t msum_2 = vdupq_n_f32(0.0f);
+    float32x4_t msum_3 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= d; i += 4) {
+        const float32x4_t mx = vload_fp32(x + i);
+        msum_0 = vmlaq_f32(msum_0, mx, vload_fp32(y0 + i));
+        msum_1 = vmlaq_f32(msum_1, mx, vload_fp32(y1 + i));
+        msum_2 = vmlaq_f32(msum_2, mx, vload_fp32(y2 + i));
+        msum_3 = vmlaq_f32(msum_3, mx, vload_fp32(y3 + i));
+    }
+    if (i < d) {
+        const float32x4_t mx = vmasked_load_fp32(d - i, x + i);
+        msum_0 = vmlaq_f32(msum_0, mx, vmasked_load_fp32(d - i, y0 + i));
+        msum_1 = vmlaq_f32(msum_1, mx, vmasked_load_fp32(d - i, y1 + i));
+        msum_2 = vmlaq_f32(msum_2, mx, vmasked_load_fp32(d - i, y2 + i));
+        msum_3 = vmlaq_f32(msum_3, mx, vmasked_load_fp32(d - i, y3 + i));
+    }
+    dis0 = vaddvq_f32(msum_0);
+    dis1 = vaddvq_f32(msum_1);
+    dis2 = vaddvq_f32(msum_2);
+    dis3 = vaddvq_f32(msum_3);
+}
+
+template <typename T>
+void
+typed_neon_L2sqr_batch_4(const float* x, const T* y0, const T* y1, const T* y2, const T* y3, const size_t d,
+                         float& dis0, float& dis1, float& dis2, float& dis3) {
+    float32x4_t msum_0 = vdupq_n_f32(0.0f);
+    float32x4_t msum_1 = vdupq_n_f32(0.0f);
+    float32x4_t msum_2 = vdupq_n_f32(0.0f);
+    float32x4_t msum_3 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= d; i += 4) {
+        const float32x4_t mx = vload_fp32(x + i);
+        const float32x4_t diff_0 = vsubq_f32(mx, vload_fp32(y0 + i));
+        const float32x4_t diff_1 = vsubq_f32(mx, vload_fp32(y1 + i));
+        const float32x4_t diff_2 = vsubq_f32(mx, vload_fp32(y2 + i));
+        const float32x4_t diff_3 = vsubq_f32(mx, vload_fp32(y3 + i));
+        msum_0 = vmlaq_f32(msum_0, diff_0, diff_0);
+        msum_1 = vmlaq_f32(msum_1, diff_1, diff_1);
+        msum_2 = vmlaq_f32(msum_2, diff_2, diff_2);
+        msum_3 = vmlaq_f32(msum_3, diff_3, diff_3);
+    }
+    if (i < d) {
+        const float32x4_t mx = vmasked_load_fp32(d - i, x + i);
+        const float32x4_t diff_0 = vsubq_f32(mx, vmasked_load_fp32(d - i, y0 + i));
+        const float32x4_t diff_1 = vsubq_f32(mx, vmasked_load_fp32(d - i, y1 + i));
+        const float32x4_t diff_2 = vsubq_f32(mx, vmasked_load_fp32(d - i, y2 + i));
+        const float32x4_t diff_3 = vsubq_f32(mx, vmasked_load_fp32(d - i, y3 + i));
+        msum_0 = vmlaq_f32(msum_0, diff_0, diff_0);
+        msum_1 = vmlaq_f32(msum_1, diff_1, diff_1);
+        msum_2 = vmlaq_f32(msum_2, diff_2, diff_2);
+        msum_3 = vmlaq_f32(msum_3, diff_3, diff_3);
+    }
+    dis0 = vaddvq_f32(msum_0);
+    dis1 = vaddvq_f32(msum_1);
+    dis2 = vaddvq_f32(msum_2);
+    dis3 = vaddvq_f32(msum_3);
+}
+
+// sums each of a0..a3 and stores the 4 sums to dis[0..3]
+inline void
+vreduce_add_4_f32(float* dis, float32x4_t a0, float32x4_t a1, float32x4_t a2, float32x4_t a3) {
+    vst1q_f32(dis, vpaddq_f32(vpaddq_f32(a0, a1), vpaddq_f32(a2, a3)));
+}
+
+// accumulates x * y, or (x - y)^2 for L2
+template <bool L2>
+inline float32x4_t
+vaccumulate_f32(float32x4_t msum, float32x4_t mx, float32x4_t my) {
+    if constexpr (L2) {
+        const float32x4_t diff = vsubq_f32(mx, my);
+        return vmlaq_f32(msum, diff, diff);
+    } else {
+        return vmlaq_f32(msum, mx, my);
+    }
+}
+
+// ny distances in blocks of 8 rows: each chunk of x is loaded and converted once and accumulated against the 8 rows
+// in registers, and the 8 sums are reduced together. The rows that do not fill a block go through batch_4 and single.
+template <bool L2, auto single, auto batch_4, typename TX, typename TY>
+void
+typed_neon_ny(float* dis, const TX* x, const TY* y, size_t d, size_t ny) {
+    size_t i = 0;
+    for (; i + 8 <= ny; i += 8) {
+        const TY* y0 = y;
+        const TY* y1 = y0 + d;
+        const TY* y2 = y1 + d;
+        const TY* y3 = y2 + d;
+        const TY* y4 = y3 + d;
+        const TY* y5 = y4 + d;
+        const TY* y6 = y5 + d;
+        const TY* y7 = y6 + d;
+        float32x4_t msum_0 = vdupq_n_f32(0.0f);
+        float32x4_t msum_1 = vdupq_n_f32(0.0f);
+        float32x4_t msum_2 = vdupq_n_f32(0.0f);
+        float32x4_t msum_3 = vdupq_n_f32(0.0f);
+        float32x4_t msum_4 = vdupq_n_f32(0.0f);
+        float32x4_t msum_5 = vdupq_n_f32(0.0f);
+        float32x4_t msum_6 = vdupq_n_f32(0.0f);
+        float32x4_t msum_7 = vdupq_n_f32(0.0f);
+        size_t j = 0;
+        for (; j + 4 <= d; j += 4) {
+            const float32x4_t mx = vload_fp32(x + j);
+            msum_0 = vaccumulate_f32<L2>(msum_0, mx, vload_fp32(y0 + j));
+            msum_1 = vaccumulate_f32<L2>(msum_1, mx, vload_fp32(y1 + j));
+            msum_2 = vaccumulate_f32<L2>(msum_2, mx, vload_fp32(y2 + j));
+            msum_3 = vaccumulate_f32<L2>(msum_3, mx, vload_fp32(y3 + j));
+            msum_4 = vaccumulate_f32<L2>(msum_4, mx, vload_fp32(y4 + j));
+            msum_5 = vaccumulate_f32<L2>(msum_5, mx, vload_fp32(y5 + j));
+            msum_6 = vaccumulate_f32<L2>(msum_6, mx, vload_fp32(y6 + j));
+            msum_7 = vaccumulate_f32<L2>(msum_7, mx, vload_fp32(y7 + j));
+        }
+        if (j < d) {
+            const float32x4_t mx = vmasked_load_fp32(d - j, x + j);
+            msum_0 = vaccumulate_f32<L2>(msum_0, mx, vmasked_load_fp32(d - j, y0 + j));
+            msum_1 = vaccumulate_f32<L2>(msum_1, mx, vmasked_load_fp32(d - j, y1 + j));
+            msum_2 = vaccumulate_f32<L2>(msum_2, mx, vmasked_load_fp32(d - j, y2 + j));
+            msum_3 = vaccumulate_f32<L2>(msum_3, mx, vmasked_load_fp32(d - j, y3 + j));
+            msum_4 = vaccumulate_f32<L2>(msum_4, mx, vmasked_load_fp32(d - j, y4 + j));
+            msum_5 = vaccumulate_f32<L2>(msum_5, mx, vmasked_load_fp32(d - j, y5 + j));
+            msum_6 = vaccumulate_f32<L2>(msum_6, mx, vmasked_load_fp32(d - j, y6 + j));
+            msum_7 = vaccumulate_f32<L2>(msum_7, mx, vmasked_load_fp32(d - j, y7 + j));
+        }
+        vreduce_add_4_f32(dis + i, msum_0, msum_1, msum_2, msum_3);
+        vreduce_add_4_f32(dis + i + 4, msum_4, msum_5, msum_6, msum_7);
+        y += 8 * d;
+    }
+    if (i + 4 <= ny) {
+        batch_4(x, y, y + d, y + 2 * d, y + 3 * d, d, dis[i], dis[i + 1], dis[i + 2], dis[i + 3]);
+        y += 4 * d;
+        i += 4;
+    }
+    for (; i < ny; i++) {
+        dis[i] = single(x, y, d);
+        y += d;
+    }
+}
+
+// sums the int32 lanes of each of a0..a3 and stores the 4 sums to dis[0..3] as floats
+inline void
+vreduce_add_4_s32(float* dis, int32x4_t a0, int32x4_t a1, int32x4_t a2, int32x4_t a3) {
+    vst1q_f32(dis, vcvtq_f32_s32(vpaddq_s32(vpaddq_s32(a0, a1), vpaddq_s32(a2, a3))));
+}
+
+// accumulates x * y, or (x - y)^2 for L2, of 8 int16 lanes into 4 int32 lanes
+template <bool L2>
+inline int32x4_t
+vaccumulate_s16(int32x4_t msum, int16x8_t mx, int16x8_t my) {
+    if constexpr (L2) {
+        const int16x8_t diff = vsubq_s16(mx, my);
+        return vmlal_high_s16(vmlal_s16(msum, vget_low_s16(diff), vget_low_s16(diff)), diff, diff);
+    } else {
+        return vmlal_high_s16(vmlal_s16(msum, vget_low_s16(mx), vget_low_s16(my)), mx, my);
+    }
+}
+
+// converts 0 <= d < 8 int8 to int16, the other lanes are zeros
+inline int16x8_t
+vmasked_load_s16(size_t d, const int8_t* x) {
+    int8_t buf[8] = {};
+    std::copy_n(x, d, buf);
+    return vmovl_s8(vld1_s8(buf));
+}
+
+// int8 ny distances in blocks of 8 rows like typed_neon_ny, the products are summed exactly in int32
+template <bool L2, auto single, auto batch_4>
+void
+int8_neon_ny(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+    size_t i = 0;
+    for (; i + 8 <= ny; i += 8) {
+        const int8_t* y0 = y;
+        const int8_t* y1 = y0 + d;
+        const int8_t* y2 = y1 + d;
+        const int8_t* y3 = y2 + d;
+        const int8_t* y4 = y3 + d;
+        const int8_t* y5 = y4 + d;
+        const int8_t* y6 = y5 + d;
+        const int8_t* y7 = y6 + d;
+        int32x4_t msum_0 = vdupq_n_s32(0);
+        int32x4_t msum_1 = vdupq_n_s32(0);
+        int32x4_t msum_2 = vdupq_n_s32(0);
+        int32x4_t msum_3 = vdupq_n_s32(0);
+        int32x4_t msum_4 = vdupq_n_s32(0);
+        int32x4_t msum_5 = vdupq_n_s32(0);
+        int32x4_t msum_6 = vdupq_n_s32(0);
+        int32x4_t msum_7 = vdupq_n_s32(0);
+        size_t j = 0;
+        for (; j + 8 <= d; j += 8) {
+            const int16x8_t mx = vmovl_s8(vld1_s8(x + j));
+            msum_0 = vaccumulate_s16<L2>(msum_0, mx, vmovl_s8(vld1_s8(y0 + j)));
+            msum_1 = vaccumulate_s16<L2>(msum_1, mx, vmovl_s8(vld1_s8(y1 + j)));
+            msum_2 = vaccumulate_s16<L2>(msum_2, mx, vmovl_s8(vld1_s8(y2 + j)));
+            msum_3 = vaccumulate_s16<L2>(msum_3, mx, vmovl_s8(vld1_s8(y3 + j)));
+            msum_4 = vaccumulate_s16<L2>(msum_4, mx, vmovl_s8(vld1_s8(y4 + j)));
+            msum_5 = vaccumulate_s16<L2>(msum_5, mx, vmovl_s8(vld1_s8(y5 + j)));
+            msum_6 = vaccumulate_s16<L2>(msum_6, mx, vmovl_s8(vld1_s8(y6 + j)));
+            msum_7 = vaccumulate_s16<L2>(msum_7, mx, vmovl_s8(vld1_s8(y7 + j)));
+        }
+        if (j < d) {
+            const int16x8_t mx = vmasked_load_s16(d - j, x + j);
+            msum_0 = vaccumulate_s16<L2>(msum_0, mx, vmasked_load_s16(d - j, y0 + j));
+            msum_1 = vaccumulate_s16<L2>(msum_1, mx, vmasked_load_s16(d - j, y1 + j));
+            msum_2 = vaccumulate_s16<L2>(msum_2, mx, vmasked_load_s16(d - j, y2 + j));
+            msum_3 = vaccumulate_s16<L2>(msum_3, mx, vmasked_load_s16(d - j, y3 + j));
+            msum_4 = vaccumulate_s16<L2>(msum_4, mx, vmasked_load_s16(d - j, y4 + j));
+            msum_5 = vaccumulate_s16<L2>(msum_5, mx, vmasked_load_s16(d - j, y5 + j));
+            msum_6 = vaccumulate_s16<L2>(msum_6, mx, vmasked_load_s16(d - j, y6 + j));
+            msum_7 = vaccumulate_s16<L2>(msum_7, mx, vmasked_load_s16(d - j, y7 + j));
+        }
+        vreduce_add_4_s32(dis + i, msum_0, msum_1, msum_2, msum_3);
+        vreduce_add_4_s32(dis + i + 4, msum_4, msum_5, msum_6, msum_7);
+        y += 8 * d;
+    }
+    if (i + 4 <= ny) {
+        batch_4(x, y, y + d, y + 2 * d, y + 3 * d, d, dis[i], dis[i + 1], dis[i + 2], dis[i + 3]);
+        y += 4 * d;
+        i += 4;
+    }
+    for (; i < ny; i++) {
+        dis[i] = single(x, y, d);
+        y += d;
+    }
+}
+}  // namespace
+
+float
+fvec_fp16_inner_product_neon(const float* x, const knowhere::fp16* y, size_t d) {
+    return typed_neon_inner_product(x, y, d);
+}
+
+float
+fvec_fp16_L2sqr_neon(const float* x, const knowhere::fp16* y, size_t d) {
+    return typed_neon_L2sqr(x, y, d);
+}
+
+void
+fvec_fp16_inner_product_batch_4_neon(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                                     const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                                     float& dis1, float& dis2, float& dis3) {
+    typed_neon_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_fp16_L2sqr_batch_4_neon(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                             const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                             float& dis1, float& dis2, float& dis3) {
+    typed_neon_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_fp16_inner_products_ny_neon(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_neon_ny<false, typed_neon_inner_product<knowhere::fp16>, typed_neon_inner_product_batch_4<knowhere::fp16>>(
+        dis, x, y, d, ny);
+}
+
+void
+fvec_fp16_L2sqr_ny_neon(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_neon_ny<true, typed_neon_L2sqr<knowhere::fp16>, typed_neon_L2sqr_batch_4<knowhere::fp16>>(dis, x, y, d, ny);
+}
+
+float
+fvec_bf16_inner_product_neon(const float* x, const knowhere::bf16* y, size_t d) {
+    return typed_neon_inner_product(x, y, d);
+}
+
+float
+fvec_bf16_L2sqr_neon(const float* x, const knowhere::bf16* y, size_t d) {
+    return typed_neon_L2sqr(x, y, d);
+}
+
+void
+fvec_bf16_inner_product_batch_4_neon(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                                     const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                                     float& dis1, float& dis2, float& dis3) {
+    typed_neon_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_bf16_L2sqr_batch_4_neon(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                             const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                             float& dis1, float& dis2, float& dis3) {
+    typed_neon_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_bf16_inner_products_ny_neon(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_neon_ny<false, typed_neon_inner_product<knowhere::bf16>, typed_neon_inner_product_batch_4<knowhere::bf16>>(
+        dis, x, y, d, ny);
+}
+
+void
+fvec_bf16_L2sqr_ny_neon(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_neon_ny<true, typed_neon_L2sqr<knowhere::bf16>, typed_neon_L2sqr_batch_4<knowhere::bf16>>(dis, x, y, d, ny);
+}
+
+float
+fvec_int8_inner_product_neon(const float* x, const int8_t* y, size_t d) {
+    return typed_neon_inner_product(x, y, d);
+}
+
+float
+fvec_int8_L2sqr_neon(const float* x, const int8_t* y, size_t d) {
+    return typed_neon_L2sqr(x, y, d);
+}
+
+void
+fvec_int8_inner_product_batch_4_neon(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                     const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                     float& dis3) {
+    typed_neon_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_int8_L2sqr_batch_4_neon(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
+                             const size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
+    typed_neon_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_int8_inner_products_ny_neon(float* dis, const float* x, const int8_t* y, size_t d, size_t ny) {
+    typed_neon_ny<false, typed_neon_inner_product<int8_t>, typed_neon_inner_product_batch_4<int8_t>>(dis, x, y, d, ny);
+}
+
+void
+fvec_int8_L2sqr_ny_neon(float* dis, const float* x, const int8_t* y, size_t d, size_t ny) {
+    typed_neon_ny<true, typed_neon_L2sqr<int8_t>, typed_neon_L2sqr_batch_4<int8_t>>(dis, x, y, d, ny);
+}
+
+// fp16, bf16 and int8 queries against vectors of the same type
+void
+fp16_vec_inner_products_ny_neon(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_neon_ny<false, fp16_vec_inner_product_neon, fp16_vec_inner_product_batch_4_neon>(dis, x, y, d, ny);
+}
+
+void
+fp16_vec_L2sqr_ny_neon(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_neon_ny<true, fp16_vec_L2sqr_neon, fp16_vec_L2sqr_batch_4_neon>(dis, x, y, d, ny);
+}
+
+void
+bf16_vec_inner_products_ny_neon(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_neon_ny<false, bf16_vec_inner_product_neon, bf16_vec_inner_product_batch_4_neon>(dis, x, y, d, ny);
+}
+
+void
+bf16_vec_L2sqr_ny_neon(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_neon_ny<true, bf16_vec_L2sqr_neon, bf16_vec_L2sqr_batch_4_neon>(dis, x, y, d, ny);
+}
+
+void
+int8_vec_inner_products_ny_neon(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+    int8_neon_ny<false, int8_vec_inner_product_neon, int8_vec_inner_product_batch_4_neon>(dis, x, y, d, ny);
+}
+
+void
+int8_vec_L2sqr_ny_neon(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+    int8_neon_ny<true, int8_vec_L2sqr_neon, int8_vec_L2sqr_batch_4_neon>(dis, x, y, d, ny);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// fp32 kernels for fixed dimensions
+
+namespace {
+// D is a multiple of 16, so the loops have a constant trip count and no tail
+template <size_t D>
+float
+fvec_L2sqr_fixed(const float* x, const float* y, size_t) {
+    float32x4_t msum_0 = vdupq_n_f32(0.0f);
+    float32x4_t msum_1 = vdupq_n_f32(0.0f);
+    float32x4_t msum_2 = vdupq_n_f32(0.0f);
+    float32x4_t msum_3 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < D; i += 16) {
+        const float32x4_t diff_0 = vsubq_f32(vld1q_f32(x + i), vld1q_f32(y + i));
+        const float32x4_t diff_1 = vsubq_f32(vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+        const float32x4_t diff_2 = vsubq_f32(vld1q_f32(x + i + 8), vld1q_f32(y + i + 8));
+        const float32x4_t diff_3 = vsubq_f32(vld1q_f32(x + i + 12), vld1q_f32(y + i + 12));
+        msum_0 = vmlaq_f32(msum_0, diff_0, diff_0);
+        msum_1 = vmlaq_f32(msum_1, diff_1, diff_1);
+        msum_2 = vmlaq_f32(msum_2, diff_2, diff_2);
+        msum_3 = vmlaq_f32(msum_3, diff_3, diff_3);
+    }
+    return vaddvq_f32(vaddq_f32(vaddq_f32(msum_0, msum_1), vaddq_f32(msum_2, msum_3)));
+}
+
+template <size_t D>
+float
+fvec_inner_product_fixed(const float* x, const float* y, size_t) {
+    float32x4_t msum_0 = vdupq_n_f32(0.0f);
+    float32x4_t msum_1 = vdupq_n_f32(0.0f);
+    float32x4_t msum_2 = vdupq_n_f32(0.0f);
+    float32x4_t msum_3 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < D; i += 16) {
+        msum_0 = vmlaq_f32(msum_0, vld1q_f32(x + i), vld1q_f32(y + i));
+        msum_1 = vmlaq_f32(msum_1, vld1q_f32(x + i + 4), vld1q_f32(y + i + 4));
+        msum_2 = vmlaq_f32(msum_2, vld1q_f32(x + i + 8), vld1q_f32(y + i + 8));
+        msum_3 = vmlaq_f32(msum_3, vld1q_f32(x + i + 12), vld1q_f32(y + i + 12));
+    }
+    return vaddvq_f32(vaddq_f32(vaddq_f32(msum_0, msum_1), vaddq_f32(msum_2, msum_3)));
+}
+
+template <size_t D>
+void
+fvec_L2sqr_batch_4_fixed(const float* x, const float* y0, const float* y1, const float* y2, const float* y3,
+                         const size_t, float& dis0, float& dis1, float& dis2, float& dis3) {
+    float32x4_t msum_0 = vdupq_n_f32(0.0f);
+    float32x4_t msum_1 = vdupq_n_f32(0.0f);
+    float32x4_t msum_2 = vdupq_n_f32(0.0f);
+    float32x4_t msum_3 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < D; i += 4) {
+        const float32x4_t mx = vld1q_f32(x + i);
+        const float32x4_t diff_0 = vsubq_f32(mx, vld1q_f32(y0 + i));
+        const float32x4_t diff_1 = vsubq_f32(mx, vld1q_f32(y1 + i));
+        const float32x4_t diff_2 = vsubq_f32(mx, vld1q_f32(y2 + i));
+        const float32x4_t diff_3 = vsubq_f32(mx, vld1q_f32(y3 + i));
+        msum_0 = vmlaq_f32(msum_0, diff_0, diff_0);
+        msum_1 = vmlaq_f32(msum_1, diff_1, diff_1);
+        msum_2 = vmlaq_f32(msum_2, diff_2, diff_2);
+        msum_3 = vmlaq_f32(msum_3, diff_3, diff_3);
+    }
+    dis0 = vaddvq_f32(msum_0);
+    dis1 = vaddvq_f32(msum_1);
+    dis2 = vaddvq_f32(msum_2);
+    dis3 = vaddvq_f32(msum_3);
+}
+
+template <size_t D>
+void
+fvec_inner_product_batch_4_fixed(const float* x, const float* y0, const float* y1, const float* y2, const float* y3,
+                                 const size_t, float& dis0, float& dis1, float& dis2, float& dis3) {
+    float32x4_t msum_0 = vdupq_n_f32(0.0f);
+    float32x4_t msum_1 = vdupq_n_f32(0.0f);
+    float32x4_t msum_2 = vdupq_n_f32(0.0f);
+    float32x4_t msum_3 = vdupq_n_f32(0.0f);
+    for (size_t i = 0; i < D; i += 4) {
+        const float32x4_t mx = vld1q_f32(x + i);
+        msum_0 = vmlaq_f32(msum_0, mx, vld1q_f32(y0 + i));
+        msum_1 = vmlaq_f32(msum_1, mx, vld1q_f32(y1 + i));
+        msum_2 = vmlaq_f32(msum_2, mx, vld1q_f32(y2 + i));
+        msum_3 = vmlaq_f32(msum_3, mx, vld1q_f32(y3 + i));
+    }
+    dis0 = vaddvq_f32(msum_0);
+    dis1 = vaddvq_f32(msum_1);
+    dis2 = vaddvq_f32(msum_2);
+    dis3 = vaddvq_f32(msum_3);
+}
+}  // namespace
+
+decltype(&fvec_L2sqr_neon)
+fvec_L2sqr_fixed_dim_neon(size_t d) {
+    switch (d) {
+    case 128:
+        return fvec_L2sqr_fixed<128>;
+    case 256:
+        return fvec_L2sqr_fixed<256>;
+    case 384:
+        return fvec_L2sqr_fixed<384>;
+    case 512:
+        return fvec_L2sqr_fixed<512>;
+    case 768:
+        return fvec_L2sqr_fixed<768>;
+    case 1024:
+        return fvec_L2sqr_fixed<1024>;
+    case 1536:
+        return fvec_L2sqr_fixed<1536>;
+    default:
+        return nullptr;
+    }
+}
+
+decltype(&fvec_inner_product_neon)
+fvec_inner_product_fixed_dim_neon(size_t d) {
+    switch (d) {
+    case 128:
+        return fvec_inner_product_fixed<128>;
+    case 256:
+        return fvec_inner_product_fixed<256>;
+    case 384:
+        return fvec_inner_product_fixed<384>;
+    case 512:
+        return fvec_inner_product_fixed<512>;
+    case 768:
+        return fvec_inner_product_fixed<768>;
+    case 1024:
+        return fvec_inner_product_fixed<1024>;
+    case 1536:
+        return fvec_inner_product_fixed<1536>;
+    default:
+        return nullptr;
+    }
+}
+
+decltype(&fvec_L2sqr_batch_4_neon)
+fvec_L2sqr_batch_4_fixed_dim_neon(size_t d) {
+    switch (d) {
+    case 128:
+        return fvec_L2sqr_batch_4_fixed<128>;
+    case 256:
+        return fvec_L2sqr_batch_4_fixed<256>;
+    case 384:
+        return fvec_L2sqr_batch_4_fixed<384>;
+    case 512:
+        return fvec_L2sqr_batch_4_fixed<512>;
+    case 768:
+        return fvec_L2sqr_batch_4_fixed<768>;
+    case 1024:
+        return fvec_L2sqr_batch_4_fixed<1024>;
+    case 1536:
+        return fvec_L2sqr_batch_4_fixed<1536>;
+    default:
+        return nullptr;
+    }
+}
+
+decltype(&fvec_inner_product_batch_4_neon)
+fvec_inner_product_batch_4_fixed_dim_neon(size_t d) {
+    switch (d) {
+    case 128:
+        return fvec_inner_product_batch_4_fixed<128>;
+    case 256:
+        return fvec_inner_product_batch_4_fixed<256>;
+    case 384:
+        return fvec_inner_product_batch_4_fixed<384>;
+    case 512:
+        return fvec_inner_product_batch_4_fixed<512>;
+    case 768:
+        return fvec_inner_product_batch_4_fixed<768>;
+    case 1024:
+        return fvec_inner_product_batch_4_fixed<1024>;
+    case 1536:
+        return fvec_inner_product_batch_4_fixed<1536>;
+    default:
+        return nullptr;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // for cardinal
 
@@ -453,6 +453,219 @@ int8_vec_L2sqr_batch_4_ref(const int8_t* x, const int8_t* y0, const int8_t* y1,
     dis3 = (float)d3;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// fp32 query against fp16, bf16 and int8 vectors
+
+namespace {
+template <typename T>
+float
+typed_ref_inner_product(const float* x, const T* y, size_t d) {
+    float res = 0;
+    for (size_t i = 0; i < d; i++) {
+        res += x[i] * (float)y[i];
+    }
+    return res;
+}
+
+template <typename T>
+float
+typed_ref_L2sqr(const float* x, const T* y, size_t d) {
+    float res = 0;
+    for (size_t i = 0; i < d; i++) {
+        const float tmp = x[i] - (float)y[i];
+        res += tmp * tmp;
+    }
+    return res;
+}
+
+template <typename T>
+void
+typed_ref_inner_product_batch_4(const float* x, const T* y0, const T* y1, const T* y2, const T* y3, const size_t d,
+                                float& dis0, float& dis1, float& dis2, float& dis3) {
+    float d0 = 0, d1 = 0, d2 = 0, d3 = 0;
+    for (size_t i = 0; i < d; ++i) {
+        d0 += x[i] * (float)y0[i];
+        d1 += x[i] * (float)y1[i];
+        d2 += x[i] * (float)y2[i];
+        d3 += x[i] * (float)y3[i];
+    }
+    dis0 = d0;
+    dis1 = d1;
+    dis2 = d2;
+    dis3 = d3;
+}
+
+template <typename T>
+void
+typed_ref_L2sqr_batch_4(const float* x, const T* y0, const T* y1, const T* y2, const T* y3, const size_t d,
+                        float& dis0, float& dis1, float& dis2, float& dis3) {
+    float d0 = 0, d1 = 0, d2 = 0, d3 = 0;
+    for (size_t i = 0; i < d; ++i) {
+        const float q0 = x[i] - (float)y0[i];
+        const float q1 = x[i] - (float)y1[i];
+        const float q2 = x[i] - (float)y2[i];
+        const float q3 = x[i] - (float)y3[i];
+        d0 += q0 * q0;
+        d1 += q1 * q1;
+        d2 += q2 * q2;
+        d3 += q3 * q3;
+    }
+    dis0 = d0;
+    dis1 = d1;
+    dis2 = d2;
+    dis3 = d3;
+}
+
+// ny distances through the batch_4 kernel, the rows that do not fill a batch one at a time
+template <auto single, auto batch_4, typename TX, typename TY>
+void
+typed_ref_ny(float* dis, const TX* x, const TY* y, size_t d, size_t ny) {
+    size_t i = 0;
+    for (; i + 4 <= ny; i += 4) {
+        batch_4(x, y, y + d, y + 2 * d, y + 3 * d, d, dis[i], dis[i + 1], dis[i + 2], dis[i + 3]);
+        y += 4 * d;
+    }
+    for (; i < ny; i++) {
+        dis[i] = single(x, y, d);
+        y += d;
+    }
+}
+}  // namespace
+
+float
+fvec_fp16_inner_product_ref(const float* x, const knowhere::fp16* y, size_t d) {
+    return typed_ref_inner_product(x, y, d);
+}
+
+float
+fvec_fp16_L2sqr_ref(const float* x, const knowhere::fp16* y, size_t d) {
+    return typed_ref_L2sqr(x, y, d);
+}
+
+void
+fvec_fp16_inner_product_batch_4_ref(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                                    const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                                    float& dis1, float& dis2, float& dis3) {
+    typed_ref_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_fp16_L2sqr_batch_4_ref(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                            const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                            float& dis1, float& dis2, float& dis3) {
+    typed_ref_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_fp16_inner_products_ny_ref(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_ref_ny<typed_ref_inner_product<knowhere::fp16>, typed_ref_inner_product_batch_4<knowhere::fp16>>(
+        dis, x, y, d, ny);
+}
+
+void
+fvec_fp16_L2sqr_ny_ref(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_ref_ny<typed_ref_L2sqr<knowhere::fp16>, typed_ref_L2sqr_batch_4<knowhere::fp16>>(dis, x, y, d, ny);
+}
+
+float
+fvec_bf16_inner_product_ref(const float* x, const knowhere::bf16* y, size_t d) {
+    return typed_ref_inner_product(x, y, d);
+}
+
+float
+fvec_bf16_L2sqr_ref(const float* x, const knowhere::bf16* y, size_t d) {
+    return typed_ref_L2sqr(x, y, d);
+}
+
+void
+fvec_bf16_inner_product_batch_4_ref(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                                    const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                                    float& dis1, float& dis2, float& dis3) {
+    typed_ref_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_bf16_L2sqr_batch_4_ref(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                            const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                            float& dis1, float& dis2, float& dis3) {
+    typed_ref_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_bf16_inner_products_ny_ref(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_ref_ny<typed_ref_inner_product<knowhere::bf16>, typed_ref_inner_product_batch_4<knowhere::bf16>>(
+        dis, x, y, d, ny);
+}
+
+void
+fvec_bf16_L2sqr_ny_ref(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_ref_ny<typed_ref_L2sqr<knowhere::bf16>, typed_ref_L2sqr_batch_4<knowhere::bf16>>(dis, x, y, d, ny);
+}
+
+float
+fvec_int8_inner_product_ref(const float* x, const int8_t* y, size_t d) {
+    return typed_ref_inner_product(x, y, d);
+}
+
+float
+fvec_int8_L2sqr_ref(const float* x, const int8_t* y, size_t d) {
+    return typed_ref_L2sqr(x, y, d);
+}
+
+void
+fvec_int8_inner_product_batch_4_ref(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                    const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                    float& dis3) {
+    typed_ref_inner_product_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_int8_L2sqr_batch_4_ref(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
+                            const size_t d, float& dis0, float& dis1, float& dis2, float& dis3) {
+    typed_ref_L2sqr_batch_4(x, y0, y1, y2, y3, d, dis0, dis1, dis2, dis3);
+}
+
+void
+fvec_int8_inner_products_ny_ref(float* dis, const float* x, const int8_t* y, size_t d, size_t ny) {
+    typed_ref_ny<typed_ref_inner_product<int8_t>, typed_ref_inner_product_batch_4<int8_t>>(dis, x, y, d, ny);
+}
+
+void
+fvec_int8_L2sqr_ny_ref(float* dis, const float* x, const int8_t* y, size_t d, size_t ny) {
+    typed_ref_ny<typed_ref_L2sqr<int8_t>, typed_ref_L2sqr_batch_4<int8_t>>(dis, x, y, d, ny);
+}
+
+// fp16, bf16 and int8 queries against vectors of the same type
+void
+fp16_vec_inner_products_ny_ref(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_ref_ny<fp16_vec_inner_product_ref, fp16_vec_inner_product_batch_4_ref>(dis, x, y, d, ny);
+}
+
+void
+fp16_vec_L2sqr_ny_ref(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny) {
+    typed_ref_ny<fp16_vec_L2sqr_ref, fp16_vec_L2sqr_batch_4_ref>(dis, x, y, d, ny);
+}
+
+void
+bf16_vec_inner_products_ny_ref(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_ref_ny<bf16_vec_inner_product_ref, bf16_vec_inner_product_batch_4_ref>(dis, x, y, d, ny);
+}
+
+void
+bf16_vec_L2sqr_ny_ref(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny) {
+    typed_ref_ny<bf16_vec_L2sqr_ref, bf16_vec_L2sqr_batch_4_ref>(dis, x, y, d, ny);
+}
+
+void
+int8_vec_inner_products_ny_ref(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+    typed_ref_ny<int8_vec_inner_product_ref, int8_vec_inner_product_batch_4_ref>(dis, x, y, d, ny);
+}
+
+void
+int8_vec_L2sqr_ny_ref(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny) {
+    typed_ref_ny<int8_vec_L2sqr_ref, int8_vec_L2sqr_batch_4_ref>(dis, x, y, d, ny);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // for cardinal
 
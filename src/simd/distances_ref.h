@@ -113,6 +113,12 @@ fp16_vec_L2sqr_batch_4_ref(const knowhere::fp16* x, const knowhere::fp16* y0, co
                            const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0, float& dis1,
                            float& dis2, float& dis3);
 
+void
+fp16_vec_inner_products_ny_ref(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny);
+
+void
+fp16_vec_L2sqr_ny_ref(float* dis, const knowhere::fp16* x, const knowhere::fp16* y, size_t d, size_t ny);
+
 ///////////////////////////////////////////////////////////////////////////////
 // bf16
 float
@@ -134,6 +140,12 @@ bf16_vec_L2sqr_batch_4_ref(const knowhere::bf16* x, const knowhere::bf16* y0, co
                            const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0, float& dis1,
                            float& dis2, float& dis3);
 
+void
+bf16_vec_inner_products_ny_ref(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny);
+
+void
+bf16_vec_L2sqr_ny_ref(float* dis, const knowhere::bf16* x, const knowhere::bf16* y, size_t d, size_t ny);
+
 ///////////////////////////////////////////////////////////////////////////////
 // int8
 float
@@ -154,6 +166,79 @@ void
 int8_vec_L2sqr_batch_4_ref(const int8_t* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
                            const size_t d, float& dis0, float& dis1, float& dis2, float& dis3);
 
+void
+int8_vec_inner_products_ny_ref(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+
+void
+int8_vec_L2sqr_ny_ref(float* dis, const int8_t* x, const int8_t* y, size_t d, size_t ny);
+
+///////////////////////////////////////////////////////////////////////////////
+// fp32 query against fp16, bf16 and int8 vectors
+float
+fvec_fp16_inner_product_ref(const float* x, const knowhere::fp16* y, size_t d);
+
+float
+fvec_fp16_L2sqr_ref(const float* x, const knowhere::fp16* y, size_t d);
+
+void
+fvec_fp16_inner_product_batch_4_ref(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                                    const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                                    float& dis1, float& dis2, float& dis3);
+
+void
+fvec_fp16_L2sqr_batch_4_ref(const float* x, const knowhere::fp16* y0, const knowhere::fp16* y1,
+                            const knowhere::fp16* y2, const knowhere::fp16* y3, const size_t d, float& dis0,
+                            float& dis1, float& dis2, float& dis3);
+
+void
+fvec_fp16_inner_products_ny_ref(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny);
+
+void
+fvec_fp16_L2sqr_ny_ref(float* dis, const float* x, const knowhere::fp16* y, size_t d, size_t ny);
+
+float
+fvec_bf16_inner_product_ref(const float* x, const knowhere::bf16* y, size_t d);
+
+float
+fvec_bf16_L2sqr_ref(const float* x, const knowhere::bf16* y, size_t d);
+
+void
+fvec_bf16_inner_product_batch_4_ref(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                                    const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                                    float& dis1, float& dis2, float& dis3);
+
+void
+fvec_bf16_L2sqr_batch_4_ref(const float* x, const knowhere::bf16* y0, const knowhere::bf16* y1,
+                            const knowhere::bf16* y2, const knowhere::bf16* y3, const size_t d, float& dis0,
+                            float& dis1, float& dis2, float& dis3);
+
+void
+fvec_bf16_inner_products_ny_ref(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny);
+
+void
+fvec_bf16_L2sqr_ny_ref(float* dis, const float* x, const knowhere::bf16* y, size_t d, size_t ny);
+
+float
+fvec_int8_inner_product_ref(const float* x, const int8_t* y, size_t d);
+
+float
+fvec_int8_L2sqr_ref(const float* x, const int8_t* y, size_t d);
+
+void
+fvec_int8_inner_product_batch_4_ref(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2,
+                                    const int8_t* y3, const size_t d, float& dis0, float& dis1, float& dis2,
+                                    float& dis3);
+
+void
+fvec_int8_L2sqr_batch_4_ref(const float* x, const int8_t* y0, const int8_t* y1, const int8_t* y2, const int8_t* y3,
+                            const size_t d, float& dis0, float& dis1, float& dis2, float& dis3);
+
+void
+fvec_int8_inner_products_ny_ref(float* dis, const float* x, const int8_t* y, size_t d, size_t ny);
+
+void
+fvec_int8_L2sqr_ny_ref(float* dis, const float* x, const int8_t* y, size_t d, size_t ny);
+
 ///////////////////////////////////////////////////////////////////////////////
 // for cardinal
 float
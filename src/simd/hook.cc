@@ -11,7 +11,14 @@
 
 #include "hook.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <limits>
 #include <mutex>
+#include <random>
+#include <vector>
 
 #include "faiss/FaissHook.h"
 
@@ -83,6 +90,8 @@ decltype(fp16_vec_norm_L2sqr) fp16_vec_norm_L2sqr = fp16_vec_norm_L2sqr_ref;
 
 decltype(fp16_vec_inner_product_batch_4) fp16_vec_inner_product_batch_4 = fp16_vec_inner_product_batch_4_ref;
 decltype(fp16_vec_L2sqr_batch_4) fp16_vec_L2sqr_batch_4 = fp16_vec_L2sqr_batch_4_ref;
+decltype(fp16_vec_inner_products_ny) fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_ref;
+decltype(fp16_vec_L2sqr_ny) fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_ref;
 
 // bf16
 decltype(bf16_vec_L2sqr) bf16_vec_L2sqr = bf16_vec_L2sqr_ref;
@@ -91,6 +100,8 @@ decltype(bf16_vec_norm_L2sqr) bf16_vec_norm_L2sqr = bf16_vec_norm_L2sqr_ref;
 
 decltype(bf16_vec_inner_product_batch_4) bf16_vec_inner_product_batch_4 = bf16_vec_inner_product_batch_4_ref;
 decltype(bf16_vec_L2sqr_batch_4) bf16_vec_L2sqr_batch_4 = bf16_vec_L2sqr_batch_4_ref;
+decltype(bf16_vec_inner_products_ny) bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_ref;
+decltype(bf16_vec_L2sqr_ny) bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_ref;
 
 // int8
 decltype(int8_vec_L2sqr) int8_vec_L2sqr = int8_vec_L2sqr_ref;
@@ -99,6 +110,30 @@ decltype(int8_vec_norm_L2sqr) int8_vec_norm_L2sqr = int8_vec_norm_L2sqr_ref;
 
 decltype(int8_vec_inner_product_batch_4) int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_ref;
 decltype(int8_vec_L2sqr_batch_4) int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_ref;
+decltype(int8_vec_inner_products_ny) int8_vec_inner_products_ny = int8_vec_inner_products_ny_ref;
+decltype(int8_vec_L2sqr_ny) int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_ref;
+
+// fp32 query against fp16, bf16 and int8 vectors
+decltype(fvec_fp16_inner_product) fvec_fp16_inner_product = fvec_fp16_inner_product_ref;
+decltype(fvec_fp16_L2sqr) fvec_fp16_L2sqr = fvec_fp16_L2sqr_ref;
+decltype(fvec_fp16_inner_product_batch_4) fvec_fp16_inner_product_batch_4 = fvec_fp16_inner_product_batch_4_ref;
+decltype(fvec_fp16_L2sqr_batch_4) fvec_fp16_L2sqr_batch_4 = fvec_fp16_L2sqr_batch_4_ref;
+decltype(fvec_fp16_inner_products_ny) fvec_fp16_inner_products_ny = fvec_fp16_inner_products_ny_ref;
+decltype(fvec_fp16_L2sqr_ny) fvec_fp16_L2sqr_ny = fvec_fp16_L2sqr_ny_ref;
+
+decltype(fvec_bf16_inner_product) fvec_bf16_inner_product = fvec_bf16_inner_product_ref;
+decltype(fvec_bf16_L2sqr) fvec_bf16_L2sqr = fvec_bf16_L2sqr_ref;
+decltype(fvec_bf16_inner_product_batch_4) fvec_bf16_inner_product_batch_4 = fvec_bf16_inner_product_batch_4_ref;
+decltype(fvec_bf16_L2sqr_batch_4) fvec_bf16_L2sqr_batch_4 = fvec_bf16_L2sqr_batch_4_ref;
+decltype(fvec_bf16_inner_products_ny) fvec_bf16_inner_products_ny = fvec_bf16_inner_products_ny_ref;
+decltype(fvec_bf16_L2sqr_ny) fvec_bf16_L2sqr_ny = fvec_bf16_L2sqr_ny_ref;
+
+decltype(fvec_int8_inner_product) fvec_int8_inner_product = fvec_int8_inner_product_ref;
+decltype(fvec_int8_L2sqr) fvec_int8_L2sqr = fvec_int8_L2sqr_ref;
+decltype(fvec_int8_inner_product_batch_4) fvec_int8_inner_product_batch_4 = fvec_int8_inner_product_batch_4_ref;
+decltype(fvec_int8_L2sqr_batch_4) fvec_int8_L2sqr_batch_4 = fvec_int8_L2sqr_batch_4_ref;
+decltype(fvec_int8_inner_products_ny) fvec_int8_inner_products_ny = fvec_int8_inner_products_ny_ref;
+decltype(fvec_int8_L2sqr_ny) fvec_int8_L2sqr_ny = fvec_int8_L2sqr_ny_ref;
 
 // rabitq
 decltype(fvec_masked_sum) fvec_masked_sum = fvec_masked_sum_ref;
@@ -220,10 +255,38 @@ disable_patch_for_fp32_bf16() {
 #endif
 }
 
+static std::mutex hook_mutex;
+static std::vector<std::string> calibration_table;
+
+// short, medium and long vectors, split at about the geometric middle of the dimensions
+// fvec_hook_calibrate times them at
+constexpr size_t kCalibrationBuckets = 3;
+
+static size_t
+calibration_bucket(size_t d) {
+    return d <= 64 ? 0 : d <= 384 ? 1 : 2;
+}
+
+// the calibrated kernel of each dimension bucket for the kernels with a _for_dim lookup,
+// all null until fvec_hook_calibrate has picked them
+static std::array<decltype(fvec_L2sqr), kCalibrationBuckets> calibrated_L2sqr;
+static std::array<decltype(fvec_inner_product), kCalibrationBuckets> calibrated_inner_product;
+static std::array<decltype(fvec_L2sqr_batch_4), kCalibrationBuckets> calibrated_L2sqr_batch_4;
+static std::array<decltype(fvec_inner_product_batch_4), kCalibrationBuckets> calibrated_inner_product_batch_4;
+
+static void
+clear_calibration() {
+    calibration_table.clear();
+    calibrated_L2sqr.fill(nullptr);
+    calibrated_inner_product.fill(nullptr);
+    calibrated_L2sqr_batch_4.fill(nullptr);
+    calibrated_inner_product_batch_4.fill(nullptr);
+}
+
 void
 fvec_hook(std::string& simd_type) {
-    static std::mutex hook_mutex;
     std::lock_guard<std::mutex> lock(hook_mutex);
+    clear_calibration();
 #if defined(__x86_64__)
     if (use_avx512 && cpu_support_avx512()) {
         fvec_inner_product = fvec_inner_product_avx512;
@@ -252,6 +315,8 @@ fvec_hook(std::string& simd_type) {
 
         fp16_vec_inner_product_batch_4 = fp16_vec_inner_product_batch_4_avx512;
         fp16_vec_L2sqr_batch_4 = fp16_vec_L2sqr_batch_4_avx512;
+        fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_avx512;
+        fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_avx512;
 
         // bf16
         bf16_vec_inner_product = bf16_vec_inner_product_avx512;
@@ -260,6 +325,8 @@ fvec_hook(std::string& simd_type) {
 
         bf16_vec_inner_product_batch_4 = bf16_vec_inner_product_batch_4_avx512;
         bf16_vec_L2sqr_batch_4 = bf16_vec_L2sqr_batch_4_avx512;
+        bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_avx512;
+        bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_avx512;
 
         // int8
         int8_vec_inner_product = int8_vec_inner_product_avx512;
@@ -268,6 +335,30 @@ fvec_hook(std::string& simd_type) {
 
         int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_avx512;
         int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_avx512;
+        int8_vec_inner_products_ny = int8_vec_inner_products_ny_avx512;
+        int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_avx512;
+
+        // fp32 query against fp16, bf16 and int8 vectors
+        fvec_fp16_inner_product = fvec_fp16_inner_product_avx512;
+        fvec_fp16_L2sqr = fvec_fp16_L2sqr_avx512;
+        fvec_fp16_inner_product_batch_4 = fvec_fp16_inner_product_batch_4_avx512;
+        fvec_fp16_L2sqr_batch_4 = fvec_fp16_L2sqr_batch_4_avx512;
+        fvec_fp16_inner_products_ny = fvec_fp16_inner_products_ny_avx512;
+        fvec_fp16_L2sqr_ny = fvec_fp16_L2sqr_ny_avx512;
+
+        fvec_bf16_inner_product = fvec_bf16_inner_product_avx512;
+        fvec_bf16_L2sqr = fvec_bf16_L2sqr_avx512;
+        fvec_bf16_inner_product_batch_4 = fvec_bf16_inner_product_batch_4_avx512;
+        fvec_bf16_L2sqr_batch_4 = fvec_bf16_L2sqr_batch_4_avx512;
+        fvec_bf16_inner_products_ny = fvec_bf16_inner_products_ny_avx512;
+        fvec_bf16_L2sqr_ny = fvec_bf16_L2sqr_ny_avx512;
+
+        fvec_int8_inner_product = fvec_int8_inner_product_avx512;
+        fvec_int8_L2sqr = fvec_int8_L2sqr_avx512;
+        fvec_int8_inner_product_batch_4 = fvec_int8_inner_product_batch_4_avx512;
+        fvec_int8_L2sqr_batch_4 = fvec_int8_L2sqr_batch_4_avx512;
+        fvec_int8_inner_products_ny = fvec_int8_inner_products_ny_avx512;
+        fvec_int8_L2sqr_ny = fvec_int8_L2sqr_ny_avx512;
 
         // rabitq
         fvec_masked_sum = fvec_masked_sum_avx512;
@@ -307,6 +398,8 @@ fvec_hook(std::string& simd_type) {
 
         fp16_vec_inner_product_batch_4 = fp16_vec_inner_product_batch_4_avx;
         fp16_vec_L2sqr_batch_4 = fp16_vec_L2sqr_batch_4_avx;
+        fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_avx;
+        fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_avx;
 
         // bf16
         bf16_vec_inner_product = bf16_vec_inner_product_avx;
@@ -315,6 +408,8 @@ fvec_hook(std::string& simd_type) {
 
         bf16_vec_inner_product_batch_4 = bf16_vec_inner_product_batch_4_avx;
         bf16_vec_L2sqr_batch_4 = bf16_vec_L2sqr_batch_4_avx;
+        bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_avx;
+        bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_avx;
 
         // int8
         int8_vec_inner_product = int8_vec_inner_product_avx;
@@ -323,6 +418,30 @@ fvec_hook(std::string& simd_type) {
 
         int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_avx;
         int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_avx;
+        int8_vec_inner_products_ny = int8_vec_inner_products_ny_avx;
+        int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_avx;
+
+        // fp32 query against fp16, bf16 and int8 vectors
+        fvec_fp16_inner_product = fvec_fp16_inner_product_avx;
+        fvec_fp16_L2sqr = fvec_fp16_L2sqr_avx;
+        fvec_fp16_inner_product_batch_4 = fvec_fp16_inner_product_batch_4_avx;
+        fvec_fp16_L2sqr_batch_4 = fvec_fp16_L2sqr_batch_4_avx;
+        fvec_fp16_inner_products_ny = fvec_fp16_inner_products_ny_avx;
+        fvec_fp16_L2sqr_ny = fvec_fp16_L2sqr_ny_avx;
+
+        fvec_bf16_inner_product = fvec_bf16_inner_product_avx;
+        fvec_bf16_L2sqr = fvec_bf16_L2sqr_avx;
+        fvec_bf16_inner_product_batch_4 = fvec_bf16_inner_product_batch_4_avx;
+        fvec_bf16_L2sqr_batch_4 = fvec_bf16_L2sqr_batch_4_avx;
+        fvec_bf16_inner_products_ny = fvec_bf16_inner_products_ny_avx;
+        fvec_bf16_L2sqr_ny = fvec_bf16_L2sqr_ny_avx;
+
+        fvec_int8_inner_product = fvec_int8_inner_product_avx;
+        fvec_int8_L2sqr = fvec_int8_L2sqr_avx;
+        fvec_int8_inner_product_batch_4 = fvec_int8_inner_product_batch_4_avx;
+        fvec_int8_L2sqr_batch_4 = fvec_int8_L2sqr_batch_4_avx;
+        fvec_int8_inner_products_ny = fvec_int8_inner_products_ny_avx;
+        fvec_int8_L2sqr_ny = fvec_int8_L2sqr_ny_avx;
 
         // rabitq
         fvec_masked_sum = fvec_masked_sum_avx;
@@ -357,6 +476,8 @@ fvec_hook(std::string& simd_type) {
 
         fp16_vec_inner_product_batch_4 = fp16_vec_inner_product_batch_4_ref;
         fp16_vec_L2sqr_batch_4 = fp16_vec_L2sqr_batch_4_ref;
+        fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_ref;
+        fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_ref;
 
         // bf16
         bf16_vec_inner_product = bf16_vec_inner_product_sse;
@@ -365,6 +486,8 @@ fvec_hook(std::string& simd_type) {
 
         bf16_vec_inner_product_batch_4 = bf16_vec_inner_product_batch_4_ref;
         bf16_vec_L2sqr_batch_4 = bf16_vec_L2sqr_batch_4_ref;
+        bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_ref;
+        bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_ref;
 
         // int8
         int8_vec_inner_product = int8_vec_inner_product_sse;
@@ -373,6 +496,30 @@ fvec_hook(std::string& simd_type) {
 
         int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_ref;
         int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_ref;
+        int8_vec_inner_products_ny = int8_vec_inner_products_ny_ref;
+        int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_ref;
+
+        // fp32 query against fp16, bf16 and int8 vectors
+        fvec_fp16_inner_product = fvec_fp16_inner_product_ref;
+        fvec_fp16_L2sqr = fvec_fp16_L2sqr_ref;
+        fvec_fp16_inner_product_batch_4 = fvec_fp16_inner_product_batch_4_ref;
+        fvec_fp16_L2sqr_batch_4 = fvec_fp16_L2sqr_batch_4_ref;
+        fvec_fp16_inner_products_ny = fvec_fp16_inner_products_ny_ref;
+        fvec_fp16_L2sqr_ny = fvec_fp16_L2sqr_ny_ref;
+
+        fvec_bf16_inner_product = fvec_bf16_inner_product_ref;
+        fvec_bf16_L2sqr = fvec_bf16_L2sqr_ref;
+        fvec_bf16_inner_product_batch_4 = fvec_bf16_inner_product_batch_4_ref;
+        fvec_bf16_L2sqr_batch_4 = fvec_bf16_L2sqr_batch_4_ref;
+        fvec_bf16_inner_products_ny = fvec_bf16_inner_products_ny_ref;
+        fvec_bf16_L2sqr_ny = fvec_bf16_L2sqr_ny_ref;
+
+        fvec_int8_inner_product = fvec_int8_inner_product_ref;
+        fvec_int8_L2sqr = fvec_int8_L2sqr_ref;
+        fvec_int8_inner_product_batch_4 = fvec_int8_inner_product_batch_4_ref;
+        fvec_int8_L2sqr_batch_4 = fvec_int8_L2sqr_batch_4_ref;
+        fvec_int8_inner_products_ny = fvec_int8_inner_products_ny_ref;
+        fvec_int8_L2sqr_ny = fvec_int8_L2sqr_ny_ref;
 
         // rabitq
         fvec_masked_sum = fvec_masked_sum_sse;
@@ -407,6 +554,8 @@ fvec_hook(std::string& simd_type) {
 
         fp16_vec_inner_product_batch_4 = fp16_vec_inner_product_batch_4_ref;
         fp16_vec_L2sqr_batch_4 = fp16_vec_L2sqr_batch_4_ref;
+        fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_ref;
+        fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_ref;
 
         // bf16
         bf16_vec_inner_product = bf16_vec_inner_product_ref;
@@ -415,6 +564,8 @@ fvec_hook(std::string& simd_type) {
 
         bf16_vec_inner_product_batch_4 = bf16_vec_inner_product_batch_4_ref;
         bf16_vec_L2sqr_batch_4 = bf16_vec_L2sqr_batch_4_ref;
+        bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_ref;
+        bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_ref;
 
         // int8
         int8_vec_inner_product = int8_vec_inner_product_ref;
@@ -423,6 +574,30 @@ fvec_hook(std::string& simd_type) {
 
         int8_vec_inner_product_batch_4 = int8_vec_inner_product_batch_4_ref;
         int8_vec_L2sqr_batch_4 = int8_vec_L2sqr_batch_4_ref;
+        int8_vec_inner_products_ny = int8_vec_inner_products_ny_ref;
+        int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_ref;
+
+        // fp32 query against fp16, bf16 and int8 vectors
+        fvec_fp16_inner_product = fvec_fp16_inner_product_ref;
+        fvec_fp16_L2sqr = fvec_fp16_L2sqr_ref;
+        fvec_fp16_inner_product_batch_4 = fvec_fp16_inner_product_batch_4_ref;
+        fvec_fp16_L2sqr_batch_4 = fvec_fp16_L2sqr_batch_4_ref;
+        fvec_fp16_inner_products_ny = fvec_fp16_inner_products_ny_ref;
+        fvec_fp16_L2sqr_ny = fvec_fp16_L2sqr_ny_ref;
+
+        fvec_bf16_inner_product = fvec_bf16_inner_product_ref;
+        fvec_bf16_L2sqr = fvec_bf16_L2sqr_ref;
+        fvec_bf16_inner_product_batch_4 = fvec_bf16_inner_product_batch_4_ref;
+        fvec_bf16_L2sqr_batch_4 = fvec_bf16_L2sqr_batch_4_ref;
+        fvec_bf16_inner_products_ny = fvec_bf16_inner_products_ny_ref;
+        fvec_bf16_L2sqr_ny = fvec_bf16_L2sqr_ny_ref;
+
+        fvec_int8_inner_product = fvec_int8_inner_product_ref;
+        fvec_int8_L2sqr = fvec_int8_L2sqr_ref;
+        fvec_int8_inner_product_batch_4 = fvec_int8_inner_product_batch_4_ref;
+        fvec_int8_L2sqr_batch_4 = fvec_int8_L2sqr_batch_4_ref;
+        fvec_int8_inner_products_ny = fvec_int8_inner_products_ny_ref;
+        fvec_int8_L2sqr_ny = fvec_int8_L2sqr_ny_ref;
 
         // rabitq
         fvec_masked_sum = fvec_masked_sum_ref;
@@ -464,6 +639,36 @@ fvec_hook(std::string& simd_type) {
         fvec_L2sqr_batch_4 = fvec_L2sqr_batch_4_sve;
         fvec_inner_product_batch_4 = fvec_inner_product_batch_4_sve;
 
+        // fp16, bf16 and int8 ny, the SVE build also has the NEON kernels
+        fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_neon;
+        fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_neon;
+        bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_neon;
+        bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_neon;
+        int8_vec_inner_products_ny = int8_vec_inner_products_ny_neon;
+        int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_neon;
+
+        // fp32 query against fp16, bf16 and int8 vectors
+        fvec_fp16_inner_product = fvec_fp16_inner_product_neon;
+        fvec_fp16_L2sqr = fvec_fp16_L2sqr_neon;
+        fvec_fp16_inner_product_batch_4 = fvec_fp16_inner_product_batch_4_neon;
+        fvec_fp16_L2sqr_batch_4 = fvec_fp16_L2sqr_batch_4_neon;
+        fvec_fp16_inner_products_ny = fvec_fp16_inner_products_ny_neon;
+        fvec_fp16_L2sqr_ny = fvec_fp16_L2sqr_ny_neon;
+
+        fvec_bf16_inner_product = fvec_bf16_inner_product_neon;
+        fvec_bf16_L2sqr = fvec_bf16_L2sqr_neon;
+        fvec_bf16_inner_product_batch_4 = fvec_bf16_inner_product_batch_4_neon;
+        fvec_bf16_L2sqr_batch_4 = fvec_bf16_L2sqr_batch_4_neon;
+        fvec_bf16_inner_products_ny = fvec_bf16_inner_products_ny_neon;
+        fvec_bf16_L2sqr_ny = fvec_bf16_L2sqr_ny_neon;
+
+        fvec_int8_inner_product = fvec_int8_inner_product_neon;
+        fvec_int8_L2sqr = fvec_int8_L2sqr_neon;
+        fvec_int8_inner_product_batch_4 = fvec_int8_inner_product_batch_4_neon;
+        fvec_int8_L2sqr_batch_4 = fvec_int8_L2sqr_batch_4_neon;
+        fvec_int8_inner_products_ny = fvec_int8_inner_products_ny_neon;
+        fvec_int8_L2sqr_ny = fvec_int8_L2sqr_ny_neon;
+
         simd_type = "SVE";
         support_pq_fast_scan = true;
 #endif
@@ -496,6 +701,8 @@ fvec_hook(std::string& simd_type) {
 
         fp16_vec_inner_product_batch_4 = fp16_vec_inner_product_batch_4_neon;
         fp16_vec_L2sqr_batch_4 = fp16_vec_L2sqr_batch_4_neon;
+        fp16_vec_inner_products_ny = fp16_vec_inner_products_ny_neon;
+        fp16_vec_L2sqr_ny = fp16_vec_L2sqr_ny_neon;
 
         // bf16
         bf16_vec_inner_product = bf16_vec_inner_product_neon;
@@ -504,8 +711,36 @@ fvec_hook(std::string& simd_type) {
 
         bf16_vec_inner_product_batch_4 = bf16_vec_inner_product_batch_4_neon;
         bf16_vec_L2sqr_batch_4 = bf16_vec_L2sqr_batch_4_neon;
+        bf16_vec_inner_products_ny = bf16_vec_inner_products_ny_neon;
+        bf16_vec_L2sqr_ny = bf16_vec_L2sqr_ny_neon;
+
+        // int8, the ny kernels sum in int32 and match the ref single row kernels exactly
+        int8_vec_inner_products_ny = int8_vec_inner_products_ny_neon;
+        int8_vec_L2sqr_ny = int8_vec_L2sqr_ny_neon;
 
         //
+        // fp32 query against fp16, bf16 and int8 vectors
+        fvec_fp16_inner_product = fvec_fp16_inner_product_neon;
+        fvec_fp16_L2sqr = fvec_fp16_L2sqr_neon;
+        fvec_fp16_inner_product_batch_4 = fvec_fp16_inner_product_batch_4_neon;
+        fvec_fp16_L2sqr_batch_4 = fvec_fp16_L2sqr_batch_4_neon;
+        fvec_fp16_inner_products_ny = fvec_fp16_inner_products_ny_neon;
+        fvec_fp16_L2sqr_ny = fvec_fp16_L2sqr_ny_neon;
+
+        fvec_bf16_inner_product = fvec_bf16_inner_product_neon;
+        fvec_bf16_L2sqr = fvec_bf16_L2sqr_neon;
+        fvec_bf16_inner_product_batch_4 = fvec_bf16_inner_product_batch_4_neon;
+        fvec_bf16_L2sqr_batch_4 = fvec_bf16_L2sqr_batch_4_neon;
+        fvec_bf16_inner_products_ny = fvec_bf16_inner_products_ny_neon;
+        fvec_bf16_L2sqr_ny = fvec_bf16_L2sqr_ny_neon;
+
+        fvec_int8_inner_product = fvec_int8_inner_product_neon;
+        fvec_int8_L2sqr = fvec_int8_L2sqr_neon;
+        fvec_int8_inner_product_batch_4 = fvec_int8_inner_product_batch_4_neon;
+        fvec_int8_L2sqr_batch_4 = fvec_int8_L2sqr_batch_4_neon;
+        fvec_int8_inner_products_ny = fvec_int8_inner_products_ny_neon;
+        fvec_int8_L2sqr_ny = fvec_int8_L2sqr_ny_neon;
+
         simd_type = "NEON";
         support_pq_fast_scan = true;
 #endif
@@ -541,6 +776,251 @@ fvec_hook(std::string& simd_type) {
 #endif
 }
 
+#if defined(__x86_64__)
+namespace {
+
+// representative dimensions of the short, medium and long vector buckets
+constexpr size_t kCalibrationDims[] = {32, 128, 768};
+static_assert(std::size(kCalibrationDims) == kCalibrationBuckets);
+constexpr size_t kCalibrationNy = 64;
+// number of vector elements touched by a single timed run
+constexpr size_t kCalibrationWork = 1 << 18;
+constexpr int kCalibrationRuns = 5;
+
+// Random data for timing the kernels taking a TX query and TY vectors. One overload of
+// Time() per kernel shape, each returns the best observed time per vector in nanoseconds.
+template <typename TX, typename TY>
+struct CalibrationBench {
+    std::vector<TX> x;
+    std::vector<TY> y;
+    std::vector<float> dis;
+    float sink = 0;
+
+    explicit CalibrationBench(std::mt19937& rng)
+        : x(Random<TX>(kCalibrationDims[2], rng)),
+          y(Random<TY>(kCalibrationDims[2] * kCalibrationNy, rng)),
+          dis(kCalibrationNy) {
+    }
+
+    template <typename T>
+    static std::vector<T>
+    Random(size_t n, std::mt19937& rng) {
+        std::uniform_real_distribution<float> distrib(-1.0f, 1.0f);
+        std::vector<T> data(n);
+        for (auto& v : data) {
+            if constexpr (std::is_same_v<T, int8_t>) {
+                v = static_cast<int8_t>(distrib(rng) * 127.0f);
+            } else {
+                v = T(distrib(rng));
+            }
+        }
+        return data;
+    }
+
+    template <typename Run>
+    double
+    Best(size_t d, Run&& run) {
+        const size_t reps = std::max<size_t>(1, kCalibrationWork / (d * kCalibrationNy));
+        run();
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < kCalibrationRuns; i++) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < reps; r++) {
+                run();
+            }
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count() / (reps * kCalibrationNy));
+        }
+        return best;
+    }
+
+    double
+    Time(float (*func)(const TX*, const TY*, size_t), size_t d) {
+        return Best(d, [&]() {
+            for (size_t i = 0; i < kCalibrationNy; i++) {
+                sink += func(x.data(), y.data() + i * d, d);
+            }
+        });
+    }
+
+    double
+    Time(void (*func)(const TX*, const TY*, const TY*, const TY*, const TY*, const size_t, float&, float&, float&,
+                      float&),
+         size_t d) {
+        return Best(d, [&]() {
+            for (size_t i = 0; i < kCalibrationNy; i += 4) {
+                const TY* y0 = y.data() + i * d;
+                func(x.data(), y0, y0 + d, y0 + 2 * d, y0 + 3 * d, d, dis[0], dis[1], dis[2], dis[3]);
+                sink += dis[0] + dis[1] + dis[2] + dis[3];
+            }
+        });
+    }
+
+    double
+    Time(void (*func)(float*, const TX*, const TY*, size_t, size_t), size_t d) {
+        return Best(d, [&]() {
+            func(dis.data(), x.data(), y.data(), d, kCalibrationNy);
+            sink += dis[0];
+        });
+    }
+};
+
+// Times the AVX512 and AVX2 implementations of a kernel for every dimension bucket and
+// installs the one with the lowest total time, each bucket relative to its fastest run so
+// that the short vectors weigh as much as the long ones. The fastest one of each bucket
+// also goes to by_bucket, if given, for the _for_dim lookups. A hook pointing elsewhere,
+// e.g. to the fp32 as bf16 patch, is left alone.
+template <typename Bench, typename Func>
+void
+calibrate_kernel(Bench& bench, const char* name, Func& hook, Func avx512, Func avx2,
+                 std::array<Func, kCalibrationBuckets>* by_bucket = nullptr) {
+    if (hook != avx512 && hook != avx2) {
+        return;
+    }
+    const Func candidates[] = {avx512, avx2};
+    const char* candidate_names[] = {"AVX512", "AVX2"};
+    double score[2] = {0, 0};
+    std::string detail;
+    for (size_t b = 0; b < kCalibrationBuckets; b++) {
+        const size_t d = kCalibrationDims[b];
+        double ns[2];
+        for (int c = 0; c < 2; c++) {
+            ns[c] = bench.Time(candidates[c], d);
+        }
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "%sd=%zu AVX512 %.1fns AVX2 %.1fns", detail.empty() ? "" : ", ", d, ns[0],
+                      ns[1]);
+        detail += buf;
+        if (by_bucket != nullptr) {
+            const int fastest = ns[0] <= ns[1] ? 0 : 1;
+            (*by_bucket)[b] = candidates[fastest];
+            detail += std::string(" -> ") + candidate_names[fastest];
+        }
+        for (int c = 0; c < 2; c++) {
+            score[c] += ns[c] / std::max(std::min(ns[0], ns[1]), 1e-3);
+        }
+    }
+    const int chosen = score[0] <= score[1] ? 0 : 1;
+    hook = candidates[chosen];
+    calibration_table.push_back(std::string(name) + ": " + candidate_names[chosen] + " (" + detail + ")");
+}
+
+}  // namespace
+#endif
+
+std::vector<std::string>
+fvec_hook_calibrate() {
+    std::lock_guard<std::mutex> lock(hook_mutex);
+    clear_calibration();
+#if defined(__x86_64__)
+    // AVX512 hosts are the only ones with more than one candidate worth timing, SSE4_2 and
+    // the generic kernels never beat AVX2.
+    if (use_avx512 && cpu_support_avx512() && use_avx2 && cpu_support_avx2()) {
+        std::mt19937 rng(123);
+
+        CalibrationBench<float, float> fp32(rng);
+        calibrate_kernel(fp32, "fvec_L2sqr", fvec_L2sqr, fvec_L2sqr_avx512, fvec_L2sqr_avx, &calibrated_L2sqr);
+        calibrate_kernel(fp32, "fvec_inner_product", fvec_inner_product, fvec_inner_product_avx512,
+                         fvec_inner_product_avx, &calibrated_inner_product);
+        calibrate_kernel(fp32, "fvec_L2sqr_batch_4", fvec_L2sqr_batch_4, fvec_L2sqr_batch_4_avx512,
+                         fvec_L2sqr_batch_4_avx, &calibrated_L2sqr_batch_4);
+        calibrate_kernel(fp32, "fvec_inner_product_batch_4", fvec_inner_product_batch_4,
+                         fvec_inner_product_batch_4_avx512, fvec_inner_product_batch_4_avx,
+                         &calibrated_inner_product_batch_4);
+        calibrate_kernel(fp32, "fvec_L2sqr_ny", fvec_L2sqr_ny, fvec_L2sqr_ny_avx512, fvec_L2sqr_ny_avx);
+        // the AVX2 hook of fvec_inner_products_ny is the SSE kernel
+        calibrate_kernel(fp32, "fvec_inner_products_ny", fvec_inner_products_ny, fvec_inner_products_ny_avx512,
+                         fvec_inner_products_ny_sse);
+
+        CalibrationBench<knowhere::fp16, knowhere::fp16> fp16(rng);
+        calibrate_kernel(fp16, "fp16_vec_L2sqr", fp16_vec_L2sqr, fp16_vec_L2sqr_avx512, fp16_vec_L2sqr_avx);
+        calibrate_kernel(fp16, "fp16_vec_inner_product", fp16_vec_inner_product, fp16_vec_inner_product_avx512,
+                         fp16_vec_inner_product_avx);
+        calibrate_kernel(fp16, "fp16_vec_L2sqr_batch_4", fp16_vec_L2sqr_batch_4, fp16_vec_L2sqr_batch_4_avx512,
+                         fp16_vec_L2sqr_batch_4_avx);
+        calibrate_kernel(fp16, "fp16_vec_inner_product_batch_4", fp16_vec_inner_product_batch_4,
+                         fp16_vec_inner_product_batch_4_avx512, fp16_vec_inner_product_batch_4_avx);
+        calibrate_kernel(fp16, "fp16_vec_L2sqr_ny", fp16_vec_L2sqr_ny, fp16_vec_L2sqr_ny_avx512,
+                         fp16_vec_L2sqr_ny_avx);
+        calibrate_kernel(fp16, "fp16_vec_inner_products_ny", fp16_vec_inner_products_ny,
+                         fp16_vec_inner_products_ny_avx512, fp16_vec_inner_products_ny_avx);
+
+        CalibrationBench<knowhere::bf16, knowhere::bf16> bf16(rng);
+        calibrate_kernel(bf16, "bf16_vec_L2sqr", bf16_vec_L2sqr, bf16_vec_L2sqr_avx512, bf16_vec_L2sqr_avx);
+        calibrate_kernel(bf16, "bf16_vec_inner_product", bf16_vec_inner_product, bf16_vec_inner_product_avx512,
+                         bf16_vec_inner_product_avx);
+        calibrate_kernel(bf16, "bf16_vec_L2sqr_batch_4", bf16_vec_L2sqr_batch_4, bf16_vec_L2sqr_batch_4_avx512,
+                         bf16_vec_L2sqr_batch_4_avx);
+        calibrate_kernel(bf16, "bf16_vec_inner_product_batch_4", bf16_vec_inner_product_batch_4,
+                         bf16_vec_inner_product_batch_4_avx512, bf16_vec_inner_product_batch_4_avx);
+        calibrate_kernel(bf16, "bf16_vec_L2sqr_ny", bf16_vec_L2sqr_ny, bf16_vec_L2sqr_ny_avx512,
+                         bf16_vec_L2sqr_ny_avx);
+        calibrate_kernel(bf16, "bf16_vec_inner_products_ny", bf16_vec_inner_products_ny,
+                         bf16_vec_inner_products_ny_avx512, bf16_vec_inner_products_ny_avx);
+
+        CalibrationBench<int8_t, int8_t> int8(rng);
+        calibrate_kernel(int8, "int8_vec_L2sqr", int8_vec_L2sqr, int8_vec_L2sqr_avx512, int8_vec_L2sqr_avx);
+        calibrate_kernel(int8, "int8_vec_inner_product", int8_vec_inner_product, int8_vec_inner_product_avx512,
+                         int8_vec_inner_product_avx);
+        calibrate_kernel(int8, "int8_vec_L2sqr_batch_4", int8_vec_L2sqr_batch_4, int8_vec_L2sqr_batch_4_avx512,
+                         int8_vec_L2sqr_batch_4_avx);
+        calibrate_kernel(int8, "int8_vec_inner_product_batch_4", int8_vec_inner_product_batch_4,
+                         int8_vec_inner_product_batch_4_avx512, int8_vec_inner_product_batch_4_avx);
+        calibrate_kernel(int8, "int8_vec_L2sqr_ny", int8_vec_L2sqr_ny, int8_vec_L2sqr_ny_avx512,
+                         int8_vec_L2sqr_ny_avx);
+        calibrate_kernel(int8, "int8_vec_inner_products_ny", int8_vec_inner_products_ny,
+                         int8_vec_inner_products_ny_avx512, int8_vec_inner_products_ny_avx);
+
+        // fp32 query against fp16, bf16 and int8 vectors
+        CalibrationBench<float, knowhere::fp16> fvec_fp16(rng);
+        calibrate_kernel(fvec_fp16, "fvec_fp16_L2sqr", fvec_fp16_L2sqr, fvec_fp16_L2sqr_avx512, fvec_fp16_L2sqr_avx);
+        calibrate_kernel(fvec_fp16, "fvec_fp16_inner_product", fvec_fp16_inner_product,
+                         fvec_fp16_inner_product_avx512, fvec_fp16_inner_product_avx);
+        calibrate_kernel(fvec_fp16, "fvec_fp16_L2sqr_batch_4", fvec_fp16_L2sqr_batch_4,
+                         fvec_fp16_L2sqr_batch_4_avx512, fvec_fp16_L2sqr_batch_4_avx);
+        calibrate_kernel(fvec_fp16, "fvec_fp16_inner_product_batch_4", fvec_fp16_inner_product_batch_4,
+                         fvec_fp16_inner_product_batch_4_avx512, fvec_fp16_inner_product_batch_4_avx);
+        calibrate_kernel(fvec_fp16, "fvec_fp16_L2sqr_ny", fvec_fp16_L2sqr_ny, fvec_fp16_L2sqr_ny_avx512,
+                         fvec_fp16_L2sqr_ny_avx);
+        calibrate_kernel(fvec_fp16, "fvec_fp16_inner_products_ny", fvec_fp16_inner_products_ny,
+                         fvec_fp16_inner_products_ny_avx512, fvec_fp16_inner_products_ny_avx);
+
+        CalibrationBench<float, knowhere::bf16> fvec_bf16(rng);
+        calibrate_kernel(fvec_bf16, "fvec_bf16_L2sqr", fvec_bf16_L2sqr, fvec_bf16_L2sqr_avx512, fvec_bf16_L2sqr_avx);
+        calibrate_kernel(fvec_bf16, "fvec_bf16_inner_product", fvec_bf16_inner_product,
+                         fvec_bf16_inner_product_avx512, fvec_bf16_inner_product_avx);
+        calibrate_kernel(fvec_bf16, "fvec_bf16_L2sqr_batch_4", fvec_bf16_L2sqr_batch_4,
+                         fvec_bf16_L2sqr_batch_4_avx512, fvec_bf16_L2sqr_batch_4_avx);
+        calibrate_kernel(fvec_bf16, "fvec_bf16_inner_product_batch_4", fvec_bf16_inner_product_batch_4,
+                         fvec_bf16_inner_product_batch_4_avx512, fvec_bf16_inner_product_batch_4_avx);
+        calibrate_kernel(fvec_bf16, "fvec_bf16_L2sqr_ny", fvec_bf16_L2sqr_ny, fvec_bf16_L2sqr_ny_avx512,
+                         fvec_bf16_L2sqr_ny_avx);
+        calibrate_kernel(fvec_bf16, "fvec_bf16_inner_products_ny", fvec_bf16_inner_products_ny,
+                         fvec_bf16_inner_products_ny_avx512, fvec_bf16_inner_products_ny_avx);
+
+        CalibrationBench<float, int8_t> fvec_int8(rng);
+        calibrate_kernel(fvec_int8, "fvec_int8_L2sqr", fvec_int8_L2sqr, fvec_int8_L2sqr_avx512, fvec_int8_L2sqr_avx);
+        calibrate_kernel(fvec_int8, "fvec_int8_inner_product", fvec_int8_inner_product,
+                         fvec_int8_inner_product_avx512, fvec_int8_inner_product_avx);
+        calibrate_kernel(fvec_int8, "fvec_int8_L2sqr_batch_4", fvec_int8_L2sqr_batch_4,
+                         fvec_int8_L2sqr_batch_4_avx512, fvec_int8_L2sqr_batch_4_avx);
+        calibrate_kernel(fvec_int8, "fvec_int8_inner_product_batch_4", fvec_int8_inner_product_batch_4,
+                         fvec_int8_inner_product_batch_4_avx512, fvec_int8_inner_product_batch_4_avx);
+        calibrate_kernel(fvec_int8, "fvec_int8_L2sqr_ny", fvec_int8_L2sqr_ny, fvec_int8_L2sqr_ny_avx512,
+                         fvec_int8_L2sqr_ny_avx);
+        calibrate_kernel(fvec_int8, "fvec_int8_inner_products_ny", fvec_int8_inner_products_ny,
+                         fvec_int8_inner_products_ny_avx512, fvec_int8_inner_products_ny_avx);
+    }
+#endif
+    return calibration_table;
+}
+
+std::vector<std::string>
+fvec_hook_calibration_table() {
+    std::lock_guard<std::mutex> lock(hook_mutex);
+    return calibration_table;
+}
+
 static int init_hook_ = []() {
     std::string simd_type;
     fvec_hook(simd_type);
@@ -548,4 +1028,113 @@ static int init_hook_ = []() {
     return 0;
 }();
 
+// The calibrated kernel of the dimension bucket of d, as long as the hook still points to
+// one of the calibrated kernels, otherwise the hook itself.
+template <typename Func>
+static Func
+calibrated_for_dim(Func hook, const std::array<Func, kCalibrationBuckets>& by_bucket, size_t d) {
+    if (std::find(by_bucket.begin(), by_bucket.end(), hook) == by_bucket.end()) {
+        return hook;
+    }
+    return by_bucket[calibration_bucket(d)];
+}
+
+// A specialized kernel is only returned while the hook still points to the kernel
+// it was derived from, so that the bf16 patch keeps taking effect.
+decltype(fvec_L2sqr)
+fvec_L2sqr_for_dim(size_t d) {
+    const auto base = calibrated_for_dim(fvec_L2sqr, calibrated_L2sqr, d);
+#if defined(__x86_64__)
+    if (base == fvec_L2sqr_avx512) {
+        if (auto func = fvec_L2sqr_fixed_dim_avx512(d)) {
+            return func;
+        }
+    } else if (base == fvec_L2sqr_avx) {
+        if (auto func = fvec_L2sqr_fixed_dim_avx(d)) {
+            return func;
+        }
+    }
+#endif
+#if defined(__ARM_NEON)
+    if (base == fvec_L2sqr_neon) {
+        if (auto func = fvec_L2sqr_fixed_dim_neon(d)) {
+            return func;
+        }
+    }
+#endif
+    return base;
+}
+
+decltype(fvec_inner_product)
+fvec_inner_product_for_dim(size_t d) {
+    const auto base = calibrated_for_dim(fvec_inner_product, calibrated_inner_product, d);
+#if defined(__x86_64__)
+    if (base == fvec_inner_product_avx512) {
+        if (auto func = fvec_inner_product_fixed_dim_avx512(d)) {
+            return func;
+        }
+    } else if (base == fvec_inner_product_avx) {
+        if (auto func = fvec_inner_product_fixed_dim_avx(d)) {
+            return func;
+        }
+    }
+#endif
+#if defined(__ARM_NEON)
+    if (base == fvec_inner_product_neon) {
+        if (auto func = fvec_inner_product_fixed_dim_neon(d)) {
+            return func;
+        }
+    }
+#endif
+    return base;
+}
+
+decltype(fvec_L2sqr_batch_4)
+fvec_L2sqr_batch_4_for_dim(size_t d) {
+    const auto base = calibrated_for_dim(fvec_L2sqr_batch_4, calibrated_L2sqr_batch_4, d);
+#if defined(__x86_64__)
+    if (base == fvec_L2sqr_batch_4_avx512) {
+        if (auto func = fvec_L2sqr_batch_4_fixed_dim_avx512(d)) {
+            return func;
+        }
+    } else if (base == fvec_L2sqr_batch_4_avx) {
+        if (auto func = fvec_L2sqr_batch_4_fixed_dim_avx(d)) {
+            return func;
+        }
+    }
+#endif
+#if defined(__ARM_NEON)
+    if (base == fvec_L2sqr_batch_4_neon) {
+        if (auto func = fvec_L2sqr_batch_4_fixed_dim_neon(d)) {
+            return func;
+        }
+    }
+#endif
+    return base;
+}
+
+decltype(fvec_inner_product_batch_4)
+fvec_inner_product_batch_4_for_dim(size_t d) {
+    const auto base = calibrated_for_dim(fvec_inner_product_batch_4, calibrated_inner_product_batch_4, d);
+#if defined(__x86_64__)
+    if (base == fvec_inner_product_batch_4_avx512) {
+        if (auto func = fvec_inner_product_batch_4_fixed_dim_avx512(d)) {
+            return func;
+        }
+    } else if (base == fvec_inner_product_batch_4_avx) {
+        if (auto func = fvec_inner_product_batch_4_fixed_dim_avx(d)) {
+            return func;
+        }
+    }
+#endif
+#if defined(__ARM_NEON)
+    if (base == fvec_inner_product_batch_4_neon) {
+        if (auto func = fvec_inner_product_batch_4_fixed_dim_neon(d)) {
+            return func;
+        }
+    }
+#endif
+    return base;
+}
+
 }  // namespace faiss
@@ -13,6 +13,7 @@
 #define HOOK_H
 
 #include <string>
+#include <vector>
 
 #include "knowhere/operands.h"
 
@@ -96,6 +97,8 @@ extern void (*fp16_vec_inner_product_batch_4)(const knowhere::fp16*, const knowh
 extern void (*fp16_vec_L2sqr_batch_4)(const knowhere::fp16*, const knowhere::fp16*, const knowhere::fp16*,
                                       const knowhere::fp16*, const knowhere::fp16*, const size_t, float&, float&,
                                       float&, float&);
+extern void (*fp16_vec_inner_products_ny)(float*, const knowhere::fp16*, const knowhere::fp16*, size_t, size_t);
+extern void (*fp16_vec_L2sqr_ny)(float*, const knowhere::fp16*, const knowhere::fp16*, size_t, size_t);
 
 // bf16
 extern float (*bf16_vec_inner_product)(const knowhere::bf16*, const knowhere::bf16*, size_t);
@@ -108,6 +111,8 @@ extern void (*bf16_vec_inner_product_batch_4)(const knowhere::bf16*, const knowh
 extern void (*bf16_vec_L2sqr_batch_4)(const knowhere::bf16*, const knowhere::bf16*, const knowhere::bf16*,
                                       const knowhere::bf16*, const knowhere::bf16*, const size_t, float&, float&,
                                       float&, float&);
+extern void (*bf16_vec_inner_products_ny)(float*, const knowhere::bf16*, const knowhere::bf16*, size_t, size_t);
+extern void (*bf16_vec_L2sqr_ny)(float*, const knowhere::bf16*, const knowhere::bf16*, size_t, size_t);
 // int8
 extern float (*int8_vec_inner_product)(const int8_t*, const int8_t*, size_t);
 extern float (*int8_vec_L2sqr)(const int8_t*, const int8_t*, size_t);
@@ -117,6 +122,40 @@ extern void (*int8_vec_inner_product_batch_4)(const int8_t*, const int8_t*, cons
                                               const size_t, float&, float&, float&, float&);
 extern void (*int8_vec_L2sqr_batch_4)(const int8_t*, const int8_t*, const int8_t*, const int8_t*, const int8_t*,
                                       const size_t, float&, float&, float&, float&);
+extern void (*int8_vec_inner_products_ny)(float*, const int8_t*, const int8_t*, size_t, size_t);
+extern void (*int8_vec_L2sqr_ny)(float*, const int8_t*, const int8_t*, size_t, size_t);
+
+// fp32 query against fp16, bf16 and int8 vectors, the vectors are converted on the fly
+extern float (*fvec_fp16_inner_product)(const float*, const knowhere::fp16*, size_t);
+extern float (*fvec_fp16_L2sqr)(const float*, const knowhere::fp16*, size_t);
+extern void (*fvec_fp16_inner_product_batch_4)(const float*, const knowhere::fp16*, const knowhere::fp16*,
+                                               const knowhere::fp16*, const knowhere::fp16*, const size_t, float&,
+                                               float&, float&, float&);
+extern void (*fvec_fp16_L2sqr_batch_4)(const float*, const knowhere::fp16*, const knowhere::fp16*,
+                                       const knowhere::fp16*, const knowhere::fp16*, const size_t, float&, float&,
+                                       float&, float&);
+extern void (*fvec_fp16_inner_products_ny)(float*, const float*, const knowhere::fp16*, size_t, size_t);
+extern void (*fvec_fp16_L2sqr_ny)(float*, const float*, const knowhere::fp16*, size_t, size_t);
+
+extern float (*fvec_bf16_inner_product)(const float*, const knowhere::bf16*, size_t);
+extern float (*fvec_bf16_L2sqr)(const float*, const knowhere::bf16*, size_t);
+extern void (*fvec_bf16_inner_product_batch_4)(const float*, const knowhere::bf16*, const knowhere::bf16*,
+                                               const knowhere::bf16*, const knowhere::bf16*, const size_t, float&,
+                                               float&, float&, float&);
+extern void (*fvec_bf16_L2sqr_batch_4)(const float*, const knowhere::bf16*, const knowhere::bf16*,
+                                       const knowhere::bf16*, const knowhere::bf16*, const size_t, float&, float&,
+                                       float&, float&);
+extern void (*fvec_bf16_inner_products_ny)(float*, const float*, const knowhere::bf16*, size_t, size_t);
+extern void (*fvec_bf16_L2sqr_ny)(float*, const float*, const knowhere::bf16*, size_t, size_t);
+
+extern float (*fvec_int8_inner_product)(const float*, const int8_t*, size_t);
+extern float (*fvec_int8_L2sqr)(const float*, const int8_t*, size_t);
+extern void (*fvec_int8_inner_product_batch_4)(const float*, const int8_t*, const int8_t*, const int8_t*, const int8_t*,
+                                               const size_t, float&, float&, float&, float&);
+extern void (*fvec_int8_L2sqr_batch_4)(const float*, const int8_t*, const int8_t*, const int8_t*, const int8_t*,
+                                       const size_t, float&, float&, float&, float&);
+extern void (*fvec_int8_inner_products_ny)(float*, const float*, const int8_t*, size_t, size_t);
+extern void (*fvec_int8_L2sqr_ny)(float*, const float*, const int8_t*, size_t, size_t);
 
 // rabitq
 extern float (*fvec_masked_sum)(const float*, const uint8_t*, const size_t);
@@ -148,6 +187,34 @@ disable_patch_for_fp32_bf16();
 void
 fvec_hook(std::string&);
 
+/// optional calibration on top of fvec_hook: times the simd implementations available
+/// on this host for each distance kernel over short, medium and long vectors and installs
+/// the fastest one. The fp32 kernels with a _for_dim lookup also keep the fastest one of
+/// each bucket. Returns one line per calibrated kernel with the choice and timings.
+std::vector<std::string>
+fvec_hook_calibrate();
+
+/// the table of the last fvec_hook_calibrate, empty if fvec_hook has run since.
+std::vector<std::string>
+fvec_hook_calibration_table();
+
+/// the fp32 kernels to use for vectors of dimension d with the current simd type.
+/// After fvec_hook_calibrate these follow the calibrated choice of the bucket of d.
+/// For the common embedding dimensions these are fully unrolled variants without
+/// tail handling, otherwise the regular hooks. Meant to be picked once, when an
+/// index or a distance computer is created.
+decltype(fvec_L2sqr)
+fvec_L2sqr_for_dim(size_t d);
+
+decltype(fvec_inner_product)
+fvec_inner_product_for_dim(size_t d);
+
+decltype(fvec_L2sqr_batch_4)
+fvec_L2sqr_batch_4_for_dim(size_t d);
+
+decltype(fvec_inner_product_batch_4)
+fvec_inner_product_batch_4_for_dim(size_t d);
+
 }  // namespace faiss
 
 #endif /* HOOK_H */
@@ -15,6 +15,7 @@
 #include "faiss/utils/Heap.h"
 #include "knowhere/comp/brute_force.h"
 #include "knowhere/comp/index_param.h"
+#include "knowhere/comp/knowhere_config.h"
 #include "knowhere/utils.h"
 #include "simd/hook.h"
 #include "utils.h"
@@ -274,3 +275,31 @@ TEST_CASE("Test Brute Force with input ids", "[float vector]") {
     check_search_with_out_ids<knowhere::bf16>(nb, nq, dim, k, metric, conf);
     check_search_with_out_ids<knowhere::int8>(nb, nq, dim, k, metric, conf);
 }
+
+TEST_CASE("Test Brute Force with split queries", "[float vector]") {
+    const int64_t nb = 100000;
+    const int64_t nq = 1;
+    const int64_t dim = 16;
+    const int64_t k = 10;
+    auto metric = GENERATE(as<std::string>{}, knowhere::metric::L2, knowhere::metric::IP, knowhere::metric::COSINE);
+    const knowhere::Json conf = {
+        {knowhere::meta::DIM, dim},
+        {knowhere::meta::METRIC_TYPE, metric},
+        {knowhere::meta::TOPK, k},
+    };
+    const auto train_ds = GenDataSet(nb, dim);
+    const auto query_ds = GenDataSet(nq, dim, 7);
+    auto filter_bits = GenerateBitsetWithRandomTbitsSet(nb, nb / 2);
+    knowhere::BitsetView bitset(filter_bits.data(), nb);
+
+    auto whole = knowhere::BruteForce::Search<knowhere::fp32>(train_ds, query_ds, conf, bitset);
+    knowhere::KnowhereConfig::SetIntraQueryParallelism(true);
+    auto split = knowhere::BruteForce::Search<knowhere::fp32>(train_ds, query_ds, conf, bitset);
+    knowhere::KnowhereConfig::SetIntraQueryParallelism(false);
+    REQUIRE(whole.has_value());
+    REQUIRE(split.has_value());
+    for (int64_t i = 0; i < nq * k; i++) {
+        REQUIRE(split.value()->GetIds()[i] == whole.value()->GetIds()[i]);
+        REQUIRE(split.value()->GetDistance()[i] == Catch::Approx(whole.value()->GetDistance()[i]));
+    }
+}
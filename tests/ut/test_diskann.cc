@@ -16,8 +16,10 @@
 #include "catch2/generators/catch_generators.hpp"
 #include "index/diskann/diskann_config.h"
 #include "knowhere/comp/brute_force.h"
+#include "knowhere/comp/knowhere_config.h"
 #include "knowhere/comp/knowhere_check.h"
 #include "knowhere/comp/local_file_manager.h"
+#include "knowhere/comp/thread_pool.h"
 #include "knowhere/expected.h"
 #include "knowhere/index/index_factory.h"
 #include "knowhere/utils.h"
@@ -315,6 +317,33 @@ base_search() {
             auto knn_recall = GetKNNRecall(*knn_gt_ptr, *res.value());
             REQUIRE(knn_recall > kKnnRecall);
 
+            // knn search with pipelined I/O
+            {
+                knowhere::Json pipelined_json = knowhere::Json::parse(knn_search_json);
+                pipelined_json["use_pipelined_search"] = true;
+                auto pipelined_res = diskann.Search(query_ds, pipelined_json, nullptr);
+                REQUIRE(pipelined_res.has_value());
+                REQUIRE(GetKNNRecall(*knn_gt_ptr, *pipelined_res.value()) > kKnnRecall);
+            }
+
+            // knn search scoring all nodes of the fetched sectors
+            {
+                knowhere::Json sector_json = knowhere::Json::parse(knn_search_json);
+                sector_json["score_full_sector"] = true;
+                auto sector_res = diskann.Search(query_ds, sector_json, nullptr);
+                REQUIRE(sector_res.has_value());
+                REQUIRE(GetKNNRecall(*knn_gt_ptr, *sector_res.value()) > kKnnRecall);
+            }
+
+            // knn search sharing sector reads across the queries of the batch
+            {
+                knowhere::Json coalesce_json = knowhere::Json::parse(knn_search_json);
+                coalesce_json["coalesce_io"] = true;
+                auto coalesce_res = diskann.Search(query_ds, coalesce_json, nullptr);
+                REQUIRE(coalesce_res.has_value());
+                REQUIRE(GetKNNRecall(*knn_gt_ptr, *coalesce_res.value()) > kKnnRecall);
+            }
+
             // knn search without cache file
             {
                 std::string cached_nodes_file_path =
@@ -332,6 +361,93 @@ base_search() {
                 REQUIRE(GetKNNRecall(*knn_gt_ptr, *res.value()) >= kKnnRecall);
             }
 
+#ifdef KNOWHERE_WITH_LIBURING
+            // knn search through the io_uring reader, two indexes share the rings of the search threads. Skipped
+            // where the kernel or a seccomp profile does not allow io_uring.
+            if (knowhere::KnowhereConfig::SetDiskIOEngine(knowhere::KnowhereConfig::DiskIOEngine::IO_URING)) {
+                auto uring_a =
+                    knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+                auto uring_b =
+                    knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+                REQUIRE(uring_a.Deserialize(binset, deserialize_json) == knowhere::Status::success);
+                REQUIRE(uring_b.Deserialize(binset, deserialize_json) == knowhere::Status::success);
+                for (auto pipelined : {false, true}) {
+                    knowhere::Json uring_json = knowhere::Json::parse(knn_search_json);
+                    uring_json["use_pipelined_search"] = pipelined;
+                    for (auto* index : {&uring_a, &uring_b}) {
+                        auto uring_res = index->Search(query_ds, uring_json, nullptr);
+                        REQUIRE(uring_res.has_value());
+                        REQUIRE(GetKNNRecall(*knn_gt_ptr, *uring_res.value()) > kKnnRecall);
+                    }
+                }
+                REQUIRE(knowhere::KnowhereConfig::SetDiskIOEngine(knowhere::KnowhereConfig::DiskIOEngine::LIBAIO));
+            }
+#endif
+
+            // knn search with dynamic sector cache, the second round is mostly served from the cache
+            {
+                knowhere::Json dyn_cache_json = knowhere::Json::parse(deserialize_gen().dump());
+                dyn_cache_json["search_dynamic_cache_budget_gb"] = 0.01;
+                auto diskann_tmp =
+                    knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+                REQUIRE(diskann_tmp.Deserialize(binset, dyn_cache_json) == knowhere::Status::success);
+                bool first_round = true;
+                for (auto pipelined : {false, true, false}) {
+                    knowhere::Json knn_json = knowhere::Json::parse(knn_search_json);
+                    knn_json["use_pipelined_search"] = pipelined;
+                    knn_json["trace_io"] = true;
+                    auto res = diskann_tmp.Search(query_ds, knn_json, nullptr);
+                    REQUIRE(res.has_value());
+                    REQUIRE(GetKNNRecall(*knn_gt_ptr, *res.value()) > kKnnRecall);
+                    auto io_stats = knowhere::Json::parse(res.value()->GetJsonIoStats());
+                    uint64_t sector_cache_hits = 0;
+                    for (uint32_t i = 0; i < kNumQueries; ++i) {
+                        sector_cache_hits += io_stats["sector_cache_hit_cnt"][i].get<unsigned>();
+                    }
+                    if (!first_round) {
+                        REQUIRE(sector_cache_hits > 0);
+                    }
+                    first_round = false;
+                }
+            }
+
+            // knn search scoring the candidates with 4-bit fast-scan PQ codes, the coarser codes need a larger list
+            {
+                knowhere::Json fast_scan_json = knowhere::Json::parse(deserialize_gen().dump());
+                fast_scan_json["use_pq_fast_scan"] = true;
+                auto diskann_tmp =
+                    knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+                REQUIRE(diskann_tmp.Deserialize(binset, fast_scan_json) == knowhere::Status::success);
+                for (auto pipelined : {false, true}) {
+                    knowhere::Json knn_json = knowhere::Json::parse(knn_search_json);
+                    knn_json["search_list_size"] = 64;
+                    knn_json["use_pipelined_search"] = pipelined;
+                    auto res = diskann_tmp.Search(query_ds, knn_json, nullptr);
+                    REQUIRE(res.has_value());
+                    REQUIRE(GetKNNRecall(*knn_gt_ptr, *res.value()) > kKnnRecall);
+                }
+            }
+
+            // knn search under a moderately selective filter, deferring the reads of filtered nodes
+            {
+                auto bitset_data = GenerateBitsetWithRandomTbitsSet(kNumRows, 0.7f * kNumRows);
+                knowhere::BitsetView bitset(bitset_data.data(), kNumRows);
+                auto gt = knowhere::BruteForce::Search<DataType>(base_ds, query_ds, knn_json, bitset);
+                for (auto pipelined : {false, true}) {
+                    knowhere::Json filter_json = knowhere::Json::parse(knn_search_json);
+                    filter_json["use_pipelined_search"] = pipelined;
+                    filter_json["trace_io"] = true;
+                    auto res = diskann.Search(query_ds, filter_json, bitset);
+                    REQUIRE(res.has_value());
+                    REQUIRE(GetKNNRecall(*gt.value(), *res.value()) >= kKnnRecall);
+                    auto io_stats = knowhere::Json::parse(res.value()->GetJsonIoStats());
+                    REQUIRE(io_stats["io_cnt"].size() == kNumQueries);
+                    for (uint32_t i = 0; i < kNumQueries; ++i) {
+                        REQUIRE(io_stats["filtered_io_cnt"][i] <= io_stats["io_cnt"][i]);
+                    }
+                }
+            }
+
             // knn search with bitset
             std::vector<std::function<std::vector<uint8_t>(size_t, size_t)>> gen_bitset_funcs = {
                 GenerateBitsetWithFirstTbitsSet, GenerateBitsetWithRandomTbitsSet};
@@ -355,6 +471,19 @@ base_search() {
                 }
             }
 
+            // knn search deferring the reads of filtered candidates, which is opt-in
+            {
+                knowhere::Json filter_aware_json = knn_json;
+                filter_aware_json["filter_threshold"] = -1.0f;
+                filter_aware_json["filter_aware_threshold"] = 0.3f;
+                auto bitset_data = GenerateBitsetWithRandomTbitsSet(kNumRows, 0.4f * kNumRows);
+                knowhere::BitsetView bitset(bitset_data.data(), kNumRows);
+                auto results = diskann.Search(query_ds, filter_aware_json, bitset);
+                REQUIRE(results.has_value());
+                auto gt = knowhere::BruteForce::Search<DataType>(base_ds, query_ds, filter_aware_json, bitset);
+                REQUIRE(GetKNNRecall(*gt.value(), *results.value()) >= kKnnRecall);
+            }
+
             // range search process
             auto range_search_json = range_search_gen().dump();
             knowhere::Json range_json = knowhere::Json::parse(range_search_json);
@@ -363,6 +492,85 @@ base_search() {
             auto ap = GetRangeSearchRecall(*range_search_gt_ptr, *range_search_res.value());
             float standard_ap = metric_range_ap_map[metric_str];
             REQUIRE(ap > standard_ap);
+
+            // range_search_k keeps only the closest results of every query
+            range_json["range_search_k"] = 10;
+            range_search_res = diskann.RangeSearch(query_ds, range_json, nullptr);
+            REQUIRE(range_search_res.has_value());
+            auto radius = range_json["radius"].get<float>();
+            auto range_filter = range_json["range_filter"].get<float>();
+            REQUIRE(CheckDistanceInScope(*range_search_res.value(), std::min(radius, range_filter),
+                                         std::max(radius, range_filter) + 0.00001f));
+            // compare with the 10 closest results of the brute force range search
+            const bool less_is_closer = knowhere::IsMetricType(metric_str, knowhere::metric::L2);
+            auto lims = range_search_res.value()->GetLims();
+            auto ids = range_search_res.value()->GetIds();
+            auto gt_lims = range_search_gt_ptr->GetLims();
+            auto gt_ids = range_search_gt_ptr->GetIds();
+            auto gt_dis = range_search_gt_ptr->GetDistance();
+            size_t n_hits = 0, n_expected = 0;
+            for (uint32_t i = 0; i < kNumQueries; ++i) {
+                REQUIRE(lims[i + 1] - lims[i] <= 10);
+                std::vector<std::pair<float, int64_t>> gt;
+                for (size_t j = gt_lims[i]; j < gt_lims[i + 1]; ++j) {
+                    gt.emplace_back(less_is_closer ? gt_dis[j] : -gt_dis[j], gt_ids[j]);
+                }
+                std::sort(gt.begin(), gt.end());
+                gt.resize(std::min<size_t>(gt.size(), 10));
+                n_expected += gt.size();
+                std::set<int64_t> res_ids(ids + lims[i], ids + lims[i + 1]);
+                for (const auto& [dis, id] : gt) {
+                    n_hits += res_ids.count(id);
+                }
+            }
+            REQUIRE(n_expected > 0);
+            REQUIRE(n_hits * 1.0f / n_expected > standard_ap);
+        }
+    }
+
+    SECTION("Test build from an in-memory dataset") {
+        std::shared_ptr<knowhere::FileManager> file_manager = std::make_shared<knowhere::LocalFileManager>();
+        auto diskann_index_pack = knowhere::Pack(file_manager);
+        knowhere::BinarySet binset;
+
+        knowhere::Json json = knowhere::Json::parse(build_gen().dump());
+        json.erase("data_path");
+        {
+            auto diskann =
+                knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+            REQUIRE(diskann.Build(base_ds, json) == knowhere::Status::success);
+            diskann.Serialize(binset);
+        }
+        auto diskann =
+            knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+        REQUIRE(diskann.Deserialize(binset, knowhere::Json::parse(deserialize_gen().dump())) ==
+                knowhere::Status::success);
+        auto res = diskann.Search(query_ds, knowhere::Json::parse(knn_search_gen().dump()), nullptr);
+        REQUIRE(res.has_value());
+        REQUIRE(GetKNNRecall(*knn_gt_ptr, *res.value()) > kKnnRecall);
+
+        auto range_search_res =
+            diskann.RangeSearch(query_ds, knowhere::Json::parse(range_search_gen().dump()), nullptr);
+        REQUIRE(range_search_res.has_value());
+        REQUIRE(GetRangeSearchRecall(*range_search_gt_ptr, *range_search_res.value()) >
+                metric_range_ap_map[metric_str]);
+
+        // an index bound to a numa node searches on the pool of the node while numa aware pools are enabled, and on
+        // the global pool once they are disabled
+        const bool numa_pools = knowhere::ThreadPool::SetNumaAwareSearchThreadPools(true);
+        knowhere::Json numa_json = knowhere::Json::parse(deserialize_gen().dump());
+        numa_json["numa_node"] = 0;
+        auto numa_diskann =
+            knowhere::IndexFactory::Instance().Create<DataType>("DISKANN", version, diskann_index_pack).value();
+        REQUIRE(numa_diskann.Deserialize(binset, numa_json) == knowhere::Status::success);
+        res = numa_diskann.Search(query_ds, knowhere::Json::parse(knn_search_gen().dump()), nullptr);
+        REQUIRE(res.has_value());
+        REQUIRE(GetKNNRecall(*knn_gt_ptr, *res.value()) > kKnnRecall);
+        if (numa_pools) {
+            REQUIRE(knowhere::ThreadPool::SetNumaAwareSearchThreadPools(false));
+            res = numa_diskann.Search(query_ds, knowhere::Json::parse(knn_search_gen().dump()), nullptr);
+            REQUIRE(res.has_value());
+            REQUIRE(GetKNNRecall(*knn_gt_ptr, *res.value()) > kKnnRecall);
         }
     }
     fs::remove_all(kDir);
@@ -458,3 +666,78 @@ TEST_CASE("Test DiskANN GetVectorByIds", "[diskann]") {
     fs::remove_all(kDir);
     fs::remove(kDir);
 }
+
+// Nodes are packed into sectors by graph locality, so every sector offset goes through the saved layout map.
+TEST_CASE("Test DiskANN locality layout", "[diskann]") {
+    auto version = GenTestVersionList();
+    fs::remove_all(kDir);
+    fs::remove(kDir);
+    REQUIRE_NOTHROW(fs::create_directories(kL2IndexDir));
+
+    auto base_gen = [] {
+        knowhere::Json json;
+        json[knowhere::meta::RETRIEVE_FRIENDLY] = true;
+        json["dim"] = kDim;
+        json["metric_type"] = knowhere::metric::L2;
+        json["k"] = kK;
+        json["index_prefix"] = kL2IndexPrefix;
+        return json;
+    };
+
+    auto query_ds = GenDataSet(kNumQueries, kDim, 42);
+    auto base_ds = GenDataSet(kNumRows, kDim, 30);
+    WriteRawDataToDisk<float>(kRawDataPath, static_cast<const float*>(base_ds->GetTensor()), kNumRows, kDim);
+    auto gt = knowhere::BruteForce::Search<knowhere::fp32>(base_ds, query_ds, base_gen(), nullptr);
+    REQUIRE(gt.has_value());
+
+    std::shared_ptr<knowhere::FileManager> file_manager = std::make_shared<knowhere::LocalFileManager>();
+    auto diskann_index_pack = knowhere::Pack(file_manager);
+    knowhere::BinarySet binset;
+    {
+        knowhere::Json build_json = base_gen();
+        build_json["data_path"] = kRawDataPath;
+        build_json["max_degree"] = 56;
+        build_json["search_list_size"] = 128;
+        build_json["pq_code_budget_gb"] = sizeof(float) * kDim * kNumRows * 0.125 / (1024 * 1024 * 1024);
+        build_json["build_dram_budget_gb"] = 32.0;
+        build_json["use_locality_layout"] = true;
+        auto diskann =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>("DISKANN", version, diskann_index_pack).value();
+        REQUIRE(diskann.Build(nullptr, build_json) == knowhere::Status::success);
+        REQUIRE(diskann.Serialize(binset) == knowhere::Status::success);
+    }
+    REQUIRE(fs::exists(std::string(kL2IndexPrefix) + "_disk.index_layout.bin"));
+
+    std::vector<double> cache_sizes = {0, 1.0f * sizeof(float) * kDim * kNumRows * 0.125 / (1024 * 1024 * 1024)};
+    for (const auto cache_size : cache_sizes) {
+        knowhere::Json deserialize_json = base_gen();
+        deserialize_json["search_cache_budget_gb"] = cache_size;
+        auto index =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>("DISKANN", version, diskann_index_pack).value();
+        REQUIRE(index.Deserialize(binset, deserialize_json) == knowhere::Status::success);
+
+        auto ids_ds = GenIdsDataSet(kNumRows, kNumRows);
+        auto results = index.GetVectorByIds(ids_ds);
+        REQUIRE(results.has_value());
+        auto xb = (const float*)base_ds->GetTensor();
+        auto data = (const float*)results.value()->GetTensor();
+        for (size_t i = 0; i < kNumRows; ++i) {
+            auto id = ids_ds->GetIds()[i];
+            for (size_t j = 0; j < kDim; ++j) {
+                REQUIRE(data[i * kDim + j] == xb[id * kDim + j]);
+            }
+        }
+
+        knowhere::Json search_json = base_gen();
+        search_json["search_list_size"] = 36;
+        search_json["beamwidth"] = 8;
+        for (const bool score_full_sector : {false, true}) {
+            search_json["score_full_sector"] = score_full_sector;
+            auto res = index.Search(query_ds, search_json, nullptr);
+            REQUIRE(res.has_value());
+            REQUIRE(GetKNNRecall(*gt.value(), *res.value()) > kKnnRecall);
+        }
+    }
+    fs::remove_all(kDir);
+    fs::remove(kDir);
+}
@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -30,6 +31,7 @@
 #include "knowhere/comp/brute_force.h"
 #include "knowhere/comp/index_param.h"
 #include "knowhere/comp/knowhere_config.h"
+#include "knowhere/comp/thread_pool.h"
 #include "knowhere/dataset.h"
 #include "knowhere/index/index_factory.h"
 #include "utils.h"
@@ -2283,3 +2285,105 @@ TEST_CASE("hnswlib to FAISS HNSW for HNSW_FLAT", "Check search fallback") {
         REQUIRE(recall == 1);
     }
 }
+
+TEST_CASE("Load MV FAISS HNSW partitions in parallel", "Check deserialization of partitioned indices") {
+    const int32_t nb = 1000;
+    const int32_t nq = 16;
+    const int32_t dim = 16;
+    const char* index_file_name = "/tmp/knowhere_faiss_hnsw_mv_index_test";
+
+    knowhere::Json conf;
+    conf[knowhere::meta::METRIC_TYPE] = knowhere::metric::L2;
+    conf[knowhere::meta::DIM] = dim;
+    conf[knowhere::meta::TOPK] = 10;
+    conf[knowhere::indexparam::HNSW_M] = 16;
+    conf[knowhere::indexparam::EFCONSTRUCTION] = 96;
+    conf[knowhere::indexparam::EF] = 64;
+
+    // the partition offsets are written from their index version on, older versions keep the version 0 header
+    auto [version, header_version] = GENERATE(table<int32_t, uint32_t>({
+        {knowhere::Version::GetCurrentVersion().VersionNumber(), 0},
+        {knowhere::Version::GetMvIndexOffsetsVersion().VersionNumber(), 1},
+    }));
+    CAPTURE(version);
+    auto base_ds = GenDataSet(nb, dim, 42);
+    auto query_ds = GenDataSet(nq, dim, 43);
+    auto scalar_info = GenerateScalarInfo(nb);
+    base_ds->Set(knowhere::meta::SCALAR_INFO, scalar_info);
+
+    auto index =
+        knowhere::IndexFactory::Instance().Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_HNSW, version).value();
+    REQUIRE(index.Build(base_ds, conf) == knowhere::Status::success);
+    knowhere::BinarySet binset;
+    REQUIRE(index.Serialize(binset) == knowhere::Status::success);
+    REQUIRE(index.SerializeToFile(index_file_name) == knowhere::Status::success);
+
+    // the header version follows the IHMV fourcc
+    auto binary = binset.GetByName(index.Type());
+    REQUIRE(binary->size > 2 * (int64_t)sizeof(uint32_t));
+    uint32_t written_header_version = 0;
+    std::memcpy(&written_header_version, binary->data.get() + sizeof(uint32_t), sizeof(uint32_t));
+    REQUIRE(written_header_version == header_version);
+
+    // the partitions are searched one at a time, the loaded index must return the very same results
+    auto check_same_results = [&](const knowhere::Index<knowhere::IndexNode>& loaded) {
+        for (const auto& partition : scalar_info[0]) {
+            auto bitset_data = GenerateBitsetByScalarInfoAndFirstTBits(partition, nb, 0);
+            knowhere::BitsetView bitset(bitset_data.data(), nb, partition.size());
+            auto expected = index.Search(query_ds, conf, bitset);
+            auto result = loaded.Search(query_ds, conf, bitset);
+            REQUIRE(expected.has_value());
+            REQUIRE(result.has_value());
+            auto expected_ids = expected.value()->GetIds();
+            auto result_ids = result.value()->GetIds();
+            REQUIRE(std::equal(expected_ids, expected_ids + nq * 10, result_ids));
+        }
+    };
+
+    SECTION("Deserialize") {
+        auto enable_zero_copy = GENERATE(as<bool>{}, true, false);
+        knowhere::Json load_conf = conf;
+        load_conf["enable_zero_copy"] = enable_zero_copy;
+        auto loaded =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_HNSW, version).value();
+        REQUIRE(loaded.Deserialize(binset, load_conf) == knowhere::Status::success);
+        check_same_results(loaded);
+    }
+
+    SECTION("DeserializeFromFile") {
+        auto enable_mmap = GENERATE(as<bool>{}, true, false);
+        knowhere::Json load_conf = conf;
+        load_conf["enable_mmap"] = enable_mmap;
+        auto loaded =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_HNSW, version).value();
+        REQUIRE(loaded.DeserializeFromFile(index_file_name, load_conf) == knowhere::Status::success);
+        check_same_results(loaded);
+    }
+
+    SECTION("Deserialize on a numa node") {
+        auto from_file = GENERATE(as<bool>{}, true, false);
+        // routes the searches to the pool of the node on multi node machines, node 0 exists everywhere
+        const bool numa_pools = knowhere::ThreadPool::SetNumaAwareSearchThreadPools(true);
+        knowhere::Json load_conf = conf;
+        load_conf["numa_node"] = 0;
+        auto loaded =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_HNSW, version).value();
+        if (from_file) {
+            REQUIRE(loaded.DeserializeFromFile(index_file_name, load_conf) == knowhere::Status::success);
+        } else {
+            REQUIRE(loaded.Deserialize(binset, load_conf) == knowhere::Status::success);
+        }
+        check_same_results(loaded);
+        if (numa_pools) {
+            REQUIRE(knowhere::ThreadPool::SetNumaAwareSearchThreadPools(false));
+        }
+        // a node that does not exist leaves the index unbound
+        load_conf["numa_node"] = 1 << 16;
+        auto unbound =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_HNSW, version).value();
+        REQUIRE(unbound.Deserialize(binset, load_conf) == knowhere::Status::success);
+        check_same_results(unbound);
+    }
+
+    std::remove(index_file_name);
+}
@@ -50,6 +50,7 @@ TEST_CASE("Knowhere global config", "[init]") {
 #ifdef KNOWHERE_WITH_DISKANN
     REQUIRE_FALSE(knowhere::KnowhereConfig::SetAioContextPool(0));
     REQUIRE(knowhere::KnowhereConfig::SetAioContextPool(16));
+    REQUIRE(knowhere::KnowhereConfig::SetDiskIOEngine(knowhere::KnowhereConfig::DiskIOEngine::LIBAIO));
 #endif
 
 #ifdef KNOWHERE_WITH_CUVS
@@ -72,3 +73,18 @@ TEST_CASE("Knowhere SIMD config", "[simd]") {
     res = knowhere::KnowhereConfig::SetSimdType(knowhere::KnowhereConfig::SimdType::AUTO);
     REQUIRE(s.find(res) != s.end());
 }
+
+TEST_CASE("Knowhere SIMD calibration", "[simd]") {
+    knowhere::KnowhereConfig::SetSimdType(knowhere::KnowhereConfig::SimdType::AUTO);
+    auto table = knowhere::KnowhereConfig::CalibrateSimdKernels();
+    REQUIRE(knowhere::KnowhereConfig::GetSimdCalibrationTable() == table);
+    for (const auto& line : table) {
+        REQUIRE((line.find(": AVX512 ") != std::string::npos || line.find(": AVX2 ") != std::string::npos));
+    }
+
+    // nothing to choose from once AVX512 is ruled out
+    knowhere::KnowhereConfig::SetSimdType(knowhere::KnowhereConfig::SimdType::AVX2);
+    REQUIRE(knowhere::KnowhereConfig::GetSimdCalibrationTable().empty());
+    REQUIRE(knowhere::KnowhereConfig::CalibrateSimdKernels().empty());
+    knowhere::KnowhereConfig::SetSimdType(knowhere::KnowhereConfig::SimdType::AUTO);
+}
@@ -9,18 +9,29 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
+#include <chrono>
+#include <cstring>
+#include <thread>
+
 #include "catch2/catch_approx.hpp"
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/generators/catch_generators.hpp"
+#include "faiss/IndexCosine.h"
+#include "faiss/IndexScalarQuantizer.h"
+#include "faiss/impl/AuxIndexStructures.h"
+#include "faiss/index_io.h"
 #include "faiss/utils/binary_distances.h"
 #include "hnswlib/hnswalg.h"
+#include "io/memory_io.h"
 #include "knowhere/bitsetview.h"
 #include "knowhere/comp/brute_force.h"
+#include "knowhere/comp/cancel_token.h"
 #include "knowhere/comp/index_param.h"
 #include "knowhere/comp/knowhere_check.h"
 #include "knowhere/comp/knowhere_config.h"
 #include "knowhere/index/index_factory.h"
 #include "knowhere/log.h"
+#include "knowhere/utils.h"
 #include "simd/hook.h"
 #include "utils.h"
 
@@ -260,6 +271,165 @@ TEST_CASE("Test Mem Index With Float Vector", "[float metrics]") {
         }
     }
 
+    SECTION("Test Search after zero copy Deserialize") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
+            {make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, flat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, ivfsq_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen)}));
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        {
+            // the loaded index keeps the binary alive, not the binary set
+            knowhere::BinarySet bs;
+            auto built = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+            REQUIRE(built.Build(train_ds, json) == knowhere::Status::success);
+            REQUIRE(built.Serialize(bs) == knowhere::Status::success);
+            json["enable_zero_copy"] = true;
+            REQUIRE(idx.Deserialize(bs, json) == knowhere::Status::success);
+        }
+        REQUIRE(idx.Count() == nb);
+        // the index views into the binary, it cannot grow
+        REQUIRE(idx.Add(train_ds, json) == knowhere::Status::not_implemented);
+        REQUIRE(idx.Count() == nb);
+        auto results = idx.Search(query_ds, json, nullptr);
+        REQUIRE(results.has_value());
+        REQUIRE(GetKNNRecall(*gt.value(), *results.value()) > kKnnRecallThreshold);
+    }
+
+    SECTION("Test Search after SerializeToFile") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
+            {make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, flat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, ivfsq_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen)}));
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        {
+            auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+            REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+            REQUIRE(idx.SerializeToFile(kMmapIndexPath) == knowhere::Status::success);
+
+            // the file holds the same bytes as the binary of the binary set
+            knowhere::BinarySet bs;
+            REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+            auto binary = bs.GetByName(idx.Type());
+            std::ifstream in(kMmapIndexPath, std::ios::binary);
+            std::vector<char> file_data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            REQUIRE(file_data.size() == (size_t)binary->size);
+            REQUIRE(std::memcmp(file_data.data(), binary->data.get(), binary->size) == 0);
+        }
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        REQUIRE(idx.DeserializeFromFile(kMmapIndexPath, json) == knowhere::Status::success);
+        auto results = idx.Search(query_ds, json, nullptr);
+        REQUIRE(results.has_value());
+        REQUIRE(GetKNNRecall(*gt.value(), *results.value()) > kKnnRecallThreshold);
+        std::remove(kMmapIndexPath);
+    }
+
+    SECTION("Test Search after pre-faulted mmap and huge page loads") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
+            {make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, flat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen)}));
+        auto load_with_mmap = GENERATE(as<bool>{}, true, false);
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json, load_with_mmap);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        {
+            auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+            REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+            REQUIRE(idx.SerializeToFile(kMmapIndexPath) == knowhere::Status::success);
+        }
+        json["enable_mmap"] = load_with_mmap;
+        json["enable_mmap_pop"] = load_with_mmap;
+        json["enable_hugepage"] = !load_with_mmap;
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        REQUIRE(idx.DeserializeFromFile(kMmapIndexPath, json) == knowhere::Status::success);
+        auto residency = idx.GetMemoryResidency();
+        if (load_with_mmap) {
+            REQUIRE(residency.mapped_bytes > 0);
+            REQUIRE(residency.mapped_resident_bytes == residency.mapped_bytes);
+        } else {
+            REQUIRE(residency.mapped_bytes == 0);
+            REQUIRE(residency.anonymous_bytes > 0);
+        }
+        auto results = idx.Search(query_ds, json, nullptr);
+        REQUIRE(results.has_value());
+        REQUIRE(GetKNNRecall(*gt.value(), *results.value()) > kKnnRecallThreshold);
+        std::remove(kMmapIndexPath);
+    }
+
+    SECTION("Test Search with prepared config") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
+            {make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, flat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen)}));
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+
+        auto prepared = idx.PrepareSearch(json);
+        REQUIRE(prepared.has_value());
+        auto k = GENERATE(as<int32_t>{}, 1, 5);
+        json[knowhere::meta::TOPK] = k;
+        auto results = idx.Search(query_ds, json, nullptr);
+        auto prepared_results = idx.Search(query_ds, prepared.value().WithTopK(k), nullptr);
+        REQUIRE(results.has_value());
+        REQUIRE(prepared_results.has_value());
+        REQUIRE(prepared_results.value()->GetDim() == k);
+        auto ids = results.value()->GetIds();
+        auto prepared_ids = prepared_results.value()->GetIds();
+        for (int64_t i = 0; i < nq * k; ++i) {
+            REQUIRE(ids[i] == prepared_ids[i]);
+        }
+
+        // a config is prepared for one kind of search only
+        REQUIRE(idx.RangeSearch(query_ds, prepared.value(), nullptr).error() == knowhere::Status::invalid_args);
+        REQUIRE(idx.Search(query_ds, prepared.value().WithTopK(0), nullptr).error() ==
+                knowhere::Status::out_of_range_in_json);
+    }
+
+    SECTION("Test SearchInto caller-provided buffers") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
+            {make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, flat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFSQ8, ivfsq_gen),
+             make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen)}));
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+
+        auto results = idx.Search(query_ds, json, nullptr);
+        REQUIRE(results.has_value());
+        // the results of two segments written side by side into one arena
+        const int64_t k = json[knowhere::meta::TOPK];
+        std::vector<int64_t> ids(2 * nq * k);
+        std::vector<float> distances(2 * nq * k);
+        auto prepared = idx.PrepareSearch(json);
+        REQUIRE(prepared.has_value());
+        REQUIRE(idx.SearchInto(query_ds, json, nullptr, ids.data(), distances.data()) == knowhere::Status::success);
+        REQUIRE(idx.SearchInto(query_ds, prepared.value(), nullptr, ids.data() + nq * k,
+                               distances.data() + nq * k) == knowhere::Status::success);
+        for (int64_t i = 0; i < nq * k; ++i) {
+            REQUIRE(ids[i] == results.value()->GetIds()[i]);
+            REQUIRE(ids[nq * k + i] == results.value()->GetIds()[i]);
+            REQUIRE(distances[i] == results.value()->GetDistance()[i]);
+        }
+    }
+
     SECTION("Test Range Search") {
         using std::make_tuple;
         auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>(
@@ -555,6 +725,247 @@ TEST_CASE("Test Mem Index With Float Vector", "[float metrics]") {
     }
 }
 
+template <typename T>
+void
+check_flat_typed(const knowhere::DataSetPtr train_ds, const knowhere::DataSetPtr query_ds, const knowhere::Json& json) {
+    using Catch::Approx;
+
+    const auto nb = train_ds->GetRows();
+    const auto nq = query_ds->GetRows();
+    const auto dim = train_ds->GetDim();
+    const auto k = json[knowhere::meta::TOPK].get<int64_t>();
+    auto base = knowhere::ConvertToDataTypeIfNeeded<T>(train_ds);
+    auto query = knowhere::ConvertToDataTypeIfNeeded<T>(query_ds);
+    auto typed_version = knowhere::Version::GetFlatTypedStorageVersion().VersionNumber();
+
+    auto idx =
+        knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, typed_version).value();
+    REQUIRE(idx.Build(base, json) == knowhere::Status::success);
+    // the vectors are stored in their own type, not as fp32
+    REQUIRE(idx.Size() == nb * dim * (int64_t)sizeof(T));
+
+    auto res = idx.Search(query, json, nullptr);
+    auto gt = knowhere::BruteForce::Search<T>(base, query, json, nullptr);
+    REQUIRE(res.has_value());
+    REQUIRE(gt.has_value());
+    for (int64_t i = 0; i < nq * k; i++) {
+        REQUIRE(res.value()->GetDistance()[i] == Approx(gt.value()->GetDistance()[i]).epsilon(0.0001));
+    }
+
+    // a radius between the last two neighbors of the first query
+    knowhere::Json range_json = json;
+    auto gt_dis = gt.value()->GetDistance();
+    range_json[knowhere::meta::RADIUS] = (gt_dis[k - 2] + gt_dis[k - 1]) / 2;
+    auto range_res = idx.RangeSearch(query, range_json, nullptr);
+    auto range_gt = knowhere::BruteForce::RangeSearch<T>(base, query, range_json, nullptr);
+    REQUIRE(range_res.has_value());
+    REQUIRE(range_gt.has_value());
+    REQUIRE(GetRangeSearchRecall(*range_gt.value(), *range_res.value()) == Approx(1.0f));
+
+    // decoding the stored vectors is exact
+    auto ids_ds = GenIdsDataSet(nb, nq);
+    auto vectors = idx.GetVectorByIds(ids_ds);
+    REQUIRE(vectors.has_value());
+    auto xb = (const T*)base->GetTensor();
+    auto data = (const T*)vectors.value()->GetTensor();
+    for (int64_t i = 0; i < nq; i++) {
+        auto id = ids_ds->GetIds()[i];
+        REQUIRE(std::memcmp(data + i * dim, xb + id * dim, dim * sizeof(T)) == 0);
+    }
+
+    // another index gives the same results as the built one
+    auto check_same = [&](knowhere::Index<knowhere::IndexNode>& other) {
+        REQUIRE(other.Size() == idx.Size());
+        auto other_res = other.Search(query, json, nullptr);
+        REQUIRE(other_res.has_value());
+        for (int64_t i = 0; i < nq * k; i++) {
+            REQUIRE(other_res.value()->GetIds()[i] == res.value()->GetIds()[i]);
+            REQUIRE(other_res.value()->GetDistance()[i] == res.value()->GetDistance()[i]);
+        }
+        auto other_range_res = other.RangeSearch(query, range_json, nullptr);
+        REQUIRE(other_range_res.has_value());
+        REQUIRE(GetRangeSearchRecall(*range_res.value(), *other_range_res.value()) == Approx(1.0f));
+    };
+
+    knowhere::BinarySet bs;
+    REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+    auto loaded =
+        knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, typed_version).value();
+    REQUIRE(loaded.Deserialize(bs, json) == knowhere::Status::success);
+    check_same(loaded);
+
+    // older versions keep building on fp32 copies of the vectors, which are encoded to the typed storage at load
+    auto old_version = knowhere::Version::GetCurrentVersion().VersionNumber();
+    REQUIRE(!(knowhere::Version::GetFlatTypedStorageVersion() <= knowhere::Version(old_version)));
+    auto old_idx =
+        knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, old_version).value();
+    REQUIRE(old_idx.Build(base, json) == knowhere::Status::success);
+    REQUIRE(old_idx.Size() == nb * dim * (int64_t)sizeof(knowhere::fp32));
+    knowhere::BinarySet old_bs;
+    REQUIRE(old_idx.Serialize(old_bs) == knowhere::Status::success);
+    auto reencoded =
+        knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, typed_version).value();
+    REQUIRE(reencoded.Deserialize(old_bs, json) == knowhere::Status::success);
+    check_same(reencoded);
+
+    // so are int8 vectors stored with their codes shifted by 128
+    if constexpr (std::is_same_v<T, knowhere::int8>) {
+        const auto metric = json[knowhere::meta::METRIC_TYPE].get<std::string>();
+        std::unique_ptr<faiss::IndexScalarQuantizer> shifted;
+        if (metric == knowhere::metric::COSINE) {
+            shifted = std::make_unique<faiss::IndexScalarQuantizerCosine>(
+                dim, faiss::ScalarQuantizer::QT_8bit_direct_signed);
+        } else {
+            shifted = std::make_unique<faiss::IndexScalarQuantizer>(
+                dim, faiss::ScalarQuantizer::QT_8bit_direct_signed,
+                metric == knowhere::metric::IP ? faiss::METRIC_INNER_PRODUCT : faiss::METRIC_L2);
+        }
+        shifted->add(nb, (const float*)knowhere::ConvertFromDataTypeIfNeeded<T>(base)->GetTensor());
+        knowhere::MemoryIOWriter writer;
+        faiss::write_index(shifted.get(), &writer);
+        std::shared_ptr<uint8_t[]> data(writer.data());
+        knowhere::BinarySet shifted_bs;
+        shifted_bs.Append(knowhere::IndexEnum::INDEX_FAISS_IDMAP, data, writer.tellg());
+        auto reencoded_shifted =
+            knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, typed_version).value();
+        REQUIRE(reencoded_shifted.Deserialize(shifted_bs, json) == knowhere::Status::success);
+        check_same(reencoded_shifted);
+    }
+}
+
+template <typename T>
+void
+check_ivf_flat_typed(const knowhere::DataSetPtr train_ds, const knowhere::DataSetPtr query_ds,
+                     const knowhere::Json& flat_json) {
+    using Catch::Approx;
+
+    const auto nb = train_ds->GetRows();
+    const auto nq = query_ds->GetRows();
+    const auto dim = train_ds->GetDim();
+    const auto k = flat_json[knowhere::meta::TOPK].get<int64_t>();
+    const int64_t nlist = 16;
+    // probing all the lists, the results are the exact ones
+    knowhere::Json json = flat_json;
+    json[knowhere::indexparam::NLIST] = nlist;
+    json[knowhere::indexparam::NPROBE] = nlist;
+    auto base = knowhere::ConvertToDataTypeIfNeeded<T>(train_ds);
+    auto query = knowhere::ConvertToDataTypeIfNeeded<T>(query_ds);
+    auto typed_version = knowhere::Version::GetFlatTypedStorageVersion().VersionNumber();
+
+    auto idx =
+        knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, typed_version).value();
+    REQUIRE(idx.Build(base, json) == knowhere::Status::success);
+    // the lists store the vectors in their own type, not as fp32
+    REQUIRE(idx.Size() == (nb + nlist) * (dim * (int64_t)sizeof(T) + (int64_t)sizeof(int64_t)));
+
+    auto res = idx.Search(query, json, nullptr);
+    auto gt = knowhere::BruteForce::Search<T>(base, query, json, nullptr);
+    REQUIRE(res.has_value());
+    REQUIRE(gt.has_value());
+    for (int64_t i = 0; i < nq * k; i++) {
+        REQUIRE(res.value()->GetDistance()[i] == Approx(gt.value()->GetDistance()[i]).epsilon(0.0001));
+    }
+
+    // the filtered lists only compute the distances of the vectors that are not filtered out
+    auto bitset_data = GenerateBitsetWithRandomTbitsSet(nb, nb / 2);
+    knowhere::BitsetView bitset(bitset_data.data(), nb);
+    auto filtered_res = idx.Search(query, json, bitset);
+    auto filtered_gt = knowhere::BruteForce::Search<T>(base, query, json, bitset);
+    REQUIRE(filtered_res.has_value());
+    REQUIRE(filtered_gt.has_value());
+    for (int64_t i = 0; i < nq * k; i++) {
+        REQUIRE(!bitset.test(filtered_res.value()->GetIds()[i]));
+        REQUIRE(filtered_res.value()->GetDistance()[i] ==
+                Approx(filtered_gt.value()->GetDistance()[i]).epsilon(0.0001));
+    }
+
+    // a radius between the last two neighbors of the first query
+    knowhere::Json range_json = json;
+    auto gt_dis = gt.value()->GetDistance();
+    range_json[knowhere::meta::RADIUS] = (gt_dis[k - 2] + gt_dis[k - 1]) / 2;
+    auto range_res = idx.RangeSearch(query, range_json, nullptr);
+    auto range_gt = knowhere::BruteForce::RangeSearch<T>(base, query, range_json, nullptr);
+    REQUIRE(range_res.has_value());
+    REQUIRE(range_gt.has_value());
+    REQUIRE(GetRangeSearchRecall(*range_gt.value(), *range_res.value()) == Approx(1.0f));
+
+    // the stored vectors are returned as they are
+    auto ids_ds = GenIdsDataSet(nb, nq);
+    auto vectors = idx.GetVectorByIds(ids_ds);
+    REQUIRE(vectors.has_value());
+    auto xb = (const T*)base->GetTensor();
+    auto data = (const T*)vectors.value()->GetTensor();
+    for (int64_t i = 0; i < nq; i++) {
+        auto id = ids_ds->GetIds()[i];
+        REQUIRE(std::memcmp(data + i * dim, xb + id * dim, dim * sizeof(T)) == 0);
+    }
+
+    knowhere::BinarySet bs;
+    REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+    auto loaded =
+        knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, typed_version).value();
+    REQUIRE(loaded.Deserialize(bs, json) == knowhere::Status::success);
+    REQUIRE(loaded.Size() == idx.Size());
+    auto loaded_res = loaded.Search(query, json, nullptr);
+    REQUIRE(loaded_res.has_value());
+    for (int64_t i = 0; i < nq * k; i++) {
+        REQUIRE(loaded_res.value()->GetIds()[i] == res.value()->GetIds()[i]);
+        REQUIRE(loaded_res.value()->GetDistance()[i] == res.value()->GetDistance()[i]);
+    }
+
+    // older versions keep building on fp32 copies of the vectors, the typed index does not load them
+    auto old_version = knowhere::Version::GetCurrentVersion().VersionNumber();
+    REQUIRE(!(knowhere::Version::GetFlatTypedStorageVersion() <= knowhere::Version(old_version)));
+    auto old_idx =
+        knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, old_version).value();
+    REQUIRE(old_idx.Build(base, json) == knowhere::Status::success);
+    REQUIRE(old_idx.Size() == (nb + nlist) * (dim * (int64_t)sizeof(knowhere::fp32) + (int64_t)sizeof(int64_t)));
+    knowhere::BinarySet old_bs;
+    REQUIRE(old_idx.Serialize(old_bs) == knowhere::Status::success);
+    auto typed_from_old =
+        knowhere::IndexFactory::Instance().Create<T>(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, typed_version).value();
+    REQUIRE(typed_from_old.Deserialize(old_bs, json) == knowhere::Status::invalid_binary_set);
+}
+
+TEST_CASE("Test Mem Index With Typed Vector", "[float metrics]") {
+    const int64_t nb = 1000, nq = 10;
+    const int64_t dim = 16;
+    const int64_t k = 10;
+    auto metric = GENERATE(as<std::string>{}, knowhere::metric::L2, knowhere::metric::IP, knowhere::metric::COSINE);
+
+    knowhere::Json json;
+    json[knowhere::meta::DIM] = dim;
+    json[knowhere::meta::METRIC_TYPE] = metric;
+    json[knowhere::meta::TOPK] = k;
+
+    const auto train_ds = GenDataSet(nb, dim);
+    const auto query_ds = CopyDataSet(train_ds, nq);
+
+    SECTION("Test FLAT with fp16 vectors") {
+        check_flat_typed<knowhere::fp16>(train_ds, query_ds, json);
+    }
+
+    SECTION("Test FLAT with bf16 vectors") {
+        check_flat_typed<knowhere::bf16>(train_ds, query_ds, json);
+    }
+
+    SECTION("Test FLAT with int8 vectors") {
+        check_flat_typed<knowhere::int8>(train_ds, query_ds, json);
+    }
+
+    SECTION("Test IVF_FLAT with fp16 vectors") {
+        check_ivf_flat_typed<knowhere::fp16>(train_ds, query_ds, json);
+    }
+
+    SECTION("Test IVF_FLAT with bf16 vectors") {
+        check_ivf_flat_typed<knowhere::bf16>(train_ds, query_ds, json);
+    }
+
+    SECTION("Test IVF_FLAT with int8 vectors") {
+        check_ivf_flat_typed<knowhere::int8>(train_ds, query_ds, json);
+    }
+}
+
 TEST_CASE("Test Mem Index With Binary Vector", "[float metrics]") {
     using Catch::Approx;
 
@@ -834,3 +1245,197 @@ TEST_CASE("Test Mem Index With Binary Vector", "[bool metrics]") {
     }
 #endif
 }
+
+TEST_CASE("Test Mem Index With Cancel Token", "[float metrics]") {
+    const int64_t nb = 1000, nq = 10;
+    const int64_t dim = 128;
+    auto version = GenTestVersionList();
+
+    auto base_gen = [=]() {
+        knowhere::Json json;
+        json[knowhere::meta::DIM] = dim;
+        json[knowhere::meta::METRIC_TYPE] = knowhere::metric::L2;
+        json[knowhere::meta::TOPK] = 10;
+        json[knowhere::meta::RADIUS] = 10.0;
+        json[knowhere::meta::RANGE_FILTER] = 0.0;
+        return json;
+    };
+
+    auto ivfflat_gen = [base_gen]() {
+        knowhere::Json json = base_gen();
+        json[knowhere::indexparam::NLIST] = 16;
+        json[knowhere::indexparam::NPROBE] = 8;
+        return json;
+    };
+
+    auto hnsw_gen = [base_gen]() {
+        knowhere::Json json = base_gen();
+        json[knowhere::indexparam::HNSW_M] = 16;
+        json[knowhere::indexparam::EFCONSTRUCTION] = 64;
+        json[knowhere::indexparam::EF] = 64;
+        return json;
+    };
+
+    const auto train_ds = GenDataSet(nb, dim);
+    const auto query_ds = GenDataSet(nq, dim);
+
+    SECTION("Test cancelled or expired requests") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
+            make_tuple(knowhere::IndexEnum::INDEX_FAISS_IDMAP, base_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, ivfflat_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_HNSW, hnsw_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_FAISS_HNSW_FLAT, hnsw_gen),
+        }));
+        auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+
+        auto cancelled = std::make_shared<knowhere::CancelToken>();
+        cancelled->Cancel();
+        auto expired = knowhere::CancelToken::WithTimeout(std::chrono::milliseconds(0));
+        auto [token, expected_status] = GENERATE_REF(table<knowhere::CancelTokenPtr, knowhere::Status>({
+            make_tuple(cancelled, knowhere::Status::cancelled),
+            make_tuple(expired, knowhere::Status::timeout),
+        }));
+
+        auto search_res = idx.Search(query_ds, json, nullptr, token);
+        REQUIRE(!search_res.has_value());
+        REQUIRE(search_res.error() == expected_status);
+
+        auto range_res = idx.RangeSearch(query_ds, json, nullptr, token);
+        REQUIRE(!range_res.has_value());
+        REQUIRE(range_res.error() == expected_status);
+
+        if (name != knowhere::IndexEnum::INDEX_FAISS_IDMAP) {
+            auto its = idx.AnnIterator(query_ds, json, nullptr, true, token);
+            REQUIRE(!its.has_value());
+            REQUIRE(its.error() == expected_status);
+        }
+
+        // a live token does not change the results
+        auto live = knowhere::CancelToken::WithTimeout(std::chrono::hours(1));
+        auto live_res = idx.Search(query_ds, json, nullptr, live);
+        REQUIRE(live_res.has_value());
+        auto plain_res = idx.Search(query_ds, json, nullptr);
+        REQUIRE(plain_res.has_value());
+        for (int64_t i = 0; i < nq * json[knowhere::meta::TOPK].get<int64_t>(); ++i) {
+            REQUIRE(live_res.value()->GetIds()[i] == plain_res.value()->GetIds()[i]);
+        }
+    }
+
+    SECTION("Test cancelling a running request") {
+        const int64_t big_nb = 20000, big_nq = 2000;
+        const auto big_train_ds = GenDataSet(big_nb, dim);
+        const auto big_query_ds = GenDataSet(big_nq, dim);
+        auto idx =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, version)
+                .value();
+        knowhere::Json json = base_gen();
+        REQUIRE(idx.Build(big_train_ds, json) == knowhere::Status::success);
+
+        auto expiring = knowhere::CancelToken::WithTimeout(std::chrono::milliseconds(1));
+        auto search_res = idx.Search(big_query_ds, json, nullptr, expiring);
+        REQUIRE(!search_res.has_value());
+        REQUIRE(search_res.error() == knowhere::Status::timeout);
+
+        auto token = std::make_shared<knowhere::CancelToken>();
+        std::thread canceller([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            token->Cancel();
+        });
+        auto range_res = idx.RangeSearch(big_query_ds, json, nullptr, token);
+        canceller.join();
+        REQUIRE(!range_res.has_value());
+        REQUIRE(range_res.error() == knowhere::Status::cancelled);
+    }
+
+    SECTION("Test faiss polls the token of the calling thread") {
+        auto token = std::make_shared<knowhere::CancelToken>();
+        REQUIRE(faiss::InterruptCallback::instance != nullptr);
+        REQUIRE(faiss::InterruptCallback::instance->is_thread_safe());
+
+        knowhere::CancelToken::ScopedSetter token_setter(token.get());
+        REQUIRE(!faiss::InterruptCallback::is_interrupted());
+        token->Cancel();
+        REQUIRE(faiss::InterruptCallback::is_interrupted());
+
+        bool other_thread_interrupted = true;
+        std::thread other([&]() { other_thread_interrupted = faiss::InterruptCallback::is_interrupted(); });
+        other.join();
+        REQUIRE(!other_thread_interrupted);
+    }
+}
+
+TEST_CASE("Test Mem Index With Split Queries", "[float metrics]") {
+    using Catch::Approx;
+
+    const int64_t nb = 100000, nq = 1;
+    const int64_t dim = 16;
+    const int64_t k = 10;
+    auto metric = GENERATE(as<std::string>{}, knowhere::metric::L2, knowhere::metric::IP, knowhere::metric::COSINE);
+    auto version = knowhere::Version::GetCurrentVersion().VersionNumber();
+    auto typed_version = knowhere::Version::GetFlatTypedStorageVersion().VersionNumber();
+
+    const auto train_ds = GenDataSet(nb, dim);
+    const auto query_ds = GenDataSet(nq, dim, 7);
+    auto filter_bits = GenerateBitsetWithRandomTbitsSet(nb, nb / 2);
+    knowhere::BitsetView bitset(filter_bits.data(), nb);
+
+    // the same index searched as a whole and with each query split across the idle threads of the search pool
+    auto check_split = [&](auto& idx, const knowhere::DataSetPtr& query, const knowhere::Json& json) {
+        auto whole = idx.Search(query, json, bitset);
+        knowhere::KnowhereConfig::SetIntraQueryParallelism(true);
+        auto split = idx.Search(query, json, bitset);
+        knowhere::KnowhereConfig::SetIntraQueryParallelism(false);
+        REQUIRE(whole.has_value());
+        REQUIRE(split.has_value());
+        for (int64_t i = 0; i < nq * k; i++) {
+            REQUIRE(split.value()->GetIds()[i] == whole.value()->GetIds()[i]);
+            REQUIRE(split.value()->GetDistance()[i] == Approx(whole.value()->GetDistance()[i]));
+        }
+    };
+
+    knowhere::Json json;
+    json[knowhere::meta::DIM] = dim;
+    json[knowhere::meta::METRIC_TYPE] = metric;
+    json[knowhere::meta::TOPK] = k;
+
+    SECTION("Test FLAT") {
+        auto idx =
+            knowhere::IndexFactory::Instance().Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, version)
+                .value();
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+        check_split(idx, query_ds, json);
+    }
+
+    SECTION("Test FLAT with fp16 vectors") {
+        auto idx = knowhere::IndexFactory::Instance()
+                       .Create<knowhere::fp16>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, typed_version)
+                       .value();
+        REQUIRE(idx.Build(knowhere::ConvertToDataTypeIfNeeded<knowhere::fp16>(train_ds), json) ==
+                knowhere::Status::success);
+        check_split(idx, knowhere::ConvertToDataTypeIfNeeded<knowhere::fp16>(query_ds), json);
+    }
+
+    SECTION("Test FLAT with int8 vectors") {
+        auto idx = knowhere::IndexFactory::Instance()
+                       .Create<knowhere::int8>(knowhere::IndexEnum::INDEX_FAISS_IDMAP, typed_version)
+                       .value();
+        REQUIRE(idx.Build(knowhere::ConvertToDataTypeIfNeeded<knowhere::int8>(train_ds), json) ==
+                knowhere::Status::success);
+        check_split(idx, knowhere::ConvertToDataTypeIfNeeded<knowhere::int8>(query_ds), json);
+    }
+
+    SECTION("Test IVF_FLAT") {
+        json[knowhere::indexparam::NLIST] = 256;
+        json[knowhere::indexparam::NPROBE] = 128;
+        auto idx = knowhere::IndexFactory::Instance()
+                       .Create<knowhere::fp32>(knowhere::IndexEnum::INDEX_FAISS_IVFFLAT, version)
+                       .value();
+        REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+        check_split(idx, query_ds, json);
+    }
+}
@@ -9,6 +9,8 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
+#include <cmath>
+
 #include "catch2/catch_approx.hpp"
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/generators/catch_generators.hpp"
@@ -44,6 +46,19 @@ ConvertVector(float* data, int dim, int rows) {
     return x;
 }
 
+// the kernels sum in a different order than the ref, and an inner product of mixed sign vectors can cancel out to much
+// less than its terms, so the inner product error is bounded against |x| * |y| rather than against the result
+template <typename TX, typename TY>
+auto
+WithinIP(const TX* x, const TY* y, size_t dim, float ref, float tolerance) {
+    float norm_x = 0.0f, norm_y = 0.0f;
+    for (size_t i = 0; i < dim; i++) {
+        norm_x += (float)x[i] * (float)x[i];
+        norm_y += (float)y[i] * (float)y[i];
+    }
+    return Catch::Matchers::WithinAbs(ref, tolerance * std::sqrt(norm_x * norm_y));
+}
+
 TEST_CASE("Test distance") {
     using Catch::Approx;
     auto simd_type = GENERATE(as<knowhere::KnowhereConfig::SimdType>{}, knowhere::KnowhereConfig::SimdType::AVX512,
@@ -54,7 +69,8 @@ TEST_CASE("Test distance") {
     LOG_KNOWHERE_INFO_ << "simd type: " << simd_type << ", dim: " << dim;
     knowhere::KnowhereConfig::SetSimdType(simd_type);
 
-    const size_t nx = 1, ny = 4;
+    // ny = 8 + 4 + 3, so that the _ny kernels run a block of 8 rows, a batch of 4 and the single row tail
+    const size_t nx = 1, ny = 15;
 
     // fp32's accuracy is 0.000001, consider the accumulation of precision loss
     const float tolerance = 0.000005f;
@@ -317,9 +333,74 @@ TEST_CASE("Test distance") {
         faiss::fvec_inner_products_ny(ip_dis.get(), x.get(), y.get(), dim, ny);
         faiss::fvec_L2sqr_ny(l2_dis.get(), x.get(), y.get(), dim, ny);
         for (size_t i = 0; i < ny; i++) {
-            REQUIRE_THAT(ip_dis[i], Catch::Matchers::WithinRel(ref_ip[i], tolerance));
+            REQUIRE_THAT(ip_dis[i], WithinIP(x.get(), y.get() + i * dim, dim, ref_ip[i], tolerance));
             REQUIRE_THAT(l2_dis[i], Catch::Matchers::WithinRel(ref_l2[i], tolerance));
         }
+
+        // fp16, bf16 and int8 against the single vector ref
+        auto run_typed_test = [&](const auto* x_data, const auto* y_data, auto ip_ny, auto l2_ny, auto ref_ip,
+                                  auto ref_l2) {
+            ip_ny(ip_dis.get(), x_data, y_data, dim, ny);
+            l2_ny(l2_dis.get(), x_data, y_data, dim, ny);
+            for (size_t i = 0; i < ny; i++) {
+                REQUIRE_THAT(ip_dis[i], WithinIP(x_data, y_data + i * dim, dim, ref_ip(x_data, y_data + i * dim, dim),
+                                                 tolerance));
+                REQUIRE_THAT(l2_dis[i], Catch::Matchers::WithinRel(ref_l2(x_data, y_data + i * dim, dim), tolerance));
+            }
+        };
+        run_typed_test(x_fp16.get(), y_fp16.get(), faiss::fp16_vec_inner_products_ny, faiss::fp16_vec_L2sqr_ny,
+                       faiss::fp16_vec_inner_product_ref, faiss::fp16_vec_L2sqr_ref);
+        run_typed_test(x_bf16.get(), y_bf16.get(), faiss::bf16_vec_inner_products_ny, faiss::bf16_vec_L2sqr_ny,
+                       faiss::bf16_vec_inner_product_ref, faiss::bf16_vec_L2sqr_ref);
+        run_typed_test(x_int8.get(), y_int8.get(), faiss::int8_vec_inner_products_ny, faiss::int8_vec_L2sqr_ny,
+                       faiss::int8_vec_inner_product_ref, faiss::int8_vec_L2sqr_ref);
+    }
+
+    SECTION("test asymmetric distance calculation") {
+        auto run_test = [&](const auto* y_data, auto ip, auto l2, auto ip_batch_4, auto l2_batch_4, auto ip_ny,
+                            auto l2_ny, auto ref_ip, auto ref_l2) {
+            const auto* y0 = y_data;
+            const auto* y1 = y_data + dim;
+            const auto* y2 = y_data + 2 * dim;
+            const auto* y3 = y_data + 3 * dim;
+
+            std::vector<float> ref_ip_dis(ny), ref_l2_dis(ny);
+            for (size_t i = 0; i < ny; i++) {
+                ref_ip_dis[i] = ref_ip(x.get(), y_data + i * dim, dim);
+                ref_l2_dis[i] = ref_l2(x.get(), y_data + i * dim, dim);
+            }
+
+            REQUIRE_THAT(ip(x.get(), y0, dim), WithinIP(x.get(), y0, dim, ref_ip_dis[0], tolerance));
+            REQUIRE_THAT(l2(x.get(), y0, dim), Catch::Matchers::WithinRel(ref_l2_dis[0], tolerance));
+
+            std::vector<float> ip_dis(ny), l2_dis(ny);
+            ip_batch_4(x.get(), y0, y1, y2, y3, dim, ip_dis[0], ip_dis[1], ip_dis[2], ip_dis[3]);
+            l2_batch_4(x.get(), y0, y1, y2, y3, dim, l2_dis[0], l2_dis[1], l2_dis[2], l2_dis[3]);
+            for (size_t i = 0; i < 4; i++) {
+                REQUIRE_THAT(ip_dis[i], WithinIP(x.get(), y_data + i * dim, dim, ref_ip_dis[i], tolerance));
+                REQUIRE_THAT(l2_dis[i], Catch::Matchers::WithinRel(ref_l2_dis[i], tolerance));
+            }
+
+            ip_ny(ip_dis.data(), x.get(), y_data, dim, ny);
+            l2_ny(l2_dis.data(), x.get(), y_data, dim, ny);
+            for (size_t i = 0; i < ny; i++) {
+                REQUIRE_THAT(ip_dis[i], WithinIP(x.get(), y_data + i * dim, dim, ref_ip_dis[i], tolerance));
+                REQUIRE_THAT(l2_dis[i], Catch::Matchers::WithinRel(ref_l2_dis[i], tolerance));
+            }
+        };
+
+        run_test(y_fp16.get(), faiss::fvec_fp16_inner_product, faiss::fvec_fp16_L2sqr,
+                 faiss::fvec_fp16_inner_product_batch_4, faiss::fvec_fp16_L2sqr_batch_4,
+                 faiss::fvec_fp16_inner_products_ny, faiss::fvec_fp16_L2sqr_ny, faiss::fvec_fp16_inner_product_ref,
+                 faiss::fvec_fp16_L2sqr_ref);
+        run_test(y_bf16.get(), faiss::fvec_bf16_inner_product, faiss::fvec_bf16_L2sqr,
+                 faiss::fvec_bf16_inner_product_batch_4, faiss::fvec_bf16_L2sqr_batch_4,
+                 faiss::fvec_bf16_inner_products_ny, faiss::fvec_bf16_L2sqr_ny, faiss::fvec_bf16_inner_product_ref,
+                 faiss::fvec_bf16_L2sqr_ref);
+        run_test(y_int8.get(), faiss::fvec_int8_inner_product, faiss::fvec_int8_L2sqr,
+                 faiss::fvec_int8_inner_product_batch_4, faiss::fvec_int8_L2sqr_batch_4,
+                 faiss::fvec_int8_inner_products_ny, faiss::fvec_int8_L2sqr_ny, faiss::fvec_int8_inner_product_ref,
+                 faiss::fvec_int8_L2sqr_ref);
     }
 
     SECTION("test madd distance calculation") {
@@ -389,3 +470,143 @@ TEST_CASE("Test distance") {
         run_test();
     }
 }
+
+TEST_CASE("Test fixed dim distance") {
+    auto simd_type = GENERATE(as<knowhere::KnowhereConfig::SimdType>{}, knowhere::KnowhereConfig::SimdType::AVX512,
+                              knowhere::KnowhereConfig::SimdType::AVX2, knowhere::KnowhereConfig::SimdType::SSE4_2,
+                              knowhere::KnowhereConfig::SimdType::GENERIC, knowhere::KnowhereConfig::SimdType::AUTO);
+    // the dims with a fixed dim kernel, and some without
+    auto dim = GENERATE(as<size_t>{}, 64, 128, 200, 256, 384, 512, 768, 1024, 1536);
+
+    LOG_KNOWHERE_INFO_ << "simd type: " << simd_type << ", dim: " << dim;
+    knowhere::KnowhereConfig::SetSimdType(simd_type);
+
+    const size_t nx = 1, ny = 4;
+
+    // fp32's accuracy is 0.000001, the accumulated precision loss grows with dim since the kernels sum in a different
+    // order than the ref
+    const float tolerance = 0.000005f * std::max<size_t>(1, dim / 128);
+    const auto x = GenRandomVector<float>(dim, nx, 314);
+    const auto y = GenRandomVector<float>(dim, ny, 271);
+
+    const auto ref_ip = faiss::fvec_inner_product_ref(x.get(), y.get(), dim);
+    const auto ref_l2 = faiss::fvec_L2sqr_ref(x.get(), y.get(), dim);
+    REQUIRE_THAT(faiss::fvec_inner_product_for_dim(dim)(x.get(), y.get(), dim),
+                 WithinIP(x.get(), y.get(), dim, ref_ip, tolerance));
+    REQUIRE_THAT(faiss::fvec_L2sqr_for_dim(dim)(x.get(), y.get(), dim),
+                 Catch::Matchers::WithinRel(ref_l2, tolerance));
+
+    std::vector<float> ref_ip_batch_4(4), ref_l2_batch_4(4), ip_batch_4(4), l2_batch_4(4);
+    const float* y_data = y.get();
+    faiss::fvec_inner_product_batch_4_ref(x.get(), y_data, y_data + dim, y_data + 2 * dim, y_data + 3 * dim, dim,
+                                          ref_ip_batch_4[0], ref_ip_batch_4[1], ref_ip_batch_4[2],
+                                          ref_ip_batch_4[3]);
+    faiss::fvec_L2sqr_batch_4_ref(x.get(), y_data, y_data + dim, y_data + 2 * dim, y_data + 3 * dim, dim,
+                                  ref_l2_batch_4[0], ref_l2_batch_4[1], ref_l2_batch_4[2], ref_l2_batch_4[3]);
+    faiss::fvec_inner_product_batch_4_for_dim(dim)(x.get(), y_data, y_data + dim, y_data + 2 * dim,
+                                                   y_data + 3 * dim, dim, ip_batch_4[0], ip_batch_4[1],
+                                                   ip_batch_4[2], ip_batch_4[3]);
+    faiss::fvec_L2sqr_batch_4_for_dim(dim)(x.get(), y_data, y_data + dim, y_data + 2 * dim, y_data + 3 * dim, dim,
+                                           l2_batch_4[0], l2_batch_4[1], l2_batch_4[2], l2_batch_4[3]);
+    for (size_t i = 0; i < 4; i++) {
+        REQUIRE_THAT(ip_batch_4[i], WithinIP(x.get(), y_data + i * dim, dim, ref_ip_batch_4[i], tolerance));
+        REQUIRE_THAT(l2_batch_4[i], Catch::Matchers::WithinRel(ref_l2_batch_4[i], tolerance));
+    }
+}
+
+TEST_CASE("Test calibrated distance") {
+    auto dim = GENERATE(as<size_t>{}, 1, 2, 4, 7, 32, 128, 256);
+    LOG_KNOWHERE_INFO_ << "dim: " << dim;
+
+    // the calibration may install the AVX2 kernels on an AVX512 host, the hooks must still agree with the ref
+    knowhere::KnowhereConfig::SetSimdType(knowhere::KnowhereConfig::SimdType::AUTO);
+    const auto table = knowhere::KnowhereConfig::CalibrateSimdKernels();
+    REQUIRE(knowhere::KnowhereConfig::GetSimdCalibrationTable() == table);
+
+    // ny = 8 + 4 + 3, so that the _ny kernels run a block of 8 rows, a batch of 4 and the single row tail
+    const size_t nx = 1, ny = 15;
+    const float tolerance = 0.000005f;
+    const float fp16_tolerance = 0.004f;
+    const float bf16_tolerance = 0.03f;
+    const float int8_tolerance = 0.000001f;
+    const auto x = GenRandomVector<float>(dim, nx, 314);
+    const auto y = GenRandomVector<float>(dim, ny, 271);
+
+    // single, batch_4 and, if given, ny against the single ref
+    auto check = [&](const auto* x_data, const auto* y_data, auto dis, auto dis_batch_4, auto dis_ny, auto ref,
+                     float tol, bool ip) {
+        std::vector<float> ref_dis(ny);
+        for (size_t i = 0; i < ny; i++) {
+            ref_dis[i] = ref(x_data, y_data + i * dim, dim);
+        }
+        auto require = [&](float value, size_t i) {
+            if (ip) {
+                REQUIRE_THAT(value, WithinIP(x_data, y_data + i * dim, dim, ref_dis[i], tol));
+            } else {
+                REQUIRE_THAT(value, Catch::Matchers::WithinRel(ref_dis[i], tol));
+            }
+        };
+
+        require(dis(x_data, y_data, dim), 0);
+
+        std::vector<float> batch_4(4);
+        dis_batch_4(x_data, y_data, y_data + dim, y_data + 2 * dim, y_data + 3 * dim, dim, batch_4[0], batch_4[1],
+                    batch_4[2], batch_4[3]);
+        for (size_t i = 0; i < 4; i++) {
+            require(batch_4[i], i);
+        }
+
+        if constexpr (!std::is_same_v<decltype(dis_ny), std::nullptr_t>) {
+            std::vector<float> ny_dis(ny);
+            dis_ny(ny_dis.data(), x_data, y_data, dim, ny);
+            for (size_t i = 0; i < ny; i++) {
+                require(ny_dis[i], i);
+            }
+        }
+    };
+
+    check(x.get(), y.get(), faiss::fvec_inner_product, faiss::fvec_inner_product_batch_4,
+          faiss::fvec_inner_products_ny, faiss::fvec_inner_product_ref, tolerance, true);
+    check(x.get(), y.get(), faiss::fvec_L2sqr, faiss::fvec_L2sqr_batch_4, faiss::fvec_L2sqr_ny,
+          faiss::fvec_L2sqr_ref, tolerance, false);
+    // the calibrated choice of the bucket of dim
+    check(x.get(), y.get(), faiss::fvec_inner_product_for_dim(dim), faiss::fvec_inner_product_batch_4_for_dim(dim),
+          nullptr, faiss::fvec_inner_product_ref, tolerance, true);
+    check(x.get(), y.get(), faiss::fvec_L2sqr_for_dim(dim), faiss::fvec_L2sqr_batch_4_for_dim(dim), nullptr,
+          faiss::fvec_L2sqr_ref, tolerance, false);
+
+    const auto x_fp16 = ConvertVector<knowhere::fp16>(x.get(), nx, dim);
+    const auto y_fp16 = ConvertVector<knowhere::fp16>(y.get(), ny, dim);
+    check(x_fp16.get(), y_fp16.get(), faiss::fp16_vec_inner_product, faiss::fp16_vec_inner_product_batch_4,
+          faiss::fp16_vec_inner_products_ny, faiss::fp16_vec_inner_product_ref, fp16_tolerance, true);
+    check(x_fp16.get(), y_fp16.get(), faiss::fp16_vec_L2sqr, faiss::fp16_vec_L2sqr_batch_4,
+          faiss::fp16_vec_L2sqr_ny, faiss::fp16_vec_L2sqr_ref, fp16_tolerance, false);
+
+    const auto x_bf16 = ConvertVector<knowhere::bf16>(x.get(), nx, dim);
+    const auto y_bf16 = ConvertVector<knowhere::bf16>(y.get(), ny, dim);
+    check(x_bf16.get(), y_bf16.get(), faiss::bf16_vec_inner_product, faiss::bf16_vec_inner_product_batch_4,
+          faiss::bf16_vec_inner_products_ny, faiss::bf16_vec_inner_product_ref, bf16_tolerance, true);
+    check(x_bf16.get(), y_bf16.get(), faiss::bf16_vec_L2sqr, faiss::bf16_vec_L2sqr_batch_4,
+          faiss::bf16_vec_L2sqr_ny, faiss::bf16_vec_L2sqr_ref, bf16_tolerance, false);
+
+    const auto x_int8 = ConvertVector<knowhere::int8>(x.get(), nx, dim);
+    const auto y_int8 = ConvertVector<knowhere::int8>(y.get(), ny, dim);
+    check(x_int8.get(), y_int8.get(), faiss::int8_vec_inner_product, faiss::int8_vec_inner_product_batch_4,
+          faiss::int8_vec_inner_products_ny, faiss::int8_vec_inner_product_ref, int8_tolerance, true);
+    check(x_int8.get(), y_int8.get(), faiss::int8_vec_L2sqr, faiss::int8_vec_L2sqr_batch_4,
+          faiss::int8_vec_L2sqr_ny, faiss::int8_vec_L2sqr_ref, int8_tolerance, false);
+
+    // fp32 query against fp16, bf16 and int8 vectors
+    check(x.get(), y_fp16.get(), faiss::fvec_fp16_inner_product, faiss::fvec_fp16_inner_product_batch_4,
+          faiss::fvec_fp16_inner_products_ny, faiss::fvec_fp16_inner_product_ref, tolerance, true);
+    check(x.get(), y_fp16.get(), faiss::fvec_fp16_L2sqr, faiss::fvec_fp16_L2sqr_batch_4, faiss::fvec_fp16_L2sqr_ny,
+          faiss::fvec_fp16_L2sqr_ref, tolerance, false);
+    check(x.get(), y_bf16.get(), faiss::fvec_bf16_inner_product, faiss::fvec_bf16_inner_product_batch_4,
+          faiss::fvec_bf16_inner_products_ny, faiss::fvec_bf16_inner_product_ref, tolerance, true);
+    check(x.get(), y_bf16.get(), faiss::fvec_bf16_L2sqr, faiss::fvec_bf16_L2sqr_batch_4, faiss::fvec_bf16_L2sqr_ny,
+          faiss::fvec_bf16_L2sqr_ref, tolerance, false);
+    check(x.get(), y_int8.get(), faiss::fvec_int8_inner_product, faiss::fvec_int8_inner_product_batch_4,
+          faiss::fvec_int8_inner_products_ny, faiss::fvec_int8_inner_product_ref, tolerance, true);
+    check(x.get(), y_int8.get(), faiss::fvec_int8_L2sqr, faiss::fvec_int8_L2sqr_batch_4, faiss::fvec_int8_L2sqr_ny,
+          faiss::fvec_int8_L2sqr_ref, tolerance, false);
+}
@@ -9,8 +9,12 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
+#include <cstring>
+#include <fstream>
 #include <future>
+#include <iterator>
 #include <thread>
+#include <vector>
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/generators/catch_generators.hpp"
@@ -165,6 +169,46 @@ TEST_CASE("Test Mem Sparse Index With Float Vector", "[float metrics]") {
         }
     }
 
+    SECTION("Test Search after SerializeToFile") {
+        using std::make_tuple;
+        auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
+            make_tuple(knowhere::IndexEnum::INDEX_SPARSE_INVERTED_INDEX, sparse_inverted_index_gen),
+            make_tuple(knowhere::IndexEnum::INDEX_SPARSE_WAND, sparse_inverted_index_gen),
+        }));
+        auto gt = knowhere::BruteForce::SearchSparse(train_ds, query_ds, conf, nullptr);
+
+        auto tmp_file = "/tmp/knowhere_sparse_inverted_index_test";
+        auto cfg_json = gen().dump();
+        CAPTURE(name, cfg_json);
+        knowhere::Json json = knowhere::Json::parse(cfg_json);
+        {
+            auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+            REQUIRE(idx.Build(train_ds, json) == knowhere::Status::success);
+            REQUIRE(idx.SerializeToFile(tmp_file) == knowhere::Status::success);
+
+            // the file holds the same bytes as the binary of the binary set
+            knowhere::BinarySet bs;
+            REQUIRE(idx.Serialize(bs) == knowhere::Status::success);
+            auto binary = bs.GetByName(idx.Type());
+            std::ifstream in(tmp_file, std::ios::binary);
+            std::vector<char> file_data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            REQUIRE(file_data.size() == (size_t)binary->size);
+            REQUIRE(std::memcmp(file_data.data(), binary->data.get(), binary->size) == 0);
+        }
+        {
+            auto idx = knowhere::IndexFactory::Instance().Create<knowhere::fp32>(name, version).value();
+            REQUIRE(idx.DeserializeFromFile(tmp_file, json) == knowhere::Status::success);
+            REQUIRE(idx.Count() == nb);
+            auto results = idx.Search(query_ds, json, nullptr);
+            REQUIRE(results.has_value());
+            if (json[knowhere::indexparam::DROP_RATIO_SEARCH].get<float>() == 0) {
+                REQUIRE(GetKNNRecall(*gt.value(), *results.value()) == 1);
+            }
+            // idx to destruct and munmap
+        }
+        REQUIRE(std::remove(tmp_file) == 0);
+    }
+
     SECTION("Test Search with Bitset") {
         using std::make_tuple;
         auto [name, gen] = GENERATE_REF(table<std::string, std::function<knowhere::Json()>>({
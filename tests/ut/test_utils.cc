@@ -9,12 +9,16 @@
 // is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
 // or implied. See the License for the specific language governing permissions and limitations under the License.
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <thread>
 #include <vector>
 
 #include "catch2/catch_approx.hpp"
 #include "catch2/catch_test_macros.hpp"
+#include "knowhere/comp/cancel_token.h"
+#include "knowhere/comp/numa.h"
 #include "knowhere/comp/thread_pool.h"
 #include "knowhere/comp/time_recorder.h"
 #include "knowhere/expected.h"
@@ -228,6 +232,153 @@ TEST_CASE("Test ThreadPool") {
         auto thread_num_2 = omp_get_max_threads();
         REQUIRE(thread_num_2 == prev_num_threads);
     }
+
+    SECTION("NUMA aware search thread pools") {
+        auto global_pool = knowhere::ThreadPool::GetGlobalSearchThreadPool();
+        // without numa aware pools, or on a single node, routing falls back to the global pool
+        {
+            knowhere::ThreadPool::ScopedNumaNodeSetter setter(0);
+            REQUIRE(knowhere::ThreadPool::GetGlobalSearchThreadPool() == global_pool);
+        }
+        if (knowhere::ThreadPool::SetNumaAwareSearchThreadPools(true)) {
+            REQUIRE(knowhere::NumaTopology::NumNodes() > 1);
+            for (int node = 0; node < knowhere::NumaTopology::NumNodes(); ++node) {
+                if (!knowhere::NumaTopology::IsValidNode(node)) {
+                    continue;
+                }
+                knowhere::ThreadPool::ScopedNumaNodeSetter setter(node);
+                auto node_pool = knowhere::ThreadPool::GetGlobalSearchThreadPool();
+                REQUIRE(node_pool != global_pool);
+                REQUIRE(node_pool->size() >= 1);
+#ifdef __linux__
+                const auto& cpus = knowhere::NumaTopology::NodeCpus(node);
+                auto cpu = node_pool->push([]() { return sched_getcpu(); }).get();
+                REQUIRE(std::find(cpus.begin(), cpus.end(), cpu) != cpus.end());
+#endif
+            }
+            REQUIRE(knowhere::ThreadPool::SetNumaAwareSearchThreadPools(false));
+        } else {
+            REQUIRE(knowhere::NumaTopology::NumNodes() == 1);
+        }
+        REQUIRE(knowhere::ThreadPool::GetGlobalSearchThreadPool() == global_pool);
+    }
+
+#ifdef __linux__
+    SECTION("ScopedNumaBind") {
+        auto current_cpus = []() {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            REQUIRE(sched_getaffinity(0, sizeof(set), &set) == 0);
+            std::vector<int> cpus;
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+            return cpus;
+        };
+        const auto cpus_before = current_cpus();
+        // unbound and invalid nodes leave the thread alone
+        for (const int node : {-1, knowhere::NumaTopology::NumNodes()}) {
+            knowhere::ScopedNumaBind bind(node);
+            REQUIRE(current_cpus() == cpus_before);
+        }
+        for (int node = 0; node < knowhere::NumaTopology::NumNodes(); ++node) {
+            if (!knowhere::NumaTopology::IsValidNode(node)) {
+                continue;
+            }
+            {
+                knowhere::ScopedNumaBind bind(node);
+                if (knowhere::NumaTopology::NumNodes() > 1) {
+                    // the kernel may narrow the mask to the cpus allowed by the cpuset of the process
+                    const auto& node_cpus = knowhere::NumaTopology::NodeCpus(node);
+                    const auto cpus = current_cpus();
+                    REQUIRE(!cpus.empty());
+                    for (const int cpu : cpus) {
+                        REQUIRE(std::find(node_cpus.begin(), node_cpus.end(), cpu) != node_cpus.end());
+                    }
+                } else {
+                    REQUIRE(current_cpus() == cpus_before);
+                }
+            }
+            REQUIRE(current_cpus() == cpus_before);
+        }
+    }
+#endif
+
+    SECTION("Priority lanes") {
+        knowhere::PriorityTaskQueue<int> queue;
+        for (int i = 0; i < 100; ++i) {
+            for (int lane = 0; lane < 3; ++lane) {
+                queue.addWithPriority(lane, lane);
+            }
+        }
+        // competing lanes are served 8:2:1
+        std::vector<int> taken(3, 0);
+        for (int i = 0; i < 110; ++i) {
+            taken[queue.take()]++;
+        }
+        REQUIRE(taken == std::vector<int>{80, 20, 10});
+        REQUIRE(queue.size() == 190);
+        REQUIRE(queue.size(knowhere::TaskPriority::BATCH) == 80);
+        // an idle lane leaves its share to the others
+        knowhere::PriorityTaskQueue<int> no_interactive_queue;
+        for (int i = 0; i < 100; ++i) {
+            no_interactive_queue.addWithPriority(1, 1);
+            no_interactive_queue.addWithPriority(2, 2);
+        }
+        std::fill(taken.begin(), taken.end(), 0);
+        for (int i = 0; i < 30; ++i) {
+            taken[no_interactive_queue.take()]++;
+        }
+        REQUIRE(taken == std::vector<int>{0, 20, 10});
+
+        // a full lane blocks its submitters only
+        knowhere::PriorityTaskQueue<int> bounded_queue(2);
+        bounded_queue.addWithPriority(0, 1);
+        bounded_queue.addWithPriority(1, 1);
+        std::atomic<bool> added = false;
+        std::thread adder([&]() {
+            bounded_queue.addWithPriority(2, 1);
+            added = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE_FALSE(added.load());
+        bounded_queue.addWithPriority(3, 0);
+        REQUIRE(bounded_queue.take() == 3);
+        REQUIRE_FALSE(added.load());
+        REQUIRE(bounded_queue.take() == 0);
+        adder.join();
+        REQUIRE(added.load());
+        REQUIRE(bounded_queue.size(knowhere::TaskPriority::BATCH) == 2);
+    }
+
+    SECTION("Admission limit") {
+        knowhere::ThreadPool pool(1, "test_lanes", knowhere::ThreadPool::QueueType::PRIORITY);
+        std::atomic<bool> release = false;
+        auto blocker = pool.push([&]() {
+            while (!release.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        std::vector<folly::Future<folly::Unit>> futs;
+        {
+            knowhere::ThreadPool::ScopedTaskPrioritySetter setter(knowhere::TaskPriority::BATCH);
+            for (int i = 0; i < 3; ++i) {
+                futs.emplace_back(pool.push([]() {}));
+            }
+        }
+        REQUIRE(pool.GetPendingTaskCount(knowhere::TaskPriority::BATCH) == 3);
+        REQUIRE(pool.GetPendingTaskCount(knowhere::TaskPriority::INTERACTIVE) == 0);
+        REQUIRE_FALSE(pool.IsSaturated(knowhere::TaskPriority::BATCH));
+        knowhere::ThreadPool::SetSearchAdmissionLimit(knowhere::TaskPriority::BATCH, 3);
+        REQUIRE(pool.IsSaturated(knowhere::TaskPriority::BATCH));
+        REQUIRE_FALSE(pool.IsSaturated(knowhere::TaskPriority::INTERACTIVE));
+        knowhere::ThreadPool::SetSearchAdmissionLimit(knowhere::TaskPriority::BATCH, 0);
+        release = true;
+        std::move(blocker).get();
+        REQUIRE(knowhere::WaitAllSuccess(futs) == knowhere::Status::success);
+    }
 }
 
 TEST_CASE("Test WaitAllSuccess with folly::Unit futures") {
@@ -309,3 +460,70 @@ TEST_CASE("Test WaitAllSuccess with knowhere::Status futures") {
         REQUIRE_THROWS_AS(knowhere::WaitAllSuccess(futures), std::runtime_error);
     }
 }
+
+TEST_CASE("Test ThreadPool ParallelFor") {
+    auto pool = knowhere::ThreadPool::GetGlobalSearchThreadPool();
+
+    SECTION("Every index runs exactly once") {
+        for (size_t n : {0, 1, 7, 1000, 100000}) {
+            std::vector<std::atomic<int>> visits(n);
+            REQUIRE(pool->ParallelFor(0, n, [&](size_t i) { visits[i]++; }) == knowhere::Status::success);
+            for (size_t i = 0; i < n; ++i) {
+                REQUIRE(visits[i].load() == 1);
+            }
+        }
+        std::vector<std::atomic<int>> visits(100);
+        pool->ParallelFor(
+            10, 90, [&](size_t i) { visits[i]++; }, 16);
+        for (size_t i = 0; i < visits.size(); ++i) {
+            REQUIRE(visits[i].load() == (i >= 10 && i < 90 ? 1 : 0));
+        }
+    }
+
+    SECTION("A failing index stops the loop") {
+        auto status = pool->ParallelFor(0, 1000, [&](size_t i) {
+            if (i == 500) {
+                return knowhere::Status::invalid_args;
+            }
+            return knowhere::Status::success;
+        });
+        REQUIRE(status == knowhere::Status::invalid_args);
+    }
+
+    SECTION("A throwing index rethrows") {
+        REQUIRE_THROWS_AS(pool->ParallelFor(0, 1000,
+                                            [&](size_t i) {
+                                                if (i == 500) {
+                                                    throw std::runtime_error("Task failed");
+                                                }
+                                            }),
+                          std::runtime_error);
+    }
+
+    SECTION("A cancelled request drops its remaining work") {
+        auto token = std::make_shared<knowhere::CancelToken>();
+        knowhere::CancelToken::ScopedSetter token_setter(token.get());
+        std::atomic<size_t> visits = 0;
+        std::atomic<bool> token_seen = true;
+        auto status = pool->ParallelFor(0, 100000, [&](size_t i) {
+            if (knowhere::CancelToken::Current() != token.get()) {
+                token_seen = false;
+            }
+            if (visits++ == 100) {
+                token->Cancel();
+            }
+        });
+        REQUIRE(status == knowhere::Status::cancelled);
+        REQUIRE(token_seen.load());
+        REQUIRE(visits.load() < 100000);
+    }
+
+    SECTION("An expired request does not start") {
+        auto token = knowhere::CancelToken::WithTimeout(std::chrono::milliseconds(0));
+        knowhere::CancelToken::ScopedSetter token_setter(token.get());
+        std::atomic<size_t> visits = 0;
+        REQUIRE(pool->ParallelFor(0, 1000, [&](size_t i) { visits++; }) == knowhere::Status::timeout);
+        REQUIRE(visits.load() == 0);
+        REQUIRE(knowhere::CancelToken::WithTimeout(std::chrono::hours(1))->GetStatus() == knowhere::Status::success);
+    }
+}
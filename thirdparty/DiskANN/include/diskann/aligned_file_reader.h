@@ -8,7 +8,6 @@
 #include <vector>
 #include <atomic>
 #include <fcntl.h>
-#include <libaio.h>
 #include <unistd.h>
 
 #include <malloc.h>
@@ -18,7 +17,9 @@
 #include "tsl/robin_map.h"
 #include "utils.h"
 
-typedef io_context_t IOContext;
+// opaque per-thread I/O handle, its meaning is defined by the reader
+// implementation (an `io_context_t` for libaio, an `io_uring` for io_uring)
+typedef void* IOContext;
 
 // NOTE :: all 3 fields must be 512-aligned
 struct AlignedRead {
@@ -61,6 +62,23 @@ class AlignedFileReader {
                     bool async = false) = 0;
 
   // async reads
-  virtual void get_submitted_req(io_context_t &ctx, size_t n_ops) = 0;
-  virtual void submit_req( io_context_t &ctx, std::vector<AlignedRead> &read_reqs) = 0;
+  virtual void get_submitted_req(IOContext &ctx, size_t n_ops) = 0;
+  virtual void submit_req(IOContext &ctx, std::vector<AlignedRead> &read_reqs) = 0;
+
+  // reap between `min_nr` and `max_nr` completed requests previously issued
+  // by `submit_req`, appending the `buf` of each finished request to
+  // `done_bufs`. Returns the number of reaped requests.
+  virtual size_t poll_submitted_req(IOContext &ctx, size_t min_nr,
+                                    size_t max_nr,
+                                    std::vector<void *> &done_bufs) = 0;
+
+  // max number of requests that can be in flight on a single context
+  virtual size_t max_events_per_ctx() = 0;
+
+  // hint the reader about long-lived destination buffers (e.g. per-thread
+  // sector scratch) so that it can pin them up front. Reads into other
+  // buffers must keep working.
+  virtual void register_buffers(
+      const std::vector<std::pair<void *, size_t>> &bufs) {
+  }
 };
@@ -129,15 +129,44 @@ namespace diskann {
     uint32_t num_nodes_to_cache = 0;
     // shuffle id to build index
     bool shuffle_build = false;
+    // place graph neighbors in the same sector of the disk index
+    bool locality_layout = false;
+    // base_num x base_dim vectors of the index data type to build from
+    // instead of data_file_path, they are only written to disk if the build
+    // needs them in a file
+    const void *base_data = nullptr;
+    _u64        base_num = 0;
+    _u64        base_dim = 0;
   };
 
   template<typename T>
   int build_disk_index(const BuildConfig &config);
 
+  // Order nodes so that each run of `nnodes_per_sector` positions holds a
+  // node together with as many of its graph neighbors as possible. Seeds are
+  // taken in BFS order from `medoid`, so consecutive sectors stay close too.
+  // Returns the node id stored at each position.
+  std::vector<_u32> generate_locality_layout(
+      const std::vector<std::vector<unsigned>> &graph, _u64 nnodes_per_sector,
+      _u32 medoid);
+
+  // When `layout_file` is given, nodes are written in the order returned by
+  // `generate_locality_layout` and the position of every node id is saved to
+  // `layout_file`. Ignored for indexes whose nodes span multiple sectors.
   template<typename T>
   void create_disk_layout(
       const std::string base_file, const std::string mem_index_file,
       const std::string output_file,
-      const std::string reorder_data_file = std::string(""));
+      const std::string reorder_data_file = std::string(""),
+      const std::string layout_file = std::string(""));
+
+  // same as above, but takes the coords of the nodes from the npts x ndims
+  // vectors of `base_data`, `stride` apart
+  template<typename T>
+  void create_disk_layout(const T *base_data, const _u64 npts,
+                          const _u64 ndims, const _u64 stride,
+                          const std::string mem_index_file,
+                          const std::string output_file,
+                          const std::string layout_file = std::string(""));
 
 }  // namespace diskann
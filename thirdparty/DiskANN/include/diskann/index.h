@@ -136,6 +136,16 @@ namespace diskann {
     void build(const char *filename, const size_t num_points_to_load,
                Parameters &parameters, const char *tag_filename);
 
+    // same as above, but copies the num_points_to_load x dim vectors of
+    // `data` instead of loading them from a file
+    void build(const T *data, const size_t num_points_to_load,
+               Parameters &parameters);
+
+    // same as above, but builds on the vectors the caller already wrote to
+    // get_data(), get_aligned_dim() apart, saving the copy
+    void build_in_place(const size_t num_points_to_load,
+                        Parameters  &parameters);
+
     // Added search overload that takes L as parameter, so that we
     // can customize L on a per-query basis without tampering with "Parameters"
     template<typename IDType>
@@ -199,6 +209,10 @@ namespace diskann {
       return _ep;
     }
 
+    size_t get_aligned_dim() const {
+      return _aligned_dim;
+    }
+
     T                                        *get_data();
     const std::unordered_map<unsigned, TagT> *get_tags() const {
       return &this->_location_to_tag;
@@ -242,6 +256,9 @@ namespace diskann {
     std::vector<std::vector<unsigned>> _final_graph;
     std::vector<std::vector<unsigned>> _in_graph;
 
+    // builds the graph once the points are in _data
+    void build_with_data_populated(Parameters &parameters);
+
     // generates one frozen point that will never get deleted from the
     // graph
     int generate_frozen_point();
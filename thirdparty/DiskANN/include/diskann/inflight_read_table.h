@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tsl/robin_map.h"
+
+#include "utils.h"
+
+namespace diskann {
+  // Table of the sector reads currently in flight, shared by all searches on
+  // an index. A search that needs a sector which another search is already
+  // reading joins that read instead of issuing its own I/O.
+  //
+  // Protocol: call `acquire` for every sector before reading it. The owner of
+  // a read must `complete` (or `abort`) it before waiting on any read it
+  // joined, which rules out two searches waiting on each other. A search
+  // acquires every sector at most once per round and shares the sector
+  // among its own nodes, it never joins a read it owns.
+  class InflightReadTable {
+   public:
+    struct Ticket;
+    using TicketPtr = std::shared_ptr<Ticket>;
+
+    explicit InflightReadTable(_u64 read_len);
+
+    // Returns true if the caller owns the read of `offset` and has to read
+    // it, false if it joined a read of another search and has to `wait`.
+    bool acquire(_u64 offset, TicketPtr &ticket);
+
+    // publishes the sector read by the owner to the searches that joined
+    void complete(_u64 offset, const TicketPtr &ticket, const char *buf);
+
+    // releases a read that failed, joined searches read it on their own
+    void abort(_u64 offset, const TicketPtr &ticket);
+
+    // Copies the sector of a joined read into `out`. Returns false if the
+    // owner failed, the caller then has to read the sector itself.
+    bool wait(const TicketPtr &ticket, char *out);
+
+   private:
+    struct Shard {
+      std::mutex                      mtx;
+      tsl::robin_map<_u64, TicketPtr> reads;
+    };
+
+    Shard &shard_of(_u64 offset) {
+      return shards_[(offset / read_len_) % shards_.size()];
+    }
+
+    void finish(_u64 offset, const TicketPtr &ticket, const char *buf);
+
+    _u64               read_len_;
+    std::vector<Shard> shards_;
+  };
+}  // namespace diskann
@@ -17,15 +17,21 @@ template<typename T>
 void gen_random_slice(const std::string base_file,
                       const std::string output_prefix, double sampling_rate);
 
+template<typename T>
+void gen_random_slice(const T *inputdata, size_t npts, size_t ndims,
+                      const std::string output_file, double sampling_rate);
+
 template<typename T>
 void gen_random_slice(const std::string data_file, double p_val,
                       std::unique_ptr<float[]> &sampled_data,
                       size_t &slice_size, size_t &ndims);
 
+// `stride` is the distance between consecutive vectors of `inputdata`, 0 if
+// they are packed
 template<typename T>
 void gen_random_slice(const T *inputdata, size_t npts, size_t ndims,
                       double p_val, std::unique_ptr<float[]> &sampled_data,
-                      size_t &slice_size);
+                      size_t &slice_size, size_t stride = 0);
 
 int estimate_cluster_sizes(float *test_data_float, size_t num_test,
                            const float *pivots, const size_t num_centers,
@@ -69,3 +75,12 @@ int generate_pq_data_from_pivots(const std::string data_file,
                                  unsigned num_centers, unsigned num_pq_chunks,
                                  std::string pq_pivots_path,
                                  std::string pq_compressed_vectors_path);
+
+// same as above, but encodes the npts x ndims vectors of `data`, `stride`
+// apart
+template<typename T>
+int generate_pq_data_from_pivots(const T *data, size_t npts, size_t ndims,
+                                 size_t stride, unsigned num_centers,
+                                 unsigned num_pq_chunks,
+                                 std::string pq_pivots_path,
+                                 std::string pq_compressed_vectors_path);
@@ -26,8 +26,11 @@ namespace diskann {
     unsigned n_cmps_saved = 0;  // # cmps saved
     unsigned n_cmps = 0;        // # cmps
     unsigned n_cache_hits = 0;  // # cache_hits
+    unsigned n_sector_cache_hits = 0;  // # sectors served by the dynamic caches
     unsigned n_hops = 0;        // # search hops
     unsigned n_iters = 0;       // # range search iterations
+    unsigned n_coalesced = 0;   // # reads joined to another in-flight read
+    unsigned n_filtered_ios = 0;  // # IOs for nodes filtered out by bitset
   };
 
   template<typename T>
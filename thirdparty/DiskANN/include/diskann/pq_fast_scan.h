@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "pq_table.h"
+#include "utils.h"
+
+namespace diskann {
+  // 4-bit PQ scoring with the fast-scan kernels of faiss: the look-up table
+  // of a query is quantized to 8 bits and stays in SIMD registers while the
+  // codes of the candidates are accumulated in blocks of 32.
+  //
+  // The 4-bit quantizer is derived from the 8-bit one at load time, so the
+  // index format does not change. Every chunk is split into two halves and
+  // the 256 centers of each half are clustered into 16, weighted by the
+  // number of points using them. An 8-bit code thus maps to one byte holding
+  // both 4-bit codes, which is looked up while the candidates are gathered:
+  // no extra memory is spent on codes.
+  class FastScanPQTable {
+   public:
+    static constexpr _u64 kBlockSize = 32;
+    static constexpr _u64 kNumCenters = 16;
+
+    // `codes` holds the `n_pts` x n_chunks codes of `pq_table`
+    void build(const FixedChunkPQTable &pq_table, const _u8 *codes,
+               _u64 n_pts);
+
+    // number of entries of the look-up table of a query
+    _u64 lut_size() const {
+      return 2 * n_chunks_ * kNumCenters;
+    }
+
+    // bytes of packed codes needed to score `n` candidates
+    _u64 blocks_size(_u64 n) const {
+      return ROUND_UP(n, kBlockSize) * n_chunks_;
+    }
+
+    // Quantizes the look-up table of the query into `lut` (32-byte aligned,
+    // lut_size() bytes), `lut_float` is scratch of lut_size() floats.
+    // Distances are recovered as bias + accumulated / scale.
+    void populate_lut(const float *query_vec, float *lut_float, _u8 *lut,
+                      float &scale, float &bias) const;
+
+    // `coord_scratch` needs n_ids * n_chunks bytes, `blocks` (32-byte
+    // aligned) blocks_size(n_ids) bytes and `acc` ROUND_UP(n_ids, 32) entries
+    void compute_dists(const unsigned *ids, _u64 n_ids, const _u8 *codes,
+                       const _u8 *lut, float scale, float bias,
+                       _u8 *coord_scratch, _u8 *blocks, uint16_t *acc,
+                       float *dists_out) const;
+
+   private:
+    _u64               n_chunks_ = 0;
+    // dims of the 2 * n_chunks sub-quantizers, in the permuted order
+    std::vector<_u32>  sub_offsets_;
+    std::vector<_u32>  rearrangement_;
+    std::vector<float> centroid_;
+    // [ndims][kNumCenters], column-major like tables_T of the 8-bit table
+    std::vector<float> centers_T_;
+    // [n_chunks][256] 8-bit code -> low | high << 4
+    std::vector<_u8>   code_map_;
+  };
+}  // namespace diskann
@@ -18,10 +18,13 @@
 
 #include "aligned_file_reader.h"
 #include "concurrent_queue.h"
+#include "inflight_read_table.h"
 #include "neighbor.h"
 #include "parameters.h"
 #include "percentile_stats.h"
+#include "pq_fast_scan.h"
 #include "pq_table.h"
+#include "sector_cache.h"
 #include "utils.h"
 #include "diskann/distance.h"
 #include "knowhere/comp/thread_pool.h"
@@ -63,6 +66,13 @@ namespace diskann {
     T     *aligned_query_T = nullptr;
     float *aligned_query_float = nullptr;
 
+    // 4-bit fast-scan scoring, only allocated once it is enabled
+    _u8      *pq4_lut = nullptr;     // [2 * N_CHUNKS * 16]
+    _u8      *pq4_blocks = nullptr;  // [ROUND_UP(MAX_DEGREE, 32) * N_CHUNKS]
+    uint16_t *pq4_acc = nullptr;     // [ROUND_UP(MAX_DEGREE, 32)]
+    float     pq4_scale = 0;
+    float     pq4_bias = 0;
+
     tsl::robin_set<_u64> *visited = nullptr;
 
     void reset() {
@@ -192,13 +202,48 @@ namespace diskann {
     void cache_bfs_levels(_u64                   num_nodes_to_cache,
                           std::vector<uint32_t> &node_list);
 
+    // enable a cache of up to `budget_bytes` that keeps the node sectors
+    // fetched by searches, must be called after load
+    void enable_sector_cache(_u64 budget_bytes);
+
+    // a cache for sharing sector reads among the queries of one batch of
+    // `nq` queries, nullptr if the batch is too small to benefit
+    std::unique_ptr<SectorCache> new_batch_sector_cache(_u64 nq,
+                                                        _u64 l_search);
+
+    // score neighbor candidates with 4-bit PQ codes derived from the 8-bit
+    // ones and the fast-scan kernels, must be called after load
+    void enable_fast_scan();
+
+    // Once at least `filter_aware_ratio` of the points are filtered out, the
+    // reads of filtered candidates, which only serve connectivity, are
+    // deferred until no unfiltered candidate is left to expand. A ratio of 1
+    // disables the deferral.
     void cached_beam_search(
         const T *query, const _u64 k_search, const _u64 l_search, _s64 *res_ids,
         float *res_dists, const _u64 beam_width,
         const bool use_reorder_data = false, QueryStats *stats = nullptr,
         const knowhere::feder::diskann::FederResultUniq &feder = nullptr,
         knowhere::BitsetView                             bitset_view = nullptr,
-        const float                                      filter_ratio = -1.0f);
+        const float                                      filter_ratio = -1.0f,
+        const bool                                       pipelined = false,
+        const bool score_full_sector = false, const bool coalesce_io = false,
+        SectorCache *batch_cache = nullptr,
+        const float  filter_aware_ratio = 1.0f);
+
+    // Native range search. Candidates are expanded best-first by PQ distance,
+    // `beam_width` sectors at a time, for at least `min_l_search` nodes and
+    // then for as long as the best candidate is within `radius` or the last
+    // beam still found results, but never more than `max_l_search` nodes.
+    // Results are scored with full precision from the fetched sectors,
+    // including the co-located nodes, and returned unsorted with distances
+    // of the user metric.
+    void range_search(const T *query, const float radius,
+                      const _u64 min_l_search, const _u64 max_l_search,
+                      const _u64 beam_width, std::vector<int64_t> &indices,
+                      std::vector<float> &distances,
+                      QueryStats          *stats = nullptr,
+                      knowhere::BitsetView bitset_view = nullptr);
 
     void get_vector_by_ids(const int64_t *ids, const int64_t n,
                            T *const output_data);
@@ -235,17 +280,34 @@ namespace diskann {
     _u64 get_thread_data_size();
 
    private:
+    // position of node_id in the graph part, differs from node_id only if
+    // the index was written with a locality-aware layout
+    _u64 get_node_position(_u64 node_id) {
+      return node_layout != nullptr ? node_layout[node_id] : node_id;
+    }
+
+    // id of the node stored at `pos`, or num_points for a padding slot
+    _u64 get_node_at_position(_u64 pos) {
+      if (pos >= num_points) {
+        return num_points;
+      }
+      return node_layout_inv != nullptr ? node_layout_inv[pos] : pos;
+    }
+
     // sector # on disk where node_id is present with in the graph part
     _u64 get_node_sector_offset(_u64 node_id) {
-      return long_node ? (node_id * nsectors_per_node + 1) * SECTOR_LEN
-                       : (node_id / nnodes_per_sector + 1) * SECTOR_LEN;
+      return long_node
+                 ? (node_id * nsectors_per_node + 1) * SECTOR_LEN
+                 : (get_node_position(node_id) / nnodes_per_sector + 1) *
+                       SECTOR_LEN;
     }
 
     // obtains region of sector containing node
     char *get_offset_to_node(char *sector_buf, _u64 node_id) {
-      return long_node
-                 ? sector_buf
-                 : sector_buf + (node_id % nnodes_per_sector) * max_node_len;
+      return long_node ? sector_buf
+                       : sector_buf + (get_node_position(node_id) %
+                                       nnodes_per_sector) *
+                                          max_node_len;
     }
 
     inline void copy_vec_base_data(T *des, const int64_t des_idx, void *src);
@@ -291,6 +353,11 @@ namespace diskann {
     // used only for cosine search to re-scale the caculated distance.
     std::unique_ptr<float[]> base_norms = nullptr;
 
+    // node id -> position and position -> node id of a locality-aware
+    // layout, both empty when nodes are stored in id order
+    std::unique_ptr<_u32[]> node_layout = nullptr;
+    std::unique_ptr<_u32[]> node_layout_inv = nullptr;
+
     // data info
     bool long_node = false;
     _u64 nsectors_per_node = 0;
@@ -343,6 +410,54 @@ namespace diskann {
       }
     }
 
+    // query <-> PQ chunk centers distances (or fast-scan look-up table) of
+    // the query in `scratch`
+    void populate_pq_dists(QueryScratch<T> &scratch, const float *query_float);
+
+    // query <-> node distances in PQ space, populate_pq_dists must be called
+    // first
+    void compute_pq_dists(QueryScratch<T> &scratch, const unsigned *ids,
+                          const _u64 n_ids, float *dists_out);
+
+    // distance between the query and the coords stored on disk for node `u`
+    float full_precision_dist(const T *query, const float *query_float,
+                              T *node_coords, unsigned u) {
+      if (!use_disk_index_pq) {
+        return dist_cmp_wrap(query, node_coords, (size_t) aligned_dim, u);
+      }
+      if (metric == Metric::INNER_PRODUCT || metric == Metric::COSINE)
+        return disk_pq_table.inner_product(query_float, (_u8 *) node_coords);
+      return disk_pq_table.l2_distance(query_float, (_u8 *) node_coords);
+    }
+
+    // converts an internal distance (smaller is closer) to the distance of
+    // the user metric, see the base and query pre-processing for IP/COSINE
+    float to_user_distance(float dist, float query_norm) const {
+      if (metric == Metric::INNER_PRODUCT) {
+        // convert l2 distance to ip distance
+        dist = 1.0 - dist / 2.0;
+        // rescale to revert back to original norms (cancelling the effect of
+        // base and query pre-processing)
+        if (max_base_norm != 0)
+          dist *= (max_base_norm * query_norm);
+      } else if (metric == Metric::COSINE) {
+        dist = -dist;
+      }
+      return dist;
+    }
+
+    // inverse of to_user_distance
+    float to_internal_distance(float dist, float query_norm) const {
+      if (metric == Metric::INNER_PRODUCT) {
+        if (max_base_norm != 0)
+          dist /= (max_base_norm * query_norm);
+        dist = 2.0 * (1.0 - dist);
+      } else if (metric == Metric::COSINE) {
+        dist = -dist;
+      }
+      return dist;
+    }
+
     // for very large datasets: we use PQ even for the disk resident index
     bool              use_disk_index_pq = false;
     _u64              disk_pq_n_chunks = 0;
@@ -372,6 +487,15 @@ namespace diskann {
     T                        *coord_cache_buf = nullptr;
     tsl::robin_map<_u32, T *> coord_cache;
 
+    // dynamic cache of sectors read by searches, disabled by default
+    std::unique_ptr<SectorCache> sector_cache = nullptr;
+
+    // 4-bit fast-scan view of the in-memory PQ codes, disabled by default
+    std::unique_ptr<FastScanPQTable> fast_scan_table = nullptr;
+
+    // sector reads in flight, joined by searches with coalesce_io
+    std::unique_ptr<InflightReadTable> inflight_reads = nullptr;
+
     // thread-specific scratch
     ConcurrentQueue<ThreadData<T>> thread_data;
     _u64                           max_nthreads;
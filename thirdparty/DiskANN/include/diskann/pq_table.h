@@ -47,7 +47,11 @@ namespace diskann {
     }
   }
 
+  class FastScanPQTable;
+
   class FixedChunkPQTable {
+    friend class FastScanPQTable;
+
     // data_dim = n_chunks * chunk_size;
     std::unique_ptr<float[]> tables =
         nullptr;  // pq_tables = float* [[2^8 * [chunk_size]] * n_chunks]
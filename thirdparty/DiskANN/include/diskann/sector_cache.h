@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tsl/robin_map.h"
+
+#include "utils.h"
+
+namespace diskann {
+  // Bounded cache of node sectors filled from the reads issued by live
+  // queries, complementing the static nhood/coord cache that is built once
+  // at load time. Entries are keyed by the disk offset of the sector and hold
+  // exactly `sector_len` bytes (`read_len_for_node` of the index).
+  //
+  // Eviction is CLOCK: a hit only sets a reference bit and the hand clears
+  // bits until it finds a victim. Admission follows the ghost queue of
+  // S3-FIFO: once the cache is full, a sector is admitted only if it was
+  // already rejected recently, so one-off reads (e.g. the tail of a
+  // brute-force scan) do not flush the hot working set.
+  //
+  // The cache is split into independently locked shards to keep contention
+  // low with many search threads.
+  class SectorCache {
+   public:
+    SectorCache(_u64 capacity_bytes, _u64 sector_len);
+
+    // copies the sector at `offset` into `out` and returns true on a hit
+    bool lookup(_u64 offset, char *out);
+
+    // offers a sector read from disk to the cache
+    void insert(_u64 offset, const char *buf);
+
+    _u64 capacity() const noexcept {
+      return capacity_;
+    }
+
+    _u64 size_in_bytes() const noexcept {
+      return capacity_ * sector_len_;
+    }
+
+   private:
+    struct Shard {
+      std::mutex                  mtx;
+      tsl::robin_map<_u64, _u32>  slot_of;
+      std::vector<_u64>           keys;
+      std::vector<_u8>            ref;
+      std::unique_ptr<char[]>     buf;
+      _u32                        nslots = 0;
+      _u32                        used = 0;
+      _u32                        hand = 0;
+      std::vector<_u64>           ghost_fifo;
+      _u32                        ghost_head = 0;
+      // ghost key -> its position in ghost_fifo
+      tsl::robin_map<_u64, _u32>  ghost;
+    };
+
+    Shard &shard_of(_u64 offset) {
+      return *shards_[(offset / sector_len_) % shards_.size()];
+    }
+
+    // returns the slot to overwrite, the shard lock must be held
+    _u32 evict(Shard &shard);
+
+    // remembers a rejected key, the shard lock must be held
+    void add_ghost(Shard &shard, _u64 offset);
+
+    _u64                                sector_len_;
+    _u64                                capacity_ = 0;
+    std::vector<std::unique_ptr<Shard>> shards_;
+  };
+}  // namespace diskann
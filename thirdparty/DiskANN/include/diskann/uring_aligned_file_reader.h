@@ -0,0 +1,67 @@
+#pragma once
+
+#include <liburing.h>
+
+#include <cstdint>
+
+#include "aligned_file_reader.h"
+
+// AlignedFileReader backed by io_uring. Rings are per thread and shared by
+// every reader, so the number of rings (and of kernel resources behind them)
+// is bounded by the number of threads doing I/O rather than by indexes times
+// threads. The index file takes a slot in the registered file table of each
+// ring lazily, the first time a thread reads it, so a sector read costs no fd
+// lookup in the kernel. With SQPOLL enabled all rings share one kernel
+// submission thread and submitting is syscall-free while it is awake.
+class UringAlignedFileReader : public AlignedFileReader {
+ public:
+  UringAlignedFileReader() = default;
+  ~UringAlignedFileReader();
+
+  // the ring of the calling thread, created on first use. The context must
+  // not be handed to another thread.
+  IOContext get_ctx() override;
+  void      put_ctx(IOContext ctx) override;
+
+  // Open & close ops
+  // Blocking calls
+  void open(const std::string &fname) override;
+  void close() override;
+
+  // process batch of aligned requests in parallel
+  // NOTE :: blocking call
+  void read(std::vector<AlignedRead> &read_reqs, IOContext &ctx,
+            bool async = false) override;
+
+  // async reads. Short reads are resubmitted for the missing tail, a failed
+  // request drains the remaining in-flight requests of the ring before the
+  // error is thrown, so the ring is clean for the next search of the thread.
+  void   get_submitted_req(IOContext &ctx, size_t n_ops) override;
+  void   submit_req(IOContext &ctx, std::vector<AlignedRead> &read_reqs) override;
+  size_t poll_submitted_req(IOContext &ctx, size_t min_nr, size_t max_nr,
+                            std::vector<void *> &done_bufs) override;
+
+  size_t max_events_per_ctx() override;
+
+  // Select io_uring for newly opened DiskANN indexes. Returns false and keeps
+  // libaio if the running kernel does not support io_uring (or it is blocked
+  // by seccomp), so callers can fall back transparently. The setup flags only
+  // apply to rings created afterwards, i.e. to threads doing their first read.
+  static bool InitGlobalUringConfig(bool enable, bool sqpoll,
+                                    uint32_t sq_thread_idle_ms);
+
+  static bool IsEnabled() {
+    return enabled_;
+  }
+
+ private:
+  int      file_desc_ = -1;
+  // slot in the registered file tables of the rings, -1 if all are taken
+  int      file_slot_ = -1;
+  // distinguishes the readers that used the same slot over time
+  uint64_t file_gen_ = 0;
+
+  inline static bool     enabled_ = false;
+  inline static bool     sqpoll_ = false;
+  inline static uint32_t sq_thread_idle_ms_ = 0;
+};
@@ -641,6 +641,40 @@ namespace diskann {
     return max_norm;
   }
 
+  // same as above, but prepares the npts x in_dims vectors of `in_data` into
+  // the npts x (in_dims + 1) vectors of `out_data`, `out_stride` apart
+  template<typename T>
+  float prepare_base_for_inner_products(const T* in_data, _u64 npts,
+                                        _u64 in_dims, T* out_data,
+                                        _u64 out_stride) {
+    static_assert(
+        knowhere::KnowhereFloatTypeCheck<T>::value,
+        "prepare_base_for_inner_products only support fp16, bf16, fp32.");
+    LOG_KNOWHERE_DEBUG_ << "Pre-processing base by adding extra coordinate";
+    _u64               out_dims = in_dims + 1;
+    std::vector<float> norms(npts, 0);
+    float              max_norm = 0;
+    for (_u64 p = 0; p < npts; p++) {
+      for (_u64 j = 0; j < in_dims; j++) {
+        norms[p] += in_data[p * in_dims + j] * in_data[p * in_dims + j];
+      }
+      max_norm = max_norm > norms[p] ? max_norm : norms[p];
+    }
+
+    max_norm = std::sqrt(max_norm);
+
+    for (_u64 p = 0; p < npts; p++) {
+      for (_u64 j = 0; j < in_dims; j++) {
+        out_data[p * out_stride + j] =
+            (T) (((float) in_data[p * in_dims + j]) / max_norm);
+      }
+      float res = 1 - (norms[p] / (max_norm * max_norm));
+      res = res <= 0 ? 0 : std::sqrt(res);
+      out_data[p * out_stride + out_dims - 1] = (T) res;
+    }
+    return max_norm;
+  }
+
   template<typename T>
   std::vector<float> prepare_base_for_cosine(const std::string in_file,
                                              const std::string out_file) {
@@ -716,6 +750,29 @@ namespace diskann {
     return norms;
   }
 
+  // same as above, but normalizes the npts x dims vectors of `in_data` into
+  // `out_data`, `out_stride` apart
+  template<typename T>
+  std::vector<float> prepare_base_for_cosine(const T* in_data, _u64 npts,
+                                             _u64 dims, T* out_data,
+                                             _u64 out_stride) {
+    static_assert(knowhere::KnowhereFloatTypeCheck<T>::value,
+                  "prepare_base_for_cosine only support fp16, bf16, fp32.");
+    LOG_KNOWHERE_DEBUG_ << "Pre-processing base by normalizing";
+    std::vector<float> norms(npts, 0);
+    for (_u64 p = 0; p < npts; p++) {
+      for (_u64 j = 0; j < dims; j++) {
+        norms[p] += in_data[p * dims + j] * in_data[p * dims + j];
+      }
+      norms[p] = (norms[p] == 0.0 ? 1.0 : std::sqrt(norms[p]));
+      for (_u64 j = 0; j < dims; j++) {
+        out_data[p * out_stride + j] =
+            (T) (((float) in_data[p * dims + j]) / norms[p]);
+      }
+    }
+    return norms;
+  }
+
   // plain saves data as npts X ndims array into filename
   template<typename T>
   void save_Tvecs(const char* filename, T* data, size_t npts, size_t ndims) {
@@ -875,6 +932,11 @@ namespace diskann {
     return disk_index_filename + "_max_base_norm.bin";
   }
 
+  inline std::string get_disk_index_layout_filename(
+      const std::string& disk_index_filename) {
+    return disk_index_filename + "_layout.bin";
+  }
+
   inline std::string get_cached_nodes_file(
       const std::string& disk_index_filename) {
     return disk_index_filename + "_cached_nodes.bin";
@@ -25,6 +25,7 @@
 #include "diskann/percentile_stats.h"
 #include "diskann/pq_flash_index.h"
 #include "knowhere/comp/thread_pool.h"
+#include "tsl/robin_map.h"
 #include "tsl/robin_set.h"
 
 #include "diskann/utils.h"
@@ -583,6 +584,28 @@ namespace diskann {
     return nullptr;
   }
 
+  // one shot build of the graph of the base_num vectors already written to
+  // the data of `vamana_index`, which must fit in the RAM budget
+  template<typename T>
+  void build_vamana_index_in_place(diskann::Index<T> *vamana_index,
+                                   size_t base_num, unsigned L, unsigned R,
+                                   bool accelerate_build, bool shuffle_build,
+                                   std::string mem_index_path) {
+    diskann::Parameters paras;
+    paras.Set<unsigned>("L", (unsigned) L);
+    paras.Set<unsigned>("R", (unsigned) R);
+    paras.Set<unsigned>("C", 750);
+    paras.Set<float>("alpha", 1.2f);
+    paras.Set<unsigned>("num_rnds", 2);
+    paras.Set<bool>("saturate_graph", 1);
+    paras.Set<std::string>("save_path", mem_index_path);
+    paras.Set<bool>("accelerate_build", accelerate_build);
+    paras.Set<bool>("shuffle_build", shuffle_build);
+
+    vamana_index->build_in_place(base_num, paras);
+    vamana_index->save(mem_index_path.c_str(), true);
+  }
+
   template<typename T>
   void generate_cache_list_from_graph_with_pq(
       _u64 num_nodes_to_cache, unsigned R, const diskann::Metric compare_metric,
@@ -823,23 +846,180 @@ namespace diskann {
     return best_bw;
   }
 
+  std::vector<_u32> generate_locality_layout(
+      const std::vector<std::vector<unsigned>> &graph, _u64 nnodes_per_sector,
+      _u32 medoid) {
+    const _u64 npts = graph.size();
+
+    // seed order: BFS from the medoid, then from every unreached node
+    std::vector<_u32> seeds;
+    seeds.reserve(npts);
+    {
+      boost::dynamic_bitset<> reached(npts);
+      auto                    bfs = [&](_u32 start) {
+        size_t head = seeds.size();
+        seeds.push_back(start);
+        reached[start] = true;
+        while (head < seeds.size()) {
+          for (auto nbr : graph[seeds[head++]]) {
+            if (!reached[nbr]) {
+              reached[nbr] = true;
+              seeds.push_back(nbr);
+            }
+          }
+        }
+      };
+      if (medoid < npts) {
+        bfs(medoid);
+      }
+      for (_u32 id = 0; id < npts; ++id) {
+        if (!reached[id]) {
+          bfs(id);
+        }
+      }
+    }
+
+    // greedily fill every sector with the unplaced node that has the most
+    // edges from the nodes already placed in it
+    std::vector<_u32>          layout;
+    boost::dynamic_bitset<>    placed(npts);
+    tsl::robin_map<_u32, _u32> score;
+    layout.reserve(npts);
+    size_t seed_idx = 0;
+    while (layout.size() < npts) {
+      if (layout.size() % nnodes_per_sector == 0) {
+        score.clear();
+      }
+      _u32 next;
+      if (!score.empty()) {
+        auto best = score.begin();
+        for (auto it = score.begin(); it != score.end(); ++it) {
+          if (it->second > best->second) {
+            best = it;
+          }
+        }
+        next = best->first;
+        score.erase(best);
+      } else {
+        while (placed[seeds[seed_idx]]) {
+          seed_idx++;
+        }
+        next = seeds[seed_idx];
+      }
+      placed[next] = true;
+      layout.push_back(next);
+      for (auto nbr : graph[next]) {
+        if (!placed[nbr]) {
+          score[nbr]++;
+        }
+      }
+    }
+    return layout;
+  }
+
+  namespace {
+    // Coords of the nodes written into the disk index, streamed from a bin
+    // file or copied from vectors already in memory.
+    template<typename T>
+    class LayoutBaseReader {
+     public:
+      LayoutBaseReader(const std::string &base_file, _u64 read_blk_size)
+          : base_file_(base_file),
+            reader_(std::make_unique<cached_ifstream>(base_file,
+                                                      read_blk_size)) {
+        _u32 npts32, ndims32;
+        reader_->read((char *) &npts32, sizeof(uint32_t));
+        reader_->read((char *) &ndims32, sizeof(uint32_t));
+        npts_ = npts32;
+        ndims_ = ndims32;
+      }
+
+      LayoutBaseReader(const T *data, _u64 npts, _u64 ndims, _u64 stride)
+          : data_(data), npts_(npts), ndims_(ndims), stride_(stride) {
+      }
+
+      _u64 num_points() const {
+        return npts_;
+      }
+
+      _u64 dims() const {
+        return ndims_;
+      }
+
+      // copies the coords of the next node into `out`
+      void read_next(char *out) {
+        if (data_ != nullptr) {
+          memcpy(out, data_ + next_id_ * stride_, ndims_ * sizeof(T));
+        } else {
+          reader_->read(out, ndims_ * sizeof(T));
+        }
+        next_id_++;
+      }
+
+      // copies the coords of the nodes in `dests`, sorted by id, into their
+      // buffers. The base file is read front to back in large blocks, and
+      // the gaps between the requested nodes are skipped over.
+      void gather(const std::vector<std::pair<_u32, char *>> &dests) {
+        const _u64 node_size = ndims_ * sizeof(T);
+        if (data_ != nullptr) {
+          for (const auto &[id, out] : dests) {
+            memcpy(out, data_ + id * stride_, node_size);
+          }
+          return;
+        }
+        if (!gather_reader_.is_open()) {
+          gather_reader_.exceptions(std::ios::failbit | std::ios::badbit);
+          gather_reader_.open(base_file_, std::ios::binary);
+        }
+        const _u64 blk_nodes =
+            std::max<_u64>(1, kGatherBlockSize / node_size);
+        std::vector<char> blk(blk_nodes * node_size);
+        size_t            i = 0;
+        while (i < dests.size()) {
+          // the block starts at the next requested node
+          const _u64 first = dests[i].first;
+          const _u64 n = std::min<_u64>(blk_nodes, npts_ - first);
+          gather_reader_.seekg(2 * sizeof(uint32_t) + first * node_size);
+          gather_reader_.read(blk.data(), n * node_size);
+          for (; i < dests.size() && dests[i].first < first + n; ++i) {
+            memcpy(dests[i].second,
+                   blk.data() + (dests[i].first - first) * node_size,
+                   node_size);
+          }
+        }
+      }
+
+     private:
+      static constexpr _u64 kGatherBlockSize = 8 * 1024 * 1024;
+
+      std::string                      base_file_;
+      std::unique_ptr<cached_ifstream> reader_ = nullptr;
+      std::ifstream                    gather_reader_;
+      const T                         *data_ = nullptr;
+      _u64                             npts_ = 0;
+      _u64                             ndims_ = 0;
+      _u64                             stride_ = 0;
+      _u64                             next_id_ = 0;
+    };
+
+  }  // namespace
+
+  // writes the sector layout of the graph in `mem_index_file`, taking the
+  // coords of the nodes from `base_reader`
   template<typename T>
-  void create_disk_layout(const std::string base_file,
-                          const std::string mem_index_file,
-                          const std::string output_file,
-                          const std::string reorder_data_file) {
-    unsigned npts, ndims;
+  void write_disk_layout(LayoutBaseReader<T> &base_reader,
+                         const std::string    mem_index_file,
+                         const std::string    output_file,
+                         const std::string    reorder_data_file,
+                         const std::string    layout_file) {
+    unsigned npts = (unsigned) base_reader.num_points();
 
-    // amount to read or write in one shot
-    _u64            read_blk_size = 64 * 1024 * 1024;
-    _u64            write_blk_size = read_blk_size;
-    cached_ifstream base_reader(base_file, read_blk_size);
-    base_reader.read((char *) &npts, sizeof(uint32_t));
-    base_reader.read((char *) &ndims, sizeof(uint32_t));
+    // amount to write in one shot
+    _u64 write_blk_size = 64 * 1024 * 1024;
 
     size_t npts_64, ndims_64;
     npts_64 = npts;
-    ndims_64 = ndims;
+    ndims_64 = base_reader.dims();
 
     // Check if we need to append data for re-ordering
     bool          append_reorder_data = false;
@@ -970,6 +1150,10 @@ namespace diskann {
     diskann_writer.write(sector_buf.get(), SECTOR_LEN);
 
     if (long_node) {
+      if (layout_file != std::string("")) {
+        LOG_KNOWHERE_INFO_ << "Node spans multiple sectors, skip the "
+                              "locality-aware layout.";
+      }
       for (_u64 node_id = 0; node_id < npts_64; ++node_id) {
         memset(sector_buf.get(), 0, sector_buf_size);
         char *nnbrs = sector_buf.get() + ndims_64 * sizeof(T);
@@ -987,7 +1171,7 @@ namespace diskann {
         vamana_reader.read(nhood_buf, *((unsigned *) nnbrs) * sizeof(unsigned));
 
         // write coords of node first
-        base_reader.read((char *) sector_buf.get(), sizeof(T) * ndims_64);
+        base_reader.read_next(sector_buf.get());
 
         diskann_writer.write(sector_buf.get(), sector_buf_size);
       }
@@ -996,38 +1180,93 @@ namespace diskann {
     }
 
     LOG_KNOWHERE_DEBUG_ << "# sectors: " << n_sectors;
-    _u64 cur_node_id = 0;
-    for (_u64 sector = 0; sector < n_sectors; sector++) {
-      if (sector % 100000 == 0) {
-        LOG_KNOWHERE_DEBUG_ << "Sector #" << sector << "written";
+    if (layout_file != std::string("")) {
+      // the nodes are written out of order, so keep the graph in memory and
+      // fill the sectors in batches: the coords of all the nodes of a batch
+      // are gathered in id order, in one pass over the base file
+      std::vector<std::vector<unsigned>> graph(npts_64);
+      for (auto &nhood : graph) {
+        unsigned nnbrs;
+        vamana_reader.read((char *) &nnbrs, sizeof(unsigned));
+        nhood.resize(nnbrs);
+        vamana_reader.read((char *) nhood.data(), nnbrs * sizeof(unsigned));
       }
-      memset(sector_buf.get(), 0, SECTOR_LEN);
-      for (_u64 sector_node_id = 0;
-           sector_node_id < nnodes_per_sector && cur_node_id < npts_64;
-           sector_node_id++) {
-        char *sector_node_buf =
-            sector_buf.get() + (sector_node_id * max_node_len);
-        char *nnbrs = sector_node_buf + ndims_64 * sizeof(T);
-        char *nhood_buf =
-            sector_node_buf + (ndims_64 * sizeof(T)) + sizeof(unsigned);
+      auto layout =
+          generate_locality_layout(graph, nnodes_per_sector, medoid_u32);
 
-        // read cur node's nnbrs
-        vamana_reader.read(nnbrs, sizeof(unsigned));
+      std::vector<_u32> node_pos(npts_64);
+      for (_u64 pos = 0; pos < npts_64; ++pos) {
+        node_pos[layout[pos]] = pos;
+      }
+      diskann::save_bin<_u32>(layout_file, node_pos.data(), npts_64, 1);
+
+      constexpr _u64 kLayoutBatchSize = 256 * 1024 * 1024;
+      const _u64     batch_sectors = std::min<_u64>(
+          n_sectors, std::max<_u64>(1, kLayoutBatchSize / SECTOR_LEN));
+      std::unique_ptr<char[]> batch_buf =
+          std::make_unique<char[]>(batch_sectors * SECTOR_LEN);
+      std::vector<std::pair<_u32, char *>> dests;
+      dests.reserve(batch_sectors * nnodes_per_sector);
+      _u64 pos = 0;
+      for (_u64 sector = 0; sector < n_sectors; sector += batch_sectors) {
+        const _u64 n = std::min<_u64>(batch_sectors, n_sectors - sector);
+        memset(batch_buf.get(), 0, n * SECTOR_LEN);
+        dests.clear();
+        for (_u64 s = 0; s < n; ++s) {
+          for (_u64 sector_node_id = 0;
+               sector_node_id < nnodes_per_sector && pos < npts_64;
+               sector_node_id++, pos++) {
+            const auto  node_id = layout[pos];
+            const auto &nhood = graph[node_id];
+            char       *sector_node_buf = batch_buf.get() + s * SECTOR_LEN +
+                                    (sector_node_id * max_node_len);
+            *(unsigned *) (sector_node_buf + ndims_64 * sizeof(T)) =
+                nhood.size();
+            memcpy(sector_node_buf + (ndims_64 * sizeof(T)) + sizeof(unsigned),
+                   nhood.data(), nhood.size() * sizeof(unsigned));
+            dests.emplace_back(node_id, sector_node_buf);
+          }
+        }
+        std::sort(dests.begin(), dests.end());
+        base_reader.gather(dests);
+        diskann_writer.write(batch_buf.get(), n * SECTOR_LEN);
+      }
+      LOG_KNOWHERE_INFO_ << "Wrote disk index with locality-aware layout.";
+    } else {
+      _u64 cur_node_id = 0;
+      for (_u64 sector = 0; sector < n_sectors; sector++) {
+        if (sector % 100000 == 0) {
+          LOG_KNOWHERE_DEBUG_ << "Sector #" << sector << "written";
+        }
+        memset(sector_buf.get(), 0, SECTOR_LEN);
+        for (_u64 sector_node_id = 0;
+             sector_node_id < nnodes_per_sector && cur_node_id < npts_64;
+             sector_node_id++) {
+          char *sector_node_buf =
+              sector_buf.get() + (sector_node_id * max_node_len);
+          char *nnbrs = sector_node_buf + ndims_64 * sizeof(T);
+          char *nhood_buf =
+              sector_node_buf + (ndims_64 * sizeof(T)) + sizeof(unsigned);
 
-        // sanity checks on nnbrs
-        assert(static_cast<uint32_t>(*nnbrs) > 0);
-        assert(static_cast<uint32_t>(*nnbrs) <= width_u32);
+          // read cur node's nnbrs
+          vamana_reader.read(nnbrs, sizeof(unsigned));
 
-        // read node's nhood
-        vamana_reader.read(nhood_buf, *((unsigned *) nnbrs) * sizeof(unsigned));
+          // sanity checks on nnbrs
+          assert(static_cast<uint32_t>(*nnbrs) > 0);
+          assert(static_cast<uint32_t>(*nnbrs) <= width_u32);
 
-        // write coords of node first
-        base_reader.read(sector_node_buf, sizeof(T) * ndims_64);
+          // read node's nhood
+          vamana_reader.read(nhood_buf,
+                             *((unsigned *) nnbrs) * sizeof(unsigned));
+
+          // write coords of node first
+          base_reader.read_next(sector_node_buf);
 
-        cur_node_id++;
+          cur_node_id++;
+        }
+        // flush sector to disk
+        diskann_writer.write(sector_buf.get(), SECTOR_LEN);
       }
-      // flush sector to disk
-      diskann_writer.write(sector_buf.get(), SECTOR_LEN);
     }
     if (append_reorder_data) {
       diskann::cout << "Index written. Appending reorder data..." << std::endl;
@@ -1061,6 +1300,28 @@ namespace diskann {
     LOG_KNOWHERE_DEBUG_ << "Output file written.";
   }
 
+  template<typename T>
+  void create_disk_layout(const std::string base_file,
+                          const std::string mem_index_file,
+                          const std::string output_file,
+                          const std::string reorder_data_file,
+                          const std::string layout_file) {
+    LayoutBaseReader<T> base_reader(base_file, 64 * 1024 * 1024);
+    write_disk_layout<T>(base_reader, mem_index_file, output_file,
+                         reorder_data_file, layout_file);
+  }
+
+  template<typename T>
+  void create_disk_layout(const T *base_data, const _u64 npts,
+                          const _u64 ndims, const _u64 stride,
+                          const std::string mem_index_file,
+                          const std::string output_file,
+                          const std::string layout_file) {
+    LayoutBaseReader<T> base_reader(base_data, npts, ndims, stride);
+    write_disk_layout<T>(base_reader, mem_index_file, output_file, "",
+                         layout_file);
+  }
+
   template<typename T>
   int build_disk_index(const BuildConfig &config) {
     if (!knowhere::KnowhereFloatTypeCheck<T>::value &&
@@ -1101,10 +1362,78 @@ namespace diskann {
     // optional, used if build mem usage is enough to generate cached nodes
     std::string cached_nodes_file = get_cached_nodes_file(index_prefix_path);
 
+    unsigned R = config.max_degree;
+    unsigned L = config.search_list_size;
+    double   indexing_ram_budget = config.index_mem_gb;
+
+    // Vectors handed over in memory are sampled, encoded, linked and laid
+    // out on disk straight from memory: neither the raw nor the
+    // pre-processed base is written to disk. They are only spilled to a
+    // temporary file when the graph has to be built in shards or the disk
+    // index stores PQ data, as these steps stream from files.
+    const T *base_data = static_cast<const T *>(config.base_data);
+    bool     from_memory = base_data != nullptr;
+    bool     spilled = false;
+    // inner products add a coordinate to every vector
+    _u64 prepped_dim = config.compare_metric == diskann::Metric::INNER_PRODUCT
+                           ? config.base_dim + 1
+                           : config.base_dim;
+    if (from_memory) {
+      double full_index_ram = estimate_ram_usage(
+          config.base_num, (_u32) prepped_dim, sizeof(T), R);
+      if (use_disk_pq ||
+          full_index_ram >= indexing_ram_budget * 1024 * 1024 * 1024) {
+        base_file = index_prefix_path + "_spilled_base.bin";
+        LOG_KNOWHERE_INFO_ << "Spilling the base vectors to " << base_file
+                           << " to build from file.";
+        diskann::save_bin<T>(base_file, const_cast<T *>(base_data),
+                             config.base_num, config.base_dim);
+        data_file_to_use = base_file;
+        data_file_to_save = base_file;
+        from_memory = false;
+        spilled = true;
+      }
+    }
+    // Vectors in memory are pre-processed straight into the data of the
+    // graph index, rows get_aligned_dim() apart. That copy is the only one
+    // made of the base: PQ training and encoding read it too, and so does
+    // the disk layout for inner products.
+    std::unique_ptr<diskann::Index<T>> vamana_index = nullptr;
+    T                                 *index_data = nullptr;
+    const T                           *data_to_use = base_data;
+    const T                           *data_to_save = base_data;
+    _u64                               data_to_use_stride = config.base_dim;
+    _u64                               data_to_save_stride = config.base_dim;
+    if (from_memory) {
+      const bool ip = config.compare_metric == diskann::Metric::INNER_PRODUCT;
+      vamana_index = std::make_unique<diskann::Index<T>>(
+          diskann::Metric::L2, ip, prepped_dim, config.base_num, false, false);
+      index_data = vamana_index->get_data();
+      data_to_use = index_data;
+      data_to_use_stride = vamana_index->get_aligned_dim();
+      if (config.compare_metric == diskann::Metric::L2) {
+        for (_u64 i = 0; i < config.base_num; ++i) {
+          memcpy(index_data + i * data_to_use_stride,
+                 base_data + i * config.base_dim, config.base_dim * sizeof(T));
+        }
+      }
+    }
+
     // output a new base file which contains extra dimension with sqrt(1 -
     // ||x||^2/M^2) for every x, M is max norm of all points. Extra space on
     // disk needed!
-    if (config.compare_metric == diskann::Metric::INNER_PRODUCT) {
+    if (config.compare_metric == diskann::Metric::INNER_PRODUCT &&
+        from_memory) {
+      float max_norm_of_base = diskann::prepare_base_for_inner_products<T>(
+          base_data, config.base_num, config.base_dim, index_data,
+          data_to_use_stride);
+      data_to_save = data_to_use;
+      data_to_save_stride = data_to_use_stride;
+      std::string norm_file =
+          get_disk_index_max_base_norm_file(disk_index_path);
+      diskann::save_bin<float>(norm_file, &max_norm_of_base, 1, 1);
+      ip_prepared = true;
+    } else if (config.compare_metric == diskann::Metric::INNER_PRODUCT) {
       LOG_KNOWHERE_INFO_
           << "Using Inner Product search, so need to pre-process base "
              "data into temp file. Please ensure there is additional "
@@ -1120,7 +1449,15 @@ namespace diskann {
       diskann::save_bin<float>(norm_file, &max_norm_of_base, 1, 1);
       ip_prepared = true;
     }
-    if (config.compare_metric == diskann::Metric::COSINE) {
+    if (config.compare_metric == diskann::Metric::COSINE && from_memory) {
+      auto norms_of_base = diskann::prepare_base_for_cosine<T>(
+          base_data, config.base_num, config.base_dim, index_data,
+          data_to_use_stride);
+      std::string norm_file =
+          get_disk_index_max_base_norm_file(disk_index_path);
+      diskann::save_bin<float>(norm_file, norms_of_base.data(),
+                               norms_of_base.size(), 1);
+    } else if (config.compare_metric == diskann::Metric::COSINE) {
       LOG_KNOWHERE_INFO_
           << "Using Cosine search, so need to pre-process base "
              "data into temp file. Please ensure there is additional "
@@ -1136,16 +1473,12 @@ namespace diskann {
                                norms_of_base.size(), 1);
     }
 
-    unsigned R = config.max_degree;
-    unsigned L = config.search_list_size;
-
     double pq_code_size_limit = get_memory_budget(config.pq_code_size_gb);
     if (pq_code_size_limit <= 0) {
       LOG(ERROR) << "Insufficient memory budget (or string was not in right "
                     "format). Should be > 0.";
       return -1;
     }
-    double indexing_ram_budget = config.index_mem_gb;
     if (indexing_ram_budget <= 0) {
       LOG(ERROR) << "Not building index. Please provide more RAM budget";
       return -1;
@@ -1161,7 +1494,12 @@ namespace diskann {
 
     size_t points_num, dim;
 
-    diskann::get_bin_metadata(data_file_to_use.c_str(), points_num, dim);
+    if (from_memory) {
+      points_num = config.base_num;
+      dim = prepped_dim;
+    } else {
+      diskann::get_bin_metadata(data_file_to_use.c_str(), points_num, dim);
+    }
 
     size_t num_pq_chunks =
         (size_t) (std::floor)(_u64(pq_code_size_limit / points_num));
@@ -1178,8 +1516,14 @@ namespace diskann {
     double p_val = ((double) MAX_PQ_TRAINING_SET_SIZE / (double) points_num);
     // generates random sample and sets it to train_data and updates
     // train_size
-    gen_random_slice<T>(data_file_to_use.c_str(), p_val, train_data, train_size,
-                        train_dim);
+    if (from_memory) {
+      gen_random_slice<T>(data_to_use, points_num, dim, p_val, train_data,
+                          train_size, data_to_use_stride);
+      train_dim = dim;
+    } else {
+      gen_random_slice<T>(data_file_to_use.c_str(), p_val, train_data,
+                          train_size, train_dim);
+    }
 
     if (use_disk_pq) {
       if (disk_pq_dims > dim)
@@ -1216,9 +1560,16 @@ namespace diskann {
                        pq_pivots_path, make_zero_mean);
 
     LOG_KNOWHERE_INFO_ << "Encoding PQ data";
-    generate_pq_data_from_pivots<T>(data_file_to_use.c_str(), 256,
-                                    (uint32_t) num_pq_chunks, pq_pivots_path,
-                                    pq_compressed_vectors_path);
+    if (from_memory) {
+      generate_pq_data_from_pivots<T>(data_to_use, points_num, dim,
+                                      data_to_use_stride, 256,
+                                      (uint32_t) num_pq_chunks, pq_pivots_path,
+                                      pq_compressed_vectors_path);
+    } else {
+      generate_pq_data_from_pivots<T>(data_file_to_use.c_str(), 256,
+                                      (uint32_t) num_pq_chunks, pq_pivots_path,
+                                      pq_compressed_vectors_path);
+    }
     auto pq_e = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> pq_diff = pq_e - pq_s;
     LOG_KNOWHERE_INFO_ << "Training PQ codes cost: " << pq_diff.count() << "s";
@@ -1230,24 +1581,39 @@ namespace diskann {
 #endif
 
     auto graph_s = std::chrono::high_resolution_clock::now();
-    auto vamana_index = diskann::build_merged_vamana_index<T>(
-        data_file_to_use.c_str(), ip_prepared, diskann::Metric::L2, L, R,
-        config.accelerate_build, config.shuffle_build, p_val, indexing_ram_budget, mem_index_path,
-        medoids_path, centroids_path);
+    if (from_memory) {
+      build_vamana_index_in_place<T>(vamana_index.get(), points_num, L, R,
+                                     config.accelerate_build,
+                                     config.shuffle_build, mem_index_path);
+    } else {
+      vamana_index = diskann::build_merged_vamana_index<T>(
+          data_file_to_use.c_str(), ip_prepared, diskann::Metric::L2, L, R,
+          config.accelerate_build, config.shuffle_build, p_val,
+          indexing_ram_budget, mem_index_path, medoids_path, centroids_path);
+    }
     auto graph_e = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> graph_diff = graph_e - graph_s;
     LOG_KNOWHERE_INFO_ << "Training graph cost: " << graph_diff.count() << "s";
-    if (!use_disk_pq) {
+    std::string layout_path =
+        config.locality_layout
+            ? get_disk_index_layout_filename(disk_index_path)
+            : std::string("");
+    if (from_memory) {
+      diskann::create_disk_layout<T>(data_to_save, points_num, dim,
+                                     data_to_save_stride, mem_index_path,
+                                     disk_index_path, layout_path);
+    } else if (!use_disk_pq) {
       diskann::create_disk_layout<T>(data_file_to_save.c_str(), mem_index_path,
-                                     disk_index_path);
+                                     disk_index_path, "", layout_path);
     } else {
       if (!reorder_data)
         diskann::create_disk_layout<_u8>(disk_pq_compressed_vectors_path,
-                                         mem_index_path, disk_index_path);
+                                         mem_index_path, disk_index_path, "",
+                                         layout_path);
       else
-        diskann::create_disk_layout<_u8>(disk_pq_compressed_vectors_path,
-                                         mem_index_path, disk_index_path,
-                                         data_file_to_save.c_str());
+        diskann::create_disk_layout<_u8>(
+            disk_pq_compressed_vectors_path, mem_index_path, disk_index_path,
+            data_file_to_save.c_str(), layout_path);
     }
 
     double ten_percent_points = std::ceil(points_num * 0.1);
@@ -1255,8 +1621,13 @@ namespace diskann {
                                    ? MAX_SAMPLE_POINTS_FOR_WARMUP
                                    : ten_percent_points;
     double sample_sampling_rate = num_sample_points / points_num;
-    gen_random_slice<T>(base_file.c_str(), sample_data_file,
-                        sample_sampling_rate);
+    if (from_memory) {
+      gen_random_slice<T>(base_data, points_num, config.base_dim,
+                          sample_data_file, sample_sampling_rate);
+    } else {
+      gen_random_slice<T>(base_file.c_str(), sample_data_file,
+                          sample_sampling_rate);
+    }
 
     if (vamana_index != nullptr) {
       auto final_graph = vamana_index->get_graph();
@@ -1281,9 +1652,13 @@ namespace diskann {
     std::chrono::duration<double> diff = e - s;
     LOG_KNOWHERE_INFO_ << "Indexing time: " << diff.count() << std::endl;
 
-    if (config.compare_metric == diskann::Metric::INNER_PRODUCT) {
+    if (config.compare_metric == diskann::Metric::INNER_PRODUCT &&
+        !from_memory) {
       std::remove(data_file_to_use.c_str());
     }
+    if (spilled) {
+      std::remove(base_file.c_str());
+    }
     std::remove(mem_index_path.c_str());
     if (use_disk_pq)
       std::remove(disk_pq_compressed_vectors_path.c_str());
@@ -1293,20 +1668,50 @@ namespace diskann {
   template void create_disk_layout<int8_t>(const std::string base_file,
                                            const std::string mem_index_file,
                                            const std::string output_file,
-                                           const std::string reorder_data_file);
+                                           const std::string reorder_data_file,
+                                           const std::string layout_file);
   template void create_disk_layout<uint8_t>(
       const std::string base_file, const std::string mem_index_file,
-      const std::string output_file, const std::string reorder_data_file);
+      const std::string output_file, const std::string reorder_data_file,
+      const std::string layout_file);
   template void create_disk_layout<float>(const std::string base_file,
                                           const std::string mem_index_file,
                                           const std::string output_file,
-                                          const std::string reorder_data_file);
+                                          const std::string reorder_data_file,
+                                          const std::string layout_file);
   template void create_disk_layout<knowhere::fp16>(
       const std::string base_file, const std::string mem_index_file,
-      const std::string output_file, const std::string reorder_data_file);
+      const std::string output_file, const std::string reorder_data_file,
+      const std::string layout_file);
   template void create_disk_layout<knowhere::bf16>(
       const std::string base_file, const std::string mem_index_file,
-      const std::string output_file, const std::string reorder_data_file);
+      const std::string output_file, const std::string reorder_data_file,
+      const std::string layout_file);
+  template void create_disk_layout<int8_t>(
+      const int8_t *base_data, const _u64 npts, const _u64 ndims,
+      const _u64 stride, const std::string mem_index_file,
+      const std::string output_file,
+      const std::string layout_file);
+  template void create_disk_layout<uint8_t>(
+      const uint8_t *base_data, const _u64 npts, const _u64 ndims,
+      const _u64 stride, const std::string mem_index_file,
+      const std::string output_file,
+      const std::string layout_file);
+  template void create_disk_layout<float>(
+      const float *base_data, const _u64 npts, const _u64 ndims,
+      const _u64 stride, const std::string mem_index_file,
+      const std::string output_file,
+      const std::string layout_file);
+  template void create_disk_layout<knowhere::fp16>(
+      const knowhere::fp16 *base_data, const _u64 npts, const _u64 ndims,
+      const _u64 stride, const std::string mem_index_file,
+      const std::string output_file,
+      const std::string layout_file);
+  template void create_disk_layout<knowhere::bf16>(
+      const knowhere::bf16 *base_data, const _u64 npts, const _u64 ndims,
+      const _u64 stride, const std::string mem_index_file,
+      const std::string output_file,
+      const std::string layout_file);
 
   template int8_t  *load_warmup<int8_t>(const std::string &cache_warmup_file,
                                        uint64_t          &warmup_num,
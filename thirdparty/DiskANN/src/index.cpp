@@ -1681,6 +1681,94 @@ namespace diskann {
     }
   }
 
+  template<typename T, typename TagT>
+  void Index<T, TagT>::build_with_data_populated(Parameters &parameters) {
+    generate_frozen_point();
+    link(parameters);  // Primary func for creating nsg graph
+
+    if (_support_eager_delete) {
+      update_in_graph();  // copying values to in_graph
+    }
+
+    size_t max = 0, min = 1 << 30, total = 0, cnt = 0;
+    for (size_t i = 0; i < _nd; i++) {
+      auto &pool = _final_graph[i];
+      max = (std::max)(max, pool.size());
+      min = (std::min)(min, pool.size());
+      total += pool.size();
+      if (pool.size() < 2)
+        cnt++;
+    }
+    if (min > max)
+      min = max;
+    if (_nd > 0) {
+      LOG_KNOWHERE_INFO_ << "Index built with degree: max:" << max << "  avg:"
+                         << (float) total / (float) (_nd + _num_frozen_pts)
+                         << "  min:" << min << "  count(deg<2):" << cnt;
+    }
+    _width = (std::max)((unsigned) max, _width);
+    _has_built = true;
+  }
+
+  template<typename T, typename TagT>
+  void Index<T, TagT>::build(const T *data, const size_t num_points_to_load,
+                             Parameters &parameters) {
+    if (num_points_to_load > _max_points) {
+      std::stringstream stream;
+      stream << "ERROR: Driver requests loading " << num_points_to_load
+             << " points, but index can support only " << _max_points
+             << " points as specified in constructor." << std::endl;
+      LOG(ERROR) << stream.str();
+      aligned_free(_data);
+      throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__,
+                                  __LINE__);
+    }
+
+    for (size_t i = 0; i < num_points_to_load; i++) {
+      memcpy(_data + i * _aligned_dim, data + i * _dim, _dim * sizeof(T));
+      memset((void *) (_data + i * _aligned_dim + _dim), 0,
+             (_aligned_dim - _dim) * sizeof(T));
+    }
+    LOG_KNOWHERE_INFO_ << "Copied " << num_points_to_load
+                       << " points from memory.";
+    build_in_place(num_points_to_load, parameters);
+  }
+
+  template<typename T, typename TagT>
+  void Index<T, TagT>::build_in_place(const size_t num_points_to_load,
+                                      Parameters  &parameters) {
+    if (num_points_to_load > _max_points) {
+      std::stringstream stream;
+      stream << "ERROR: Driver requests building on " << num_points_to_load
+             << " points, but index can support only " << _max_points
+             << " points as specified in constructor." << std::endl;
+      LOG(ERROR) << stream.str();
+      aligned_free(_data);
+      throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__,
+                                  __LINE__);
+    }
+    if (_enable_tags) {
+      std::stringstream stream;
+      stream << "ERROR: Building from memory does not support tags."
+             << std::endl;
+      LOG(ERROR) << stream.str();
+      aligned_free(_data);
+      throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__,
+                                  __LINE__);
+    }
+
+    if (_normalize_vecs) {
+      for (size_t i = 0; i < num_points_to_load; i++) {
+        normalize(_data + _aligned_dim * i, _aligned_dim);
+      }
+    }
+    LOG_KNOWHERE_INFO_ << "Building start on " << num_points_to_load
+                       << " points in memory.";
+    _nd = num_points_to_load;
+
+    build_with_data_populated(parameters);
+  }
+
   template<typename T, typename TagT>
   void Index<T, TagT>::build(const char              *filename,
                              const size_t             num_points_to_load,
@@ -1753,31 +1841,7 @@ namespace diskann {
       }
     }
 
-    generate_frozen_point();
-    link(parameters);  // Primary func for creating nsg graph
-
-    if (_support_eager_delete) {
-      update_in_graph();  // copying values to in_graph
-    }
-
-    size_t max = 0, min = 1 << 30, total = 0, cnt = 0;
-    for (size_t i = 0; i < _nd; i++) {
-      auto &pool = _final_graph[i];
-      max = (std::max)(max, pool.size());
-      min = (std::min)(min, pool.size());
-      total += pool.size();
-      if (pool.size() < 2)
-        cnt++;
-    }
-    if (min > max)
-      min = max;
-    if (_nd > 0) {
-      LOG_KNOWHERE_INFO_ << "Index built with degree: max:" << max << "  avg:"
-                         << (float) total / (float) (_nd + _num_frozen_pts)
-                         << "  min:" << min << "  count(deg<2):" << cnt;
-    }
-    _width = (std::max)((unsigned) max, _width);
-    _has_built = true;
+    build_with_data_populated(parameters);
   }
 
   template<typename T, typename TagT>
@@ -1864,31 +1928,7 @@ namespace diskann {
       }
     }
 
-    generate_frozen_point();
-    link(parameters);  // Primary func for creating nsg graph
-
-    if (_support_eager_delete) {
-      update_in_graph();  // copying values to in_graph
-    }
-
-    size_t max = 0, min = 1 << 30, total = 0, cnt = 0;
-    for (size_t i = 0; i < _nd; i++) {
-      auto &pool = _final_graph[i];
-      max = (std::max)(max, pool.size());
-      min = (std::min)(min, pool.size());
-      total += pool.size();
-      if (pool.size() < 2)
-        cnt++;
-    }
-    if (min > max)
-      min = max;
-    if (_nd > 0) {
-      LOG_KNOWHERE_INFO_ << "Index built with degree: max:" << max << "  avg:"
-                         << (float) total / (float) (_nd + _num_frozen_pts)
-                         << "  min:" << min << "  count(deg<2):" << cnt;
-    }
-    _width = (std::max)((unsigned) max, _width);
-    _has_built = true;
+    build_with_data_populated(parameters);
   }
 
   template<typename T, typename TagT>
@@ -0,0 +1,79 @@
+#include "diskann/inflight_read_table.h"
+
+#include <condition_variable>
+#include <cstring>
+
+namespace {
+  constexpr size_t kNumShards = 16;
+}  // namespace
+
+namespace diskann {
+  struct InflightReadTable::Ticket {
+    std::mutex              mtx;
+    std::condition_variable cv;
+    bool                    done = false;
+    bool                    failed = false;
+    _u32                    n_waiters = 0;
+    // only allocated if another search joined the read
+    std::unique_ptr<char[]> data = nullptr;
+  };
+
+  InflightReadTable::InflightReadTable(_u64 read_len)
+      : read_len_(read_len), shards_(kNumShards) {
+  }
+
+  bool InflightReadTable::acquire(_u64 offset, TicketPtr &ticket) {
+    auto                       &shard = shard_of(offset);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto                        iter = shard.reads.find(offset);
+    if (iter != shard.reads.end()) {
+      ticket = iter->second;
+      std::lock_guard<std::mutex> ticket_lock(ticket->mtx);
+      ticket->n_waiters++;
+      return false;
+    }
+    ticket = std::make_shared<Ticket>();
+    shard.reads.emplace(offset, ticket);
+    return true;
+  }
+
+  void InflightReadTable::complete(_u64 offset, const TicketPtr &ticket,
+                                   const char *buf) {
+    finish(offset, ticket, buf);
+  }
+
+  void InflightReadTable::abort(_u64 offset, const TicketPtr &ticket) {
+    finish(offset, ticket, nullptr);
+  }
+
+  void InflightReadTable::finish(_u64 offset, const TicketPtr &ticket,
+                                 const char *buf) {
+    {
+      // no one can join once the read is out of the table
+      auto                       &shard = shard_of(offset);
+      std::lock_guard<std::mutex> lock(shard.mtx);
+      shard.reads.erase(offset);
+    }
+    {
+      std::lock_guard<std::mutex> lock(ticket->mtx);
+      if (buf == nullptr) {
+        ticket->failed = true;
+      } else if (ticket->n_waiters > 0) {
+        ticket->data.reset(new char[read_len_]);
+        memcpy(ticket->data.get(), buf, read_len_);
+      }
+      ticket->done = true;
+    }
+    ticket->cv.notify_all();
+  }
+
+  bool InflightReadTable::wait(const TicketPtr &ticket, char *out) {
+    std::unique_lock<std::mutex> lock(ticket->mtx);
+    ticket->cv.wait(lock, [&] { return ticket->done; });
+    if (ticket->failed) {
+      return false;
+    }
+    memcpy(out, ticket->data.get(), read_len_);
+    return true;
+  }
+}  // namespace diskann
@@ -163,17 +163,17 @@ void LinuxAlignedFileReader::close() {
 }
 
 void LinuxAlignedFileReader::read(std::vector<AlignedRead> &read_reqs,
-                                  io_context_t &ctx, bool async) {
+                                  IOContext &ctx, bool async) {
   if (async == true) {
     diskann::cout << "Async currently not supported in linux." << std::endl;
   }
   assert(this->file_desc != -1);
 
-  execute_io(ctx, this->ctx_pool_->max_events_per_ctx(), this->file_desc,
-             read_reqs);
+  execute_io(static_cast<io_context_t>(ctx),
+             this->ctx_pool_->max_events_per_ctx(), this->file_desc, read_reqs);
 }
 
-void LinuxAlignedFileReader::submit_req(io_context_t             &ctx,
+void LinuxAlignedFileReader::submit_req(IOContext                &ctx,
                                         std::vector<AlignedRead> &read_reqs) {
   const auto maxnr = this->ctx_pool_->max_events_per_ctx();
   if (read_reqs.size() > maxnr) {
@@ -183,14 +183,18 @@ void LinuxAlignedFileReader::submit_req(io_context_t             &ctx,
         << maxnr << ")";
     throw diskann::ANNException(err.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
   }
-  const auto n_ops = read_reqs.size();
-  const int  fd = this->file_desc;
+  const auto   n_ops = read_reqs.size();
+  const int    fd = this->file_desc;
+  io_context_t aio_ctx = static_cast<io_context_t>(ctx);
 
   std::vector<iocb_t *>    cbs(n_ops, nullptr);
   std::vector<struct iocb> cb(n_ops);
   for (size_t j = 0; j < n_ops; j++) {
     io_prep_pread(cb.data() + j, fd, read_reqs[j].buf, read_reqs[j].len,
                   read_reqs[j].offset);
+    // the kernel hands `data` back in io_event, so pipelined readers can map
+    // a completion to its request without keeping the iocb alive
+    cb[j].data = read_reqs[j].buf;
   }
   for (uint64_t i = 0; i < n_ops; i++) {
     cbs[i] = cb.data() + i;
@@ -199,7 +203,7 @@ void LinuxAlignedFileReader::submit_req(io_context_t             &ctx,
   int64_t ret;
   uint64_t num_submitted = 0, submit_retry = 0;
   while (num_submitted < n_ops) {
-    while ((ret = io_submit(ctx, n_ops - num_submitted,
+    while ((ret = io_submit(aio_ctx, n_ops - num_submitted,
                             cbs.data() + num_submitted)) < 0) {
       if (-ret != EINTR) {
         std::stringstream err;
@@ -225,7 +229,7 @@ void LinuxAlignedFileReader::submit_req(io_context_t             &ctx,
   }
 }
 
-void LinuxAlignedFileReader::get_submitted_req(io_context_t &ctx, size_t n_ops) {
+void LinuxAlignedFileReader::get_submitted_req(IOContext &ctx, size_t n_ops) {
   if (n_ops > this->ctx_pool_->max_events_per_ctx()) {
     std::stringstream err;
     err << "Async does not support getting number of read requests (" << n_ops
@@ -237,8 +241,9 @@ void LinuxAlignedFileReader::get_submitted_req(io_context_t &ctx, size_t n_ops)
   int64_t ret;
   uint64_t                 num_read = 0, read_retry = 0;
   std::vector<io_event_t> evts(n_ops);
+  io_context_t            aio_ctx = static_cast<io_context_t>(ctx);
   while (num_read < n_ops) {
-    while ((ret = io_getevents(ctx, n_ops - num_read, n_ops - num_read,
+    while ((ret = io_getevents(aio_ctx, n_ops - num_read, n_ops - num_read,
                                evts.data() + num_read, nullptr)) < 0) {
       if (-ret != EINTR) {
         std::stringstream err;
@@ -262,4 +267,35 @@ void LinuxAlignedFileReader::get_submitted_req(io_context_t &ctx, size_t n_ops)
       }
     }
   }
-}
\ No newline at end of file
+}
+size_t LinuxAlignedFileReader::poll_submitted_req(
+    IOContext &ctx, size_t min_nr, size_t max_nr,
+    std::vector<void *> &done_bufs) {
+  if (max_nr > this->ctx_pool_->max_events_per_ctx()) {
+    std::stringstream err;
+    err << "Async does not support polling number of read requests ("
+        << max_nr << ") exceeds max number of events per context ("
+        << this->ctx_pool_->max_events_per_ctx() << ")";
+    throw diskann::ANNException(err.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+  }
+  if (max_nr == 0) {
+    return 0;
+  }
+
+  int64_t                 ret;
+  std::vector<io_event_t> evts(max_nr);
+  io_context_t            aio_ctx = static_cast<io_context_t>(ctx);
+  while ((ret = io_getevents(aio_ctx, min_nr, max_nr, evts.data(), nullptr)) < 0) {
+    if (-ret != EINTR) {
+      std::stringstream err;
+      err << "Unknown error occur in io_getevents, errno: " << -ret << ", "
+          << strerror(-ret);
+      throw diskann::ANNException(err.str(), -1, __FUNCSIG__, __FILE__,
+                                  __LINE__);
+    }
+  }
+  for (int64_t i = 0; i < ret; i++) {
+    done_bufs.push_back(evts[i].data);
+  }
+  return (size_t) ret;
+}
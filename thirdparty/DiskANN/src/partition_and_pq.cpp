@@ -11,6 +11,7 @@
 #include <cmath>
 #include <cstdio>
 #include <ctime>
+#include <functional>
 #include <future>
 #include <iostream>
 #include <iomanip>
@@ -95,6 +96,38 @@ void gen_random_slice(const std::string base_file,
                       << " points to sample file: " << output_file;
 }
 
+// same as above, but samples the npts x ndims vectors of `inputdata`
+template<typename T>
+void gen_random_slice(const T *inputdata, size_t npts, size_t ndims,
+                      const std::string output_file, double sampling_rate) {
+  std::ofstream sample_writer(output_file.c_str(), std::ios::binary);
+
+  std::random_device rd;
+  auto               x = rd();
+  std::mt19937       generator(x);
+  std::uniform_real_distribution<float> distribution(0, 1);
+
+  uint32_t npts_u32 = (uint32_t) npts, nd_u32 = (uint32_t) ndims;
+  uint32_t num_sampled_pts_u32 = 0;
+  LOG_KNOWHERE_DEBUG_ << "Sampling base in memory. #points: " << npts_u32
+                      << ". #dim: " << nd_u32 << ".";
+  sample_writer.write((char *) &num_sampled_pts_u32, sizeof(uint32_t));
+  sample_writer.write((char *) &nd_u32, sizeof(uint32_t));
+
+  for (size_t i = 0; i < npts; i++) {
+    float sample = distribution(generator);
+    if (sample < sampling_rate) {
+      sample_writer.write((char *) (inputdata + i * ndims), sizeof(T) * ndims);
+      num_sampled_pts_u32++;
+    }
+  }
+  sample_writer.seekp(0, std::ios::beg);
+  sample_writer.write((char *) &num_sampled_pts_u32, sizeof(uint32_t));
+  sample_writer.close();
+  LOG_KNOWHERE_DEBUG_ << "Wrote " << num_sampled_pts_u32
+                      << " points to sample file: " << output_file;
+}
+
 // streams data from the file, and samples each vector with probability p_val
 // and returns a matrix of size slice_size* ndims as floating point type.
 // the slice_size and ndims are set inside the function.
@@ -152,9 +185,11 @@ void gen_random_slice(const std::string data_file, double p_val,
 // npts*ndims to return sampled_data of size slice_size*ndims.
 template<typename T>
 void gen_random_slice(const T *inputdata, size_t npts, size_t ndims,
-                      double p_val, std::unique_ptr<float[]> &sampled_data, size_t &slice_size) {
+                      double p_val, std::unique_ptr<float[]> &sampled_data,
+                      size_t &slice_size, size_t stride) {
   std::vector<std::vector<float>> sampled_vectors;
   const T                        *cur_vector_T;
+  stride = stride == 0 ? ndims : stride;
 
   p_val = p_val < 1 ? p_val : 1;
 
@@ -166,7 +201,7 @@ void gen_random_slice(const T *inputdata, size_t npts, size_t ndims,
   std::uniform_real_distribution<float> distribution(0, 1);
 
   for (size_t i = 0; i < npts; i++) {
-    cur_vector_T = inputdata + ndims * i;
+    cur_vector_T = inputdata + stride * i;
     float rnd_val = distribution(generator);
     if (rnd_val < p_val) {
       std::vector<float> cur_vector_float;
@@ -380,25 +415,14 @@ int generate_pq_pivots(const float *passed_train_data, size_t num_train,
   return 0;
 }
 
-// streams the base file (data_file), and computes the closest centers in each
-// chunk to generate the compressed data_file and stores it in
-// pq_compressed_vectors_path.
-// If the numbber of centers is < 256, it stores as byte vector, else as 4-byte
-// vector in binary format.
-template<typename T>
-int generate_pq_data_from_pivots(const std::string data_file,
-                                 unsigned num_centers, unsigned num_pq_chunks,
-                                 std::string pq_pivots_path,
-                                 std::string pq_compressed_vectors_path) {
-  _u64            read_blk_size = 64 * 1024 * 1024;
-  cached_ifstream base_reader(data_file, read_blk_size);
-  _u32            npts32;
-  _u32            basedim32;
-  base_reader.read((char *) &npts32, sizeof(uint32_t));
-  base_reader.read((char *) &basedim32, sizeof(uint32_t));
-  size_t num_points = npts32;
-  size_t dim = basedim32;
-
+// computes the closest centers in each chunk of the num_points x dim base
+// vectors, which `read_block(start_id, n, out)` hands out as floats one block
+// at a time
+static int generate_pq_data_from_pivots_impl(
+    size_t num_points, size_t dim,
+    const std::function<void(size_t, size_t, float *)> &read_block,
+    unsigned num_centers, unsigned num_pq_chunks, std::string pq_pivots_path,
+    std::string pq_compressed_vectors_path) {
   std::unique_ptr<float[]>    full_pivot_data;
   std::unique_ptr<float[]>    centroid;
   std::unique_ptr<uint32_t[]> rearrangement;
@@ -479,7 +503,8 @@ int generate_pq_data_from_pivots(const std::string data_file,
 #ifdef SAVE_INFLATED_PQ
   std::ofstream inflated_file_writer(inflated_pq_file, std::ios::binary);
   inflated_file_writer.write((char *) &num_points, sizeof(uint32_t));
-  inflated_file_writer.write((char *) &basedim32, sizeof(uint32_t));
+  _u32 dim32 = (_u32) dim;
+  inflated_file_writer.write((char *) &dim32, sizeof(uint32_t));
 
   std::unique_ptr<float[]> block_inflated_base =
       std::make_unique<float[]>(block_size * dim);
@@ -491,7 +516,6 @@ int generate_pq_data_from_pivots(const std::string data_file,
   std::memset(block_compressed_base.get(), 0,
               block_size * (_u64) num_pq_chunks * sizeof(uint32_t));
 
-  std::unique_ptr<T[]> block_data_T = std::make_unique<T[]>(block_size * dim);
   std::unique_ptr<float[]> block_data_float =
       std::make_unique<float[]>(block_size * dim);
 
@@ -505,10 +529,7 @@ int generate_pq_data_from_pivots(const std::string data_file,
     size_t end_id = (std::min)((block + 1) * block_size, num_points);
     size_t cur_blk_size = end_id - start_id;
 
-    base_reader.read((char *) (block_data_T.get()),
-                     sizeof(T) * (cur_blk_size * dim));
-    diskann::convert_types<T, float>(block_data_T.get(), block_data_float.get(),
-                                     cur_blk_size, dim);
+    read_block(start_id, cur_blk_size, block_data_float.get());
 
     LOG_KNOWHERE_DEBUG_ << "Processing points  [" << start_id << ", " << end_id
                         << ")..";
@@ -614,6 +635,57 @@ int generate_pq_data_from_pivots(const std::string data_file,
   return 0;
 }
 
+// streams the base file (data_file), and computes the closest centers in each
+// chunk to generate the compressed data_file and stores it in
+// pq_compressed_vectors_path.
+// If the numbber of centers is < 256, it stores as byte vector, else as 4-byte
+// vector in binary format.
+template<typename T>
+int generate_pq_data_from_pivots(const std::string data_file,
+                                 unsigned num_centers, unsigned num_pq_chunks,
+                                 std::string pq_pivots_path,
+                                 std::string pq_compressed_vectors_path) {
+  _u64            read_blk_size = 64 * 1024 * 1024;
+  cached_ifstream base_reader(data_file, read_blk_size);
+  _u32            npts32;
+  _u32            basedim32;
+  base_reader.read((char *) &npts32, sizeof(uint32_t));
+  base_reader.read((char *) &basedim32, sizeof(uint32_t));
+  size_t num_points = npts32;
+  size_t dim = basedim32;
+
+  size_t block_size = num_points <= BLOCK_SIZE ? num_points : BLOCK_SIZE;
+  std::unique_ptr<T[]> block_data_T = std::make_unique<T[]>(block_size * dim);
+  auto read_block = [&](size_t start_id, size_t n, float *out) {
+    base_reader.read((char *) (block_data_T.get()), sizeof(T) * (n * dim));
+    diskann::convert_types<T, float>(block_data_T.get(), out, n, dim);
+  };
+  return generate_pq_data_from_pivots_impl(num_points, dim, read_block,
+                                           num_centers, num_pq_chunks,
+                                           pq_pivots_path,
+                                           pq_compressed_vectors_path);
+}
+
+// same as above, but encodes the npts x ndims vectors of `data`, `stride`
+// apart
+template<typename T>
+int generate_pq_data_from_pivots(const T *data, size_t npts, size_t ndims,
+                                 size_t stride, unsigned num_centers,
+                                 unsigned num_pq_chunks,
+                                 std::string pq_pivots_path,
+                                 std::string pq_compressed_vectors_path) {
+  auto read_block = [&](size_t start_id, size_t n, float *out) {
+    for (size_t i = 0; i < n; ++i) {
+      diskann::convert_types<T, float>(data + (start_id + i) * stride,
+                                       out + i * ndims, 1, ndims);
+    }
+  };
+  return generate_pq_data_from_pivots_impl(npts, ndims, read_block,
+                                           num_centers, num_pq_chunks,
+                                           pq_pivots_path,
+                                           pq_compressed_vectors_path);
+}
+
 int estimate_cluster_sizes(float *test_data_float, size_t num_test,
                            const float *pivots, const size_t num_centers,
                            const size_t test_dim, const size_t k_base,
@@ -1061,25 +1133,37 @@ template void gen_random_slice<knowhere::fp16>(const std::string base_file,
 template void gen_random_slice<knowhere::bf16>(const std::string base_file,
                                                const std::string output_file,
                                                double            sampling_rate);
-
-template void gen_random_slice<float>(const float *inputdata, size_t npts,
-                                      size_t ndims, double p_val,
-                                      std::unique_ptr<float[]> &sampled_data,
-                                      size_t                 &slice_size);
-template void gen_random_slice<uint8_t>(const uint8_t *inputdata, size_t npts,
-                                        size_t ndims, double p_val,
-                                        std::unique_ptr<float[]> &sampled_data,
-                                        size_t                 &slice_size);
-template void gen_random_slice<int8_t>(const int8_t *inputdata, size_t npts,
-                                       size_t ndims, double p_val,
-                                       std::unique_ptr<float[]> &sampled_data,
-                                       size_t                   &slice_size);
+template void gen_random_slice<int8_t>(
+    const int8_t *inputdata, size_t npts, size_t ndims,
+    const std::string output_file, double sampling_rate);
+template void gen_random_slice<uint8_t>(
+    const uint8_t *inputdata, size_t npts, size_t ndims,
+    const std::string output_file, double sampling_rate);
+template void gen_random_slice<float>(
+    const float *inputdata, size_t npts, size_t ndims,
+    const std::string output_file, double sampling_rate);
+template void gen_random_slice<knowhere::fp16>(
+    const knowhere::fp16 *inputdata, size_t npts, size_t ndims,
+    const std::string output_file, double sampling_rate);
+template void gen_random_slice<knowhere::bf16>(
+    const knowhere::bf16 *inputdata, size_t npts, size_t ndims,
+    const std::string output_file, double sampling_rate);
+
+template void gen_random_slice<float>(
+    const float *inputdata, size_t npts, size_t ndims, double p_val,
+    std::unique_ptr<float[]> &sampled_data, size_t &slice_size, size_t stride);
+template void gen_random_slice<uint8_t>(
+    const uint8_t *inputdata, size_t npts, size_t ndims, double p_val,
+    std::unique_ptr<float[]> &sampled_data, size_t &slice_size, size_t stride);
+template void gen_random_slice<int8_t>(
+    const int8_t *inputdata, size_t npts, size_t ndims, double p_val,
+    std::unique_ptr<float[]> &sampled_data, size_t &slice_size, size_t stride);
 template void gen_random_slice<knowhere::fp16>(
     const knowhere::fp16 *inputdata, size_t npts, size_t ndims, double p_val,
-    std::unique_ptr<float[]> &sampled_data, size_t &slice_size);
+    std::unique_ptr<float[]> &sampled_data, size_t &slice_size, size_t stride);
 template void gen_random_slice<knowhere::bf16>(
     const knowhere::bf16 *inputdata, size_t npts, size_t ndims, double p_val,
-    std::unique_ptr<float[]> &sampled_data, size_t &slice_size);
+    std::unique_ptr<float[]> &sampled_data, size_t &slice_size, size_t stride);
 template void gen_random_slice<float>(const std::string data_file, double p_val,
                                       std::unique_ptr<float[]> &sampled_data,
                                       size_t &slice_size, size_t &ndims);
@@ -1164,3 +1248,23 @@ template int generate_pq_data_from_pivots<knowhere::fp16>(
 template int generate_pq_data_from_pivots<knowhere::bf16>(
     const std::string data_file, unsigned num_centers, unsigned num_pq_chunks,
     std::string pq_pivots_path, std::string pq_compressed_vectors_path);
+template int generate_pq_data_from_pivots<int8_t>(
+    const int8_t *data, size_t npts, size_t ndims, size_t stride,
+    unsigned num_centers, unsigned num_pq_chunks, std::string pq_pivots_path,
+    std::string pq_compressed_vectors_path);
+template int generate_pq_data_from_pivots<uint8_t>(
+    const uint8_t *data, size_t npts, size_t ndims, size_t stride,
+    unsigned num_centers, unsigned num_pq_chunks, std::string pq_pivots_path,
+    std::string pq_compressed_vectors_path);
+template int generate_pq_data_from_pivots<float>(
+    const float *data, size_t npts, size_t ndims, size_t stride,
+    unsigned num_centers, unsigned num_pq_chunks, std::string pq_pivots_path,
+    std::string pq_compressed_vectors_path);
+template int generate_pq_data_from_pivots<knowhere::fp16>(
+    const knowhere::fp16 *data, size_t npts, size_t ndims, size_t stride,
+    unsigned num_centers, unsigned num_pq_chunks, std::string pq_pivots_path,
+    std::string pq_compressed_vectors_path);
+template int generate_pq_data_from_pivots<knowhere::bf16>(
+    const knowhere::bf16 *data, size_t npts, size_t ndims, size_t stride,
+    unsigned num_centers, unsigned num_pq_chunks, std::string pq_pivots_path,
+    std::string pq_compressed_vectors_path);
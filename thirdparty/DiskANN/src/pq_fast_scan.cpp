@@ -0,0 +1,208 @@
+#include "diskann/pq_fast_scan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "faiss/impl/pq4_fast_scan.h"
+#include "faiss/impl/simd_result_handlers.h"
+
+namespace {
+  constexpr _u64     kNumCodes = 256;
+  constexpr unsigned kMaxKmeansIters = 20;
+
+  // Weighted k-means of the `kNumCodes` sub-vectors of one half chunk,
+  // stored column-major in `tables_T` (dim j of code i at j * 256 + i).
+  // Writes the centers to `centers_T` and the assignment to `assign`.
+  void cluster_half_chunk(const float *tables_T, _u32 dim_begin,
+                          _u32 dim_end, const std::vector<_u64> &weights,
+                          float *centers_T, _u8 *assign) {
+    constexpr _u64 k = diskann::FastScanPQTable::kNumCenters;
+    const _u64     dim = dim_end - dim_begin;
+    auto sub = [&](_u64 code, _u64 d) {
+      return tables_T[(dim_begin + d) * kNumCodes + code];
+    };
+    auto center = [&](_u64 c, _u64 d) -> float & {
+      return centers_T[(dim_begin + d) * k + c];
+    };
+
+    // seed with the most used codes, they matter most for the distances
+    std::vector<_u64> order(kNumCodes);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](_u64 a, _u64 b) { return weights[a] > weights[b]; });
+    for (_u64 c = 0; c < k; ++c) {
+      for (_u64 d = 0; d < dim; ++d) {
+        center(c, d) = sub(order[c], d);
+      }
+    }
+
+    std::vector<double> sums(k * dim);
+    std::vector<double> counts(k);
+    for (unsigned iter = 0; iter < kMaxKmeansIters; ++iter) {
+      bool changed = false;
+      for (_u64 code = 0; code < kNumCodes; ++code) {
+        _u8   best = 0;
+        float best_dist = std::numeric_limits<float>::max();
+        for (_u64 c = 0; c < k; ++c) {
+          float dist = 0;
+          for (_u64 d = 0; d < dim; ++d) {
+            const float diff = sub(code, d) - center(c, d);
+            dist += diff * diff;
+          }
+          if (dist < best_dist) {
+            best_dist = dist;
+            best = (_u8) c;
+          }
+        }
+        changed |= iter == 0 || assign[code] != best;
+        assign[code] = best;
+      }
+      if (!changed) {
+        break;
+      }
+      std::fill(sums.begin(), sums.end(), 0.0);
+      std::fill(counts.begin(), counts.end(), 0.0);
+      for (_u64 code = 0; code < kNumCodes; ++code) {
+        // unused codes still get a small say so that no center is left empty
+        const double w = weights[code] + 1e-3;
+        counts[assign[code]] += w;
+        for (_u64 d = 0; d < dim; ++d) {
+          sums[assign[code] * dim + d] += w * sub(code, d);
+        }
+      }
+      for (_u64 c = 0; c < k; ++c) {
+        if (counts[c] == 0) {
+          continue;
+        }
+        for (_u64 d = 0; d < dim; ++d) {
+          center(c, d) = (float) (sums[c * dim + d] / counts[c]);
+        }
+      }
+    }
+  }
+}  // namespace
+
+namespace diskann {
+  void FastScanPQTable::build(const FixedChunkPQTable &pq_table,
+                              const _u8 *codes, _u64 n_pts) {
+    n_chunks_ = pq_table.n_chunks;
+    const _u64 ndims = pq_table.ndims;
+    rearrangement_.assign(pq_table.rearrangement.get(),
+                          pq_table.rearrangement.get() + ndims);
+    centroid_.assign(pq_table.centroid.get(),
+                     pq_table.centroid.get() + ndims);
+    centers_T_.assign(ndims * kNumCenters, 0);
+    code_map_.assign(n_chunks_ * kNumCodes, 0);
+    sub_offsets_.resize(2 * n_chunks_ + 1);
+
+    std::vector<_u64> weights(kNumCodes);
+    std::vector<_u8>  assign(kNumCodes);
+    for (_u64 chunk = 0; chunk < n_chunks_; ++chunk) {
+      const _u32 begin = pq_table.chunk_offsets[chunk];
+      const _u32 end = pq_table.chunk_offsets[chunk + 1];
+      const _u32 mid = begin + (end - begin + 1) / 2;
+      sub_offsets_[2 * chunk] = begin;
+      sub_offsets_[2 * chunk + 1] = mid;
+      sub_offsets_[2 * chunk + 2] = end;
+
+      std::fill(weights.begin(), weights.end(), 0);
+      for (_u64 i = 0; i < n_pts; ++i) {
+        weights[codes[i * n_chunks_ + chunk]]++;
+      }
+      _u8 *chunk_map = code_map_.data() + chunk * kNumCodes;
+      // a chunk of a single dim leaves the high half empty, its codes stay 0
+      for (_u32 half = 0; half < 2; ++half) {
+        const _u32 dim_begin = half == 0 ? begin : mid;
+        const _u32 dim_end = half == 0 ? mid : end;
+        if (dim_begin == dim_end) {
+          continue;
+        }
+        cluster_half_chunk(pq_table.tables_T.get(), dim_begin, dim_end,
+                           weights, centers_T_.data(), assign.data());
+        for (_u64 code = 0; code < kNumCodes; ++code) {
+          chunk_map[code] |= assign[code] << (4 * half);
+        }
+      }
+    }
+    LOG_KNOWHERE_INFO_ << "Derived 4-bit fast-scan PQ with "
+                       << 2 * n_chunks_ << " sub-quantizers";
+  }
+
+  void FastScanPQTable::populate_lut(const float *query_vec, float *lut_float,
+                                     _u8 *lut, float &scale,
+                                     float &bias) const {
+    const _u64 nsq = 2 * n_chunks_;
+    std::fill(lut_float, lut_float + lut_size(), 0.0f);
+    float max_span = 0;
+    float sum_span = 0;
+    bias = 0;
+    for (_u64 sq = 0; sq < nsq; ++sq) {
+      float *row = lut_float + sq * kNumCenters;
+      for (_u64 j = sub_offsets_[sq]; j < sub_offsets_[sq + 1]; ++j) {
+        const _u64   permuted_dim_in_query = rearrangement_[j];
+        const float  q = query_vec[permuted_dim_in_query] -
+                        centroid_[permuted_dim_in_query];
+        const float *centers_dim_vec = centers_T_.data() + j * kNumCenters;
+        for (_u64 c = 0; c < kNumCenters; ++c) {
+          const float diff = centers_dim_vec[c] - q;
+          row[c] += diff * diff;
+        }
+      }
+      const auto [min_it, max_it] = std::minmax_element(row, row + kNumCenters);
+      const float span = *max_it - *min_it;
+      bias += *min_it;
+      max_span = std::max(max_span, span);
+      sum_span += span;
+    }
+
+    // the kernels accumulate in 16 bits, keep the worst case sum in range.
+    // Rounding adds up to 0.5 to every entry, so the scaled spans may only
+    // use 65535 - nsq of the range.
+    scale = max_span > 0 ? 255.0f / max_span : 1.0f;
+    const float acc_max = std::numeric_limits<uint16_t>::max() - (float) nsq;
+    if (sum_span * scale > acc_max) {
+      scale = acc_max / sum_span;
+    }
+    // with a single query, the packed layout of the LUT is the row-major
+    // one (see faiss::pq4_pack_LUT)
+    for (_u64 sq = 0; sq < nsq; ++sq) {
+      const float *row = lut_float + sq * kNumCenters;
+      const float  row_min = *std::min_element(row, row + kNumCenters);
+      for (_u64 c = 0; c < kNumCenters; ++c) {
+        lut[sq * kNumCenters + c] = (_u8) std::min(
+            255.0f, std::floor((row[c] - row_min) * scale + 0.5f));
+      }
+    }
+  }
+
+  void FastScanPQTable::compute_dists(const unsigned *ids, const _u64 n_ids,
+                                      const _u8 *codes, const _u8 *lut,
+                                      const float scale, const float bias,
+                                      _u8 *coord_scratch, _u8 *blocks,
+                                      uint16_t *acc, float *dists_out) const {
+    if (n_ids == 0) {
+      return;
+    }
+    // gather the candidates, translating to 4-bit codes on the way
+    for (_u64 i = 0; i < n_ids; ++i) {
+      const _u8 *src = codes + (_u64) ids[i] * n_chunks_;
+      _u8       *dst = coord_scratch + i * n_chunks_;
+      for (_u64 chunk = 0; chunk < n_chunks_; ++chunk) {
+        dst[chunk] = code_map_[chunk * kNumCodes + src[chunk]];
+      }
+    }
+    const _u64 nsq = 2 * n_chunks_;
+    const _u64 nb = ROUND_UP(n_ids, kBlockSize);
+    faiss::pq4_pack_codes(coord_scratch, n_ids, nsq, nb, kBlockSize, nsq,
+                          blocks);
+    faiss::simd_result_handlers::StoreResultHandler handler(acc, nb);
+    faiss::pq4_accumulate_loop(1, nb, kBlockSize, nsq, blocks, lut, handler,
+                               nullptr);
+    const float inv_scale = 1.0f / scale;
+    for (_u64 i = 0; i < n_ids; ++i) {
+      dists_out[i] = bias + acc[i] * inv_scale;
+    }
+  }
+}  // namespace diskann
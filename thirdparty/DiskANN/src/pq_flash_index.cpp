@@ -20,10 +20,12 @@
 #include "diskann/aux_utils.h"
 #include "diskann/timer.h"
 #include "diskann/utils.h"
+#include "knowhere/comp/cancel_token.h"
 #include "knowhere/comp/thread_pool.h"
 #include "knowhere/heap.h"
 #include "knowhere/prometheus_client.h"
 #include "knowhere/utils.h"
+#include "tsl/robin_map.h"
 #include "tsl/robin_set.h"
 
 #include "diskann/linux_aligned_file_reader.h"
@@ -234,6 +236,8 @@ namespace diskann {
   void PQFlashIndex<T>::setup_thread_data(_u64 nthreads) {
     LOG(INFO) << "Setting up thread-specific contexts for nthreads: "
               << nthreads;
+    std::vector<std::pair<void *, size_t>> sector_bufs;
+    sector_bufs.reserve(nthreads);
     for (_s64 thread = 0; thread < (_s64) nthreads; thread++) {
       QueryScratch<T> scratch;
       _u64 coord_alloc_size = ROUND_UP(sizeof(T) * this->aligned_dim, 256);
@@ -263,10 +267,16 @@ namespace diskann {
              this->aligned_dim * sizeof(T));
       memset(scratch.aligned_query_float, 0, this->aligned_dim * sizeof(float));
 
+      sector_bufs.emplace_back(scratch.sector_scratch,
+                               (_u64) MAX_N_SECTOR_READS * read_len_for_node);
+
       ThreadData<T> data;
       data.scratch = scratch;
       this->thread_data.push(data);
     }
+    // sector scratch is the destination of every search read, let the reader
+    // pin it once instead of on each request
+    reader->register_buffers(sector_bufs);
     load_flag = true;
   }
 
@@ -305,11 +315,106 @@ namespace diskann {
       diskann::aligned_free((void *) scratch.aligned_dist_scratch);
       diskann::aligned_free((void *) scratch.aligned_query_float);
       diskann::aligned_free((void *) scratch.aligned_query_T);
+      if (scratch.pq4_lut != nullptr) {
+        diskann::aligned_free((void *) scratch.pq4_lut);
+        diskann::aligned_free((void *) scratch.pq4_blocks);
+        diskann::aligned_free((void *) scratch.pq4_acc);
+      }
 
       delete scratch.visited;
     }
   }
 
+  template<typename T>
+  void PQFlashIndex<T>::enable_sector_cache(_u64 budget_bytes) {
+    if (budget_bytes < read_len_for_node) {
+      sector_cache.reset();
+      return;
+    }
+    sector_cache =
+        std::make_unique<SectorCache>(budget_bytes, read_len_for_node);
+    LOG_KNOWHERE_INFO_ << "Enabled dynamic sector cache with "
+                       << sector_cache->capacity() << " sectors of "
+                       << read_len_for_node << " bytes";
+  }
+
+  template<typename T>
+  std::unique_ptr<SectorCache> PQFlashIndex<T>::new_batch_sector_cache(
+      _u64 nq, _u64 l_search) {
+    // a query reads roughly l_search sectors, the cache is only filled as far
+    // as the batch actually reads
+    constexpr _u64 kMaxBatchCacheBytes = 32 * 1024 * 1024;
+    if (nq <= 1) {
+      return nullptr;
+    }
+    auto budget_bytes =
+        std::min(nq * l_search * read_len_for_node, kMaxBatchCacheBytes);
+    return std::make_unique<SectorCache>(budget_bytes, read_len_for_node);
+  }
+
+  template<typename T>
+  void PQFlashIndex<T>::enable_fast_scan() {
+    if (fast_scan_table != nullptr) {
+      return;
+    }
+    auto table = std::make_unique<FastScanPQTable>();
+    table->build(pq_table, data.get(), num_points);
+
+    // add the fast-scan scratch to every thread data, no search is running
+    const _u64 max_n = ROUND_UP(MAX_GRAPH_DEGREE, FastScanPQTable::kBlockSize);
+    std::vector<ThreadData<T>> all_data;
+    while (all_data.size() < max_nthreads) {
+      ThreadData<T> data = this->thread_data.pop();
+      while (data.scratch.sector_scratch == nullptr) {
+        this->thread_data.wait_for_push_notify();
+        data = this->thread_data.pop();
+      }
+      auto &scratch = data.scratch;
+      diskann::alloc_aligned((void **) &scratch.pq4_lut,
+                             ROUND_UP(table->lut_size(), 64), 64);
+      diskann::alloc_aligned((void **) &scratch.pq4_blocks,
+                             ROUND_UP(table->blocks_size(max_n), 64), 64);
+      diskann::alloc_aligned((void **) &scratch.pq4_acc,
+                             max_n * sizeof(uint16_t), 64);
+      all_data.push_back(data);
+    }
+    for (auto &data : all_data) {
+      this->thread_data.push(data);
+    }
+    this->thread_data.push_notify_all();
+    fast_scan_table = std::move(table);
+  }
+
+  template<typename T>
+  void PQFlashIndex<T>::populate_pq_dists(QueryScratch<T> &scratch,
+                                          const float     *query_float) {
+    if (fast_scan_table != nullptr) {
+      fast_scan_table->populate_lut(
+          query_float, scratch.aligned_pqtable_dist_scratch, scratch.pq4_lut,
+          scratch.pq4_scale, scratch.pq4_bias);
+    } else {
+      pq_table.populate_chunk_distances(query_float,
+                                        scratch.aligned_pqtable_dist_scratch);
+    }
+  }
+
+  template<typename T>
+  void PQFlashIndex<T>::compute_pq_dists(QueryScratch<T> &scratch,
+                                         const unsigned *ids, const _u64 n_ids,
+                                         float *dists_out) {
+    if (fast_scan_table != nullptr) {
+      fast_scan_table->compute_dists(
+          ids, n_ids, data.get(), scratch.pq4_lut, scratch.pq4_scale,
+          scratch.pq4_bias, scratch.aligned_pq_coord_scratch,
+          scratch.pq4_blocks, scratch.pq4_acc, dists_out);
+      return;
+    }
+    aggregate_coords(ids, n_ids, data.get(), n_chunks,
+                     scratch.aligned_pq_coord_scratch);
+    pq_dist_lookup(scratch.aligned_pq_coord_scratch, n_ids, n_chunks,
+                   scratch.aligned_pqtable_dist_scratch, dists_out);
+  }
+
   template<typename T>
   void PQFlashIndex<T>::load_cache_list(std::vector<uint32_t> &node_list) {
     _u64 num_cached_nodes = node_list.size();
@@ -827,6 +932,27 @@ namespace diskann {
 
     index_metadata.close();
 
+    std::string layout_file = get_disk_index_layout_filename(disk_index_file);
+    if (!long_node && file_exists(layout_file)) {
+      size_t layout_num, layout_dim;
+      diskann::load_bin<_u32>(layout_file, node_layout, layout_num,
+                              layout_dim);
+      if (layout_num != num_points || layout_dim != 1) {
+        std::stringstream stream;
+        stream << "Error loading layout file. Expected " << num_points
+               << " x 1 positions, got " << layout_num << " x " << layout_dim;
+        throw diskann::ANNException(stream.str(), -1, __FUNCSIG__, __FILE__,
+                                    __LINE__);
+      }
+      node_layout_inv = std::make_unique<_u32[]>(num_points);
+      for (_u64 id = 0; id < num_points; ++id) {
+        node_layout_inv[node_layout[id]] = id;
+      }
+      LOG_KNOWHERE_INFO_ << "Loaded locality-aware layout of disk index.";
+    }
+
+    inflight_reads = std::make_unique<InflightReadTable>(read_len_for_node);
+
     // open AlignedFileReader handle to index_file
     std::string index_fname(disk_index_file);
     reader->open(index_fname);
@@ -1082,7 +1208,10 @@ namespace diskann {
       const T *query1, const _u64 k_search, const _u64 l_search, _s64 *indices,
       float *distances, const _u64 beam_width, const bool use_reorder_data,
       QueryStats *stats, const knowhere::feder::diskann::FederResultUniq &feder,
-      knowhere::BitsetView bitset_view, const float filter_ratio_in) {
+      knowhere::BitsetView bitset_view, const float filter_ratio_in,
+      const bool pipelined, const bool score_full_sector_in,
+      const bool coalesce_io, SectorCache *batch_cache,
+      const float filter_aware_ratio) {
     if (beam_width > MAX_N_SECTOR_READS)
       throw ANNException("Beamwidth can not be higher than MAX_N_SECTOR_READS",
                          -1, __FUNCSIG__, __FILE__, __LINE__);
@@ -1142,6 +1271,13 @@ namespace diskann {
       return;
     }
 
+    // With a moderately selective filter, most candidates are filtered and
+    // reading their sectors only buys connectivity. Unfiltered candidates are
+    // expanded first, so that many filtered ones drop out of retset before
+    // they are read. A ratio of 1 turns this off.
+    const bool filter_aware = !bitset_view.empty() && filter_aware_ratio < 1 &&
+                              bv_cnt >= bitset_view.size() * filter_aware_ratio;
+
     auto         query_scratch = &(data.scratch);
     const T     *query = data.scratch.aligned_query_T;
     const float *query_float = data.scratch.aligned_query_float;
@@ -1166,21 +1302,16 @@ namespace diskann {
     cached_nhoods.reserve(2 * beam_width);
 
     // query <-> PQ chunk centers distances
-    float *pq_dists = query_scratch->aligned_pqtable_dist_scratch;
-    pq_table.populate_chunk_distances(query_float, pq_dists);
+    populate_pq_dists(*query_scratch, query_float);
 
     // query <-> neighbor list
     float *dist_scratch = query_scratch->aligned_dist_scratch;
-    _u8   *pq_coord_scratch = query_scratch->aligned_pq_coord_scratch;
 
     // lambda to batch compute query<-> node distances in PQ space
-    auto compute_dists = [this, pq_coord_scratch, pq_dists](const unsigned *ids,
-                                                            const _u64 n_ids,
-                                                            float *dists_out) {
-      aggregate_coords(ids, n_ids, this->data.get(), this->n_chunks,
-                       pq_coord_scratch);
-      pq_dist_lookup(pq_coord_scratch, n_ids, this->n_chunks, pq_dists,
-                     dists_out);
+    auto compute_dists = [this, query_scratch](const unsigned *ids,
+                                               const _u64 n_ids,
+                                               float     *dists_out) {
+      compute_pq_dists(*query_scratch, ids, n_ids, dists_out);
     };
     Timer                 cpu_timer;
     std::vector<Neighbor> retset(l_search + 1);
@@ -1219,6 +1350,7 @@ namespace diskann {
     unsigned hops = 0;
     unsigned num_ios = 0;
     unsigned k = 0;
+    unsigned nk = cur_list_size;
 
     float                 accumulative_alpha = 0;
     std::vector<unsigned> filtered_nbrs;
@@ -1245,185 +1377,508 @@ namespace diskann {
       return {filtered_nbrs.size(), filtered_nbrs.data()};
     };
 
-    while (k < cur_list_size) {
-      auto nk = cur_list_size;
-      // clear iteration state
-      frontier.clear();
-      frontier_nhoods.clear();
-      frontier_read_reqs.clear();
-      cached_nhoods.clear();
-      sector_scratch_idx = 0;
-      // find new beam
-      _u32 marker = k;
-      _u32 num_seen = 0;
-      while (marker < cur_list_size && frontier.size() < beam_width &&
-             num_seen < beam_width) {
-        if (retset[marker].flag) {
-          num_seen++;
-          {
-            std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
-            auto iter = nhood_cache.find(retset[marker].id);
-            if (iter != nhood_cache.end()) {
-              cached_nhoods.push_back(
-                  std::make_pair(retset[marker].id, iter->second));
-              if (stats != nullptr) {
-                stats->n_cache_hits++;
-              }
-            } else {
-              frontier.push_back(retset[marker].id);
-            }
-          }
-          retset[marker].flag = false;
-          {
-            std::shared_lock<std::shared_mutex> lock(
-                this->node_visit_counter_mtx);
-            if (this->count_visited_nodes) {
-              this->node_visit_counter[retset[marker].id].second->fetch_add(1);
-            }
-          }
-          if (!bitset_view.empty() && bitset_view.test(retset[marker].id)) {
-            std::memmove(&retset[marker], &retset[marker + 1],
-                         (cur_list_size - marker - 1) * sizeof(Neighbor));
-            cur_list_size--;
-          } else {
-            marker++;
-          }
-        } else {
-          marker++;
+    auto full_dist = [&](T *node_fp_coords_copy, unsigned node_id) {
+      return full_precision_dist(query, query_float, node_fp_coords_copy,
+                                 node_id);
+    };
+
+    // With a locality-aware layout the other nodes of a fetched sector are
+    // likely close to the query as well, score them with full precision for
+    // free. `full_scored` keeps every node out of full_retset twice.
+    const bool score_full_sector = score_full_sector_in && !long_node;
+    tsl::robin_set<unsigned> full_scored;
+
+    auto process_node = [&](T *node_fp_coords_copy, auto node_id, auto n_nbr,
+                            auto *nbrs) {
+      if ((bitset_view.empty() || !bitset_view.test(node_id)) &&
+          (!score_full_sector || full_scored.insert(node_id).second)) {
+        float cur_expanded_dist = full_dist(node_fp_coords_copy, node_id);
+        full_retset.push_back(
+            Neighbor((unsigned) node_id, cur_expanded_dist, true));
+
+        // add top candidate info into feder result
+        if (feder != nullptr) {
+          feder->visit_info_.AddTopCandidateInfo(node_id, cur_expanded_dist);
+          feder->id_set_.insert(node_id);
         }
       }
+      auto [nnbrs, node_nbrs] = filter_nbrs(n_nbr, nbrs);
 
-      // read nhoods of frontier ids
-      if (!frontier.empty()) {
-        if (stats != nullptr)
-          stats->n_hops++;
-        for (_u64 i = 0; i < frontier.size(); i++) {
-          auto                    id = frontier[i];
-          std::pair<_u32, char *> fnhood;
-          fnhood.first = id;
-          fnhood.second =
-              sector_scratch + sector_scratch_idx * read_len_for_node;
-          sector_scratch_idx++;
-          frontier_nhoods.push_back(fnhood);
-          frontier_read_reqs.emplace_back(get_node_sector_offset(((size_t) id)),
-                                          read_len_for_node, fnhood.second);
+      // compute node_nbrs <-> query dists in PQ space
+      cpu_timer.reset();
+      compute_dists(node_nbrs, nnbrs, dist_scratch);
+      if (stats != nullptr) {
+        stats->n_cmps += (double) nnbrs;
+        stats->cpu_us += (double) cpu_timer.elapsed();
+      }
+
+      cpu_timer.reset();
+      // process prefetched nhood
+      for (_u64 m = 0; m < nnbrs; ++m) {
+        unsigned id = node_nbrs[m];
+
+        // add neighbor info into feder result
+        if (feder != nullptr) {
+          feder->visit_info_.AddTopCandidateNeighbor(node_id, id,
+                                                     dist_scratch[m]);
+          feder->id_set_.insert(id);
+        }
+
+        float dist = dist_scratch[m];
+        if (stats != nullptr) {
+          stats->n_cmps++;
+        }
+        if (cur_list_size > 0 && dist >= retset[cur_list_size - 1].distance &&
+            (cur_list_size == l_search))
+          continue;
+        Neighbor nn(id, dist, true);
+        // Return position in sorted list where nn inserted.
+        auto r = InsertIntoPool(retset.data(), cur_list_size, nn);
+        if (cur_list_size < l_search)
+          ++cur_list_size;
+        if (r < nk)
+          // nk logs the best position in the retset that was
+          // updated due to neighbors of n.
+          nk = r;
+      }
+      if (stats != nullptr) {
+        stats->cpu_us += (double) cpu_timer.elapsed();
+      }
+    };
+
+    // pick the next unexpanded node of retset starting from `marker`, look it
+    // up in the nhood cache and mark it as expanded. Filtered nodes are still
+    // expanded for connectivity but are dropped from retset.
+    auto select_next = [&](_u32 &marker, bool &is_cached,
+                           std::pair<_u32, _u32 *> &cached_nhood) -> unsigned {
+      unsigned id = retset[marker].id;
+      {
+        std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
+        auto iter = nhood_cache.find(id);
+        is_cached = iter != nhood_cache.end();
+        if (is_cached) {
+          cached_nhood = iter->second;
           if (stats != nullptr) {
-            stats->n_4k++;
-            stats->n_ios++;
+            stats->n_cache_hits++;
           }
-          num_ios++;
         }
-        io_timer.reset();
-        reader->read(frontier_read_reqs, ctx);  // synchronous IO linux
+      }
+      retset[marker].flag = false;
+      {
+        std::shared_lock<std::shared_mutex> lock(this->node_visit_counter_mtx);
+        if (this->count_visited_nodes) {
+          this->node_visit_counter[id].second->fetch_add(1);
+        }
+      }
+      if (!bitset_view.empty() && bitset_view.test(id)) {
+        std::memmove(&retset[marker], &retset[marker + 1],
+                     (cur_list_size - marker - 1) * sizeof(Neighbor));
+        cur_list_size--;
+      } else {
+        marker++;
+      }
+      return id;
+    };
+
+    // a filtered candidate waits for the unfiltered ones unless its nhood is
+    // cached and costs no read. The deferred candidates of the search list
+    // are snapshotted once per round, under a single lock of the cache.
+    tsl::robin_set<unsigned> deferred_ids;
+    auto                     snapshot_deferred = [&](_u64 begin) {
+      deferred_ids.clear();
+      if (!filter_aware) {
+        return;
+      }
+      std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
+      for (_u64 i = begin; i < cur_list_size; ++i) {
+        const unsigned id = retset[i].id;
+        if (retset[i].flag && bitset_view.test(id) &&
+            nhood_cache.find(id) == nhood_cache.end()) {
+          deferred_ids.insert(id);
+        }
+      }
+    };
+    auto is_deferred = [&](unsigned id) {
+      return deferred_ids.find(id) != deferred_ids.end();
+    };
+
+    auto count_read = [&](unsigned id) {
+      if (stats != nullptr) {
+        stats->n_4k++;
+        stats->n_ios++;
+        if (!bitset_view.empty() && bitset_view.test(id)) {
+          stats->n_filtered_ios++;
+        }
+      }
+      num_ios++;
+    };
+
+    auto process_cached_nhood = [&](unsigned                       id,
+                                    const std::pair<_u32, _u32 *> &nhood) {
+      if (stats != nullptr) {
+        stats->n_hops++;
+      }
+      T *node_fp_coords_copy;
+      {
+        std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
+        auto global_cache_iter = coord_cache.find(id);
+        node_fp_coords_copy = global_cache_iter->second;
+      }
+      process_node(node_fp_coords_copy, id, nhood.first, nhood.second);
+    };
+
+    // serve a sector from the dynamic or the batch cache instead of issuing
+    // a read
+    auto read_sector_from_cache = [&](_u64 offset, char *sector_buf) {
+      if ((sector_cache == nullptr ||
+           !sector_cache->lookup(offset, sector_buf)) &&
+          (batch_cache == nullptr ||
+           !batch_cache->lookup(offset, sector_buf))) {
+        return false;
+      }
+      if (stats != nullptr) {
+        stats->n_sector_cache_hits++;
+      }
+      return true;
+    };
+
+    auto fill_sector_caches = [&](_u64 offset, const char *sector_buf) {
+      if (sector_cache != nullptr) {
+        sector_cache->insert(offset, sector_buf);
+      }
+      if (batch_cache != nullptr) {
+        batch_cache->insert(offset, sector_buf);
+      }
+    };
+
+    // reads of the current beam owned in or joined from `inflight_reads`
+    std::vector<InflightReadTable::TicketPtr> owned_reads;
+    std::vector<std::pair<AlignedRead, InflightReadTable::TicketPtr>>
+        joined_reads;
+    // frontier nodes whose sector is already requested by this beam, as
+    // (destination, source) buffers. Joining our own read in the table would
+    // only copy the sector one more time.
+    std::vector<std::pair<char *, const char *>> beam_dups;
+    auto find_beam_read = [&](_u64 offset) -> const char * {
+      for (const auto &req : frontier_read_reqs) {
+        if (req.offset == offset) {
+          return (const char *) req.buf;
+        }
+      }
+      for (const auto &joined : joined_reads) {
+        if (joined.first.offset == offset) {
+          return (const char *) joined.first.buf;
+        }
+      }
+      return nullptr;
+    };
+
+    auto process_sector = [&](unsigned id, char *sector_buf) {
+      char     *node_disk_buf = get_offset_to_node(sector_buf, id);
+      unsigned *node_buf = OFFSET_TO_NODE_NHOOD(node_disk_buf);
+      T        *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
+      T        *node_fp_coords_copy = data_buf;
+      memcpy(node_fp_coords_copy, node_fp_coords, disk_bytes_per_point);
+      process_node(node_fp_coords_copy, id, *node_buf, node_buf + 1);
+      if (!score_full_sector) {
+        return;
+      }
+      const _u64 first_pos =
+          get_node_position(id) / nnodes_per_sector * nnodes_per_sector;
+      for (_u64 i = 0; i < nnodes_per_sector; ++i) {
+        const _u64 nbr_id = get_node_at_position(first_pos + i);
+        if (nbr_id >= num_points || nbr_id == id ||
+            (!bitset_view.empty() && bitset_view.test(nbr_id)) ||
+            !full_scored.insert(nbr_id).second) {
+          continue;
+        }
+        memcpy(node_fp_coords_copy,
+               OFFSET_TO_NODE_COORDS(sector_buf + i * max_node_len),
+               disk_bytes_per_point);
+        full_retset.push_back(Neighbor((unsigned) nbr_id,
+                                       full_dist(node_fp_coords_copy, nbr_id),
+                                       true));
         if (stats != nullptr) {
-          stats->io_us += (double) io_timer.elapsed();
+          stats->n_cmps++;
         }
       }
+    };
 
-      auto process_node = [&](T *node_fp_coords_copy, auto node_id, auto n_nbr,
-                              auto *nbrs) {
-        if (bitset_view.empty() || !bitset_view.test(node_id)) {
-          float cur_expanded_dist;
-          if (!use_disk_index_pq) {
-            cur_expanded_dist = dist_cmp_wrap(query, node_fp_coords_copy,
-                                              (size_t) aligned_dim, node_id);
-          } else {
-            if (metric == diskann::Metric::INNER_PRODUCT ||
-                metric == diskann::Metric::COSINE)
-              cur_expanded_dist = disk_pq_table.inner_product(
-                  query_float, (_u8 *) node_fp_coords_copy);
-            else
-              cur_expanded_dist = disk_pq_table.l2_distance(
-                  query_float, (_u8 *) node_fp_coords_copy);
+    if (!pipelined) {
+      // a hop is one round of I/O, the cancel token is cheap to poll at that
+      // rate
+      while (k < cur_list_size &&
+             !knowhere::CancelToken::CurrentIsCancelled()) {
+        nk = cur_list_size;
+        // clear iteration state
+        frontier.clear();
+        frontier_nhoods.clear();
+        frontier_read_reqs.clear();
+        cached_nhoods.clear();
+        owned_reads.clear();
+        joined_reads.clear();
+        beam_dups.clear();
+        sector_scratch_idx = 0;
+        // find new beam, deferred candidates are only taken if nothing else
+        // is left
+        auto fill_beam = [&](bool take_deferred) {
+          _u32 marker = k;
+          _u32 num_seen = 0;
+          while (marker < cur_list_size && frontier.size() < beam_width &&
+                 num_seen < beam_width) {
+            if (retset[marker].flag &&
+                (take_deferred || !is_deferred(retset[marker].id))) {
+              num_seen++;
+              bool                    is_cached = false;
+              std::pair<_u32, _u32 *> cached_nhood;
+              auto id = select_next(marker, is_cached, cached_nhood);
+              if (is_cached) {
+                cached_nhoods.push_back(std::make_pair(id, cached_nhood));
+              } else {
+                frontier.push_back(id);
+              }
+            } else {
+              marker++;
+            }
           }
-          full_retset.push_back(
-              Neighbor((unsigned) node_id, cur_expanded_dist, true));
+        };
+        snapshot_deferred(k);
+        fill_beam(!filter_aware);
+        if (filter_aware && frontier.empty() && cached_nhoods.empty()) {
+          fill_beam(true);
+        }
 
-          // add top candidate info into feder result
-          if (feder != nullptr) {
-            feder->visit_info_.AddTopCandidateInfo(node_id, cur_expanded_dist);
-            feder->id_set_.insert(node_id);
+        // read nhoods of frontier ids
+        if (!frontier.empty()) {
+          if (stats != nullptr)
+            stats->n_hops++;
+          for (_u64 i = 0; i < frontier.size(); i++) {
+            auto                    id = frontier[i];
+            std::pair<_u32, char *> fnhood;
+            fnhood.first = id;
+            fnhood.second =
+                sector_scratch + sector_scratch_idx * read_len_for_node;
+            sector_scratch_idx++;
+            frontier_nhoods.push_back(fnhood);
+            auto offset = get_node_sector_offset(((size_t) id));
+            if (read_sector_from_cache(offset, fnhood.second)) {
+              continue;
+            }
+            if (auto src = find_beam_read(offset); src != nullptr) {
+              beam_dups.emplace_back(fnhood.second, src);
+              continue;
+            }
+            if (coalesce_io) {
+              InflightReadTable::TicketPtr ticket;
+              if (!inflight_reads->acquire(offset, ticket)) {
+                joined_reads.emplace_back(
+                    AlignedRead(offset, read_len_for_node, fnhood.second),
+                    std::move(ticket));
+                continue;
+              }
+              owned_reads.push_back(std::move(ticket));
+            }
+            frontier_read_reqs.emplace_back(offset, read_len_for_node,
+                                            fnhood.second);
+            count_read(id);
+          }
+          if (!frontier_read_reqs.empty()) {
+            io_timer.reset();
+            try {
+              reader->read(frontier_read_reqs, ctx);  // synchronous IO linux
+            } catch (...) {
+              for (size_t i = 0; i < owned_reads.size(); ++i) {
+                inflight_reads->abort(frontier_read_reqs[i].offset,
+                                      owned_reads[i]);
+              }
+              throw;
+            }
+            if (stats != nullptr) {
+              stats->io_us += (double) io_timer.elapsed();
+            }
+            for (size_t i = 0; i < frontier_read_reqs.size(); ++i) {
+              const auto &req = frontier_read_reqs[i];
+              if (coalesce_io) {
+                inflight_reads->complete(req.offset, owned_reads[i],
+                                         (char *) req.buf);
+              }
+              fill_sector_caches(req.offset, (char *) req.buf);
+            }
+          }
+          // only wait for other searches after publishing our own reads
+          if (!joined_reads.empty()) {
+            io_timer.reset();
+            frontier_read_reqs.clear();
+            for (auto &[req, ticket] : joined_reads) {
+              if (inflight_reads->wait(ticket, (char *) req.buf)) {
+                if (stats != nullptr) {
+                  stats->n_coalesced++;
+                }
+                fill_sector_caches(req.offset, (char *) req.buf);
+              } else {
+                frontier_read_reqs.push_back(req);
+              }
+            }
+            if (!frontier_read_reqs.empty()) {
+              reader->read(frontier_read_reqs, ctx);
+              if (stats != nullptr) {
+                stats->n_4k += frontier_read_reqs.size();
+                stats->n_ios += frontier_read_reqs.size();
+              }
+              num_ios += frontier_read_reqs.size();
+              for (const auto &req : frontier_read_reqs) {
+                fill_sector_caches(req.offset, (char *) req.buf);
+              }
+            }
+            if (stats != nullptr) {
+              stats->io_us += (double) io_timer.elapsed();
+            }
+          }
+          for (const auto &[dst, src] : beam_dups) {
+            memcpy(dst, src, read_len_for_node);
           }
         }
-        auto [nnbrs, node_nbrs] = filter_nbrs(n_nbr, nbrs);
 
-        // compute node_nbrs <-> query dists in PQ space
-        cpu_timer.reset();
-        compute_dists(node_nbrs, nnbrs, dist_scratch);
-        if (stats != nullptr) {
-          stats->n_cmps += (double) nnbrs;
-          stats->cpu_us += (double) cpu_timer.elapsed();
+        // process cached nhoods
+        for (auto &cached_nhood : cached_nhoods) {
+          process_cached_nhood(cached_nhood.first, cached_nhood.second);
         }
 
-        cpu_timer.reset();
-        // process prefetched nhood
-        for (_u64 m = 0; m < nnbrs; ++m) {
-          unsigned id = node_nbrs[m];
+        for (auto &frontier_nhood : frontier_nhoods) {
+          process_sector(frontier_nhood.first, frontier_nhood.second);
+        }
 
-          // add neighbor info into feder result
-          if (feder != nullptr) {
-            feder->visit_info_.AddTopCandidateNeighbor(node_id, id,
-                                                       dist_scratch[m]);
-            feder->id_set_.insert(id);
+        // update best inserted position
+        if (filter_aware) {
+          // deferred candidates stay unexpanded ahead of the beam. The
+          // candidates before both k and the best inserted position are all
+          // expanded, resume the scan from there.
+          k = std::min(k, nk);
+          while (k < cur_list_size && !retset[k].flag) {
+            k++;
           }
+        } else if (nk <= k) {
+          k = nk;  // k is the best position in retset updated in this round.
+        } else {
+          ++k;
+        }
 
-          float dist = dist_scratch[m];
-          if (stats != nullptr) {
-            stats->n_cmps++;
+        hops++;
+      }
+    } else {
+      // Pipelined search: keep up to `pipeline_width` sector reads in flight
+      // and expand a node as soon as its own sector arrives, then refill the
+      // freed slot with the best unexpanded candidate. This overlaps the PQ
+      // distance computation with outstanding I/O instead of alternating
+      // between the two.
+      const _u64 pipeline_width =
+          std::min<_u64>(beam_width, reader->max_events_per_ctx());
+      std::vector<unsigned> slot_nodes(pipeline_width);
+      std::vector<_u64>     free_slots;
+      free_slots.reserve(pipeline_width);
+      for (_u64 slot = pipeline_width; slot > 0; --slot) {
+        free_slots.push_back(slot - 1);
+      }
+      std::vector<void *> done_bufs;
+      done_bufs.reserve(pipeline_width);
+      // slots filled from the dynamic sector cache, no read needed
+      std::vector<_u64> ready_slots;
+      ready_slots.reserve(pipeline_width);
+      _u64 n_inflight = 0;
+
+      while (true) {
+        frontier_read_reqs.clear();
+        cached_nhoods.clear();
+        ready_slots.clear();
+
+        // issue reads for the best unexpanded candidates into free slots,
+        // deferred candidates only once nothing else is left or in flight
+        auto fill_slots = [&](bool take_deferred) {
+          _u32 marker = 0;
+          _u32 num_seen = 0;
+          while (marker < cur_list_size && !free_slots.empty() &&
+                 num_seen < pipeline_width) {
+            if (!retset[marker].flag ||
+                (!take_deferred && is_deferred(retset[marker].id))) {
+              marker++;
+              continue;
+            }
+            num_seen++;
+            bool                    is_cached = false;
+            std::pair<_u32, _u32 *> cached_nhood;
+            auto id = select_next(marker, is_cached, cached_nhood);
+            if (is_cached) {
+              cached_nhoods.push_back(std::make_pair(id, cached_nhood));
+              continue;
+            }
+            const auto slot = free_slots.back();
+            free_slots.pop_back();
+            slot_nodes[slot] = id;
+            auto  offset = get_node_sector_offset(((size_t) id));
+            char *sector_buf = sector_scratch + slot * read_len_for_node;
+            if (read_sector_from_cache(offset, sector_buf)) {
+              ready_slots.push_back(slot);
+              continue;
+            }
+            frontier_read_reqs.emplace_back(offset, read_len_for_node,
+                                            sector_buf);
+            count_read(id);
           }
-          if (cur_list_size > 0 && dist >= retset[cur_list_size - 1].distance &&
-              (cur_list_size == l_search))
-            continue;
-          Neighbor nn(id, dist, true);
-          // Return position in sorted list where nn inserted.
-          auto r = InsertIntoPool(retset.data(), cur_list_size, nn);
-          if (cur_list_size < l_search)
-            ++cur_list_size;
-          if (r < nk)
-            // nk logs the best position in the retset that was
-            // updated due to neighbors of n.
-            nk = r;
+        };
+        // once the request is cancelled, no more reads are issued and the
+        // loop ends as soon as the ones in flight are drained
+        const bool cancelled = knowhere::CancelToken::CurrentIsCancelled();
+        if (!cancelled) {
+          snapshot_deferred(0);
+          fill_slots(!filter_aware);
         }
-        if (stats != nullptr) {
-          stats->cpu_us += (double) cpu_timer.elapsed();
+        if (!cancelled && filter_aware && n_inflight == 0 &&
+            frontier_read_reqs.empty() && cached_nhoods.empty() &&
+            ready_slots.empty()) {
+          fill_slots(true);
+        }
+        if (!frontier_read_reqs.empty()) {
+          reader->submit_req(ctx, frontier_read_reqs);
+          n_inflight += frontier_read_reqs.size();
+        }
+
+        // expand cached nodes while the reads are in flight
+        for (auto &cached_nhood : cached_nhoods) {
+          process_cached_nhood(cached_nhood.first, cached_nhood.second);
+        }
+        for (auto slot : ready_slots) {
+          process_sector(slot_nodes[slot],
+                         sector_scratch + slot * read_len_for_node);
+          free_slots.push_back(slot);
+        }
+
+        if (n_inflight == 0) {
+          if (cached_nhoods.empty() && ready_slots.empty()) {
+            break;
+          }
+          continue;
         }
-      };
 
-      // process cached nhoods
-      for (auto &cached_nhood : cached_nhoods) {
+        // wait for at least one sector and expand whatever has completed
+        done_bufs.clear();
+        io_timer.reset();
+        n_inflight -= reader->poll_submitted_req(ctx, 1, n_inflight, done_bufs);
         if (stats != nullptr) {
+          stats->io_us += (double) io_timer.elapsed();
           stats->n_hops++;
         }
-        T *node_fp_coords_copy;
-        {
-          std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
-          auto global_cache_iter = coord_cache.find(cached_nhood.first);
-          node_fp_coords_copy = global_cache_iter->second;
+        for (auto buf : done_bufs) {
+          const _u64 slot =
+              ((char *) buf - sector_scratch) / read_len_for_node;
+          fill_sector_caches(
+              get_node_sector_offset(((size_t) slot_nodes[slot])),
+              (char *) buf);
+          process_sector(slot_nodes[slot], (char *) buf);
+          free_slots.push_back(slot);
         }
-        process_node(node_fp_coords_copy, cached_nhood.first,
-                     cached_nhood.second.first, cached_nhood.second.second);
-      }
-
-      for (auto &frontier_nhood : frontier_nhoods) {
-        char *node_disk_buf =
-            get_offset_to_node(frontier_nhood.second, frontier_nhood.first);
-        unsigned *node_buf = OFFSET_TO_NODE_NHOOD(node_disk_buf);
-        T        *node_fp_coords = OFFSET_TO_NODE_COORDS(node_disk_buf);
-        T        *node_fp_coords_copy = data_buf;
-        memcpy(node_fp_coords_copy, node_fp_coords, disk_bytes_per_point);
-        process_node(node_fp_coords_copy, frontier_nhood.first, *node_buf,
-                     node_buf + 1);
+        hops++;
       }
-
-      // update best inserted position
-      if (nk <= k)
-        k = nk;  // k is the best position in retset updated in this round.
-      else
-        ++k;
-
-      hops++;
     }
-
     // re-sort by distance
     std::sort(full_retset.begin(), full_retset.end(),
               [](const Neighbor &left, const Neighbor &right) {
@@ -1486,17 +1941,7 @@ namespace diskann {
       }
       indices[i] = full_retset[i].id;
       if (distances != nullptr) {
-        distances[i] = full_retset[i].distance;
-        if (metric == diskann::Metric::INNER_PRODUCT) {
-          // convert l2 distance to ip distance
-          distances[i] = 1.0 - distances[i] / 2.0;
-          // rescale to revert back to original norms (cancelling the effect of
-          // base and query pre-processing)
-          if (max_base_norm != 0)
-            distances[i] *= (max_base_norm * query_norm);
-        } else if (metric == diskann::Metric::COSINE) {
-          distances[i] = -distances[i];
-        }
+        distances[i] = to_user_distance(full_retset[i].distance, query_norm);
       }
     }
 
@@ -1513,6 +1958,232 @@ namespace diskann {
     }
   }
 
+  template<typename T>
+  void PQFlashIndex<T>::range_search(
+      const T *query1, const float radius, const _u64 min_l_search,
+      const _u64 max_l_search, const _u64 beam_width,
+      std::vector<int64_t> &indices, std::vector<float> &distances,
+      QueryStats *stats, knowhere::BitsetView bitset_view) {
+    if (beam_width > MAX_N_SECTOR_READS)
+      throw ANNException("Beamwidth can not be higher than MAX_N_SECTOR_READS",
+                         -1, __FUNCSIG__, __FILE__, __LINE__);
+    indices.clear();
+    distances.clear();
+    if (!bitset_view.empty() && bitset_view.count() == bitset_view.size()) {
+      return;
+    }
+
+    ThreadData<T> data = this->thread_data.pop();
+    while (data.scratch.sector_scratch == nullptr) {
+      this->thread_data.wait_for_push_notify();
+      data = this->thread_data.pop();
+    }
+    auto query_norm_opt = init_thread_data(data, query1);
+    if (!query_norm_opt.has_value()) {
+      // return an empty answer when calcu a zero point
+      this->thread_data.push(data);
+      this->thread_data.push_notify_all();
+      return;
+    }
+    const float query_norm = query_norm_opt.value();
+    // compare in the internal space, smaller is closer
+    const float internal_radius = to_internal_distance(radius, query_norm);
+    auto        ctx = this->reader->get_ctx();
+
+    auto         query_scratch = &(data.scratch);
+    const T     *query = query_scratch->aligned_query_T;
+    const float *query_float = query_scratch->aligned_query_float;
+    T           *data_buf = query_scratch->coord_scratch;
+    char        *sector_scratch = query_scratch->sector_scratch;
+    float       *dist_scratch = query_scratch->aligned_dist_scratch;
+    tsl::robin_set<_u64> &visited = *(query_scratch->visited);
+    populate_pq_dists(*query_scratch, query_float);
+
+    auto compute_dists = [this, query_scratch](const unsigned *ids,
+                                               const _u64 n_ids,
+                                               float     *dists_out) {
+      compute_pq_dists(*query_scratch, ids, n_ids, dists_out);
+    };
+
+    // every node is scored with full precision once, either when it is
+    // expanded or as a co-located node of a fetched sector
+    tsl::robin_set<unsigned> scored;
+    bool                     beam_hit = false;
+    auto add_result = [&](unsigned id, T *node_coords) {
+      if ((!bitset_view.empty() && bitset_view.test(id)) ||
+          !scored.insert(id).second) {
+        return;
+      }
+      memcpy(data_buf, node_coords, disk_bytes_per_point);
+      const float dist = full_precision_dist(query, query_float, data_buf, id);
+      if (stats != nullptr) {
+        stats->n_cmps++;
+      }
+      if (dist < internal_radius) {
+        indices.push_back(id);
+        distances.push_back(to_user_distance(dist, query_norm));
+        beam_hit = true;
+      }
+    };
+
+    // unbounded frontier ordered by PQ distance, it grows with the range
+    auto heap_cmp = [](const SimpleNeighbor &a, const SimpleNeighbor &b) {
+      return a.distance > b.distance;
+    };
+    std::vector<SimpleNeighbor> frontier_heap;
+    std::vector<unsigned>       nbrs;
+    nbrs.reserve(this->max_degree);
+    auto expand = [&](unsigned n_nbrs, const unsigned *node_nbrs) {
+      nbrs.clear();
+      for (unsigned m = 0; m < n_nbrs; ++m) {
+        if (visited.insert(node_nbrs[m]).second) {
+          nbrs.push_back(node_nbrs[m]);
+        }
+      }
+      compute_dists(nbrs.data(), nbrs.size(), dist_scratch);
+      if (stats != nullptr) {
+        stats->n_cmps += nbrs.size();
+      }
+      for (size_t m = 0; m < nbrs.size(); ++m) {
+        frontier_heap.emplace_back(nbrs[m], dist_scratch[m]);
+        std::push_heap(frontier_heap.begin(), frontier_heap.end(), heap_cmp);
+      }
+    };
+
+    _u32  best_medoid = 0;
+    float best_dist = (std::numeric_limits<float>::max)();
+    for (_u64 cur_m = 0; cur_m < num_medoids; cur_m++) {
+      float cur_expanded_dist =
+          dist_cmp_float_wrap(query_float, centroid_data + aligned_dim * cur_m,
+                              (size_t) aligned_dim, medoids[cur_m]);
+      if (cur_expanded_dist < best_dist) {
+        best_medoid = medoids[cur_m];
+        best_dist = cur_expanded_dist;
+      }
+    }
+    compute_dists(&best_medoid, 1, dist_scratch);
+    frontier_heap.emplace_back(best_medoid, dist_scratch[0]);
+    visited.insert(best_medoid);
+
+    Timer                    io_timer, query_timer;
+    std::vector<unsigned>    frontier;
+    std::vector<AlignedRead> read_reqs;
+    // sector offset -> slot in sector_scratch, nodes may share a sector
+    tsl::robin_map<_u64, char *> frontier_sectors;
+    std::vector<std::pair<unsigned, std::pair<_u32, _u32 *>>> cached_nhoods;
+    _u64 n_expanded = 0;
+
+    while (!frontier_heap.empty() && n_expanded < max_l_search &&
+           !knowhere::CancelToken::CurrentIsCancelled()) {
+      // PQ distances are approximate: keep going past the radius as long as
+      // the previous beam still found results
+      if (n_expanded >= min_l_search && !beam_hit &&
+          frontier_heap.front().distance >= internal_radius) {
+        break;
+      }
+      beam_hit = false;
+      frontier.clear();
+      cached_nhoods.clear();
+      read_reqs.clear();
+      frontier_sectors.clear();
+      while (!frontier_heap.empty() && frontier.size() < beam_width &&
+             n_expanded < max_l_search) {
+        std::pop_heap(frontier_heap.begin(), frontier_heap.end(), heap_cmp);
+        const unsigned id = frontier_heap.back().id;
+        frontier_heap.pop_back();
+        n_expanded++;
+        {
+          std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
+          auto iter = nhood_cache.find(id);
+          if (iter != nhood_cache.end()) {
+            cached_nhoods.emplace_back(id, iter->second);
+            if (stats != nullptr) {
+              stats->n_cache_hits++;
+            }
+            continue;
+          }
+        }
+        frontier.push_back(id);
+        const _u64 offset = get_node_sector_offset(id);
+        if (frontier_sectors.count(offset) > 0) {
+          continue;
+        }
+        char *sector_buf = sector_scratch + frontier_sectors.size() *
+                                                read_len_for_node;
+        frontier_sectors.emplace(offset, sector_buf);
+        if (sector_cache != nullptr &&
+            sector_cache->lookup(offset, sector_buf)) {
+          if (stats != nullptr) {
+            stats->n_sector_cache_hits++;
+          }
+          continue;
+        }
+        read_reqs.emplace_back(offset, read_len_for_node, sector_buf);
+      }
+
+      if (!read_reqs.empty()) {
+        io_timer.reset();
+        reader->read(read_reqs, ctx);
+        if (stats != nullptr) {
+          stats->io_us += (double) io_timer.elapsed();
+          stats->n_ios += read_reqs.size();
+          stats->n_4k += read_reqs.size();
+        }
+        if (sector_cache != nullptr) {
+          for (const auto &req : read_reqs) {
+            sector_cache->insert(req.offset, (char *) req.buf);
+          }
+        }
+      }
+      if (stats != nullptr) {
+        stats->n_hops++;
+      }
+
+      for (auto &[id, nhood] : cached_nhoods) {
+        T *node_coords;
+        {
+          std::shared_lock<std::shared_mutex> lock(this->cache_mtx);
+          node_coords = coord_cache.find(id)->second;
+        }
+        add_result(id, node_coords);
+        expand(nhood.first, nhood.second);
+      }
+      for (const auto id : frontier) {
+        char *node_disk_buf = get_offset_to_node(
+            frontier_sectors[get_node_sector_offset(id)], id);
+        unsigned *node_buf = OFFSET_TO_NODE_NHOOD(node_disk_buf);
+        add_result(id, OFFSET_TO_NODE_COORDS(node_disk_buf));
+        expand(*node_buf, node_buf + 1);
+      }
+      // the other nodes of the fetched sectors come for free, with a
+      // locality-aware layout they are likely in range as well
+      if (!long_node) {
+        for (const auto &[offset, sector_buf] : frontier_sectors) {
+          const _u64 first_pos = (offset / SECTOR_LEN - 1) * nnodes_per_sector;
+          for (_u64 i = 0; i < nnodes_per_sector; ++i) {
+            const _u64 id = get_node_at_position(first_pos + i);
+            if (id >= num_points) {
+              continue;
+            }
+            add_result((unsigned) id, OFFSET_TO_NODE_COORDS(
+                                          sector_buf + i * max_node_len));
+          }
+        }
+      }
+      if (stats != nullptr) {
+        stats->n_iters++;
+      }
+    }
+
+    this->thread_data.push(data);
+    this->thread_data.push_notify_all();
+    this->reader->put_ctx(ctx);
+
+    if (stats != nullptr) {
+      stats->total_us = (double) query_timer.elapsed();
+    }
+  }
+
   template<typename T>
   inline void PQFlashIndex<T>::copy_vec_base_data(T *des, const int64_t des_idx,
                                                   void *src) {
@@ -1565,7 +2236,7 @@ namespace diskann {
     }
 
     const size_t batch_size =
-        std::min(AioContextPool::GetGlobalAioPool()->max_events_per_ctx(),
+        std::min(reader->max_events_per_ctx(),
                  std::min(MAX_N_SECTOR_READS / 2UL, sectors_to_visit.size()));
     const size_t half_buf_idx = MAX_N_SECTOR_READS / 2 * read_len_for_node;
     char        *sector_scratch = data.scratch.sector_scratch;
@@ -1680,21 +2351,15 @@ namespace diskann {
     _u64 &sector_scratch_idx = data.scratch.sector_idx;
 
     // query <-> PQ chunk centers distances
-    float *pq_dists = data.scratch.aligned_pqtable_dist_scratch;
-    pq_table.populate_chunk_distances(workspace->aligned_query_float, pq_dists);
+    populate_pq_dists(data.scratch, workspace->aligned_query_float);
 
     // query <-> neighbor list
     float *dist_scratch = data.scratch.aligned_dist_scratch;
-    _u8   *pq_coord_scratch = data.scratch.aligned_pq_coord_scratch;
 
     // lambda to batch compute query<-> node distances in PQ space
-    auto compute_dists = [this, pq_coord_scratch, pq_dists](const unsigned *ids,
-                                                            const _u64 n_ids,
-                                                            float *dists_out) {
-      aggregate_coords(ids, n_ids, this->data.get(), this->n_chunks,
-                       pq_coord_scratch);
-      pq_dist_lookup(pq_coord_scratch, n_ids, this->n_chunks, pq_dists,
-                     dists_out);
+    auto compute_dists = [this, &data](const unsigned *ids, const _u64 n_ids,
+                                       float *dists_out) {
+      compute_pq_dists(data.scratch, ids, n_ids, dists_out);
     };
 
     if (!workspace->initialized) {
@@ -1900,6 +2565,23 @@ namespace diskann {
     index_mem_size += coord_cache.size() * sizeof(std::pair<_u32, T *>);
     index_mem_size +=
         nhood_cache.size() * sizeof(std::pair<_u32, std::pair<_u32, _u32 *>>);
+    if (sector_cache != nullptr) {
+      index_mem_size += sector_cache->size_in_bytes();
+    }
+    if (node_layout != nullptr) {
+      index_mem_size += 2 * num_points * sizeof(_u32);
+    }
+    if (fast_scan_table != nullptr) {
+      const _u64 max_n =
+          ROUND_UP(MAX_GRAPH_DEGREE, FastScanPQTable::kBlockSize);
+      index_mem_size += this->pq_table.get_total_dims() *
+                            FastScanPQTable::kNumCenters * sizeof(float) +
+                        this->n_chunks * 256;
+      index_mem_size +=
+          (_u64) this->thread_data.size() *
+          (fast_scan_table->lut_size() + fast_scan_table->blocks_size(max_n) +
+           max_n * sizeof(uint16_t));
+    }
     // get entry points:
     index_mem_size += ROUND_UP(num_medoids * aligned_dim * sizeof(float), 32);
     index_mem_size += num_medoids * aligned_dim * sizeof(uint32_t);
@@ -0,0 +1,96 @@
+#include "diskann/sector_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+  constexpr size_t kNumShards = 16;
+  constexpr _u64   kInvalidKey = std::numeric_limits<_u64>::max();
+}  // namespace
+
+namespace diskann {
+  SectorCache::SectorCache(_u64 capacity_bytes, _u64 sector_len)
+      : sector_len_(sector_len) {
+    const _u64 total_slots = capacity_bytes / sector_len;
+    const size_t n_shards =
+        std::max<size_t>(1, std::min<_u64>(kNumShards, total_slots));
+    shards_.reserve(n_shards);
+    for (size_t i = 0; i < n_shards; ++i) {
+      auto shard = std::make_unique<Shard>();
+      shard->nslots = total_slots / n_shards + (i < total_slots % n_shards);
+      shard->keys.assign(shard->nslots, kInvalidKey);
+      shard->ref.assign(shard->nslots, 0);
+      // left uninitialized, pages are only touched once a slot is filled
+      shard->buf.reset(new char[shard->nslots * sector_len_]);
+      shard->slot_of.reserve(shard->nslots);
+      // the ghost queue remembers as many keys as the shard holds sectors
+      shard->ghost_fifo.assign(shard->nslots, kInvalidKey);
+      shard->ghost.reserve(shard->nslots);
+      capacity_ += shard->nslots;
+      shards_.push_back(std::move(shard));
+    }
+  }
+
+  bool SectorCache::lookup(_u64 offset, char *out) {
+    auto                       &shard = shard_of(offset);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto                        iter = shard.slot_of.find(offset);
+    if (iter == shard.slot_of.end()) {
+      return false;
+    }
+    const auto slot = iter->second;
+    shard.ref[slot] = 1;
+    memcpy(out, shard.buf.get() + slot * sector_len_, sector_len_);
+    return true;
+  }
+
+  void SectorCache::insert(_u64 offset, const char *buf) {
+    auto                       &shard = shard_of(offset);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    if (shard.nslots == 0 || shard.slot_of.count(offset) > 0) {
+      return;
+    }
+    _u32 slot;
+    if (shard.used < shard.nslots) {
+      slot = shard.used++;
+    } else {
+      auto ghost_iter = shard.ghost.find(offset);
+      if (ghost_iter == shard.ghost.end()) {
+        add_ghost(shard, offset);
+        return;
+      }
+      // free its fifo position too, otherwise recycling that position would
+      // drop the key early if it turns into a ghost again
+      shard.ghost_fifo[ghost_iter->second] = kInvalidKey;
+      shard.ghost.erase(ghost_iter);
+      slot = evict(shard);
+      shard.slot_of.erase(shard.keys[slot]);
+    }
+    shard.keys[slot] = offset;
+    shard.ref[slot] = 0;
+    shard.slot_of[offset] = slot;
+    memcpy(shard.buf.get() + slot * sector_len_, buf, sector_len_);
+  }
+
+  _u32 SectorCache::evict(Shard &shard) {
+    while (true) {
+      const auto slot = shard.hand;
+      shard.hand = (shard.hand + 1) % shard.nslots;
+      if (shard.ref[slot] == 0) {
+        return slot;
+      }
+      shard.ref[slot] = 0;
+    }
+  }
+
+  void SectorCache::add_ghost(Shard &shard, _u64 offset) {
+    auto &oldest = shard.ghost_fifo[shard.ghost_head];
+    if (oldest != kInvalidKey) {
+      shard.ghost.erase(oldest);
+    }
+    oldest = offset;
+    shard.ghost[offset] = shard.ghost_head;
+    shard.ghost_head = (shard.ghost_head + 1) % shard.nslots;
+  }
+}  // namespace diskann
@@ -0,0 +1,384 @@
+#include "diskann/uring_aligned_file_reader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+
+#include "diskann/aio_context_pool.h"
+#include "diskann/ann_exception.h"
+#include "diskann/utils.h"
+
+namespace {
+  // keep the same per-context depth as the libaio pool so that callers
+  // batching by `max_events_per_ctx` behave identically on both backends
+  constexpr size_t kUringDepth = default_max_events;
+  // size of the registered file table of every ring, readers beyond this
+  // many open at once read through their plain fd
+  constexpr int kMaxFileSlots = 256;
+
+  [[noreturn]] void throw_uring_error(const char *op, int err) {
+    std::stringstream ss;
+    ss << op << " failed, errno: " << err << ", " << strerror(err);
+    throw diskann::ANNException(ss.str(), -1, __FUNCSIG__, __FILE__,
+                                __LINE__);
+  }
+
+  // a request in flight, its remaining part is resubmitted on a short read
+  struct PendingRead {
+    AlignedRead req;
+    void       *done_buf = nullptr;
+    int         fd = -1;
+    bool        fixed_file = false;
+  };
+
+  struct UringThreadRing;
+
+  // every live ring and the owner of every file slot, so that a closing
+  // reader can drop its file from the rings of all threads
+  std::mutex                           registry_mtx;
+  std::unordered_set<UringThreadRing *> registry_rings;
+  std::vector<uint64_t>                slot_owner(kMaxFileSlots, 0);
+  uint64_t                             next_file_gen = 1;
+
+  // ring whose kernel submission thread the other rings attach to in SQPOLL
+  // mode, kept alive for the lifetime of the process
+  std::mutex      anchor_mtx;
+  struct io_uring anchor_ring;
+  bool            anchor_ok = false;
+
+  struct UringThreadRing {
+    struct io_uring            ring;
+    bool                       files_ok = false;
+    // generation of the reader file registered in each slot of this ring
+    std::vector<uint64_t>      file_gens;
+    std::vector<PendingRead>   pending;
+    std::vector<PendingRead *> free_pending;
+    size_t                     inflight = 0;
+
+    UringThreadRing(bool sqpoll, uint32_t sq_thread_idle_ms)
+        : file_gens(kMaxFileSlots, 0), pending(kUringDepth) {
+      struct io_uring_params params;
+      memset(&params, 0, sizeof(params));
+      if (sqpoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = sq_thread_idle_ms;
+        std::scoped_lock lk(anchor_mtx);
+        if (anchor_ok) {
+          params.flags |= IORING_SETUP_ATTACH_WQ;
+          params.wq_fd = anchor_ring.ring_fd;
+        }
+      }
+      int ret = io_uring_queue_init_params(kUringDepth, &ring, &params);
+      if (ret < 0) {
+        throw_uring_error("io_uring_queue_init_params", -ret);
+      }
+      // a sparse table, slots are filled in as readers are used
+      std::vector<int> fds(kMaxFileSlots, -1);
+      files_ok = io_uring_register_files(&ring, fds.data(), fds.size()) == 0;
+      for (auto &p : pending) {
+        free_pending.push_back(&p);
+      }
+      std::scoped_lock lk(registry_mtx);
+      registry_rings.insert(this);
+    }
+
+    ~UringThreadRing() {
+      {
+        std::scoped_lock lk(registry_mtx);
+        registry_rings.erase(this);
+      }
+      io_uring_queue_exit(&ring);
+    }
+
+    void prep(PendingRead *p) {
+      struct io_uring_sqe *sqe = io_uring_get_sqe(&ring);
+      if (sqe == nullptr) {
+        // submission queue is full, flush it and retry
+        io_uring_submit(&ring);
+        sqe = io_uring_get_sqe(&ring);
+        if (sqe == nullptr) {
+          throw_uring_error("io_uring_get_sqe", EBUSY);
+        }
+      }
+      io_uring_prep_read(sqe, p->fd, p->req.buf, p->req.len, p->req.offset);
+      if (p->fixed_file) {
+        sqe->flags |= IOSQE_FIXED_FILE;
+      }
+      io_uring_sqe_set_data(sqe, p);
+    }
+
+    void submit() {
+      int ret;
+      while ((ret = io_uring_submit(&ring)) < 0) {
+        if (-ret != EINTR && -ret != EAGAIN) {
+          throw_uring_error("io_uring_submit", -ret);
+        }
+      }
+    }
+
+    // reap a single completion, blocking if `wait`. Returns false if none is
+    // ready. On a short read the missing tail is resubmitted and `*done` is
+    // left null, on a failed read the error is returned in `*err`.
+    bool reap(bool wait, void **done, int *err) {
+      struct io_uring_cqe *cqe = nullptr;
+      int                  ret;
+      do {
+        ret = wait ? io_uring_wait_cqe(&ring, &cqe)
+                   : io_uring_peek_cqe(&ring, &cqe);
+      } while (ret == -EINTR);
+      if (ret == -EAGAIN && !wait) {
+        return false;
+      }
+      if (ret < 0) {
+        throw_uring_error("io_uring_wait_cqe", -ret);
+      }
+      auto p = static_cast<PendingRead *>(io_uring_cqe_get_data(cqe));
+      int  res = cqe->res;
+      io_uring_cqe_seen(&ring, cqe);
+
+      *done = nullptr;
+      *err = 0;
+      if (res < 0) {
+        *err = -res;
+      } else if ((uint64_t) res < p->req.len) {
+        // O_DIRECT only stops short at the end of the file or on a signal,
+        // anything that would leave the tail unaligned is an error
+        if (res == 0 || !IS_512_ALIGNED(res)) {
+          *err = EIO;
+        } else {
+          p->req.offset += res;
+          p->req.len -= res;
+          p->req.buf = static_cast<char *>(p->req.buf) + res;
+          prep(p);
+          submit();
+          return true;
+        }
+      }
+      if (*err == 0) {
+        *done = p->done_buf;
+      }
+      free_pending.push_back(p);
+      inflight--;
+      return true;
+    }
+
+    // wait for everything still in flight, used before throwing so that a
+    // failed search leaves no stale completions for the next one
+    void drain() {
+      void *done;
+      int   err;
+      while (inflight > 0) {
+        try {
+          reap(true, &done, &err);
+        } catch (const diskann::ANNException &) {
+          // the ring itself is broken, nothing left to drain
+          free_pending.clear();
+          for (auto &p : pending) {
+            free_pending.push_back(&p);
+          }
+          inflight = 0;
+        }
+      }
+    }
+  };
+
+  thread_local std::unique_ptr<UringThreadRing> thread_ring;
+}  // namespace
+
+UringAlignedFileReader::~UringAlignedFileReader() {
+  close();
+}
+
+IOContext UringAlignedFileReader::get_ctx() {
+  if (thread_ring == nullptr) {
+    thread_ring =
+        std::make_unique<UringThreadRing>(sqpoll_, sq_thread_idle_ms_);
+  }
+  return thread_ring.get();
+}
+
+void UringAlignedFileReader::put_ctx(IOContext ctx) {
+  // the ring stays with its thread
+}
+
+size_t UringAlignedFileReader::max_events_per_ctx() {
+  return kUringDepth;
+}
+
+void UringAlignedFileReader::open(const std::string &fname) {
+  int flags = O_DIRECT | O_RDONLY | O_LARGEFILE;
+  file_desc_ = ::open(fname.c_str(), flags);
+  if (file_desc_ == -1) {
+    throw_uring_error("open", errno);
+  }
+  std::scoped_lock lk(registry_mtx);
+  auto it = std::find(slot_owner.begin(), slot_owner.end(), 0);
+  if (it != slot_owner.end()) {
+    file_slot_ = (int) (it - slot_owner.begin());
+    file_gen_ = next_file_gen++;
+    *it = file_gen_;
+  }
+  LOG_KNOWHERE_DEBUG_ << "Opened file with io_uring : " << fname
+                      << ", file slot: " << file_slot_;
+}
+
+void UringAlignedFileReader::close() {
+  if (file_slot_ >= 0) {
+    std::scoped_lock lk(registry_mtx);
+    const int closed_fd = -1;
+    for (auto ring : registry_rings) {
+      if (ring->file_gens[file_slot_] == file_gen_) {
+        io_uring_register_files_update(&ring->ring, file_slot_, &closed_fd, 1);
+        ring->file_gens[file_slot_] = 0;
+      }
+    }
+    slot_owner[file_slot_] = 0;
+    file_slot_ = -1;
+  }
+  if (file_desc_ != -1) {
+    ::close(file_desc_);
+    file_desc_ = -1;
+  }
+}
+
+void UringAlignedFileReader::read(std::vector<AlignedRead> &read_reqs,
+                                  IOContext &ctx, bool async) {
+  if (async == true) {
+    diskann::cout << "Async currently not supported in linux." << std::endl;
+  }
+  assert(file_desc_ != -1);
+
+  // break-up requests into chunks of at most the ring depth each
+  for (size_t start = 0; start < read_reqs.size(); start += kUringDepth) {
+    size_t                   end = std::min(read_reqs.size(), start + kUringDepth);
+    std::vector<AlignedRead> chunk(read_reqs.begin() + start,
+                                   read_reqs.begin() + end);
+    submit_req(ctx, chunk);
+    get_submitted_req(ctx, chunk.size());
+  }
+}
+
+void UringAlignedFileReader::submit_req(IOContext                &ctx,
+                                        std::vector<AlignedRead> &read_reqs) {
+  auto ring = static_cast<UringThreadRing *>(ctx);
+  if (read_reqs.size() > ring->free_pending.size()) {
+    std::stringstream err;
+    err << "Async does not support number of read requests ("
+        << read_reqs.size() << ") exceeds max number of events per context ("
+        << kUringDepth << ")";
+    throw diskann::ANNException(err.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+  }
+
+  // make sure the file is in the table of this ring, then read through it
+  bool fixed_file = false;
+  if (file_slot_ >= 0 && ring->files_ok) {
+    if (ring->file_gens[file_slot_] != file_gen_) {
+      std::scoped_lock lk(registry_mtx);
+      if (io_uring_register_files_update(&ring->ring, file_slot_, &file_desc_,
+                                         1) >= 0) {
+        ring->file_gens[file_slot_] = file_gen_;
+      }
+    }
+    fixed_file = ring->file_gens[file_slot_] == file_gen_;
+  }
+
+  for (const auto &req : read_reqs) {
+    PendingRead *p = ring->free_pending.back();
+    ring->free_pending.pop_back();
+    p->req = req;
+    p->done_buf = req.buf;
+    p->fd = fixed_file ? file_slot_ : file_desc_;
+    p->fixed_file = fixed_file;
+    ring->inflight++;
+    ring->prep(p);
+  }
+  try {
+    ring->submit();
+  } catch (const diskann::ANNException &) {
+    ring->drain();
+    throw;
+  }
+}
+
+void UringAlignedFileReader::get_submitted_req(IOContext &ctx, size_t n_ops) {
+  std::vector<void *> done_bufs;
+  done_bufs.reserve(n_ops);
+  size_t num_read = 0;
+  while (num_read < n_ops) {
+    num_read +=
+        poll_submitted_req(ctx, n_ops - num_read, n_ops - num_read, done_bufs);
+  }
+}
+
+size_t UringAlignedFileReader::poll_submitted_req(
+    IOContext &ctx, size_t min_nr, size_t max_nr,
+    std::vector<void *> &done_bufs) {
+  if (max_nr > kUringDepth) {
+    std::stringstream err;
+    err << "Async does not support polling number of read requests ("
+        << max_nr << ") exceeds max number of events per context ("
+        << kUringDepth << ")";
+    throw diskann::ANNException(err.str(), -1, __FUNCSIG__, __FILE__, __LINE__);
+  }
+  auto   ring = static_cast<UringThreadRing *>(ctx);
+  size_t num_done = 0;
+  while (num_done < max_nr && ring->inflight > 0) {
+    void *done;
+    int   err;
+    try {
+      if (!ring->reap(num_done < min_nr, &done, &err)) {
+        break;
+      }
+    } catch (const diskann::ANNException &) {
+      ring->drain();
+      throw;
+    }
+    if (err != 0) {
+      ring->drain();
+      throw_uring_error("io_uring read", err);
+    }
+    if (done != nullptr) {
+      done_bufs.push_back(done);
+      num_done++;
+    }
+  }
+  return num_done;
+}
+
+bool UringAlignedFileReader::InitGlobalUringConfig(bool     enable,
+                                                   bool     sqpoll,
+                                                   uint32_t sq_thread_idle_ms) {
+  if (enable) {
+    // probe the kernel once with the requested setup flags, in SQPOLL mode
+    // the probe ring is kept as the one the thread rings attach to
+    std::scoped_lock       lk(anchor_mtx);
+    struct io_uring        ring;
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    if (sqpoll) {
+      params.flags |= IORING_SETUP_SQPOLL;
+      params.sq_thread_idle = sq_thread_idle_ms;
+    }
+    int ret = io_uring_queue_init_params(1, &ring, &params);
+    if (ret < 0) {
+      LOG(WARNING) << "io_uring is not available, errno: " << -ret << ", "
+                   << strerror(-ret) << ". Keep using libaio.";
+      enabled_ = false;
+      return false;
+    }
+    if (sqpoll && !anchor_ok) {
+      anchor_ring = ring;
+      anchor_ok = true;
+    } else {
+      io_uring_queue_exit(&ring);
+    }
+  }
+  enabled_ = enable;
+  sqpoll_ = sqpoll;
+  sq_thread_idle_ms_ = sq_thread_idle_ms;
+  return true;
+}
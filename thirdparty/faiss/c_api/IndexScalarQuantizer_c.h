@@ -29,6 +29,8 @@ typedef enum FaissQuantizerType {
     QT_bf16,
     QT_8bit_direct_signed, ///< fast indexing of signed int8s ranging from [-128
                            ///< to 127]
+    QT_8bit_direct_signed_raw, ///< same, the codes are the int8s as they are,
+                               ///< without the offset of 128
 } FaissQuantizerType;
 
 // forward declaration
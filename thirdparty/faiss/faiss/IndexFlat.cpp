@@ -145,14 +145,17 @@ struct FlatL2Dis : FlatCodesDistanceComputer {
     const float* q;
     const float* b;
     size_t ndis;
+    // kernels picked for the dimension once per distance computer
+    decltype(fvec_L2sqr) dis_func;
+    decltype(fvec_L2sqr_batch_4) dis_batch_4_func;
 
     float distance_to_code(const uint8_t* code) final {
         ndis++;
-        return fvec_L2sqr(q, (float*)code, d);
+        return dis_func(q, (float*)code, d);
     }
 
     float symmetric_dis(idx_t i, idx_t j) override {
-        return fvec_L2sqr(b + j * d, b + i * d, d);
+        return dis_func(b + j * d, b + i * d, d);
     }
 
     explicit FlatL2Dis(const IndexFlat& storage, const float* q = nullptr)
@@ -163,7 +166,9 @@ struct FlatL2Dis : FlatCodesDistanceComputer {
               nb(storage.ntotal),
               q(q),
               b(storage.get_xb()),
-              ndis(0) {}
+              ndis(0),
+              dis_func(fvec_L2sqr_for_dim(storage.d)),
+              dis_batch_4_func(fvec_L2sqr_batch_4_for_dim(storage.d)) {}
 
     void set_query(const float* x) override {
         q = x;
@@ -195,7 +200,7 @@ struct FlatL2Dis : FlatCodesDistanceComputer {
         float dp1 = 0;
         float dp2 = 0;
         float dp3 = 0;
-        fvec_L2sqr_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
+        dis_batch_4_func(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
         dis0 = dp0;
         dis1 = dp1;
         dis2 = dp2;
@@ -209,14 +214,17 @@ struct FlatIPDis : FlatCodesDistanceComputer {
     const float* q;
     const float* b;
     size_t ndis;
+    // kernels picked for the dimension once per distance computer
+    decltype(fvec_inner_product) dis_func;
+    decltype(fvec_inner_product_batch_4) dis_batch_4_func;
 
     float symmetric_dis(idx_t i, idx_t j) final override {
-        return fvec_inner_product(b + j * d, b + i * d, d);
+        return dis_func(b + j * d, b + i * d, d);
     }
 
     float distance_to_code(const uint8_t* code) final override {
         ndis++;
-        return fvec_inner_product(q, (const float*)code, d);
+        return dis_func(q, (const float*)code, d);
     }
 
     explicit FlatIPDis(const IndexFlat& storage, const float* q = nullptr)
@@ -227,7 +235,9 @@ struct FlatIPDis : FlatCodesDistanceComputer {
               nb(storage.ntotal),
               q(q),
               b(storage.get_xb()),
-              ndis(0) {}
+              ndis(0),
+              dis_func(fvec_inner_product_for_dim(storage.d)),
+              dis_batch_4_func(fvec_inner_product_batch_4_for_dim(storage.d)) {}
 
     void set_query(const float* x) override {
         q = x;
@@ -259,7 +269,7 @@ struct FlatIPDis : FlatCodesDistanceComputer {
         float dp1 = 0;
         float dp2 = 0;
         float dp3 = 0;
-        fvec_inner_product_batch_4(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
+        dis_batch_4_func(q, y0, y1, y2, y3, d, dp0, dp1, dp2, dp3);
         dis0 = dp0;
         dis1 = dp1;
         dis2 = dp2;
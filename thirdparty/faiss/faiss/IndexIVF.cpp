@@ -643,6 +643,15 @@ void IndexIVF::search_preassigned(
                     if (nscan >= max_codes && (!ensure_topk_full || nscan >= k)) {
                         break;
                     }
+
+                    // poll after every list: with a thread safe callback
+                    // (the knowhere cancel token) this is a thread-local
+                    // load and at most a clock read, and even the locked
+                    // poll is cheap next to scanning a list
+                    if (InterruptCallback::is_interrupted()) {
+                        interrupt = true;
+                        break;
+                    }
                 }
 
                 ndis += nscan;
@@ -935,6 +944,11 @@ void IndexIVF::range_search_preassigned(
                         break;
                     }
                     prev_nres = qres.nres;
+
+                    if (InterruptCallback::is_interrupted()) {
+                        interrupt = true;
+                        break;
+                    }
                 }
 
                 // The end of Knowhere-specific code.
@@ -13,11 +13,15 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <cmath>
 #include <cstdio>
+#include <type_traits>
 
 #include "knowhere/object.h"
 #include "knowhere/utils.h"
 #include "knowhere/bitsetview_idselector.h"
+#include "knowhere/operands.h"
+#include "simd/hook.h"
 
 #include <faiss/IndexFlat.h>
 
@@ -584,6 +588,405 @@ IndexIVFFlatCC::IndexIVFFlatCC(
 
 IndexIVFFlatCC::IndexIVFFlatCC() {}
 
+/*****************************************
+ * IndexIVFFlatTyped implementation
+ ******************************************/
+
+IndexIVFFlatTyped::IndexIVFFlatTyped(
+        Index* quantizer,
+        size_t d,
+        size_t nlist,
+        ScalarQuantizer::QuantizerType qtype,
+        MetricType metric,
+        bool is_cosine)
+        : IndexIVFFlat(quantizer, d, nlist, metric, is_cosine), sq(d, qtype) {
+    FAISS_THROW_IF_NOT_MSG(
+            qtype == ScalarQuantizer::QT_fp16 ||
+                    qtype == ScalarQuantizer::QT_bf16 ||
+                    qtype == ScalarQuantizer::QT_8bit_direct_signed_raw,
+            "IndexIVFFlatTyped only stores fp16, bf16 and int8 vectors");
+    code_size = sq.code_size;
+    replace_invlists(new ArrayInvertedLists(nlist, code_size, is_cosine), true);
+}
+
+IndexIVFFlatTyped::IndexIVFFlatTyped() {}
+
+void IndexIVFFlatTyped::add_core(
+        idx_t n,
+        const float* x,
+        const float* x_norms,
+        const idx_t* xids,
+        const idx_t* coarse_idx,
+        void* inverted_list_context) {
+    FAISS_THROW_IF_NOT(is_trained);
+    FAISS_THROW_IF_NOT(coarse_idx);
+    FAISS_THROW_IF_NOT(!by_residual);
+    assert(invlists);
+    direct_map.check_can_add(xids);
+
+    std::vector<uint8_t> codes(n * code_size);
+    sq.compute_codes(x, codes.data(), n);
+
+    DirectMapAdd dm_adder(direct_map, n, xids);
+
+#pragma omp parallel
+    {
+        int nt = omp_get_num_threads();
+        int rank = omp_get_thread_num();
+
+        // each thread takes care of a subset of lists
+        for (size_t i = 0; i < n; i++) {
+            idx_t list_no = coarse_idx[i];
+
+            if (list_no >= 0 && list_no % nt == rank) {
+                idx_t id = xids ? xids[i] : ntotal + i;
+                const float* xi_normal =
+                        (x_norms == nullptr) ? nullptr : (x_norms + i);
+                size_t offset = invlists->add_entry(
+                        list_no,
+                        id,
+                        codes.data() + i * code_size,
+                        xi_normal,
+                        inverted_list_context);
+                dm_adder.add(i, list_no, offset);
+            } else if (rank == 0 && list_no == -1) {
+                dm_adder.add(i, -1, 0);
+            }
+        }
+    }
+    ntotal += n;
+}
+
+void IndexIVFFlatTyped::encode_vectors(
+        idx_t n,
+        const float* x,
+        const idx_t* list_nos,
+        uint8_t* codes,
+        bool include_listnos) const {
+    FAISS_THROW_IF_NOT(!by_residual);
+    if (!include_listnos) {
+        sq.compute_codes(x, codes, n);
+    } else {
+        size_t coarse_size = coarse_code_size();
+        for (size_t i = 0; i < n; i++) {
+            int64_t list_no = list_nos[i];
+            uint8_t* code = codes + i * (code_size + coarse_size);
+            if (list_no >= 0) {
+                encode_listno(list_no, code);
+                sq.compute_codes(x + i * d, code + coarse_size, 1);
+            } else {
+                memset(code, 0, code_size + coarse_size);
+            }
+        }
+    }
+}
+
+void IndexIVFFlatTyped::sa_decode(idx_t n, const uint8_t* bytes, float* x)
+        const {
+    size_t coarse_size = coarse_code_size();
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* code = bytes + i * (code_size + coarse_size);
+        sq.decode(code + coarse_size, x + i * d, 1);
+    }
+}
+
+void IndexIVFFlatTyped::reconstruct_from_offset(
+        int64_t list_no,
+        int64_t offset,
+        float* recons) const {
+    sq.decode(invlists->get_single_code(list_no, offset), recons, 1);
+}
+
+namespace {
+
+// rows of a list whose distances are computed by a single _ny call
+constexpr size_t TYPED_SCAN_BLOCK_SIZE = 256;
+
+template <typename DataType>
+float typed_norm_L2sqr(const DataType* x, size_t d) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+        return fp16_vec_norm_L2sqr(x, d);
+    } else if constexpr (std::is_same_v<DataType, knowhere::bf16>) {
+        return bf16_vec_norm_L2sqr(x, d);
+    } else {
+        return int8_vec_norm_L2sqr(x, d);
+    }
+}
+
+template <typename DataType, MetricType metric>
+float typed_distance(const DataType* x, const DataType* y, size_t d) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+        return metric == METRIC_INNER_PRODUCT ? fp16_vec_inner_product(x, y, d)
+                                              : fp16_vec_L2sqr(x, y, d);
+    } else if constexpr (std::is_same_v<DataType, knowhere::bf16>) {
+        return metric == METRIC_INNER_PRODUCT ? bf16_vec_inner_product(x, y, d)
+                                              : bf16_vec_L2sqr(x, y, d);
+    } else {
+        return metric == METRIC_INNER_PRODUCT ? int8_vec_inner_product(x, y, d)
+                                              : int8_vec_L2sqr(x, y, d);
+    }
+}
+
+template <typename DataType, MetricType metric>
+void typed_distances_ny(
+        float* dis,
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t ny) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+        metric == METRIC_INNER_PRODUCT
+                ? fp16_vec_inner_products_ny(dis, x, y, d, ny)
+                : fp16_vec_L2sqr_ny(dis, x, y, d, ny);
+    } else if constexpr (std::is_same_v<DataType, knowhere::bf16>) {
+        metric == METRIC_INNER_PRODUCT
+                ? bf16_vec_inner_products_ny(dis, x, y, d, ny)
+                : bf16_vec_L2sqr_ny(dis, x, y, d, ny);
+    } else {
+        metric == METRIC_INNER_PRODUCT
+                ? int8_vec_inner_products_ny(dis, x, y, d, ny)
+                : int8_vec_L2sqr_ny(dis, x, y, d, ny);
+    }
+}
+
+template <typename DataType, MetricType metric, typename Pred, typename Apply>
+void typed_distances_ny_if(
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t ny,
+        Pred pred,
+        Apply apply) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+        if constexpr (metric == METRIC_INNER_PRODUCT) {
+            fp16_vec_inner_products_ny_if(x, y, d, ny, pred, apply);
+        } else {
+            fp16_vec_L2sqr_ny_if(x, y, d, ny, pred, apply);
+        }
+    } else if constexpr (std::is_same_v<DataType, knowhere::bf16>) {
+        if constexpr (metric == METRIC_INNER_PRODUCT) {
+            bf16_vec_inner_products_ny_if(x, y, d, ny, pred, apply);
+        } else {
+            bf16_vec_L2sqr_ny_if(x, y, d, ny, pred, apply);
+        }
+    } else {
+        if constexpr (metric == METRIC_INNER_PRODUCT) {
+            int8_vec_inner_products_ny_if(x, y, d, ny, pred, apply);
+        } else {
+            int8_vec_L2sqr_ny_if(x, y, d, ny, pred, apply);
+        }
+    }
+}
+
+// scans the lists of IndexIVFFlatTyped. Without a selector the rows of a list
+//   go block by block through the _ny kernel, otherwise only the accepted
+//   ones are computed. Sel is the type of the selector, so that the calls
+//   to a BitsetViewIDSelector are not virtual.
+template <
+        typename DataType,
+        MetricType metric,
+        class C,
+        bool use_sel,
+        class Sel>
+struct IVFFlatTypedScanner : InvertedListScanner {
+    size_t d;
+    std::vector<DataType> query;
+    /// divides the distances to the codes that have a norm (cosine)
+    float query_inverse_norm = 1.0f;
+
+    IVFFlatTypedScanner(size_t d, bool store_pairs, const IDSelector* sel)
+            : InvertedListScanner(store_pairs, sel), d(d), query(d) {
+        keep_max = is_similarity_metric(metric);
+        code_size = d * sizeof(DataType);
+    }
+
+    void set_query(const float* x) override {
+        for (size_t i = 0; i < d; i++) {
+            query[i] = DataType(x[i]);
+        }
+        if constexpr (metric == METRIC_INNER_PRODUCT) {
+            const float norm = std::sqrt(typed_norm_L2sqr(query.data(), d));
+            query_inverse_norm = (norm == 0.0f) ? 1.0f : 1.0f / norm;
+        }
+    }
+
+    void set_list(idx_t list_no, float /* coarse_dis */) override {
+        this->list_no = list_no;
+    }
+
+    float distance_to_code(const uint8_t* code) const override {
+        return typed_distance<DataType, metric>(
+                query.data(), (const DataType*)code, d);
+    }
+
+    // calls apply(dis, j) for the accepted rows j of a list
+    template <typename Apply>
+    void for_each_distance(
+            size_t list_size,
+            const uint8_t* codes,
+            const float* code_norms,
+            const idx_t* ids,
+            Apply apply) const {
+        const DataType* list_vecs = (const DataType*)codes;
+        auto apply_normed = [&](const float dis_in, const size_t j) {
+            apply((code_norms == nullptr)
+                          ? dis_in
+                          : (dis_in * query_inverse_norm / code_norms[j]),
+                  j);
+        };
+        if constexpr (use_sel) {
+            const Sel* selector = static_cast<const Sel*>(sel);
+            auto filter = [&](const size_t j) {
+                return selector->is_member(ids[j]);
+            };
+            typed_distances_ny_if<DataType, metric>(
+                    query.data(),
+                    list_vecs,
+                    d,
+                    list_size,
+                    filter,
+                    apply_normed);
+        } else {
+            float dis[TYPED_SCAN_BLOCK_SIZE];
+            for (size_t j0 = 0; j0 < list_size; j0 += TYPED_SCAN_BLOCK_SIZE) {
+                const size_t nb =
+                        std::min(TYPED_SCAN_BLOCK_SIZE, list_size - j0);
+                typed_distances_ny<DataType, metric>(
+                        dis, query.data(), list_vecs + j0 * d, d, nb);
+                for (size_t j = 0; j < nb; j++) {
+                    apply_normed(dis[j], j0 + j);
+                }
+            }
+        }
+    }
+
+    size_t scan_codes(
+            size_t list_size,
+            const uint8_t* codes,
+            const float* code_norms,
+            const idx_t* ids,
+            float* simi,
+            idx_t* idxi,
+            size_t k,
+            size_t& scan_cnt) const override {
+        size_t nup = 0;
+        for_each_distance(
+                list_size,
+                codes,
+                code_norms,
+                ids,
+                [&](const float dis, const size_t j) {
+                    scan_cnt++;
+                    if (C::cmp(simi[0], dis)) {
+                        const int64_t id =
+                                store_pairs ? lo_build(list_no, j) : ids[j];
+                        heap_replace_top<C>(k, simi, idxi, dis, id);
+                        nup++;
+                    }
+                });
+        return nup;
+    }
+
+    void scan_codes_and_return(
+            size_t list_size,
+            const uint8_t* codes,
+            const float* code_norms,
+            const idx_t* ids,
+            std::vector<knowhere::DistId>& out) const override {
+        for_each_distance(
+                list_size,
+                codes,
+                code_norms,
+                ids,
+                [&](const float dis, const size_t j) {
+                    out.emplace_back(ids[j], dis);
+                });
+    }
+
+    void scan_codes_range(
+            size_t list_size,
+            const uint8_t* codes,
+            const float* code_norms,
+            const idx_t* ids,
+            float radius,
+            RangeQueryResult& res) const override {
+        for_each_distance(
+                list_size,
+                codes,
+                code_norms,
+                ids,
+                [&](const float dis, const size_t j) {
+                    if (C::cmp(radius, dis)) {
+                        int64_t id =
+                                store_pairs ? lo_build(list_no, j) : ids[j];
+                        res.add(dis, id);
+                    }
+                });
+    }
+};
+
+template <typename DataType, MetricType metric, class C>
+InvertedListScanner* get_typed_InvertedListScanner2(
+        size_t d,
+        bool store_pairs,
+        const IDSelector* sel) {
+    if (sel == nullptr) {
+        return new IVFFlatTypedScanner<DataType, metric, C, false, IDSelector>(
+                d, store_pairs, sel);
+    }
+    if (dynamic_cast<const knowhere::BitsetViewIDSelector*>(sel) != nullptr) {
+        return new IVFFlatTypedScanner<
+                DataType,
+                metric,
+                C,
+                true,
+                knowhere::BitsetViewIDSelector>(d, store_pairs, sel);
+    }
+    return new IVFFlatTypedScanner<DataType, metric, C, true, IDSelector>(
+            d, store_pairs, sel);
+}
+
+template <typename DataType>
+InvertedListScanner* get_typed_InvertedListScanner1(
+        const IndexIVFFlatTyped* ivf,
+        bool store_pairs,
+        const IDSelector* sel) {
+    if (ivf->metric_type == METRIC_INNER_PRODUCT) {
+        return get_typed_InvertedListScanner2<
+                DataType,
+                METRIC_INNER_PRODUCT,
+                CMin<float, int64_t>>(ivf->d, store_pairs, sel);
+    } else if (ivf->metric_type == METRIC_L2) {
+        return get_typed_InvertedListScanner2<
+                DataType,
+                METRIC_L2,
+                CMax<float, int64_t>>(ivf->d, store_pairs, sel);
+    } else {
+        FAISS_THROW_MSG("metric type not supported");
+    }
+}
+
+} // anonymous namespace
+
+InvertedListScanner* IndexIVFFlatTyped::get_InvertedListScanner(
+        bool store_pairs,
+        const IDSelector* sel,
+        const IVFSearchParameters*) const {
+    switch (sq.qtype) {
+        case ScalarQuantizer::QT_fp16:
+            return get_typed_InvertedListScanner1<knowhere::fp16>(
+                    this, store_pairs, sel);
+        case ScalarQuantizer::QT_bf16:
+            return get_typed_InvertedListScanner1<knowhere::bf16>(
+                    this, store_pairs, sel);
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return get_typed_InvertedListScanner1<knowhere::int8>(
+                    this, store_pairs, sel);
+        default:
+            FAISS_THROW_MSG("quantizer type not supported");
+    }
+}
+
 /*****************************************
  * IndexIVFFlatDedup implementation
  ******************************************/
@@ -14,6 +14,7 @@
 #include <unordered_map>
 
 #include <faiss/IndexIVF.h>
+#include <faiss/impl/ScalarQuantizer.h>
 
 #include "knowhere/object.h"
 
@@ -79,6 +80,52 @@ struct IndexIVFFlatCC : IndexIVFFlat {
     IndexIVFFlatCC();
 };
 
+/** Inverted file with the vectors stored as fp16, bf16 or int8, the codes of
+ * a QT_fp16, QT_bf16 or QT_8bit_direct_signed_raw scalar quantizer. The lists
+ * are scanned with the _ny kernels of the type, the query is converted to it
+ * first. So it has to be representable in the type: for cosine it is not
+ * normalized, the distances are divided by its norm instead.
+ */
+struct IndexIVFFlatTyped : IndexIVFFlat {
+    /// converts the vectors to and from the codes of the lists
+    ScalarQuantizer sq;
+
+    IndexIVFFlatTyped(
+            Index* quantizer,
+            size_t d,
+            size_t nlist_,
+            ScalarQuantizer::QuantizerType qtype,
+            MetricType = METRIC_L2,
+            bool is_cosine = false);
+
+    void add_core(
+            idx_t n,
+            const float* x,
+            const float* x_norms,
+            const idx_t* xids,
+            const idx_t* precomputed_idx,
+            void* inverted_list_context = nullptr) override;
+
+    void encode_vectors(
+            idx_t n,
+            const float* x,
+            const idx_t* list_nos,
+            uint8_t* codes,
+            bool include_listnos = false) const override;
+
+    InvertedListScanner* get_InvertedListScanner(
+            bool store_pairs,
+            const IDSelector* sel,
+            const IVFSearchParameters* params) const override;
+
+    void reconstruct_from_offset(int64_t list_no, int64_t offset, float* recons)
+            const override;
+
+    void sa_decode(idx_t n, const uint8_t* bytes, float* x) const override;
+
+    IndexIVFFlatTyped();
+};
+
 struct IndexIVFFlatDedup : IndexIVFFlat {
     /** Maps ids stored in the index to the ids of vectors that are
      *  the same. When a vector is unique, it does not appear in the
@@ -97,6 +97,7 @@ IndexIVF* Cloner::clone_IndexIVF(const IndexIVF* ivf) {
     TRYCLONE(IndexIVFPQFastScan, ivf)
 
     TRYCLONE(IndexIVFFlatDedup, ivf)
+    TRYCLONE(IndexIVFFlatTyped, ivf)
     TRYCLONE(IndexIVFFlat, ivf)
 
     TRYCLONE(IndexIVFSpectralHash, ivf)
@@ -44,6 +44,9 @@ namespace {
 // whether to track statistics
 constexpr bool track_hnsw_stats = true;
 
+// number of hops between two polls of the interrupt callback
+constexpr size_t interrupt_check_period = 64;
+
 } // namespace
 
 // Accomodates all the search logic and variables.
@@ -309,7 +312,14 @@ struct v2_hnsw_searcher {
         };
 
         // iterate while possible
+        size_t nhops = 0;
         while (retset.has_next()) {
+            // stop if the search was interrupted, the caller checks for it
+            if (++nhops % interrupt_check_period == 0 &&
+                InterruptCallback::is_interrupted()) {
+                break;
+            }
+
             // get a node to be processed
             const knowhere::Neighbor neighbor = retset.pop();
 
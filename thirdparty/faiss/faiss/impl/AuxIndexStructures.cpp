@@ -221,9 +221,13 @@ void InterruptCallback::check() {
 }
 
 bool InterruptCallback::is_interrupted() {
-    if (!instance.get()) {
+    InterruptCallback* cb = instance.get();
+    if (!cb) {
         return false;
     }
+    if (cb->is_thread_safe()) {
+        return cb->want_interrupt();
+    }
     std::lock_guard<std::mutex> guard(lock);
     return instance->want_interrupt();
 }
@@ -136,6 +136,12 @@ struct FAISS_API InterruptCallback {
     virtual bool want_interrupt() = 0;
     virtual ~InterruptCallback() {}
 
+    /// true if want_interrupt() may be called from several threads at
+    /// once. is_interrupted() then polls it without taking the lock.
+    virtual bool is_thread_safe() const {
+        return false;
+    }
+
     // lock that protects concurrent calls to is_interrupted
     static std::mutex lock;
 
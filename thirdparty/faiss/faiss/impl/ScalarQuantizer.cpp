@@ -76,6 +76,7 @@ void ScalarQuantizer::set_derived_sizes() {
         case QT_8bit_uniform:
         case QT_8bit_direct:
         case QT_8bit_direct_signed:
+        case QT_8bit_direct_signed_raw:
             code_size = d;
             bits = 8;
             break;
@@ -134,6 +135,7 @@ void ScalarQuantizer::train(size_t n, const float* x) {
         case QT_8bit_direct:
         case QT_bf16:
         case QT_8bit_direct_signed:
+        case QT_8bit_direct_signed_raw:
             // no training necessary
             break;
     }
@@ -35,6 +35,8 @@ struct ScalarQuantizer : Quantizer {
         QT_bf16,
         QT_8bit_direct_signed, ///< fast indexing of signed int8s ranging from
                                ///< [-128 to 127]
+        QT_8bit_direct_signed_raw, ///< same, the codes are the int8s as they
+                                   ///< are, without the offset of 128
     };
 
     QuantizerType qtype = QT_8bit;
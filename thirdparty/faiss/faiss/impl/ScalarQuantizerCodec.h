@@ -328,6 +328,40 @@ struct Quantizer8bitDirectSigned<1> : ScalarQuantizer::SQuantizer {
     }
 };
 
+/*******************************************************************
+ * 8bit_direct_signed_raw quantizer
+ *******************************************************************/
+
+template <int SIMDWIDTH>
+struct Quantizer8bitDirectSignedRaw {};
+
+template <>
+struct Quantizer8bitDirectSignedRaw<1> : ScalarQuantizer::SQuantizer {
+    const size_t d;
+
+    Quantizer8bitDirectSignedRaw(
+            size_t d,
+            const std::vector<float>& /* unused */)
+            : d(d) {}
+
+    void encode_vector(const float* x, uint8_t* code) const final {
+        for (size_t i = 0; i < d; i++) {
+            code[i] = (uint8_t)(int8_t)x[i];
+        }
+    }
+
+    void decode_vector(const uint8_t* code, float* x) const final {
+        for (size_t i = 0; i < d; i++) {
+            x[i] = (int8_t)code[i];
+        }
+    }
+
+    FAISS_ALWAYS_INLINE float reconstruct_component(const uint8_t* code, int i)
+            const {
+        return (int8_t)code[i];
+    }
+};
+
 template <int SIMDWIDTH>
 SQuantizer* select_quantizer_1(
         QuantizerType qtype,
@@ -357,6 +391,8 @@ SQuantizer* select_quantizer_1(
             return new Quantizer8bitDirect<SIMDWIDTH>(d, trained);
         case ScalarQuantizer::QT_8bit_direct_signed:
             return new Quantizer8bitDirectSigned<SIMDWIDTH>(d, trained);
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return new Quantizer8bitDirectSignedRaw<SIMDWIDTH>(d, trained);
     }
     FAISS_THROW_MSG("unknown qtype");
 }
@@ -603,6 +639,12 @@ SQDistanceComputer* select_distance_computer(
                     Quantizer8bitDirectSigned<SIMDWIDTH>,
                     Sim,
                     SIMDWIDTH>(d, trained);
+
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return new DCTemplate<
+                    Quantizer8bitDirectSignedRaw<SIMDWIDTH>,
+                    Sim,
+                    SIMDWIDTH>(d, trained);
     }
     FAISS_THROW_MSG("unknown qtype");
     return nullptr;
@@ -717,6 +759,11 @@ InvertedListScanner* sel1_InvertedListScanner(
                     Quantizer8bitDirectSigned<SIMDWIDTH>,
                     Similarity,
                     SIMDWIDTH>>(sq, quantizer, store_pairs, sel, r);
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return sel2_InvertedListScanner<DCTemplate<
+                    Quantizer8bitDirectSignedRaw<SIMDWIDTH>,
+                    Similarity,
+                    SIMDWIDTH>>(sq, quantizer, store_pairs, sel, r);
     }
 
     FAISS_THROW_MSG("unknown qtype");
@@ -271,6 +271,36 @@ struct Quantizer8bitDirectSigned_avx<8> : public Quantizer8bitDirectSigned<1> {
     }
 };
 
+/*******************************************************************
+ * 8bit_direct_signed_raw quantizer
+ *******************************************************************/
+
+template <int SIMDWIDTH>
+struct Quantizer8bitDirectSignedRaw_avx {};
+
+template <>
+struct Quantizer8bitDirectSignedRaw_avx<1>
+        : public Quantizer8bitDirectSignedRaw<1> {
+    Quantizer8bitDirectSignedRaw_avx(size_t d, const std::vector<float>& unused)
+            : Quantizer8bitDirectSignedRaw(d, unused) {}
+};
+
+template <>
+struct Quantizer8bitDirectSignedRaw_avx<8>
+        : public Quantizer8bitDirectSignedRaw<1> {
+    Quantizer8bitDirectSignedRaw_avx(
+            size_t d,
+            const std::vector<float>& trained)
+            : Quantizer8bitDirectSignedRaw<1>(d, trained) {}
+
+    FAISS_ALWAYS_INLINE __m256
+    reconstruct_8_components(const uint8_t* code, int i) const {
+        __m128i x8 = _mm_loadl_epi64((__m128i*)(code + i)); // 8 * int8
+        __m256i y8 = _mm256_cvtepi8_epi32(x8);              // 8 * int32
+        return _mm256_cvtepi32_ps(y8);                      // 8 * float32
+    }
+};
+
 template <int SIMDWIDTH>
 SQuantizer* select_quantizer_1_avx(
         QuantizerType qtype,
@@ -300,6 +330,8 @@ SQuantizer* select_quantizer_1_avx(
             return new Quantizer8bitDirect_avx<SIMDWIDTH>(d, trained);
         case QuantizerType::QT_8bit_direct_signed:
             return new Quantizer8bitDirectSigned_avx<SIMDWIDTH>(d, trained);
+        case QuantizerType::QT_8bit_direct_signed_raw:
+            return new Quantizer8bitDirectSignedRaw_avx<SIMDWIDTH>(d, trained);
     }
     FAISS_THROW_MSG("unknown qtype");
 }
@@ -661,6 +693,12 @@ SQDistanceComputer* select_distance_computer_avx(
                     Quantizer8bitDirectSigned_avx<SIMDWIDTH>,
                     Sim,
                     SIMDWIDTH>(d, trained);
+
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return new DCTemplate_avx<
+                    Quantizer8bitDirectSignedRaw_avx<SIMDWIDTH>,
+                    Sim,
+                    SIMDWIDTH>(d, trained);
     }
     FAISS_THROW_MSG("unknown qtype");
     return nullptr;
@@ -751,6 +789,11 @@ InvertedListScanner* sel1_InvertedListScanner_avx(
                     Quantizer8bitDirectSigned_avx<SIMDWIDTH>,
                     Similarity,
                     SIMDWIDTH>>(sq, quantizer, store_pairs, sel, r);
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return sel2_InvertedListScanner_avx<DCTemplate_avx<
+                    Quantizer8bitDirectSignedRaw_avx<SIMDWIDTH>,
+                    Similarity,
+                    SIMDWIDTH>>(sq, quantizer, store_pairs, sel, r);
     }
 
     FAISS_THROW_MSG("unknown qtype");
@@ -356,6 +356,47 @@ struct Quantizer8bitDirectSigned_avx512<16>
     }
 };
 
+/*******************************************************************
+ * 8bit_direct_signed_raw quantizer
+ *******************************************************************/
+
+template <int SIMDWIDTH>
+struct Quantizer8bitDirectSignedRaw_avx512 {};
+
+template <>
+struct Quantizer8bitDirectSignedRaw_avx512<1>
+        : public Quantizer8bitDirectSignedRaw_avx<1> {
+    Quantizer8bitDirectSignedRaw_avx512(
+            size_t d,
+            const std::vector<float>& unused)
+            : Quantizer8bitDirectSignedRaw_avx<1>(d, unused) {}
+};
+
+template <>
+struct Quantizer8bitDirectSignedRaw_avx512<8>
+        : public Quantizer8bitDirectSignedRaw_avx<8> {
+    Quantizer8bitDirectSignedRaw_avx512(
+            size_t d,
+            const std::vector<float>& trained)
+            : Quantizer8bitDirectSignedRaw_avx<8>(d, trained) {}
+};
+
+template <>
+struct Quantizer8bitDirectSignedRaw_avx512<16>
+        : public Quantizer8bitDirectSignedRaw_avx<8> {
+    Quantizer8bitDirectSignedRaw_avx512(
+            size_t d,
+            const std::vector<float>& trained)
+            : Quantizer8bitDirectSignedRaw_avx<8>(d, trained) {}
+
+    FAISS_ALWAYS_INLINE __m512
+    reconstruct_16_components(const uint8_t* code, int i) const {
+        __m128i x16 = _mm_loadu_si128((__m128i*)(code + i)); // 16 * int8
+        __m512i y16 = _mm512_cvtepi8_epi32(x16);             // 16 * int32
+        return _mm512_cvtepi32_ps(y16);                      // 16 * float32
+    }
+};
+
 template <int SIMDWIDTH>
 SQuantizer* select_quantizer_1_avx512(
         QuantizerType qtype,
@@ -395,6 +436,8 @@ SQuantizer* select_quantizer_1_avx512(
             return new Quantizer8bitDirect_avx512<SIMDWIDTH>(d, trained);
         case QuantizerType::QT_8bit_direct_signed:
             return new Quantizer8bitDirectSigned_avx512<SIMDWIDTH>(d, trained);
+        case QuantizerType::QT_8bit_direct_signed_raw:
+            return new Quantizer8bitDirectSignedRaw_avx512<SIMDWIDTH>(d, trained);
     }
     FAISS_THROW_MSG("unknown qtype");
 }
@@ -799,6 +842,12 @@ SQDistanceComputer* select_distance_computer_avx512(
                     Quantizer8bitDirectSigned_avx512<SIMDWIDTH>,
                     Sim,
                     SIMDWIDTH>(d, trained);
+
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return new DCTemplate_avx512<
+                    Quantizer8bitDirectSignedRaw_avx512<SIMDWIDTH>,
+                    Sim,
+                    SIMDWIDTH>(d, trained);
     }
     FAISS_THROW_MSG("unknown qtype");
     return nullptr;
@@ -889,6 +938,11 @@ InvertedListScanner* sel1_InvertedListScanner_avx512(
                     Quantizer8bitDirectSigned_avx512<SIMDWIDTH>,
                     Similarity,
                     SIMDWIDTH>>(sq, quantizer, store_pairs, sel, r);
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return sel2_InvertedListScanner_avx512<DCTemplate_avx512<
+                    Quantizer8bitDirectSignedRaw_avx512<SIMDWIDTH>,
+                    Similarity,
+                    SIMDWIDTH>>(sq, quantizer, store_pairs, sel, r);
     }
 
     FAISS_THROW_MSG("unknown qtype");
@@ -251,6 +251,41 @@ struct Quantizer8bitDirectSigned_neon<8> : public Quantizer8bitDirectSigned<1> {
     }
 };
 
+/*******************************************************************
+ * 8bit_direct_signed_raw quantizer
+ *******************************************************************/
+
+template <int SIMDWIDTH>
+struct Quantizer8bitDirectSignedRaw_neon {};
+
+template <>
+struct Quantizer8bitDirectSignedRaw_neon<1>
+        : public Quantizer8bitDirectSignedRaw<1> {
+    Quantizer8bitDirectSignedRaw_neon(
+            size_t d,
+            const std::vector<float>& unused)
+            : Quantizer8bitDirectSignedRaw(d, unused) {}
+};
+
+template <>
+struct Quantizer8bitDirectSignedRaw_neon<8>
+        : public Quantizer8bitDirectSignedRaw<1> {
+    Quantizer8bitDirectSignedRaw_neon(
+            size_t d,
+            const std::vector<float>& trained)
+            : Quantizer8bitDirectSignedRaw<1>(d, trained) {}
+
+    FAISS_ALWAYS_INLINE float32x4x2_t
+    reconstruct_8_components(const uint8_t* code, int i) const {
+        int8x8_t x8 = vld1_s8((const int8_t*)(code + i));
+        int16x8_t y8 = vmovl_s8(x8); // convert int8 -> int16
+
+        // convert int16 -> int32 -> fp32
+        return {vcvtq_f32_s32(vmovl_s16(vget_low_s16(y8))),
+                vcvtq_f32_s32(vmovl_s16(vget_high_s16(y8)))};
+    }
+};
+
 template <int SIMDWIDTH>
 SQuantizer* select_quantizer_1_neon(
         QuantizerType qtype,
@@ -280,6 +315,8 @@ SQuantizer* select_quantizer_1_neon(
             return new Quantizer8bitDirect_neon<SIMDWIDTH>(d, trained);
         case QuantizerType::QT_8bit_direct_signed:
             return new Quantizer8bitDirectSigned_neon<SIMDWIDTH>(d, trained);
+        case QuantizerType::QT_8bit_direct_signed_raw:
+            return new Quantizer8bitDirectSignedRaw_neon<SIMDWIDTH>(d, trained);
     }
     FAISS_THROW_MSG("unknown qtype");
 }
@@ -643,6 +680,12 @@ SQDistanceComputer* select_distance_computer_neon(
                     Quantizer8bitDirectSigned_neon<SIMDWIDTH>,
                     Sim,
                     SIMDWIDTH>(d, trained);
+
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return new DCTemplate_neon<
+                    Quantizer8bitDirectSignedRaw_neon<SIMDWIDTH>,
+                    Sim,
+                    SIMDWIDTH>(d, trained);
     }
     FAISS_THROW_MSG("unknown qtype");
     return nullptr;
@@ -733,6 +776,11 @@ InvertedListScanner* sel1_InvertedListScanner_neon(
                     Quantizer8bitDirectSigned_neon<SIMDWIDTH>,
                     Similarity,
                     SIMDWIDTH>>(sq, quantizer, store_pairs, sel, r);
+        case ScalarQuantizer::QT_8bit_direct_signed_raw:
+            return sel2_InvertedListScanner_neon<DCTemplate_neon<
+                    Quantizer8bitDirectSignedRaw_neon<SIMDWIDTH>,
+                    Similarity,
+                    SIMDWIDTH>>(sq, quantizer, store_pairs, sel, r);
     }
 
     FAISS_THROW_MSG("unknown qtype");
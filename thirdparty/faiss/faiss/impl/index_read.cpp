@@ -80,6 +80,10 @@ void read_vector(std::vector<uint32_t>& v, IOReader* f) {
     READVECTOR(v);
 }
 
+void read_vector(std::vector<uint64_t>& v, IOReader* f) {
+    READVECTOR(v);
+}
+
 // "IHMV" is a special header for faiss hnsw to indicate whether mv or not
 bool read_is_mv(IOReader* f) {
     uint32_t h;
@@ -173,7 +177,7 @@ bool read_vector_base(
                     size_t(size),
                     strerror(errno));
 
-            VectorT view = VectorT::create_view(address, nread, nullptr);
+            VectorT view = VectorT::create_view(address, nread, zr->owner);
             target = std::move(view);
 
             return true;
@@ -1172,6 +1176,16 @@ Index* read_index(IOReader* f, int io_flags) {
         }
         read_InvertedLists(ivfl, f, io_flags);
         idx = ivfl;
+    } else if (h == fourcc("IwFt")) {
+        IndexIVFFlatTyped* ivft = new IndexIVFFlatTyped();
+        read_ivf_header(ivft, f);
+        read_ScalarQuantizer(&ivft->sq, f);
+        ivft->code_size = ivft->sq.code_size;
+        if (ivft->is_cosine) {
+            io_flags |= IO_FLAG_WITH_NORM;
+        }
+        read_InvertedLists(ivft, f, io_flags);
+        idx = ivft;
     } else if (h == fourcc("IxS8")) {
         IndexScalarQuantizerCosine* idxs = new IndexScalarQuantizerCosine();
         read_index_header(idxs, f);
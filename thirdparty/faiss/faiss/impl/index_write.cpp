@@ -849,6 +849,14 @@ void write_index(const Index* idx, IOWriter* f, int io_flags) {
             WRITEVECTOR(tab);
         }
         write_InvertedLists(ivfl->invlists, f);
+    } else if (
+            const IndexIVFFlatTyped* ivft =
+                    dynamic_cast<const IndexIVFFlatTyped*>(idx)) {
+        uint32_t h = fourcc("IwFt");
+        WRITE1(h);
+        write_ivf_header(ivft, f);
+        write_ScalarQuantizer(&ivft->sq, f);
+        write_InvertedLists(ivft->invlists, f);
     } else if (const IndexIVFFlat* ivfl = dynamic_cast<const IndexIVFFlatCC*>(idx)) {
         uint32_t h = fourcc("IwFc");
         WRITE1(h);
@@ -1140,6 +1148,10 @@ void write_vector(const std::vector<uint32_t>& v, IOWriter* f) {
     WRITEVECTOR(v);
 }
 
+void write_vector(const std::vector<uint64_t>& v, IOWriter* f) {
+    WRITEVECTOR(v);
+}
+
 // "IHMV" is a special header for faiss hnsw to indicate whether mv or not
 void write_mv(IOWriter* f) {
     uint32_t h = fourcc("IHMV");
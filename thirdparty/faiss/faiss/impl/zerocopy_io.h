@@ -8,18 +8,26 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 
 #include <faiss/impl/io.h>
+#include <faiss/impl/maybe_owned_vector.h>
 
 namespace faiss {
 
 // ZeroCopyIOReader just maps the data from a given pointer.
+// If set, `owner` is shared by the vectors viewing into the data, so that
+// the data outlives the index read from it.
 struct ZeroCopyIOReader : public faiss::IOReader {
     uint8_t* data_;
     size_t rp_ = 0;
     size_t total_ = 0;
+    std::shared_ptr<MaybeOwnedVectorOwner> owner;
 
-    ZeroCopyIOReader(uint8_t* data, size_t size);
+    ZeroCopyIOReader(
+            uint8_t* data,
+            size_t size,
+            std::shared_ptr<MaybeOwnedVectorOwner> owner = nullptr);
     ~ZeroCopyIOReader();
 
     void reset();
@@ -146,6 +146,7 @@ std::map<std::string, ScalarQuantizer::QuantizerType> sq_types = {
         {"SQfp16", ScalarQuantizer::QT_fp16},
         {"SQbf16", ScalarQuantizer::QT_bf16},
         {"SQ8_direct_signed", ScalarQuantizer::QT_8bit_direct_signed},
+        {"SQ8_direct_signed_raw", ScalarQuantizer::QT_8bit_direct_signed_raw},
         {"SQ8_direct", ScalarQuantizer::QT_8bit_direct},
 };
 const std::string sq_pattern =
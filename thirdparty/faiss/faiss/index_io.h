@@ -103,6 +103,8 @@ bool read_is_mv(IOReader* reader);
 bool read_is_mv(const char* fname);
 void write_vector(const std::vector<uint32_t>& v, IOWriter* writer);
 void read_vector(std::vector<uint32_t>& v, IOReader* f);
+void write_vector(const std::vector<uint64_t>& v, IOWriter* writer);
+void read_vector(std::vector<uint64_t>& v, IOReader* f);
 uint32_t read_value(IOReader *f);
 void write_value(uint32_t v, IOWriter* writer);
 void write_mv(IOWriter* writer);
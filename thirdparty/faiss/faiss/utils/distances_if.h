@@ -244,14 +244,20 @@ void internal_fvec_inner_products_ny_if(
         Apply apply) {
     using idx_type = std::invoke_result_t<IndexRemapper, size_t>;
 
+    // the kernels for the dimension, picked once per query
+    const auto dis1_func = fvec_inner_product_for_dim(d);
+    const auto dis4_func = fvec_inner_product_batch_4_for_dim(d);
+
     // compute a distance from the query to 1 element
-    auto distance1 = [x, y, d](const idx_type idx) {
-        return fvec_inner_product(x, y + idx * d, d);
+    auto distance1 = [x, y, d, dis1_func](const idx_type idx) {
+        return dis1_func(x, y + idx * d, d);
     };
 
     // compute distances from the query to 4 elements
-    auto distance4 = [x, y, d](const std::array<idx_type, 4> indices, std::array<float, 4>& dis) { 
-        fvec_inner_product_batch_4(
+    auto distance4 = [x, y, d, dis4_func](
+            const std::array<idx_type, 4> indices,
+            std::array<float, 4>& dis) {
+        dis4_func(
             x,
             y + indices[0] * d,
             y + indices[1] * d,
@@ -301,14 +307,20 @@ void internal_fvec_L2sqr_ny_if(
         Apply apply) {    
     using idx_type = std::invoke_result_t<IndexRemapper, size_t>;
 
+    // the kernels for the dimension, picked once per query
+    const auto dis1_func = fvec_L2sqr_for_dim(d);
+    const auto dis4_func = fvec_L2sqr_batch_4_for_dim(d);
+
     // compute a distance from the query to 1 element
-    auto distance1 = [x, y, d](const idx_type idx) { 
-        return fvec_L2sqr(x, y + idx * d, d); 
+    auto distance1 = [x, y, d, dis1_func](const idx_type idx) { 
+        return dis1_func(x, y + idx * d, d); 
     };
 
     // compute distances from the query to 4 elements
-    auto distance4 = [x, y, d](const std::array<idx_type, 4> indices, std::array<float, 4>& dis) { 
-        fvec_L2sqr_batch_4(
+    auto distance4 = [x, y, d, dis4_func](
+            const std::array<idx_type, 4> indices,
+            std::array<float, 4>& dis) {
+        dis4_func(
             x,
             y + indices[0] * d,
             y + indices[1] * d,
@@ -24,6 +24,63 @@
 #include "simd/hook.h"
 namespace faiss {
 namespace {
+// number of rows whose distances are computed by a single _ny call
+constexpr size_t TYPED_NY_BLOCK_SIZE = 256;
+
+// compute the distances between x and all the ny contiguous y vectors
+//   block by block with a _ny kernel, and apply every element.
+//   Used when nothing is filtered out, so that the kernel can walk the
+//   rows in order instead of gathering the accepted ones.
+template <typename DataType, typename DistanceNy, typename Apply>
+void typed_distances_ny(
+        const DataType* __restrict x,
+        const DataType* __restrict y,
+        size_t d,
+        size_t ny,
+        DistanceNy distance_ny,
+        Apply apply) {
+    float dis[TYPED_NY_BLOCK_SIZE];
+    for (size_t j0 = 0; j0 < ny; j0 += TYPED_NY_BLOCK_SIZE) {
+        const size_t nb = std::min(TYPED_NY_BLOCK_SIZE, ny - j0);
+        distance_ny(dis, x, y + j0 * d, d, nb);
+        for (size_t j = 0; j < nb; j++) {
+            apply(dis[j], j0 + j);
+        }
+    }
+}
+
+template <typename DataType>
+void typed_inner_products_ny(
+        float* dis,
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t ny) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+        fp16_vec_inner_products_ny(dis, x, y, d, ny);
+    } else if constexpr (std::is_same_v<DataType, knowhere::bf16>) {
+        bf16_vec_inner_products_ny(dis, x, y, d, ny);
+    } else if constexpr (std::is_same_v<DataType, knowhere::int8>) {
+        int8_vec_inner_products_ny(dis, x, y, d, ny);
+    }
+}
+
+template <typename DataType>
+void typed_L2sqr_ny(
+        float* dis,
+        const DataType* x,
+        const DataType* y,
+        size_t d,
+        size_t ny) {
+    if constexpr (std::is_same_v<DataType, knowhere::fp16>) {
+        fp16_vec_L2sqr_ny(dis, x, y, d, ny);
+    } else if constexpr (std::is_same_v<DataType, knowhere::bf16>) {
+        bf16_vec_L2sqr_ny(dis, x, y, d, ny);
+    } else if constexpr (std::is_same_v<DataType, knowhere::int8>) {
+        int8_vec_L2sqr_ny(dis, x, y, d, ny);
+    }
+}
+
 template <typename DataType, class BlockResultHandler, class IDSelector>
 void exhaustive_inner_product_impl_typed(
         const DataType* __restrict x,
@@ -58,6 +115,9 @@ void exhaustive_inner_product_impl_typed(
                 int8_vec_inner_products_ny_by_idx_if(
                         x_i, y, selector.ids, d, selector.n, filter, apply);
             }
+        } else if constexpr (std::is_same_v<IDSelector, IDSelectorAll>) {
+            typed_distances_ny(
+                    x_i, y, d, ny, typed_inner_products_ny<DataType>, apply);
         } else {
             // the lambda that filters acceptable elements.
             auto filter = [&selector](const size_t j) {
@@ -109,6 +169,9 @@ void exhaustive_L2sqr_seq_impl_typed(
                 int8_vec_L2sqr_ny_by_idx_if(
                         x_i, y, selector.ids, d, selector->n, filter, apply);
             }
+        } else if constexpr (std::is_same_v<IDSelector, IDSelectorAll>) {
+            typed_distances_ny(
+                    x_i, y, d, ny, typed_L2sqr_ny<DataType>, apply);
         } else {
             // the lambda that filters acceptable elements.
             auto filter = [&selector](const size_t j) {
@@ -177,6 +240,9 @@ void exhaustive_cosine_seq_impl_typed(
                 int8_vec_inner_products_ny_by_idx_if(
                         x_i, y, selector.ids, d, selector->n, filter, apply);
             }
+        } else if constexpr (std::is_same_v<IDSelector, IDSelectorAll>) {
+            typed_distances_ny(
+                    x_i, y, d, ny, typed_inner_products_ny<DataType>, apply);
         } else {
             // the lambda that filters acceptable elements.
             auto filter = [&selector](const size_t j) {
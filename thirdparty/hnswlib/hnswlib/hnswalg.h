@@ -26,6 +26,7 @@
 
 #include "hnswlib.h"
 #include "io/memory_io.h"
+#include "knowhere/comp/cancel_token.h"
 #include "knowhere/config.h"
 #include "knowhere/heap.h"
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
@@ -46,6 +47,8 @@ typedef unsigned int linklistsizeint;
 constexpr float kHnswSearchKnnBFFilterThreshold = 0.93f;
 constexpr float kHnswSearchRangeBFFilterThreshold = 0.97f;
 constexpr float kHnswSearchBFTopkThreshold = 0.5f;
+// hops between two polls of the cancel token of the request
+constexpr size_t kCancelCheckPeriod = 64;
 
 enum Metric {
     L2 = 0,
@@ -501,6 +504,10 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
             searchBaseLayerSTNext<decltype(add_search_candidate), has_deletions, collect_metrics>(
                 data_point, retset.pop(), visited, accumulative_alpha, bitset, add_search_candidate, feder_result);
             hops++;
+            // the request was given up on, the caller drops the result
+            if (hops % kCancelCheckPeriod == 0 && knowhere::CancelToken::CurrentIsCancelled()) {
+                break;
+            }
         }
 #if defined(NOT_COMPILE_FOR_SWIG) && !defined(KNOWHERE_WITH_LIGHT)
         knowhere::knowhere_hnsw_search_hops.Observe(hops);
@@ -567,7 +574,11 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
             visited[cand.id] = true;
         }
 
+        size_t hops = 0;
         while (!radius_queue.empty()) {
+            if (++hops % kCancelCheckPeriod == 0 && knowhere::CancelToken::CurrentIsCancelled()) {
+                break;
+            }
             auto cur = radius_queue.front();
             radius_queue.pop();
 